@@ -17,16 +17,26 @@
 
 #pragma once
 
+#include "dbus/host.hpp"
 #include "peci/metrics/types.hpp"
+#include "peci/transport/worker.hpp"
 #include "utils/configuration.hpp"
 #include "utils/log.hpp"
 
 #include <boost/asio/steady_timer.hpp>
+#include <boost/container/flat_map.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
+#include <variant>
+#include <vector>
 
 namespace cups
 {
@@ -34,21 +44,41 @@ namespace cups
 namespace base
 {
 
+/**
+ * @brief Detects CPUs present in the PECI sockets.
+ *
+ * All addresses are probed concurrently on worker threads, so sockets timing
+ * out do not delay each other nor the main loop. Sweep is started
+ * immediately when the host state changes. When the host goes to Running it
+ * is repeated at fastInterval until a CPU shows up, as PECI becomes available
+ * a while after power-on.
+ * Periodic sweep runs only as a backstop. CPU model and DIMM population are
+ * cached per socket, so sweeps after power cycle skip walking DIMM slots. The
+ * periodic sweep refreshes DIMM population, in case DIMMs have been replaced
+ * while the host was off.
+ */
 class CupsDiscovery : public std::enable_shared_from_this<CupsDiscovery>
 {
     // Prevents constructor from being called externally
     struct ctor_lock
     {};
 
+    using Cpus =
+        std::array<std::optional<peci::metrics::Cpu>, peci::cpu::limit>;
+    using SocketCaches =
+        std::array<peci::metrics::SocketCache, peci::cpu::limit>;
+
   public:
     CupsDiscovery(
         ctor_lock, boost::asio::io_context& iocArg,
+        std::shared_ptr<sdbusplus::asio::connection> busArg,
         std::shared_ptr<peci::transport::Adapter> peciAdapterArg,
         std::function<void(const std::array<std::optional<peci::metrics::Cpu>,
                                             peci::cpu::limit>&)>&& cpuUpdate) :
         ioc(iocArg),
-        peciAdapter(peciAdapterArg),
-        timer(iocArg, interval), updateCb{std::move(cpuUpdate)}
+        bus(busArg), peciAdapter(peciAdapterArg),
+        worker(iocArg, peci::cpu::limit), timer(iocArg, interval),
+        updateCb{std::move(cpuUpdate)}
     {
         if (updateCb == nullptr)
         {
@@ -58,15 +88,15 @@ class CupsDiscovery : public std::enable_shared_from_this<CupsDiscovery>
 
     static std::shared_ptr<CupsDiscovery> make(
         boost::asio::io_context& ioc,
+        std::shared_ptr<sdbusplus::asio::connection> bus,
         std::shared_ptr<peci::transport::Adapter> peciAdapter,
         std::function<void(const std::array<std::optional<peci::metrics::Cpu>,
                                             peci::cpu::limit>&)>&& cpuUpdate)
     {
         auto discovery = std::make_shared<CupsDiscovery>(
-            ctor_lock{}, ioc, peciAdapter, std::move(cpuUpdate));
-        discovery->detectCpus();
-        discovery->updateCb(discovery->cpus);
-        discovery->tick(discovery->interval);
+            ctor_lock{}, ioc, bus, peciAdapter, std::move(cpuUpdate));
+        discovery->initHostStateMonitor();
+        discovery->tick(std::chrono::milliseconds{0});
 
         return discovery;
     }
@@ -83,55 +113,152 @@ class CupsDiscovery : public std::enable_shared_from_this<CupsDiscovery>
 
   private:
     std::reference_wrapper<boost::asio::io_context> ioc;
+    std::shared_ptr<sdbusplus::asio::connection> bus;
     std::shared_ptr<peci::transport::Adapter> peciAdapter;
+    std::unique_ptr<sdbusplus::bus::match_t> hostStateMonitor;
+    peci::transport::Worker worker;
 
-    const std::chrono::milliseconds interval = std::chrono::seconds(30);
+    const std::chrono::milliseconds interval = std::chrono::minutes(2);
+    const std::chrono::milliseconds fastInterval = std::chrono::seconds(2);
+    const unsigned fastSweepLimit = 30;
     boost::asio::steady_timer timer;
 
     CupsDiscovery(const CupsDiscovery&) = delete;
     CupsDiscovery& operator=(const CupsDiscovery&) = delete;
 
-    std::array<std::optional<peci::metrics::Cpu>, peci::cpu::limit> cpus;
+    Cpus cpus;
+    // Every element is accessed only by the job probing its socket
+    std::shared_ptr<SocketCaches> caches = std::make_shared<SocketCaches>();
     std::function<void(
         const std::array<std::optional<peci::metrics::Cpu>, peci::cpu::limit>&)>
         updateCb;
 
-    void tick(std::chrono::milliseconds startDelay)
+    bool sweepInProgress = false;
+    bool sweepRequested = false;
+    unsigned fastSweepsLeft = 0;
+    size_t pendingProbes = 0;
+    Cpus sweepResult;
+
+    void initHostStateMonitor()
+    {
+        hostStateMonitor = dbus::host::makeStateMatch(
+            *bus, [weakSelf = weak_from_this()](const std::string& state) {
+                if (auto self = weakSelf.lock())
+                {
+                    LOG_DEBUG << "Host state changed to " << state
+                              << ", detecting CPUs";
+                    self->fastSweepsLeft = state == dbus::host::StateRunning
+                                               ? self->fastSweepLimit
+                                               : 0;
+                    self->tick(std::chrono::milliseconds{0});
+                }
+            });
+    }
+
+    void tick(std::chrono::milliseconds startDelay, bool refreshCache = false)
     {
         timer.expires_after(startDelay);
         timer.async_wait(
-            [self = shared_from_this()](const boost::system::error_code& e) {
+            [self = shared_from_this(),
+             refreshCache](const boost::system::error_code& e) {
                 LOG_DEBUG << "CupsDiscovery::tick()";
 
                 if (e)
                 {
-                    LOG_ERROR << "Timer failed with error : " << e.message();
+                    if (e != boost::asio::error::operation_aborted)
+                    {
+                        LOG_ERROR << "Timer failed with error : "
+                                  << e.message();
+                    }
                     return;
                 }
 
-                self->detectCpus();
-                self->updateCb(self->cpus);
-                self->tick(self->interval);
+                self->startSweep(refreshCache);
             });
     }
 
-    void detectCpus()
+    void startSweep(bool refreshCache)
     {
+        if (sweepInProgress)
+        {
+            sweepRequested = true;
+            return;
+        }
+
         LOG_DEBUG << "Detecting CPUs";
 
-        for (size_t index = 0; index < peci::cpu::limit; index++)
+        if (refreshCache)
         {
-            cpus[index].reset();
+            for (auto& cache : *caches)
+            {
+                cache.dimmPopulation.reset();
+            }
+        }
 
+        sweepInProgress = true;
+        pendingProbes = peci::cpu::limit;
+        for (size_t index = 0; index < peci::cpu::limit; index++)
+        {
             const uint8_t address =
                 static_cast<uint8_t>(peci::cpu::minAddress + index);
 
-            if (auto metrics = peci::metrics::Cpu::detect(peciAdapter, address))
-            {
-                LOG_DEBUG << "CPU found: " << metrics->core;
-                cpus[index].emplace(std::move(*metrics));
-            }
+            worker.post(
+                [peciAdapter = peciAdapter, caches = caches, index,
+                 address]() {
+                    return peci::metrics::Cpu::detect(peciAdapter, address,
+                                                      (*caches)[index]);
+                },
+                [weakSelf = weak_from_this(),
+                 index](std::optional<peci::metrics::Cpu> cpu) {
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->onProbed(index, std::move(cpu));
+                    }
+                });
+        }
+    }
+
+    void onProbed(size_t index, std::optional<peci::metrics::Cpu>&& cpu)
+    {
+        if (cpu)
+        {
+            LOG_DEBUG << "CPU found: " << cpu->core;
+        }
+        sweepResult[index] = std::move(cpu);
+        if (--pendingProbes > 0)
+        {
+            return;
+        }
+
+        cpus = std::move(sweepResult);
+        sweepResult = {};
+        sweepInProgress = false;
+
+        // Next sweep is scheduled first, so a restart requested from the
+        // update callback takes precedence
+        if (sweepRequested)
+        {
+            sweepRequested = false;
+            tick(std::chrono::milliseconds{0});
+        }
+        else if (fastSweepsLeft > 0 && !isAnyCpuPresent())
+        {
+            fastSweepsLeft--;
+            tick(fastInterval);
+        }
+        else
+        {
+            fastSweepsLeft = 0;
+            tick(interval, true);
         }
+
+        updateCb(cpus);
+    }
+
+    bool isAnyCpuPresent() const
+    {
+        return std::any_of(cpus.begin(), cpus.end(),
+                           [](const auto& cpu) { return cpu.has_value(); });
     }
 };
 
@@ -18,7 +18,9 @@
 #pragma once
 
 #include "base/loadFactors.hpp"
+#include "dbus/host.hpp"
 #include "peci/metrics/types.hpp"
+#include "peci/transport/worker.hpp"
 #include "utils/log.hpp"
 
 #include <boost/asio/steady_timer.hpp>
@@ -31,6 +33,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <variant>
 #include <vector>
 
@@ -66,10 +69,11 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
     CupsReadings(
         ctor_lock, boost::asio::io_context& iocArg,
         std::shared_ptr<sdbusplus::asio::connection> busArg,
+        std::shared_ptr<peci::transport::Worker> workerArg,
         std::function<void(std::array<std::optional<peci::metrics::Cpu>,
                                       peci::cpu::limit>&)>&& cpuRetriever) :
         ioc(iocArg),
-        bus(busArg),
+        bus(busArg), worker(workerArg),
         timer(iocArg, interval), getCpuData{std::move(cpuRetriever)}
     {
         if (getCpuData == nullptr)
@@ -81,11 +85,12 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
     static std::shared_ptr<CupsReadings>
         make(boost::asio::io_context& ioc,
              std::shared_ptr<sdbusplus::asio::connection> bus,
+             std::shared_ptr<peci::transport::Worker> worker,
              std::function<void(std::array<std::optional<peci::metrics::Cpu>,
                                            peci::cpu::limit>&)>&& cpuRetriever)
     {
-        auto readings = std::make_shared<CupsReadings>(ctor_lock{}, ioc, bus,
-                                                       std::move(cpuRetriever));
+        auto readings = std::make_shared<CupsReadings>(
+            ctor_lock{}, ioc, bus, worker, std::move(cpuRetriever));
         readings->initHostStateMonitor();
         readings->tick();
 
@@ -161,8 +166,31 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
     }
 
   private:
+    using Utilizations =
+        std::array<std::optional<peci::metrics::Utilization>, peci::cpu::limit>;
+
+    /**
+     * @brief Result of a single metric of a single CPU, error holds message
+     * of the PECI exception thrown while sampling.
+     */
+    struct MetricSample
+    {
+        std::optional<std::pair<double, double>> delta;
+        std::optional<std::string> error;
+    };
+
+    struct CpuSample
+    {
+        MetricSample core;
+        MetricSample memory;
+        MetricSample iio;
+    };
+
+    using Samples = std::array<std::optional<CpuSample>, peci::cpu::limit>;
+
     std::reference_wrapper<boost::asio::io_context> ioc;
     std::shared_ptr<sdbusplus::asio::connection> bus;
+    std::shared_ptr<peci::transport::Worker> worker;
     std::unique_ptr<sdbusplus::bus::match_t> hostStateMonitor;
 
     std::chrono::milliseconds interval = std::chrono::seconds(1);
@@ -176,8 +204,10 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
         std::array<std::optional<peci::metrics::Cpu>, peci::cpu::limit>&)>
         getCpuData;
     std::array<std::optional<peci::metrics::Cpu>, peci::cpu::limit> cpus;
-    std::array<std::optional<peci::metrics::Utilization>, peci::cpu::limit>
-        utilization;
+    // Accessed by the worker job while the tick is sampling, the main loop
+    // uses it only between the ticks
+    std::shared_ptr<Utilizations> utilization =
+        std::make_shared<Utilizations>();
 
     // [TODO] consider changing to std::array
     boost::container::flat_map<Type, std::shared_ptr<Sensor>> sensors;
@@ -189,9 +219,8 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
     void initHostStateMonitor()
     {
         sdbusplus::asio::getProperty<std::string>(
-            *bus, "xyz.openbmc_project.State.Host",
-            "/xyz/openbmc_project/state/host0",
-            "xyz.openbmc_project.State.Host", "CurrentHostState",
+            *bus, dbus::host::Service, dbus::host::Path, dbus::host::Iface,
+            dbus::host::StateProperty,
             [self = shared_from_this()](const boost::system::error_code ec,
                                         const std::string& initialHostState) {
                 if (ec)
@@ -205,40 +234,12 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
                 }
             });
 
-        constexpr auto matchParam =
-            "type='signal',member='PropertiesChanged',path='/xyz/"
-            "openbmc_project/state/"
-            "host0',arg0='xyz.openbmc_project.State.Host'";
-
-        hostStateMonitor = std::make_unique<sdbusplus::bus::match_t>(
-            *bus, matchParam,
-            [weakSelf =
-                 weak_from_this()](sdbusplus::message::message& message) {
+        hostStateMonitor = dbus::host::makeStateMatch(
+            *bus, [weakSelf = weak_from_this()](const std::string& state) {
                 if (auto self = weakSelf.lock())
                 {
-                    std::string iface;
-                    boost::container::flat_map<
-                        std::string, std::variant<std::monostate, std::string>>
-                        changedProperties;
-                    std::vector<std::string> invalidatedProperties;
-
-                    message.read(iface, changedProperties,
-                                 invalidatedProperties);
-
-                    if (iface == "xyz.openbmc_project.State.Host")
-                    {
-                        const auto it =
-                            changedProperties.find("CurrentHostState");
-                        if (it != changedProperties.end())
-                        {
-                            if (auto val =
-                                    std::get_if<std::string>(&it->second))
-                            {
-                                LOG_DEBUG << "New host state: " << *val;
-                                self->hostState = *val;
-                            }
-                        }
-                    }
+                    LOG_DEBUG << "New host state: " << state;
+                    self->hostState = state;
                 }
             });
     }
@@ -254,20 +255,63 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
         }
     }
 
+    /**
+     * @brief Samples all CPUs on the worker thread, sensors are updated from
+     * the main loop once all PECI commands of the tick have completed.
+     */
     void tick()
     {
         updateCpuState();
-        if ((hostState == "xyz.openbmc_project.State.Host.HostState.Off") &&
-            (countCpus() > 0))
+        if ((hostState == dbus::host::StateOff) && (countCpus() > 0))
         {
             updateUtilizationForHostOff();
+            updateCupsIndex();
+            scheduleTick();
+            return;
         }
-        else
+
+        worker->post(
+            [utilization = utilization]() { return sample(*utilization); },
+            [weakSelf = weak_from_this()](const Samples& samples) {
+                if (auto self = weakSelf.lock())
+                {
+                    self->updateUtilization(samples);
+                    self->updateCupsIndex();
+                    self->scheduleTick();
+                }
+            });
+    }
+
+    static Samples sample(Utilizations& utilization)
+    {
+        Samples samples;
+        for (size_t idx = 0; idx < utilization.size(); idx++)
         {
-            updateUtilization();
+            if (auto& util = utilization[idx])
+            {
+                samples[idx] = CpuSample{sampleMetric(util->core),
+                                         sampleMetric(util->memory),
+                                         sampleMetric(util->iio)};
+            }
         }
-        updateCupsIndex();
+        return samples;
+    }
 
+    template <typename Metric>
+    static MetricSample sampleMetric(Metric& metric)
+    {
+        try
+        {
+            return {metric.delta(), std::nullopt};
+        }
+        catch (const peci::Exception& e)
+        {
+            return {std::nullopt, e.what()};
+        }
+    }
+
+    void scheduleTick()
+    {
         timer.expires_after(interval);
         timer.async_wait(
             [self = shared_from_this()](const boost::system::error_code& e) {
@@ -292,7 +336,7 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
         // Clear data related to non-existent cpus
         for (auto& cpu : cpus)
         {
-            auto& util = utilization[idx];
+            auto& util = (*utilization)[idx];
             if (!cpu)
             {
                 util.reset();
@@ -315,63 +359,65 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
         return std::count_if(cpus.begin(), cpus.end(), isCpuPresent);
     }
 
-    void updateUtilization()
+    void updateUtilization(const Samples& samples)
     {
         auto core = sensors.find(Type::Core);
         if (core != sensors.end())
         {
-            updateAggregateSensor(core->second,
-                                  &peci::metrics::Utilization::core);
+            updateAggregateSensor(core->second, samples, &CpuSample::core);
         }
 
         auto memory = sensors.find(Type::Memory);
         if (memory != sensors.end())
         {
-            updateAggregateSensor(memory->second,
-                                  &peci::metrics::Utilization::memory);
+            updateAggregateSensor(memory->second, samples, &CpuSample::memory);
         }
 
         auto iio = sensors.find(Type::Iio);
         if (iio != sensors.end())
         {
-            updateAggregateSensor(iio->second,
-                                  &peci::metrics::Utilization::iio);
+            updateAggregateSensor(iio->second, samples, &CpuSample::iio);
         }
     }
 
-    template <typename T, typename U>
-    void updateAggregateSensor(std::shared_ptr<Sensor>& sensor, T U::*counter)
+    void updateAggregateSensor(std::shared_ptr<Sensor>& sensor,
+                               const Samples& samples,
+                               MetricSample CpuSample::*metric)
     {
-        try
+        for (const auto& cpuSample : samples)
         {
-            if (auto value = aggregateUtilization(counter))
+            if (cpuSample && (*cpuSample.*metric).error)
             {
-                constexpr auto e = boost::system::errc::success;
-                sensor->update(boost::system::errc::make_error_code(e), *value);
+                LOG_ERROR << "Aggregation failed for sensor: "
+                          << sensor->getName() << ", "
+                          << *(*cpuSample.*metric).error;
+
+                auto value = std::numeric_limits<double>::quiet_NaN();
+                constexpr auto err = boost::system::errc::io_error;
+                sensor->update(boost::system::errc::make_error_code(err),
+                               value);
+                return;
             }
         }
-        catch (const peci::Exception& e)
-        {
-            LOG_ERROR << "Aggregation failed for sensor: " << sensor->getName()
-                      << ", " << e.what();
 
-            auto value = std::numeric_limits<double>::quiet_NaN();
-            constexpr auto err = boost::system::errc::io_error;
-            sensor->update(boost::system::errc::make_error_code(err), value);
+        if (auto value = aggregateUtilization(samples, metric))
+        {
+            constexpr auto e = boost::system::errc::success;
+            sensor->update(boost::system::errc::make_error_code(e), *value);
         }
     }
 
-    template <typename T, typename U>
-    std::optional<double> aggregateUtilization(T U::*counter)
+    std::optional<double> aggregateUtilization(const Samples& samples,
+                                               MetricSample CpuSample::*metric)
     {
         double totalDelta = 0;
         double totalMax = 0;
 
-        for (auto& util : utilization)
+        for (const auto& cpuSample : samples)
         {
-            if (util)
+            if (cpuSample)
             {
-                const auto& ret = (*util.*counter).delta();
+                const auto& ret = (*cpuSample.*metric).delta;
                 if (!ret)
                 {
                     return std::nullopt;
@@ -382,8 +428,9 @@ class CupsReadings : public std::enable_shared_from_this<CupsReadings>
                 totalMax += maxUtil;
             }
         }
+        using Format = peci::metrics::UtilizationDelta<peci::metrics::Core>;
         LOG_DEBUG_T("Total")
-            << "Utilization = " << T::to_string(totalDelta, totalMax);
+            << "Utilization = " << Format::to_string(totalDelta, totalMax);
 
         return peci::metrics::convertToPercent(totalDelta, totalMax);
     }
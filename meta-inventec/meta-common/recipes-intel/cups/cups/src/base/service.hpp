@@ -21,6 +21,7 @@
 #include "base/readings.hpp"
 #include "base/sensor.hpp"
 #include "peci/transport/adapter.hpp"
+#include "peci/transport/worker.hpp"
 
 #include <boost/beast/core/span.hpp>
 #include <sdbusplus/asio/object_server.hpp>
@@ -45,7 +46,8 @@ class CupsService
     CupsService(ctor_lock, boost::asio::io_context& iocArg,
                 std::shared_ptr<peci::transport::Adapter> peciAdapterArg) :
         ioc(iocArg),
-        peciAdapter(peciAdapterArg)
+        peciAdapter(peciAdapterArg),
+        peciWorker(std::make_shared<peci::transport::Worker>(iocArg))
     {}
 
     static std::shared_ptr<CupsService>
@@ -150,9 +152,9 @@ class CupsService
             };
 
         cupsService->discovery = CupsDiscovery::make(
-            ioc, cupsService->peciAdapter, std::move(cpuSetter));
-        cupsService->readings =
-            CupsReadings::make(ioc, bus, std::move(cpuGetter));
+            ioc, bus, cupsService->peciAdapter, std::move(cpuSetter));
+        cupsService->readings = CupsReadings::make(
+            ioc, bus, cupsService->peciWorker, std::move(cpuGetter));
     }
 
     static void
@@ -233,6 +235,7 @@ class CupsService
 
     std::reference_wrapper<boost::asio::io_context> ioc;
     std::shared_ptr<peci::transport::Adapter> peciAdapter;
+    std::shared_ptr<peci::transport::Worker> peciWorker;
     std::vector<std::shared_ptr<Sensor>> sensors;
 
     std::shared_ptr<CupsDiscovery> discovery;
@@ -0,0 +1,90 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#pragma once
+
+#include <boost/container/flat_map.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace cups
+{
+
+namespace dbus
+{
+
+namespace host
+{
+
+static constexpr auto Service = "xyz.openbmc_project.State.Host";
+static constexpr auto Path = "/xyz/openbmc_project/state/host0";
+static constexpr auto Iface = "xyz.openbmc_project.State.Host";
+static constexpr auto StateProperty = "CurrentHostState";
+static constexpr auto StateOff =
+    "xyz.openbmc_project.State.Host.HostState.Off";
+static constexpr auto StateRunning =
+    "xyz.openbmc_project.State.Host.HostState.Running";
+
+/**
+ * @brief Calls onChange with the new value of CurrentHostState of host0
+ * every time it changes.
+ */
+inline std::unique_ptr<sdbusplus::bus::match_t>
+    makeStateMatch(sdbusplus::bus::bus& bus,
+                   std::function<void(const std::string&)>&& onChange)
+{
+    const std::string matchParam =
+        std::string("type='signal',member='PropertiesChanged',path='") +
+        Path + "',arg0='" + Iface + "'";
+
+    return std::make_unique<sdbusplus::bus::match_t>(
+        bus, matchParam,
+        [onChange = std::move(onChange)](sdbusplus::message::message& message) {
+            std::string iface;
+            boost::container::flat_map<
+                std::string, std::variant<std::monostate, std::string>>
+                changedProperties;
+            std::vector<std::string> invalidatedProperties;
+
+            message.read(iface, changedProperties, invalidatedProperties);
+
+            if (iface != Iface)
+            {
+                return;
+            }
+            const auto it = changedProperties.find(StateProperty);
+            if (it != changedProperties.end())
+            {
+                if (auto val = std::get_if<std::string>(&it->second))
+                {
+                    onChange(*val);
+                }
+            }
+        });
+}
+
+} // namespace host
+
+} // namespace dbus
+
+} // namespace cups
@@ -20,6 +20,7 @@
 #include "dbus/service.hpp"
 #include "log.hpp"
 #include "peci/transport/adapter.hpp"
+#include "peci/transport/transport.hpp"
 #include "utils/traits.hpp"
 
 #include <CLI/CLI.hpp>
@@ -27,7 +28,9 @@
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 
+#include <map>
 #include <memory>
+#include <string>
 
 constexpr auto defaultLogLevel = cups::utils::LogLevel::info;
 
@@ -36,9 +39,13 @@ namespace cups
 class App
 {
   public:
-    App(boost::asio::io_context& iocArg) :
-        ioc(iocArg), bus{std::make_shared<typeof(*bus)>(ioc)},
-        objServer{std::make_shared<typeof(*objServer)>(bus)}, config(bus)
+    App(boost::asio::io_context& iocArg,
+        std::shared_ptr<peci::transport::Transport> peciTransport) :
+        ioc(iocArg),
+        bus{std::make_shared<typeof(*bus)>(ioc)},
+        objServer{std::make_shared<typeof(*objServer)>(bus)},
+        peciAdapter{std::make_shared<peci::transport::Adapter>(peciTransport)},
+        config(bus)
     {
         bus->request_name(dbus::Service);
 
@@ -52,8 +59,8 @@ class App
     std::reference_wrapper<boost::asio::io_context> ioc;
     std::shared_ptr<sdbusplus::asio::connection> bus;
     std::shared_ptr<sdbusplus::asio::object_server> objServer;
-    std::shared_ptr<dbus::CupsService> cupsService;
     std::shared_ptr<peci::transport::Adapter> peciAdapter;
+    std::shared_ptr<dbus::CupsService> cupsService;
     Configuration config;
 
     void configureService(const bool isEnabled,
@@ -127,6 +134,29 @@ int main(int argc, char* argv[])
         cups::utils::toIntegral(cups::utils::LogLevel::most_verbose),
         cups::utils::toIntegral(cups::utils::LogLevel::least_verbose)));
 
+    cups::peci::transport::Options peciOptions;
+    const std::map<std::string, cups::peci::transport::Mode> peciModes = {
+        {"hardware", cups::peci::transport::Mode::hardware},
+        {"record", cups::peci::transport::Mode::record},
+        {"replay", cups::peci::transport::Mode::replay},
+        {"synthetic", cups::peci::transport::Mode::synthetic}};
+
+    params
+        .add_option("--peci-transport", peciOptions.mode,
+                    "PECI transport: hardware, record, replay or synthetic")
+        ->transform(CLI::CheckedTransformer(peciModes));
+    params.add_option("--peci-trace-file", peciOptions.traceFile,
+                      "File written in record and read in replay mode");
+    params
+        .add_option("--peci-time-scale", peciOptions.timeScale,
+                    "Multiplier of recorded latencies in replay mode, 0 "
+                    "disables delays")
+        ->check(CLI::NonNegativeNumber);
+    params
+        .add_option("--peci-cpus", peciOptions.cpuCount,
+                    "Number of CPUs simulated in synthetic mode")
+        ->check(CLI::Range(1U, cups::peci::cpu::limit));
+
     CLI11_PARSE(params, argc, argv);
 
     cups::utils::logger::setLogLevel(
@@ -140,7 +170,12 @@ int main(int argc, char* argv[])
 
     LOG_INFO << "Application starting";
 
-    cups::App app(ioc);
+    auto peciTransport = cups::peci::transport::makeTransport(peciOptions);
+    if (!peciTransport)
+    {
+        return 1;
+    }
+    cups::App app(ioc, peciTransport);
 
     ioc.run();
 
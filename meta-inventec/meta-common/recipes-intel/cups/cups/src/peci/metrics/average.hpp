@@ -32,6 +32,14 @@ namespace peci
 namespace metrics
 {
 
+/**
+ * @brief Moving average of the last numSamples values.
+ *
+ * Sum of the samples is updated on every insertion instead of being
+ * recalculated, which makes the update cost independent of the window size.
+ * To keep rounding errors from building up, the sum is recalculated from the
+ * stored samples once per window length.
+ */
 class AverageCounter
 {
   public:
@@ -40,19 +48,26 @@ class AverageCounter
 
     double updateAverage(double value)
     {
+        if (samples.full() && !samples.empty())
+        {
+            sum -= samples.front();
+        }
         samples.push_back(value);
+        sum += value;
+
+        if (++updatesSinceRecalculation >= samples.capacity())
+        {
+            sum = std::accumulate(samples.begin(), samples.end(), double(0));
+            updatesSinceRecalculation = 0;
+        }
 
-        return calculateAverageUtilization();
+        return sum / static_cast<double>(samples.size());
     }
 
   private:
     boost::circular_buffer<double> samples;
-
-    double calculateAverageUtilization()
-    {
-        return std::accumulate(samples.begin(), samples.end(), double(0)) /
-               static_cast<double>(samples.size());
-    }
+    double sum = 0;
+    size_t updatesSinceRecalculation = 0;
 };
 
 } // namespace metrics
@@ -34,6 +34,12 @@ namespace peci
 namespace metrics
 {
 
+struct DimmPopulation
+{
+    uint8_t dimmCount;
+    uint8_t channelCount;
+};
+
 class MemoryFactory
 {
   public:
@@ -43,11 +49,28 @@ class MemoryFactory
 
     std::optional<Memory> detect(uint8_t address, uint32_t cpuId,
                                  uint8_t cpuBusNumber)
+    {
+        std::optional<DimmPopulation> dimmPopulation;
+        return detect(address, cpuId, cpuBusNumber, dimmPopulation);
+    }
+
+    /**
+     * @brief Uses dimmPopulation when provided instead of walking all DIMM
+     * slots, stores the detected population in it otherwise.
+     */
+    std::optional<Memory> detect(uint8_t address, uint32_t cpuId,
+                                 uint8_t cpuBusNumber,
+                                 std::optional<DimmPopulation>& dimmPopulation)
     {
         try
         {
-            auto [dimmCount, channelCount] =
-                detectDimmPopulation(address, cpuId, cpuBusNumber);
+            if (!dimmPopulation)
+            {
+                auto [dimmCount, channelCount] =
+                    detectDimmPopulation(address, cpuId, cpuBusNumber);
+                dimmPopulation = DimmPopulation{dimmCount, channelCount};
+            }
+            const auto [dimmCount, channelCount] = *dimmPopulation;
             uint32_t frequency = detectFrequency(address, cpuId, cpuBusNumber);
             uint64_t maxUtil = calcMaxUtil(channelCount, frequency);
 
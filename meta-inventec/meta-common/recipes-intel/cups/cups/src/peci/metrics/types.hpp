@@ -35,6 +35,16 @@ namespace peci
 namespace metrics
 {
 
+/**
+ * @brief Discovery data of a socket kept between discoveries. DIMM population
+ * is reused as long as the same CPU model is found in the socket.
+ */
+struct SocketCache
+{
+    std::optional<uint32_t> cpuId;
+    std::optional<DimmPopulation> dimmPopulation;
+};
+
 struct Cpu
 {
     Core core;
@@ -48,6 +58,14 @@ struct Cpu
     static std::optional<Cpu>
         detect(std::shared_ptr<transport::Adapter> peciAdapter,
                const uint8_t address)
+    {
+        SocketCache cache;
+        return detect(peciAdapter, address, cache);
+    }
+
+    static std::optional<Cpu>
+        detect(std::shared_ptr<transport::Adapter> peciAdapter,
+               const uint8_t address, SocketCache& cache)
     {
         auto coreFactory = CoreFactory(peciAdapter);
         auto cpu = coreFactory.detect(address);
@@ -63,9 +81,16 @@ struct Cpu
             return std::nullopt;
         }
 
+        if (cache.cpuId != cpu->getCpuId())
+        {
+            cache.cpuId = cpu->getCpuId();
+            cache.dimmPopulation.reset();
+        }
+
         auto memoryFactory = MemoryFactory(peciAdapter);
         auto memory = memoryFactory.detect(cpu->getAddress(), cpu->getCpuId(),
-                                           cpu->getBusNumber());
+                                           cpu->getBusNumber(),
+                                           cache.dimmPopulation);
         if (!memory)
         {
             return std::nullopt;
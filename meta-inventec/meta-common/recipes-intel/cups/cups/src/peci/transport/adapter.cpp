@@ -76,9 +76,10 @@ static void trace(const std::string& name, const uint8_t* payload,
 #define trace(name, payload, size)
 #endif
 
-bool commandHandler(const uint8_t target, const uint8_t* pReq,
-                    const size_t reqSize, uint8_t* pRsp, const size_t rspSize,
-                    const bool logError, const std::string& name)
+bool commandHandler(Transport& transport, const uint8_t target,
+                    const uint8_t* pReq, const size_t reqSize, uint8_t* pRsp,
+                    const size_t rspSize, const bool logError,
+                    const std::string& name)
 {
     static constexpr unsigned devCompCodeSuccess = 0x40;
 
@@ -86,9 +87,7 @@ bool commandHandler(const uint8_t target, const uint8_t* pReq,
 
     trace(name, pReq, reqSize);
 
-    ret = peci_raw(target, static_cast<uint8_t>(rspSize), pReq,
-                   static_cast<uint8_t>(reqSize), pRsp,
-                   static_cast<uint8_t>(rspSize));
+    ret = transport.execute(target, pReq, reqSize, pRsp, rspSize);
 
     if (PECI_CC_SUCCESS != ret)
     {
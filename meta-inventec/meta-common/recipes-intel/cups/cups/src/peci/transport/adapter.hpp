@@ -18,12 +18,14 @@
 #pragma once
 
 #include "peci/abi.hpp"
+#include "peci/transport/transport.hpp"
 #include "utils/log.hpp"
 #include "utils/traits.hpp"
 
 #include <boost/crc.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace cups
@@ -52,13 +54,18 @@ static inline uint8_t calculateAwFcs(uint8_t target, uint8_t reqLen,
     return (crc_8() ^ 0x80);
 }
 
-bool commandHandler(const uint8_t target, const uint8_t* pReq,
-                    const size_t reqSize, uint8_t* pRsp, const size_t rspSize,
-                    const bool logError = true, const std::string& name = "");
+bool commandHandler(Transport& transport, const uint8_t target,
+                    const uint8_t* pReq, const size_t reqSize, uint8_t* pRsp,
+                    const size_t rspSize, const bool logError = true,
+                    const std::string& name = "");
 
 class Adapter
 {
   public:
+    explicit Adapter(std::shared_ptr<Transport> transportArg) :
+        transport{std::move(transportArg)}
+    {}
+
     template <typename Req, typename Rsp>
     bool executePeciCommand(uint8_t target, Req& req, Rsp& rsp,
                             bool logError = true) const
@@ -67,8 +74,8 @@ class Adapter
         const auto pRsp = reinterpret_cast<uint8_t*>(&rsp);
         auto reqName = utils::typeName<Req>();
 
-        return commandHandler(target, pReq, sizeof(Req), pRsp, sizeof(Rsp),
-                              logError, reqName);
+        return commandHandler(*transport, target, pReq, sizeof(Req), pRsp,
+                              sizeof(Rsp), logError, reqName);
     }
 
     bool getCpuId(uint8_t target, uint32_t& cpuId) const
@@ -574,6 +581,9 @@ class Adapter
         xppMonFrCtrClk = rsp.count;
         return true;
     }
+
+  private:
+    std::shared_ptr<Transport> transport;
 };
 
 } // namespace transport
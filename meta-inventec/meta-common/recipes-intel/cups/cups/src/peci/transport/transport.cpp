@@ -0,0 +1,509 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#include "peci/transport/transport.hpp"
+
+#include "peci/abi.hpp"
+#include "utils/log.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+namespace cups
+{
+
+namespace peci
+{
+
+namespace transport
+{
+
+namespace
+{
+
+// Node Manager has its own copy of the trace format in
+// include/sensors/peci/peci_transport.hpp (PeciTraceFile), any change must be
+// made in both and traceVersion increased.
+constexpr char traceMagic[] = "PECT";
+constexpr size_t traceMagicSize = sizeof(traceMagic) - 1;
+constexpr uint16_t traceVersion = 1;
+constexpr size_t traceHeaderSize = traceMagicSize + 4;
+constexpr size_t traceRecordHeaderSize = 8;
+
+void putInt(std::string& out, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+    {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint32_t getInt(const std::string& in, size_t offset, size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(in[offset + i]))
+                 << (8 * i);
+    }
+    return value;
+}
+
+template <typename Response>
+Response* responseAs(uint8_t* pRsp, size_t rspSize)
+{
+    return rspSize == sizeof(Response) ? reinterpret_cast<Response*>(pRsp)
+                                       : nullptr;
+}
+
+} // namespace
+
+EPECIStatus HardwareTransport::execute(uint8_t target, const uint8_t* pReq,
+                                       size_t reqSize, uint8_t* pRsp,
+                                       size_t rspSize)
+{
+    return peci_raw(target, static_cast<uint8_t>(rspSize), pReq,
+                    static_cast<uint8_t>(reqSize), pRsp,
+                    static_cast<uint8_t>(rspSize));
+}
+
+namespace trace
+{
+
+std::string encodeHeader()
+{
+    std::string header(traceMagic, traceMagicSize);
+    putInt(header, traceVersion, 2);
+    putInt(header, 0, 2);
+    return header;
+}
+
+std::string encodeRecord(const TraceRecord& record)
+{
+    std::string encoded;
+    putInt(encoded, record.target, 1);
+    putInt(encoded, static_cast<uint32_t>(record.status), 1);
+    putInt(encoded, static_cast<uint32_t>(record.request.size()), 1);
+    putInt(encoded, static_cast<uint32_t>(record.response.size()), 1);
+    putInt(encoded, static_cast<uint32_t>(record.latency.count()), 4);
+    encoded.append(record.request.begin(), record.request.end());
+    encoded.append(record.response.begin(), record.response.end());
+    return encoded;
+}
+
+std::optional<std::vector<TraceRecord>>
+    load(const std::filesystem::path& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+    const std::string content{std::istreambuf_iterator<char>(file),
+                              std::istreambuf_iterator<char>()};
+    if (content.size() < traceHeaderSize ||
+        content.compare(0, traceMagicSize, traceMagic) != 0 ||
+        getInt(content, traceMagicSize, 2) != traceVersion)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<TraceRecord> records;
+    size_t offset = traceHeaderSize;
+    while (content.size() - offset >= traceRecordHeaderSize)
+    {
+        const size_t reqSize = getInt(content, offset + 2, 1);
+        const size_t rspSize = getInt(content, offset + 3, 1);
+        const size_t dataOffset = offset + traceRecordHeaderSize;
+        if (content.size() - dataOffset < reqSize + rspSize)
+        {
+            break;
+        }
+
+        TraceRecord& record = records.emplace_back();
+        record.target = static_cast<uint8_t>(getInt(content, offset, 1));
+        record.status =
+            static_cast<EPECIStatus>(getInt(content, offset + 1, 1));
+        record.latency =
+            std::chrono::microseconds{getInt(content, offset + 4, 4)};
+        const auto data = content.begin() + static_cast<long>(dataOffset);
+        record.request.assign(data, data + static_cast<long>(reqSize));
+        record.response.assign(data + static_cast<long>(reqSize),
+                               data + static_cast<long>(reqSize + rspSize));
+        offset = dataOffset + reqSize + rspSize;
+    }
+    return records;
+}
+
+} // namespace trace
+
+RecordingTransport::RecordingTransport(std::unique_ptr<Transport> innerArg,
+                                       const std::filesystem::path& filePath) :
+    inner{std::move(innerArg)},
+    file{filePath, std::ios::binary | std::ios::trunc}
+{
+    if (!file)
+    {
+        LOG_ERROR << "Unable to open PECI trace file: " << filePath;
+    }
+    file << trace::encodeHeader();
+    file.flush();
+}
+
+EPECIStatus RecordingTransport::execute(uint8_t target, const uint8_t* pReq,
+                                        size_t reqSize, uint8_t* pRsp,
+                                        size_t rspSize)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto status = inner->execute(target, pReq, reqSize, pRsp, rspSize);
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << trace::encodeRecord({target, status,
+                                 std::vector<uint8_t>(pReq, pReq + reqSize),
+                                 std::vector<uint8_t>(pRsp, pRsp + rspSize),
+                                 latency});
+    file.flush();
+    return status;
+}
+
+ReplayTransport::ReplayTransport(const std::vector<TraceRecord>& records,
+                                 double timeScaleArg) :
+    timeScale{timeScaleArg}
+{
+    for (const auto& record : records)
+    {
+        responses[{record.target, record.request, record.response.size()}]
+            .records.push_back(record);
+    }
+}
+
+EPECIStatus ReplayTransport::execute(uint8_t target, const uint8_t* pReq,
+                                     size_t reqSize, uint8_t* pRsp,
+                                     size_t rspSize)
+{
+    std::optional<TraceRecord> record;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = responses.find(
+            {target, std::vector<uint8_t>(pReq, pReq + reqSize), rspSize});
+        if (it != responses.end())
+        {
+            auto& entry = it->second;
+            record = entry.records[entry.next];
+            entry.next = (entry.next + 1) % entry.records.size();
+        }
+    }
+
+    if (!record)
+    {
+        LOG_DEBUG << "No recorded PECI response for target "
+                  << static_cast<int>(target);
+        return PECI_CC_TIMEOUT;
+    }
+
+    if (timeScale > 0)
+    {
+        std::this_thread::sleep_for(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                record->latency * timeScale));
+    }
+    std::copy(record->response.begin(), record->response.end(), pRsp);
+    return record->status;
+}
+
+namespace synthetic
+{
+
+constexpr uint32_t cpuId = 0x000806F0;
+constexpr uint8_t nonTurboRatio = 20;
+constexpr uint8_t turboRatio = 35;
+constexpr uint32_t coreMaskLow = 0xFFFFFFFF;
+constexpr uint32_t coreMaskHigh = 0x00FFFFFF;
+constexpr double cores = 56;
+constexpr double loadPeriodS = 60;
+constexpr double memoryCacheLinesPerS = 1.2e9;
+constexpr double iioDwordsPerS = 4e9;
+constexpr double iioClocksPerS = 1e9;
+// DDR5-4800, 36 x 133.33 MHz
+constexpr uint8_t memoryFreqRatio = 36;
+constexpr uint8_t linkSpeedGen4 = 4;
+constexpr uint8_t linkWidthX16 = 16;
+constexpr uint64_t counter48Mask = 0xFFFFFFFFFFFF;
+
+constexpr uint8_t rdPkgConfig = abi::request::RdPkgConfigHeader.command;
+constexpr uint8_t rdEndpointConfig =
+    abi::request::RdEndpointConfigHeader.command;
+constexpr uint8_t getTelemetry = abi::request::GetTelemetryPeciHeader.command;
+
+} // namespace synthetic
+
+SyntheticTransport::SyntheticTransport(unsigned cpuCountArg) :
+    cpuCount{cpuCountArg}, started{std::chrono::steady_clock::now()}
+{}
+
+EPECIStatus SyntheticTransport::execute(uint8_t target, const uint8_t* pReq,
+                                        size_t reqSize, uint8_t* pRsp,
+                                        size_t rspSize)
+{
+    if (target < cpu::minAddress || target >= cpu::minAddress + cpuCount ||
+        reqSize == 0 || rspSize == 0)
+    {
+        return PECI_CC_TIMEOUT;
+    }
+
+    const unsigned cpu = target - cpu::minAddress;
+    std::memset(pRsp, 0, rspSize);
+    pRsp[0] = 0x40;
+
+    if (pReq[0] == synthetic::rdPkgConfig)
+    {
+        readPkgConfig(cpu, pReq, pRsp, rspSize);
+    }
+    else if (pReq[0] == synthetic::rdEndpointConfig)
+    {
+        readEndpointConfig(cpu, pReq, reqSize, pRsp, rspSize);
+    }
+    else if (pReq[0] == synthetic::getTelemetry)
+    {
+        if (auto rsp = responseAs<abi::response::GetMemoryRwCounter>(pRsp,
+                                                                     rspSize))
+        {
+            const double lines =
+                busyTime(cpu) * synthetic::memoryCacheLinesPerS;
+            rsp->cacheLineReads = static_cast<uint32_t>(
+                static_cast<uint64_t>(lines * 2 / 3) & 0xFFFFFFFF);
+            rsp->cacheLineWrites = static_cast<uint32_t>(
+                static_cast<uint64_t>(lines / 3) & 0xFFFFFFFF);
+        }
+    }
+    return PECI_CC_SUCCESS;
+}
+
+/**
+ * @brief Busy time in seconds accumulated by a single unit since start, the
+ * integral of load 0.5 + 0.3 * sin(omega * t + cpu).
+ */
+double SyntheticTransport::busyTime(unsigned cpu) const
+{
+    const double t = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - started)
+                         .count();
+    const double omega = 2 * M_PI / synthetic::loadPeriodS;
+    const double phase = static_cast<double>(cpu);
+    return 0.5 * t +
+           0.3 / omega * (std::cos(phase) - std::cos(omega * t + phase));
+}
+
+void SyntheticTransport::readPkgConfig(unsigned cpu, const uint8_t* pReq,
+                                       uint8_t* pRsp, size_t rspSize) const
+{
+    const uint8_t index = pReq[2];
+    if (auto rsp = responseAs<abi::response::GetCpuId>(pRsp, rspSize);
+        rsp && index == abi::request::GetCpuId{}.payload.index)
+    {
+        rsp->cpuId = synthetic::cpuId;
+    }
+    else if (auto rsp =
+                 responseAs<abi::response::GetCpuC0Counter>(pRsp, rspSize);
+             rsp && index == abi::request::GetCpuC0Counter{}.payload.index)
+    {
+        rsp->c0Counter = static_cast<uint64_t>(
+            busyTime(cpu) * synthetic::cores *
+            static_cast<double>(abi::MHzToHz(synthetic::turboRatio *
+                                             abi::cpuFreqRatioMHz)));
+    }
+    else if (auto rsp =
+                 responseAs<abi::response::GetMaxTurboRatio>(pRsp, rspSize);
+             rsp && index == abi::request::GetMaxTurboRatio{}.payload.index)
+    {
+        std::fill(std::begin(rsp->ratio), std::end(rsp->ratio),
+                  synthetic::turboRatio);
+    }
+}
+
+void SyntheticTransport::readEndpointConfig(unsigned cpu, const uint8_t* pReq,
+                                            size_t reqSize, uint8_t* pRsp,
+                                            size_t rspSize) const
+{
+    using namespace abi::request;
+
+    // Register is at the same offset in PCI and MMIO requests
+    constexpr size_t regOffset = sizeof(PeciHeader) + sizeof(EndpointHeader);
+    if (reqSize < regOffset + 4)
+    {
+        return;
+    }
+    const uint8_t messageType = pReq[sizeof(PeciHeader)];
+    const auto counter = [this, cpu](double rate) {
+        return static_cast<uint64_t>(busyTime(cpu) * rate);
+    };
+
+    if (messageType == EndpointConfigExtHeaderMmio64.messageType)
+    {
+        uint32_t reg = 0;
+        std::memcpy(&reg, pReq + regOffset + 2, sizeof(reg));
+        if (auto rsp =
+                responseAs<abi::response::GetMemoryCounter>(pRsp, rspSize))
+        {
+            const double share = reg == GetMemoryRdCounter64{}.payload.reg
+                                     ? 2.0 / 3
+                                     : 1.0 / 3;
+            rsp->counter64bytes =
+                counter(synthetic::memoryCacheLinesPerS * share);
+        }
+        else if (auto rsp =
+                     responseAs<abi::response::GetDimmmtr>(pRsp, rspSize))
+        {
+            rsp->dimmPop = 1;
+        }
+        return;
+    }
+
+    const uint16_t reg =
+        static_cast<uint16_t>((pReq[regOffset] | pReq[regOffset + 1] << 8) &
+                              0xFFF);
+    switch (reg)
+    {
+        case 0x80:
+            std::memcpy(pRsp + 1, &synthetic::coreMaskLow, 4);
+            break;
+        case 0x84:
+            std::memcpy(pRsp + 1, &synthetic::coreMaskHigh, 4);
+            break;
+        case 0x94:
+            if (auto rsp = responseAs<abi::response::GetCapabilityRegister>(
+                    pRsp, rspSize))
+            {
+                rsp->energyEfficientTurbo = 1;
+            }
+            break;
+        case 0x98:
+            if (auto rsp =
+                    responseAs<abi::response::GetMemoryFreq>(pRsp, rspSize))
+            {
+                rsp->frequency = synthetic::memoryFreqRatio;
+            }
+            break;
+        case 0xA8:
+            if (auto rsp = responseAs<abi::response::GetMaxNonTurboRatio>(
+                    pRsp, rspSize))
+            {
+                rsp->ratio = synthetic::nonTurboRatio;
+            }
+            break;
+        case 0xD0:
+            if (auto rsp =
+                    responseAs<abi::response::GetCpuBusNumber>(pRsp, rspSize))
+            {
+                rsp->busNumber0 = static_cast<uint8_t>(0x7E + cpu * 0x80);
+            }
+            break;
+        case abi::iio::spr::reg::linkStatus:
+            if (auto rsp =
+                    responseAs<abi::response::GetLinkStatus>(pRsp, rspSize))
+            {
+                rsp->speed = synthetic::linkSpeedGen4;
+                rsp->width = synthetic::linkWidthX16;
+                rsp->active = 1;
+            }
+            break;
+        case 0x580:
+            if (auto rsp = responseAs<abi::response::GetXPPMdl>(pRsp, rspSize))
+            {
+                rsp->counterDwords = static_cast<uint32_t>(
+                    counter(synthetic::iioDwordsPerS) & 0xFFFFFFFF);
+            }
+            break;
+        case 0x590:
+            if (auto rsp = responseAs<abi::response::GetXPPMdh>(pRsp, rspSize))
+            {
+                rsp->counterDwords0 = static_cast<uint32_t>(
+                    (counter(synthetic::iioDwordsPerS) >> 32) & 0xF);
+            }
+            break;
+        case 0x594:
+            std::memcpy(pRsp + 1, &abi::iio::xppMr, 4);
+            break;
+        case 0x5AC:
+            std::memcpy(pRsp + 1, &abi::iio::xppMer, 4);
+            break;
+        case 0x5C4:
+            std::memcpy(pRsp + 1, &abi::iio::xppErConf, 4);
+            break;
+        case 0x670:
+            if (auto rsp =
+                    responseAs<abi::response::GetXPPMonFrCtr>(pRsp, rspSize))
+            {
+                const double elapsed =
+                    std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - started)
+                        .count();
+                rsp->count = static_cast<uint64_t>(
+                                 elapsed * synthetic::iioClocksPerS) &
+                             synthetic::counter48Mask;
+            }
+            break;
+        default:
+            if (auto rsp =
+                    responseAs<abi::response::GetXPPMonFrCtr>(pRsp, rspSize))
+            {
+                rsp->count = counter(synthetic::iioClocksPerS) &
+                             synthetic::counter48Mask;
+            }
+            break;
+    }
+}
+
+std::shared_ptr<Transport> makeTransport(const Options& options)
+{
+    switch (options.mode)
+    {
+        case Mode::record:
+            LOG_INFO << "Recording PECI transactions to " << options.traceFile;
+            return std::make_shared<RecordingTransport>(
+                std::make_unique<HardwareTransport>(), options.traceFile);
+
+        case Mode::replay:
+            if (auto records = trace::load(options.traceFile))
+            {
+                LOG_INFO << "Replaying " << records->size()
+                         << " PECI transactions from " << options.traceFile;
+                return std::make_shared<ReplayTransport>(*records,
+                                                         options.timeScale);
+            }
+            LOG_ERROR << "Unable to read PECI trace file "
+                      << options.traceFile;
+            return nullptr;
+
+        case Mode::synthetic:
+            LOG_INFO << "Simulating " << options.cpuCount << " CPUs";
+            return std::make_shared<SyntheticTransport>(options.cpuCount);
+
+        default:
+            return std::make_shared<HardwareTransport>();
+    }
+}
+
+} // namespace transport
+
+} // namespace peci
+
+} // namespace cups
@@ -0,0 +1,195 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#pragma once
+
+#include "peci.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace cups
+{
+
+namespace peci
+{
+
+namespace transport
+{
+
+/**
+ * @brief Sends raw PECI requests, selected at startup.
+ */
+class Transport
+{
+  public:
+    virtual ~Transport() = default;
+
+    virtual EPECIStatus execute(uint8_t target, const uint8_t* pReq,
+                                size_t reqSize, uint8_t* pRsp,
+                                size_t rspSize) = 0;
+};
+
+class HardwareTransport : public Transport
+{
+  public:
+    EPECIStatus execute(uint8_t target, const uint8_t* pReq, size_t reqSize,
+                        uint8_t* pRsp, size_t rspSize) override;
+};
+
+struct TraceRecord
+{
+    uint8_t target;
+    EPECIStatus status;
+    std::vector<uint8_t> request;
+    std::vector<uint8_t> response;
+    std::chrono::microseconds latency;
+};
+
+/**
+ * @brief Binary file with PECI transactions, shared with Node Manager. Both
+ * services encode it on their own, format changes must be made in both.
+ *
+ * File starts with "PECT" magic and format version (u16) followed by reserved
+ * u16, then records encoded as:
+ * | target (u8) | status (u8) | request size (u8) | response size (u8) |
+ * | latency in us (u32) | request | response |
+ * All integers are little endian.
+ */
+namespace trace
+{
+
+std::string encodeHeader();
+std::string encodeRecord(const TraceRecord& record);
+
+/**
+ * @brief Returns all complete records, std::nullopt when file cannot be read
+ * or has unknown header.
+ */
+std::optional<std::vector<TraceRecord>>
+    load(const std::filesystem::path& filePath);
+
+} // namespace trace
+
+/**
+ * @brief Passes requests to the inner transport and appends every
+ * transaction with its latency to the trace file.
+ */
+class RecordingTransport : public Transport
+{
+  public:
+    RecordingTransport(std::unique_ptr<Transport> innerArg,
+                       const std::filesystem::path& filePath);
+
+    EPECIStatus execute(uint8_t target, const uint8_t* pReq, size_t reqSize,
+                        uint8_t* pRsp, size_t rspSize) override;
+
+  private:
+    std::unique_ptr<Transport> inner;
+    std::mutex mutex;
+    std::ofstream file;
+};
+
+/**
+ * @brief Answers identical requests with their recorded responses in the
+ * recorded order, starting over when all have been used. Every response is
+ * delayed by its recorded latency multiplied by timeScale, 0 disables delays.
+ * Requests missing in the trace time out.
+ */
+class ReplayTransport : public Transport
+{
+  public:
+    ReplayTransport(const std::vector<TraceRecord>& records,
+                    double timeScaleArg);
+
+    EPECIStatus execute(uint8_t target, const uint8_t* pReq, size_t reqSize,
+                        uint8_t* pRsp, size_t rspSize) override;
+
+  private:
+    using Key = std::tuple<uint8_t, std::vector<uint8_t>, size_t>;
+
+    struct Responses
+    {
+        std::vector<TraceRecord> records;
+        size_t next = 0;
+    };
+
+    double timeScale;
+    std::mutex mutex;
+    std::map<Key, Responses> responses;
+};
+
+/**
+ * @brief Simulates cpuCount Sapphire Rapids CPUs with 56 cores, populated
+ * DIMMs and active PCIe links. Core, memory and IIO counters advance with a
+ * load slowly oscillating around 50%, shifted in phase for every CPU.
+ */
+class SyntheticTransport : public Transport
+{
+  public:
+    explicit SyntheticTransport(unsigned cpuCountArg);
+
+    EPECIStatus execute(uint8_t target, const uint8_t* pReq, size_t reqSize,
+                        uint8_t* pRsp, size_t rspSize) override;
+
+  private:
+    unsigned cpuCount;
+    std::chrono::steady_clock::time_point started;
+
+    double busyTime(unsigned cpu) const;
+    void readPkgConfig(unsigned cpu, const uint8_t* pReq, uint8_t* pRsp,
+                       size_t rspSize) const;
+    void readEndpointConfig(unsigned cpu, const uint8_t* pReq, size_t reqSize,
+                            uint8_t* pRsp, size_t rspSize) const;
+};
+
+enum class Mode
+{
+    hardware,
+    record,
+    replay,
+    synthetic
+};
+
+struct Options
+{
+    Mode mode = Mode::hardware;
+    std::string traceFile = "/tmp/cups-peci.trace";
+    double timeScale = 1.0;
+    unsigned cpuCount = 2;
+};
+
+/**
+ * @brief Creates transport for the given options, returns nullptr when the
+ * replay trace cannot be read.
+ */
+std::shared_ptr<Transport> makeTransport(const Options& options);
+
+} // namespace transport
+
+} // namespace peci
+
+} // namespace cups
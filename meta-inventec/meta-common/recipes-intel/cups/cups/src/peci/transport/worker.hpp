@@ -0,0 +1,107 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#pragma once
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cups
+{
+
+namespace peci
+{
+
+namespace transport
+{
+
+/**
+ * @brief Dedicated threads issuing PECI commands, so PECI latency does not
+ * delay D-Bus handling on the main io_context.
+ *
+ * With a single thread jobs are executed one after another in the order of
+ * posting, with more threads they run concurrently. Result of a job is passed
+ * to its completion handler on the main io_context. Jobs must not access
+ * objects used by the main io_context without synchronization.
+ */
+class Worker
+{
+  public:
+    explicit Worker(boost::asio::io_context& mainIocArg,
+                    unsigned threadCount = 1) :
+        mainIoc(mainIocArg),
+        work(boost::asio::make_work_guard(ioc))
+    {
+        for (unsigned i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([this]() { ioc.run(); });
+        }
+    }
+
+    ~Worker()
+    {
+        work.reset();
+        ioc.stop();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Runs job on the worker, the main io_context is kept running until
+     * the completion handler is called with the result of the job.
+     */
+    template <typename Job, typename Completion>
+    void post(Job&& job, Completion&& completion)
+    {
+        boost::asio::post(
+            ioc, [&mainIoc = mainIoc.get(),
+                  mainWork = boost::asio::make_work_guard(mainIoc.get()),
+                  job = std::forward<Job>(job),
+                  completion = std::forward<Completion>(completion)]() mutable {
+                boost::asio::post(
+                    mainIoc, [mainWork = std::move(mainWork),
+                              completion = std::move(completion),
+                              result = job()]() mutable {
+                        completion(std::move(result));
+                    });
+            });
+    }
+
+  private:
+    std::reference_wrapper<boost::asio::io_context> mainIoc;
+    boost::asio::io_context ioc;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work;
+    std::vector<std::thread> threads;
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+};
+
+} // namespace transport
+
+} // namespace peci
+
+} // namespace cups
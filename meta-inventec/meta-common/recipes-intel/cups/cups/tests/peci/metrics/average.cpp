@@ -20,6 +20,10 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <deque>
+#include <numeric>
+#include <random>
+
 using namespace ::testing;
 using namespace ::cups;
 
@@ -82,3 +86,31 @@ INSTANTIATE_TEST_CASE_P(AllZeros, AverageTest, params);
 INSTANTIATE_TEST_CASE_P(AllValuesEqual, AverageTest, params);
 INSTANTIATE_TEST_CASE_P(InsertWhenAllZeros, AverageTest, params);
 INSTANTIATE_TEST_CASE_P(InsertZerosWhenAllEqual, AverageTest, params);
+
+class AverageRandomSamplesTest : public TestWithParam<int>
+{};
+
+TEST_P(AverageRandomSamplesTest, MatchesAverageOfLastSamples)
+{
+    const auto numSamples = static_cast<unsigned>(GetParam());
+    peci::metrics::AverageCounter average(numSamples);
+    std::deque<double> reference;
+    std::mt19937 generator(numSamples);
+    std::uniform_real_distribution<double> utilization(0., 100.);
+
+    for (unsigned sample = 0; sample < 100 * numSamples; sample++)
+    {
+        const double value = utilization(generator);
+        reference.push_back(value);
+        if (reference.size() > numSamples)
+            reference.pop_front();
+
+        const double expected =
+            std::accumulate(reference.begin(), reference.end(), double(0)) /
+            static_cast<double>(reference.size());
+        ASSERT_NEAR(average.updateAverage(value), expected, 1e-9);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(RandomSamples, AverageRandomSamplesTest,
+                        Values(1, 2, 3, 10, 64, 300));
@@ -0,0 +1,180 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#include "peci/transport/transport.hpp"
+
+#include "peci/abi.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace ::cups;
+using namespace ::testing;
+
+class TransportTest : public ::testing::Test
+{
+  public:
+    using TraceRecord = peci::transport::TraceRecord;
+
+  protected:
+    void TearDown() override
+    {
+        std::filesystem::remove(tracePath);
+    }
+
+    void writeTrace(const std::vector<TraceRecord>& records,
+                    size_t truncateBy = 0)
+    {
+        std::string content = peci::transport::trace::encodeHeader();
+        for (const auto& record : records)
+        {
+            content += peci::transport::trace::encodeRecord(record);
+        }
+        content.resize(content.size() - truncateBy);
+        std::ofstream(tracePath, std::ios::binary) << content;
+    }
+
+    const std::filesystem::path tracePath =
+        std::filesystem::temp_directory_path() / "cups-ut-peci.trace";
+};
+
+class FakeTransport : public peci::transport::Transport
+{
+  public:
+    EPECIStatus execute(uint8_t, const uint8_t*, size_t, uint8_t* pRsp,
+                        size_t rspSize) override
+    {
+        std::fill(pRsp, pRsp + rspSize, ++counter);
+        return PECI_CC_SUCCESS;
+    }
+
+    uint8_t counter = 0x40;
+};
+
+TEST_F(TransportTest, RecordedTraceIsReplayedInOrder)
+{
+    {
+        peci::transport::RecordingTransport recorder(
+            std::make_unique<FakeTransport>(), tracePath);
+        const uint8_t req[] = {0xA1, 0x00, 0x00};
+        uint8_t rsp[2] = {};
+        recorder.execute(0x30, req, sizeof(req), rsp, sizeof(rsp));
+        recorder.execute(0x30, req, sizeof(req), rsp, sizeof(rsp));
+    }
+
+    const auto records = peci::transport::trace::load(tracePath);
+    ASSERT_TRUE(records);
+    ASSERT_EQ(records->size(), 2u);
+
+    peci::transport::ReplayTransport replay(*records, 0);
+    const uint8_t req[] = {0xA1, 0x00, 0x00};
+    std::vector<uint8_t> responses;
+    for (int i = 0; i < 3; i++)
+    {
+        uint8_t rsp[2] = {};
+        ASSERT_EQ(replay.execute(0x30, req, sizeof(req), rsp, sizeof(rsp)),
+                  PECI_CC_SUCCESS);
+        responses.push_back(rsp[0]);
+    }
+    EXPECT_THAT(responses, ElementsAre(0x41, 0x42, 0x41));
+}
+
+TEST_F(TransportTest, RequestMissingInTraceTimesOut)
+{
+    peci::transport::ReplayTransport replay(
+        {{0x30, PECI_CC_SUCCESS, {0xA1}, {0x40}, {}}}, 0);
+    const uint8_t req[] = {0xA1};
+    uint8_t rsp[1] = {};
+
+    EXPECT_EQ(replay.execute(0x31, req, sizeof(req), rsp, sizeof(rsp)),
+              PECI_CC_TIMEOUT);
+}
+
+TEST_F(TransportTest, TruncatedRecordIsDropped)
+{
+    writeTrace({{0x30, PECI_CC_SUCCESS, {0xA1}, {0x40}, {}},
+                {0x31, PECI_CC_SUCCESS, {0xA1}, {0x40}, {}}},
+               1);
+
+    const auto records = peci::transport::trace::load(tracePath);
+    ASSERT_TRUE(records);
+    EXPECT_EQ(records->size(), 1u);
+}
+
+TEST_F(TransportTest, TraceWithUnknownHeaderIsRejected)
+{
+    std::ofstream(tracePath, std::ios::binary) << "NOPE1234";
+
+    EXPECT_FALSE(peci::transport::trace::load(tracePath));
+}
+
+TEST_F(TransportTest, ReplayWithoutTraceFails)
+{
+    peci::transport::Options options;
+    options.mode = peci::transport::Mode::replay;
+    options.traceFile = tracePath.string();
+
+    EXPECT_EQ(peci::transport::makeTransport(options), nullptr);
+}
+
+TEST_F(TransportTest, SyntheticCpusAreDetected)
+{
+    peci::transport::SyntheticTransport synthetic(2);
+    peci::abi::request::GetCpuId req;
+    peci::abi::response::GetCpuId rsp{};
+
+    for (uint8_t target = peci::cpu::minAddress;
+         target < peci::cpu::minAddress + 2; target++)
+    {
+        ASSERT_EQ(synthetic.execute(target,
+                                    reinterpret_cast<uint8_t*>(&req),
+                                    sizeof(req),
+                                    reinterpret_cast<uint8_t*>(&rsp),
+                                    sizeof(rsp)),
+                  PECI_CC_SUCCESS);
+        EXPECT_EQ(rsp.compCode, 0x40);
+        EXPECT_EQ(peci::cpu::toModel(rsp.cpuId), peci::cpu::model::spr);
+    }
+    EXPECT_EQ(synthetic.execute(peci::cpu::minAddress + 2,
+                                reinterpret_cast<uint8_t*>(&req), sizeof(req),
+                                reinterpret_cast<uint8_t*>(&rsp), sizeof(rsp)),
+              PECI_CC_TIMEOUT);
+}
+
+TEST_F(TransportTest, SyntheticC0CounterIncreases)
+{
+    peci::transport::SyntheticTransport synthetic(1);
+    peci::abi::request::GetCpuC0Counter req;
+    peci::abi::response::GetCpuC0Counter first{};
+    peci::abi::response::GetCpuC0Counter second{};
+
+    synthetic.execute(peci::cpu::minAddress, reinterpret_cast<uint8_t*>(&req),
+                      sizeof(req), reinterpret_cast<uint8_t*>(&first),
+                      sizeof(first));
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    synthetic.execute(peci::cpu::minAddress, reinterpret_cast<uint8_t*>(&req),
+                      sizeof(req), reinterpret_cast<uint8_t*>(&second),
+                      sizeof(second));
+
+    EXPECT_GT(second.c0Counter, first.c0Counter);
+}
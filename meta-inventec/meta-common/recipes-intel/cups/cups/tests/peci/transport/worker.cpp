@@ -0,0 +1,102 @@
+/*
+ *  INTEL CONFIDENTIAL
+ *
+ *  Copyright 2022 Intel Corporation
+ *
+ *  This software and the related documents are Intel copyrighted materials,
+ *  and your use of them is governed by the express license under which they
+ *  were provided to you (License). Unless the License provides otherwise,
+ *  you may not use, modify, copy, publish, distribute, disclose or
+ *  transmit this software or the related documents without
+ *  Intel's prior written permission.
+ *
+ *  This software and the related documents are provided as is,
+ *  with no express or implied warranties, other than those
+ *  that are expressly stated in the License.
+ */
+
+#include "peci/transport/worker.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace ::cups;
+using namespace ::testing;
+
+class WorkerTest : public ::testing::Test
+{
+  protected:
+    boost::asio::io_context ioc;
+    // Keeps run_one_for() waiting for completions posted by the worker
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work = boost::asio::make_work_guard(ioc);
+    peci::transport::Worker worker{ioc};
+};
+
+TEST_F(WorkerTest, JobRunsOnWorkerAndCompletionOnMainContext)
+{
+    const auto mainThread = std::this_thread::get_id();
+    std::thread::id jobThread;
+    std::thread::id completionThread;
+    int result = 0;
+
+    worker.post(
+        [&jobThread]() {
+            jobThread = std::this_thread::get_id();
+            return 42;
+        },
+        [&](int value) {
+            completionThread = std::this_thread::get_id();
+            result = value;
+        });
+    ioc.run_one_for(std::chrono::seconds{1});
+
+    EXPECT_EQ(result, 42);
+    EXPECT_NE(jobThread, mainThread);
+    EXPECT_EQ(completionThread, mainThread);
+}
+
+TEST_F(WorkerTest, JobsAreCompletedInOrderOfPosting)
+{
+    std::vector<int> completed;
+
+    for (int i = 0; i < 3; i++)
+    {
+        worker.post([i]() { return i; },
+                    [&completed](int value) { completed.push_back(value); });
+    }
+    while (completed.size() < 3 && ioc.run_one_for(std::chrono::seconds{1}))
+    {}
+
+    EXPECT_THAT(completed, ElementsAre(0, 1, 2));
+}
+
+TEST_F(WorkerTest, JobsRunConcurrentlyOnMultipleThreads)
+{
+    peci::transport::Worker pool(ioc, 4);
+    std::vector<int> completed;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 4; i++)
+    {
+        pool.post(
+            [i]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds{200});
+                return i;
+            },
+            [&completed](int value) { completed.push_back(value); });
+    }
+    while (completed.size() < 4 && ioc.run_one_for(std::chrono::seconds{1}))
+    {}
+
+    EXPECT_THAT(completed, UnorderedElementsAre(0, 1, 2, 3));
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds{600});
+}
@@ -77,8 +77,9 @@ class Budgeting : public BudgetingIf
 
     void run() override final
     {
-        auto perf =
-            Perf("Budgeting-run-duration", std::chrono::milliseconds{20});
+        static const MeasureHandle perfHandle(
+            "Budgeting-run-duration", std::chrono::milliseconds{20});
+        auto perf = Perf(perfHandle);
 
         propagatePtamLimits();
         runCompoundBudgeting();
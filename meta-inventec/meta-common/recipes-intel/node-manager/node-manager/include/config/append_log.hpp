@@ -0,0 +1,315 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "config/persistent_storage.hpp"
+#include "loggers/log.hpp"
+
+#include <boost/crc.hpp>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nodemanager
+{
+
+struct AppendLogRecord
+{
+    std::string key;
+    /**
+     * @brief Value stored for the key, std::nullopt removes the key.
+     */
+    std::optional<std::string> value;
+};
+
+/**
+ * @brief Key-value store kept in a single file as a sequence of records, each
+ * protected with CRC-32.
+ *
+ * File starts with a header holding magic and format version, followed by
+ * records encoded as:
+ * | payload size (u32) | crc32 of payload (u32) | payload |
+ * where payload is:
+ * | operation (u8) | key size (u16) | key | value |
+ * All integers are little endian. Changes are appended and synced to the
+ * disk, compact() atomically replaces the file with one record per key.
+ */
+class AppendLog
+{
+    static constexpr std::string_view kMagic = "NMAL";
+    static constexpr size_t kHeaderSize = kMagic.size() + 4;
+    static constexpr size_t kRecordHeaderSize = 8;
+    static constexpr size_t kPayloadHeaderSize = 3;
+
+    enum class Operation : uint8_t
+    {
+        put = 1,
+        remove = 2
+    };
+
+  public:
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
+    AppendLog(AppendLog&&) = delete;
+    AppendLog& operator=(AppendLog&&) = delete;
+
+    AppendLog(std::filesystem::path filePathArg, uint16_t versionArg) :
+        filePath(filePathArg), version(versionArg)
+    {
+    }
+
+    virtual ~AppendLog() = default;
+
+    bool exists()
+    {
+        return storage.exists(filePath);
+    }
+
+    /**
+     * @brief Reads the whole file and returns the latest value of every key.
+     * Everything from the first truncated or corrupted record, e.g. left by a
+     * power loss during append, is discarded and cut off the file, so new
+     * records follow the last valid one. A file with unknown header is moved
+     * aside.
+     */
+    std::map<std::string, std::string> load()
+    {
+        std::map<std::string, std::string> entries;
+        recordsCount = 0;
+        const auto content = storage.readFile(filePath);
+        if (!content || content->empty())
+        {
+            return entries;
+        }
+        if (!isHeaderValid(*content))
+        {
+            Logger::log<LogLevel::error>(
+                "File %s has unsupported format, moving it aside",
+                filePath.c_str());
+            std::error_code ec;
+            std::filesystem::rename(filePath, filePath.string() + ".invalid",
+                                    ec);
+            return entries;
+        }
+
+        size_t offset = kHeaderSize;
+        while (offset < content->size())
+        {
+            const auto recordSize = parseRecord(*content, offset, entries);
+            if (!recordSize)
+            {
+                Logger::log<LogLevel::warning>(
+                    "File %s has corrupted record at offset %d, dropping %d "
+                    "bytes",
+                    filePath.c_str(), static_cast<int>(offset),
+                    static_cast<int>(content->size() - offset));
+                storage.truncate(filePath, offset);
+                break;
+            }
+            offset += *recordSize;
+            recordsCount++;
+        }
+        return entries;
+    }
+
+    /**
+     * @brief Appends all records with a single write followed by sync. When
+     * the append fails the file is cut back to its previous size, so no torn
+     * record is left before the records appended later. When that fails too,
+     * isCompactionRequired() reports that the file has to be rewritten.
+     */
+    bool append(const std::vector<AppendLogRecord>& records)
+    {
+        std::string data;
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(filePath, ec);
+        if (ec || fileSize == 0)
+        {
+            data = encodeHeader();
+        }
+        for (const auto& record : records)
+        {
+            data += encodeRecord(record);
+        }
+        if (!storage.append(filePath, data))
+        {
+            if (!storage.truncate(filePath, ec ? 0 : fileSize))
+            {
+                compactionRequired = true;
+            }
+            return false;
+        }
+        recordsCount += records.size();
+        return true;
+    }
+
+    /**
+     * @brief Atomically replaces the file with a single put record per entry.
+     */
+    bool compact(const std::map<std::string, std::string>& entries)
+    {
+        std::string data = encodeHeader();
+        for (const auto& [key, value] : entries)
+        {
+            data += encodeRecord({key, value});
+        }
+        if (!storage.storeAtomically(filePath, data))
+        {
+            return false;
+        }
+        recordsCount = entries.size();
+        compactionRequired = false;
+        return true;
+    }
+
+    /**
+     * @brief Tells whether the file may end with a torn record, which would
+     * hide the records appended after it, and must be replaced by compact().
+     */
+    bool isCompactionRequired() const
+    {
+        return compactionRequired;
+    }
+
+    /**
+     * @brief Number of records in the file, including the ones superseded by
+     * later records.
+     */
+    size_t getRecordsCount() const
+    {
+        return recordsCount;
+    }
+
+  private:
+    PersistentStorage storage;
+    std::filesystem::path filePath;
+    uint16_t version;
+    size_t recordsCount = 0;
+    bool compactionRequired = false;
+
+    static void putInt(std::string& out, uint32_t value, size_t bytes)
+    {
+        for (size_t idx = 0; idx < bytes; ++idx)
+        {
+            out.push_back(static_cast<char>((value >> (8 * idx)) & 0xff));
+        }
+    }
+
+    static uint32_t getInt(std::string_view in, size_t offset, size_t bytes)
+    {
+        uint32_t value = 0;
+        for (size_t idx = 0; idx < bytes; ++idx)
+        {
+            value |= static_cast<uint32_t>(
+                         static_cast<uint8_t>(in[offset + idx]))
+                     << (8 * idx);
+        }
+        return value;
+    }
+
+    static uint32_t crc32(std::string_view data)
+    {
+        boost::crc_32_type crc;
+        crc.process_bytes(data.data(), data.size());
+        return crc.checksum();
+    }
+
+    std::string encodeHeader() const
+    {
+        std::string header(kMagic);
+        putInt(header, version, 2);
+        putInt(header, 0, 2);
+        return header;
+    }
+
+    bool isHeaderValid(std::string_view content) const
+    {
+        return content.size() >= kHeaderSize &&
+               content.substr(0, kMagic.size()) == kMagic &&
+               getInt(content, kMagic.size(), 2) == version;
+    }
+
+    static std::string encodeRecord(const AppendLogRecord& record)
+    {
+        std::string payload;
+        payload.push_back(static_cast<char>(
+            record.value ? Operation::put : Operation::remove));
+        putInt(payload, static_cast<uint32_t>(record.key.size()), 2);
+        payload += record.key;
+        if (record.value)
+        {
+            payload += *record.value;
+        }
+
+        std::string encoded;
+        putInt(encoded, static_cast<uint32_t>(payload.size()), 4);
+        putInt(encoded, crc32(payload), 4);
+        return encoded + payload;
+    }
+
+    /**
+     * @brief Applies record starting at offset to entries and returns its
+     * size, or std::nullopt when the record is not complete or valid.
+     */
+    static std::optional<size_t>
+        parseRecord(std::string_view content, size_t offset,
+                    std::map<std::string, std::string>& entries)
+    {
+        if (content.size() - offset < kRecordHeaderSize)
+        {
+            return std::nullopt;
+        }
+        const size_t payloadSize = getInt(content, offset, 4);
+        const uint32_t crc = getInt(content, offset + 4, 4);
+        if (payloadSize < kPayloadHeaderSize ||
+            content.size() - offset - kRecordHeaderSize < payloadSize)
+        {
+            return std::nullopt;
+        }
+        const auto payload =
+            content.substr(offset + kRecordHeaderSize, payloadSize);
+        if (crc32(payload) != crc)
+        {
+            return std::nullopt;
+        }
+        const size_t keySize = getInt(payload, 1, 2);
+        if (payloadSize < kPayloadHeaderSize + keySize)
+        {
+            return std::nullopt;
+        }
+        std::string key(payload.substr(kPayloadHeaderSize, keySize));
+        switch (static_cast<Operation>(payload[0]))
+        {
+            case Operation::put:
+                entries[std::move(key)] =
+                    std::string(payload.substr(kPayloadHeaderSize + keySize));
+                break;
+            case Operation::remove:
+                entries.erase(key);
+                break;
+            default:
+                return std::nullopt;
+        }
+        return kRecordHeaderSize + payloadSize;
+    }
+};
+
+} // namespace nodemanager
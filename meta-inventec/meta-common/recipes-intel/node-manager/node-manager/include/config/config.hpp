@@ -50,7 +50,9 @@ void to_json(nlohmann::json& j, const GeneralPresets& data)
         {"ProchotAssertionRatio", data.prochotAssertionRatio},
         {"NmInitializationMode", data.nmInitializationMode},
         {"AcceleratorsInterface", data.acceleratorsInterface},
-        {"CpuTurboRatioLimit", data.cpuTurboRatioLimit}};
+        {"CpuTurboRatioLimit", data.cpuTurboRatioLimit},
+        {"PowerKnobHysteresisMw", data.powerKnobHysteresisMw},
+        {"KnobRefreshIntervalMs", data.knobRefreshIntervalMs}};
 }
 
 void to_json(nlohmann::json& j, const Gpio& data)
@@ -262,6 +264,12 @@ class Config
             std::make_tuple(kGeneralPresets, "CpuTurboRatioLimit",
                             std::ref(generalPresets.cpuTurboRatioLimit),
                             validate),
+            std::make_tuple(kGeneralPresets, "PowerKnobHysteresisMw",
+                            std::ref(generalPresets.powerKnobHysteresisMw),
+                            getRangeValidator<uint32_t>(0, 10000)),
+            std::make_tuple(kGeneralPresets, "KnobRefreshIntervalMs",
+                            std::ref(generalPresets.knobRefreshIntervalMs),
+                            getRangeValidator<uint32_t>(0, 3600000)),
             std::make_tuple(kGpio, "HwProtectionPolicyTriggerGpio",
                             std::ref(gpio.hwProtectionPolicyTriggerGpio),
                             validate),
@@ -18,10 +18,17 @@
 #pragma once
 #include "loggers/log.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <optional>
+#include <sstream>
+#include <string_view>
+#include <system_error>
 #include <utility/for_each.hpp>
 
 namespace nodemanager
@@ -46,40 +53,110 @@ class PersistentStorage
     {
         Logger::log<LogLevel::info>("Storing json data to file: %s",
                                     filePath.c_str());
+        std::ostringstream content;
+        content << std::setw(4) << data;
+        return storeAtomically(filePath, content.str());
+    }
+
+    /**
+     * @brief Replaces content of the file so that after a power loss it holds
+     * either the previous or the new data. Data is written to a temporary
+     * file, synced to the disk and renamed over the target file.
+     *
+     * @param filePath
+     * @param data
+     * @return true on success, the previous content is kept otherwise.
+     */
+    bool storeAtomically(const std::filesystem::path& filePath,
+                         std::string_view data)
+    {
+        const std::filesystem::path tmpPath = filePath.string() + ".tmp";
         try
+        {
+            createParentDirectory(filePath);
+            writeAndSync(tmpPath, data, O_WRONLY | O_CREAT | O_TRUNC);
+            limitPermissions(tmpPath);
+            std::filesystem::rename(tmpPath, filePath);
+            syncDirectory(filePath.parent_path());
+            return true;
+        }
+        catch (const std::exception& e)
         {
             std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            Logger::log<LogLevel::error>(
+                "Storing data to file: %s failed, error: %s", filePath.c_str(),
+                e.what());
+            return false;
+        }
+    }
 
-            std::filesystem::create_directories(filePath.parent_path(), ec);
-            if (ec)
-            {
-                throw std::runtime_error(
-                    "Unable to create directory for file: " +
-                    filePath.string() + ", ec=" + std::to_string(ec.value()) +
-                    ": " + ec.message());
-            }
-            std::ofstream file(filePath);
-            file << std::setw(4) << data;
-            if (!file)
-            {
-                throw std::runtime_error("Unable to create file: " +
-                                         filePath.string());
-            }
-            file.flush();
-            limitPermissions(filePath.parent_path());
+    /**
+     * @brief Appends data to the file, which is created when missing, and
+     * waits until it is synced to the disk.
+     *
+     * @param filePath
+     * @param data
+     * @return true on success
+     */
+    bool append(const std::filesystem::path& filePath, std::string_view data)
+    {
+        try
+        {
+            createParentDirectory(filePath);
+            writeAndSync(filePath, data, O_WRONLY | O_CREAT | O_APPEND);
             limitPermissions(filePath);
             return true;
         }
         catch (const std::exception& e)
         {
-            remove(filePath);
             Logger::log<LogLevel::error>(
-                "Storing data to file: %s failed, error: %s", filePath.c_str(),
-                e.what());
+                "Appending data to file: %s failed, error: %s",
+                filePath.c_str(), e.what());
             return false;
         }
     }
 
+    /**
+     * @brief Cuts the file to the given size and waits until it is synced to
+     * the disk.
+     *
+     * @param filePath
+     * @param size
+     * @return true on success
+     */
+    bool truncate(const std::filesystem::path& filePath, uintmax_t size)
+    {
+        const int fd = ::open(filePath.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            Logger::log<LogLevel::error>("Unable to open file: %s, error: %s",
+                                         filePath.c_str(), strerror(errno));
+            return false;
+        }
+        const bool ret = ::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+                         ::fsync(fd) == 0;
+        if (!ret)
+        {
+            Logger::log<LogLevel::error>(
+                "Truncating file: %s failed, error: %s", filePath.c_str(),
+                strerror(errno));
+        }
+        ::close(fd);
+        return ret;
+    }
+
+    std::optional<std::string> readFile(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file)
+        {
+            return std::nullopt;
+        }
+        return std::string(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+    }
+
     std::vector<std::string> readLines(const std::filesystem::path& filePath)
     {
         std::vector<std::string> lines;
@@ -117,6 +194,22 @@ class PersistentStorage
                                          filePath);
             return false;
         }
+        return readJson(j, std::forward<JsonMapper>(paramsToRead),
+                        filePath.string());
+    }
+
+    /**
+     * @brief From json object tries to read values described by paramsToRead.
+     *
+     * @tparam JsonMapper
+     * @param j
+     * @param paramsToRead
+     * @param sourceName used only in logs
+     */
+    template <class JsonMapper>
+    bool readJson(const nlohmann::json& j, JsonMapper&& paramsToRead,
+                  const std::string& sourceName)
+    {
         uint32_t error_counter = 0;
         for_each(
             std::forward<JsonMapper>(paramsToRead),
@@ -173,14 +266,13 @@ class PersistentStorage
             });
         if (error_counter == 0)
         {
-            Logger::log<LogLevel::info>("Json file %1% loaded with success",
-                                        filePath);
+            Logger::log<LogLevel::info>("Json %1% loaded with success",
+                                        sourceName);
         }
         else
         {
-            Logger::log<LogLevel::info>(
-                "Json file %1% loaded with %2% error(s)", filePath,
-                error_counter);
+            Logger::log<LogLevel::info>("Json %1% loaded with %2% error(s)",
+                                        sourceName, error_counter);
         }
         return (error_counter == 0);
     }
@@ -219,6 +311,73 @@ class PersistentStorage
     }
 
   private:
+    void createParentDirectory(const std::filesystem::path& filePath)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+        if (ec)
+        {
+            throw std::runtime_error(
+                "Unable to create directory for file: " + filePath.string() +
+                ", ec=" + std::to_string(ec.value()) + ": " + ec.message());
+        }
+        limitPermissions(filePath.parent_path());
+    }
+
+    void writeAndSync(const std::filesystem::path& filePath,
+                      std::string_view data, int flags)
+    {
+        const int fd = ::open(filePath.c_str(), flags | O_CLOEXEC,
+                              S_IRUSR | S_IWUSR);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Unable to open file: " +
+                                        filePath.string());
+        }
+        size_t written = 0;
+        while (written < data.size())
+        {
+            const auto ret =
+                ::write(fd, data.data() + written, data.size() - written);
+            if (ret < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ret < 0)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(),
+                                        "Unable to write file: " +
+                                            filePath.string());
+            }
+            written += static_cast<size_t>(ret);
+        }
+        if (::fsync(fd) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "Unable to sync file: " +
+                                        filePath.string());
+        }
+        ::close(fd);
+    }
+
+    /**
+     * @brief Makes a rename within the directory durable.
+     */
+    void syncDirectory(const std::filesystem::path& dirPath)
+    {
+        const int fd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd >= 0)
+        {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+
     void limitPermissions(const std::filesystem::path& path)
     {
         constexpr auto filePerms = std::filesystem::perms::owner_read |
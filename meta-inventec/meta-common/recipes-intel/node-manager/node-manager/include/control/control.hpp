@@ -68,7 +68,9 @@ class Control : public ControlIf, public RunnerIf
 
     void run() override final
     {
-        auto perf = Perf("Control-run-duration", std::chrono::milliseconds{20});
+        static const MeasureHandle perfHandle(
+            "Control-run-duration", std::chrono::milliseconds{20});
+        auto perf = Perf(perfHandle);
         for (auto const& [domain, balancer] : domainBalancers)
         {
             balancer->run();
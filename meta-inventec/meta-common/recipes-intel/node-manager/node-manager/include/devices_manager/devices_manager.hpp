@@ -64,6 +64,7 @@
 #include "utility/performance_monitor.hpp"
 #include "utility/status_provider_if.hpp"
 #include "utility/types.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <iostream>
 #include <sdbusplus/asio/object_server.hpp>
@@ -110,7 +111,9 @@ class DevicesManager : public RunnerIf,
             std::make_shared<
                 AsyncExecutor<std::pair<KnobType, DeviceIndex>,
                               std::pair<std::ios_base::iostate, uint32_t>>>(
-                busArg))
+                busArg,
+                AsyncTaskTimeout<std::pair<std::ios_base::iostate, uint32_t>>{
+                    kKnobWriteTimeout, {std::ios_base::failbit, 0}}))
     {
         installSensors();
         installReadings();
@@ -144,13 +147,19 @@ class DevicesManager : public RunnerIf,
     void reportStatus(nlohmann::json& out) const final
     {
         std::set<NmHealth> allHealth;
+        KnobWriteCounters totalWriteCounters;
         for (auto&& knob : knobs)
         {
             knob->reportStatus(out["Knobs"]);
             allHealth.insert(knob->getHealth());
+            const auto writeCounters = knob->getWriteCounters();
+            totalWriteCounters.issued += writeCounters.issued;
+            totalWriteCounters.suppressed += writeCounters.suppressed;
         }
         out["Knobs"]["Health"] =
             enumToStr(healthNames, getMostRestrictiveHealth(allHealth));
+        out["Knobs"]["IssuedWrites"] = totalWriteCounters.issued;
+        out["Knobs"]["SuppressedWrites"] = totalWriteCounters.suppressed;
         allHealth.clear();
         for (const auto& sensor : sensorsVec)
         {
@@ -163,15 +172,43 @@ class DevicesManager : public RunnerIf,
 
     void run() override final
     {
-        auto perf1 = Perf("DeviceManager-sensors-run-duration",
-                          std::chrono::milliseconds{20});
+        runSensors();
+        runReadingsAndKnobs();
+    }
+
+    /**
+     * @brief Collects results of sensor sampling and starts the next one.
+     * Sensor readings are only updated here and a snapshot of them is
+     * published at the end, which is what readings consume until the next
+     * call.
+     */
+    void runSensors()
+    {
+        static const MeasureHandle perf1Handle(
+            "DeviceManager-sensors-run-duration",
+            std::chrono::milliseconds{20});
+        auto perf1 = Perf(perf1Handle);
         for (const auto& sensors : sensorsVec)
         {
             sensors->run();
         }
+        sensorReadingsManager->dispatchEvents();
+        sensorReadingsManager->publishSnapshot();
         perf1.stopMeasure();
-        auto perf2 = Perf("DeviceManager-readings-run-duration",
-                          std::chrono::milliseconds{20});
+        WorkerPool::getInstance().publishStatistics();
+        PeciScheduler::getInstance().publishStatistics();
+    }
+
+    /**
+     * @brief Propagates current sensor readings to reading consumers and
+     * writes values requested from knobs.
+     */
+    void runReadingsAndKnobs()
+    {
+        static const MeasureHandle perf2Handle(
+            "DeviceManager-readings-run-duration",
+            std::chrono::milliseconds{20});
+        auto perf2 = Perf(perf2Handle);
         for (const auto& reading : readings)
         {
             reading->run();
@@ -213,17 +250,15 @@ class DevicesManager : public RunnerIf,
     void setKnobValue(KnobType knobType, DeviceIndex deviceIndex,
                       const double valueToBeSet) override
     {
-        executeKnobAction(knobType, deviceIndex,
-                          [valueToBeSet](std::unique_ptr<KnobIf>& knob) {
-                              knob->setKnob(valueToBeSet);
-                          });
+        executeKnobAction(
+            knobType, deviceIndex,
+            [valueToBeSet](KnobIf& knob) { knob.setKnob(valueToBeSet); });
     }
 
     void resetKnobValue(KnobType knobType, DeviceIndex deviceIndex) override
     {
-        executeKnobAction(
-            knobType, deviceIndex,
-            [](std::unique_ptr<KnobIf>& knob) { knob->resetKnob(); });
+        executeKnobAction(knobType, deviceIndex,
+                          [](KnobIf& knob) { knob.resetKnob(); });
     }
 
     virtual std::shared_ptr<ReadingIf>
@@ -245,15 +280,10 @@ class DevicesManager : public RunnerIf,
     virtual bool isKnobSet(KnobType knobType,
                            DeviceIndex deviceIndex) const override
     {
-        const auto& knobIt = std::find_if(
-            knobs.cbegin(), knobs.cend(),
-            [knobType, deviceIndex](const std::unique_ptr<KnobIf>& knob) {
-                return (knob->getKnobType() == knobType) &&
-                       (knob->getDeviceIndex() == deviceIndex);
-            });
-        if (knobIt != knobs.cend())
+        const auto knobIt = knobsIndex.find({knobType, deviceIndex});
+        if (knobIt != knobsIndex.cend())
         {
-            return (*knobIt)->isKnobSet();
+            return knobIt->second->isKnobSet();
         }
         return false;
     }
@@ -267,6 +297,7 @@ class DevicesManager : public RunnerIf,
     std::vector<std::shared_ptr<Reading>> readings;
     std::vector<std::shared_ptr<Sensor>> sensorsVec;
     std::vector<std::unique_ptr<KnobIf>> knobs;
+    std::map<std::pair<KnobType, DeviceIndex>, KnobIf*> knobsIndex;
     std::shared_ptr<PeciCommands> peciCommands =
         std::make_shared<PeciCommands>();
     std::shared_ptr<AsyncKnobExecutor> knobExecutor;
@@ -446,44 +477,51 @@ class DevicesManager : public RunnerIf,
         constexpr uint32_t pcieHwmonKnobMinInMilliWatts = 1000;
         constexpr uint32_t hwmonKnobMaxInMilliWatts =
             std::numeric_limits<uint32_t>::max();
+        const auto& presets = Config::getInstance().getGeneralPresets();
+        const KnobWritePolicy knobWritePolicy{
+            0, std::chrono::milliseconds{presets.knobRefreshIntervalMs}};
+        const KnobWritePolicy powerKnobWritePolicy{
+            presets.powerKnobHysteresisMw, knobWritePolicy.refreshInterval};
 
         for (DeviceIndex idx = 0; idx < kMaxCpuNumber; ++idx)
         {
             knobs.push_back(std::move(std::make_unique<HwmonKnob>(
                 KnobType::CpuPackagePower, idx, cpuHwmonKnobMinInMilliWatts,
                 hwmonKnobMaxInMilliWatts, hwmonFileProvider, knobExecutor,
-                sensorReadingsManager)));
+                sensorReadingsManager, powerKnobWritePolicy)));
             knobs.push_back(std::move(std::make_unique<HwmonKnob>(
                 KnobType::DramPower, idx, cpuHwmonKnobMinInMilliWatts,
                 hwmonKnobMaxInMilliWatts, hwmonFileProvider, knobExecutor,
-                sensorReadingsManager)));
+                sensorReadingsManager, powerKnobWritePolicy)));
 
             knobs.push_back(std::move(std::make_unique<TurboRatioKnob>(
                 KnobType::TurboRatioLimit, idx, peciCommands, knobExecutor,
-                sensorReadingsManager)));
+                sensorReadingsManager, knobWritePolicy)));
 
             knobs.push_back(std::move(std::make_unique<HwpmKnob>(
                 KnobType::HwpmPerfPreference, idx, kHwpmKnobsDefault,
-                peciCommands, knobExecutor, sensorReadingsManager)));
+                peciCommands, knobExecutor, sensorReadingsManager,
+                knobWritePolicy)));
 
             knobs.push_back(std::move(std::make_unique<HwpmKnob>(
                 KnobType::HwpmPerfBias, idx, kHwpmKnobsDefault, peciCommands,
-                knobExecutor, sensorReadingsManager)));
+                knobExecutor, sensorReadingsManager, knobWritePolicy)));
 
             knobs.push_back(std::move(std::make_unique<HwpmKnob>(
                 KnobType::HwpmPerfPreferenceOverride, idx, kHwpmKnobsDefault,
-                peciCommands, knobExecutor, sensorReadingsManager)));
+                peciCommands, knobExecutor, sensorReadingsManager,
+                knobWritePolicy)));
 
             knobs.push_back(std::move(std::make_unique<ProchotRatioKnob>(
                 KnobType::Prochot, idx, peciCommands, knobExecutor,
-                sensorReadingsManager)));
+                sensorReadingsManager, knobWritePolicy)));
         }
         for (DeviceIndex idx = 0; idx < kMaxPlatformNumber; ++idx)
         {
             knobs.push_back(std::move(std::make_unique<HwmonKnob>(
                 KnobType::DcPlatformPower, idx, cpuHwmonKnobMinInMilliWatts,
                 hwmonKnobMaxInMilliWatts, hwmonFileProvider, knobExecutor,
-                sensorReadingsManager)));
+                sensorReadingsManager, powerKnobWritePolicy)));
         }
 
         if (Config::getInstance().getGeneralPresets().acceleratorsInterface ==
@@ -493,7 +531,8 @@ class DevicesManager : public RunnerIf,
             {
                 knobs.push_back(std::move(std::make_unique<PcieDbusKnob>(
                     KnobType::PciePower, idx, pldmEntityProvider, bus,
-                    sensorReadingsManager)));
+                    sensorReadingsManager, kPcieKnobBusName,
+                    knobWritePolicy)));
             }
         }
         else
@@ -503,31 +542,38 @@ class DevicesManager : public RunnerIf,
                 knobs.push_back(std::move(std::make_unique<HwmonKnob>(
                     KnobType::PciePower, idx, pcieHwmonKnobMinInMilliWatts,
                     hwmonKnobMaxInMilliWatts, hwmonFileProvider, knobExecutor,
-                    sensorReadingsManager)));
+                    sensorReadingsManager, powerKnobWritePolicy)));
             }
         }
 
         for (auto&& knob : knobs)
         {
+            knobsIndex.emplace(
+                std::make_pair(knob->getKnobType(), knob->getDeviceIndex()),
+                knob.get());
             knob->resetKnob();
         }
     }
 
-    void executeKnobAction(
-        KnobType knobType, DeviceIndex deviceIndex,
-        std::function<void(std::unique_ptr<KnobIf>&)> knobAction)
+    void executeKnobAction(KnobType knobType, DeviceIndex deviceIndex,
+                           std::function<void(KnobIf&)> knobAction)
     {
         bool isDeviceFound = false;
-        for (auto&& knob : knobs)
+        if (deviceIndex == kAllDevices)
         {
-            if (((knob->getDeviceIndex() == deviceIndex) ||
-                 kAllDevices == deviceIndex) &&
-                (knob->getKnobType() == knobType))
+            for (auto it = knobsIndex.lower_bound({knobType, DeviceIndex{0}});
+                 it != knobsIndex.end() && it->first.first == knobType; ++it)
             {
-                knobAction(knob);
+                knobAction(*it->second);
                 isDeviceFound = true;
             }
         }
+        else if (const auto it = knobsIndex.find({knobType, deviceIndex});
+                 it != knobsIndex.end())
+        {
+            knobAction(*it->second);
+            isDeviceFound = true;
+        }
         if (!isDeviceFound)
         {
             Logger::log<LogLevel::error>(
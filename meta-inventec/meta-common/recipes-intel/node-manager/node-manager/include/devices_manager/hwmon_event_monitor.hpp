@@ -0,0 +1,509 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "loggers/log.hpp"
+
+#include <linux/netlink.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/asio.hpp>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace nodemanager
+{
+
+static constexpr size_t kHwmonEventBufferSize = 8192;
+static constexpr uint32_t kInotifyHwmonMask =
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+
+enum class HwmonEventSource
+{
+    none,
+    uevent,
+    inotify
+};
+
+/**
+ * @brief Callback invoked with the watched root directory that is affected by
+ * a hotplug event.
+ */
+using HwmonEventCallback = std::function<void(const std::filesystem::path&)>;
+
+/**
+ * @brief Notifies about devices being added to or removed from the watched
+ * sysfs bus directories (e.g. /sys/bus/peci/devices).
+ *
+ * Kernel kobject uevents received over a NETLINK_KOBJECT_UEVENT socket are the
+ * primary source. Messages not sent by the kernel are ignored. Each event is
+ * mapped to the watched root of the bus whose adapter ("<bus>-<number>") is
+ * one of the components of its DEVPATH. When the netlink socket cannot be used, or when the
+ * roots are not located in sysfs, directories under the roots are watched
+ * recursively with inotify instead.
+ */
+class HwmonEventMonitor
+{
+  public:
+    HwmonEventMonitor() = delete;
+    HwmonEventMonitor(const HwmonEventMonitor&) = delete;
+    HwmonEventMonitor& operator=(const HwmonEventMonitor&) = delete;
+    HwmonEventMonitor(HwmonEventMonitor&&) = delete;
+    HwmonEventMonitor& operator=(HwmonEventMonitor&&) = delete;
+
+    HwmonEventMonitor(boost::asio::io_context& ioc,
+                      const std::vector<std::filesystem::path>& rootsArg,
+                      const HwmonEventCallback& callbackArg,
+                      bool useUeventsArg = true) :
+        roots(rootsArg),
+        callback(callbackArg), descriptor(ioc)
+    {
+        if ((useUeventsArg && openUeventSocket()) || openInotify())
+        {
+            readEvents();
+        }
+        else
+        {
+            Logger::log<LogLevel::warning>(
+                "[HwmonEventMonitor]: No hotplug event source available");
+        }
+    }
+
+    ~HwmonEventMonitor() = default;
+
+    HwmonEventSource getSource() const
+    {
+        return source;
+    }
+
+    /**
+     * @brief Checks if one of the components of `devPath` is an adapter of
+     * the bus, i.e. "<bus>-<number>" (e.g. "i2c-7", "peci-0").
+     */
+    static bool isBusAdapterInPath(std::string_view devPath,
+                                   std::string_view bus)
+    {
+        if (bus.empty())
+        {
+            return false;
+        }
+        while (!devPath.empty())
+        {
+            const auto component = devPath.substr(0, devPath.find('/'));
+            devPath.remove_prefix(
+                std::min(component.size() + 1, devPath.size()));
+            if (component.size() > bus.size() + 1 &&
+                component.starts_with(bus) && component[bus.size()] == '-' &&
+                std::all_of(component.begin() + bus.size() + 1,
+                            component.end(),
+                            [](char c) {
+                                return std::isdigit(
+                                    static_cast<unsigned char>(c));
+                            }))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::vector<std::filesystem::path> roots;
+    HwmonEventCallback callback;
+    boost::asio::posix::stream_descriptor descriptor;
+    HwmonEventSource source = HwmonEventSource::none;
+    std::map<int, std::filesystem::path> inotifyWatches;
+    std::array<char, kHwmonEventBufferSize> readBuffer;
+
+    bool openUeventSocket()
+    {
+        int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                          NETLINK_KOBJECT_UEVENT);
+        if (fd < 0)
+        {
+            Logger::log<LogLevel::info>(
+                "[HwmonEventMonitor]: Cannot open uevent socket, errno: %d",
+                errno);
+            return false;
+        }
+
+        sockaddr_nl address{};
+        address.nl_family = AF_NETLINK;
+        address.nl_groups = 1; // kernel events multicast group
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address),
+                   sizeof(address)) < 0)
+        {
+            Logger::log<LogLevel::info>(
+                "[HwmonEventMonitor]: Cannot bind uevent socket, errno: %d",
+                errno);
+            ::close(fd);
+            return false;
+        }
+
+        descriptor.assign(fd);
+        source = HwmonEventSource::uevent;
+        Logger::log<LogLevel::info>(
+            "[HwmonEventMonitor]: Using kernel uevents for hwmon discovery");
+        return true;
+    }
+
+    bool openInotify()
+    {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+        {
+            Logger::log<LogLevel::error>(
+                "[HwmonEventMonitor]: inotify_init1 failed, errno: %d", errno);
+            return false;
+        }
+        descriptor.assign(fd);
+        source = HwmonEventSource::inotify;
+        for (const auto& root : roots)
+        {
+            addInotifyWatches(root);
+        }
+        Logger::log<LogLevel::info>(
+            "[HwmonEventMonitor]: Using inotify for hwmon discovery");
+        return true;
+    }
+
+    /**
+     * @brief Watches `dir` and, if it belongs to one of the roots, all of its
+     * subdirectories. Symlinks are not followed. For a root that does not
+     * exist yet its nearest existing ancestor is watched, so creation of the
+     * root is reported as well.
+     */
+    void addInotifyWatches(const std::filesystem::path& dir)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec))
+        {
+            if (dir.has_parent_path() && dir != dir.root_path() &&
+                isAncestorOfRoot(dir.parent_path()))
+            {
+                addInotifyWatches(dir.parent_path());
+            }
+            return;
+        }
+
+        if (!addInotifyWatch(dir))
+        {
+            return;
+        }
+
+        if (getAffectedRoot(dir))
+        {
+            for (auto it = std::filesystem::recursive_directory_iterator(
+                     dir, std::filesystem::directory_options::none, ec);
+                 !ec && it != std::filesystem::recursive_directory_iterator();
+                 it.increment(ec))
+            {
+                if (it->is_directory(ec) && !it->is_symlink(ec))
+                {
+                    addInotifyWatch(it->path());
+                }
+            }
+            return;
+        }
+
+        for (const auto& root : roots)
+        {
+            const auto next = nextPathComponent(dir, root);
+            if (next && std::filesystem::exists(*next, ec))
+            {
+                addInotifyWatches(*next);
+            }
+        }
+    }
+
+    bool addInotifyWatch(const std::filesystem::path& dir)
+    {
+        int wd = inotify_add_watch(descriptor.native_handle(), dir.c_str(),
+                                   kInotifyHwmonMask);
+        if (wd < 0)
+        {
+            Logger::log<LogLevel::debug>(
+                "[HwmonEventMonitor]: inotify_add_watch failed for %s",
+                dir.string());
+            return false;
+        }
+        inotifyWatches[wd] = dir;
+        return true;
+    }
+
+    void readEvents()
+    {
+        descriptor.async_wait(
+            boost::asio::posix::stream_descriptor::wait_read,
+            [this](const boost::system::error_code& ec) {
+                if (ec == boost::asio::error::operation_aborted)
+                {
+                    return;
+                }
+                if (ec)
+                {
+                    Logger::log<LogLevel::error>(
+                        "[HwmonEventMonitor]: Reading events failed: %s",
+                        ec.message());
+                    return;
+                }
+                if (source == HwmonEventSource::uevent)
+                {
+                    receiveUevents();
+                }
+                else
+                {
+                    readInotifyEvents();
+                }
+                readEvents();
+            });
+    }
+
+    void receiveUevents()
+    {
+        while (true)
+        {
+            sockaddr_nl sender{};
+            socklen_t senderLength = sizeof(sender);
+            const auto bytesReceived = ::recvfrom(
+                descriptor.native_handle(), readBuffer.data(),
+                readBuffer.size(), 0, reinterpret_cast<sockaddr*>(&sender),
+                &senderLength);
+            if (bytesReceived < 0)
+            {
+                if (errno == ENOBUFS)
+                {
+                    Logger::log<LogLevel::warning>(
+                        "[HwmonEventMonitor]: Events lost, rescanning all "
+                        "roots");
+                    for (const auto& root : roots)
+                    {
+                        callback(root);
+                    }
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                {
+                    Logger::log<LogLevel::error>(
+                        "[HwmonEventMonitor]: recvfrom failed, errno: %d",
+                        errno);
+                }
+                return;
+            }
+            // Only the kernel sends with port id 0, anything else is spoofed
+            if (senderLength != sizeof(sender) ||
+                sender.nl_family != AF_NETLINK || sender.nl_pid != 0)
+            {
+                continue;
+            }
+            processUevent(static_cast<std::size_t>(bytesReceived));
+        }
+    }
+
+    void readInotifyEvents()
+    {
+        while (true)
+        {
+            const auto bytesRead = ::read(descriptor.native_handle(),
+                                          readBuffer.data(), readBuffer.size());
+            if (bytesRead <= 0)
+            {
+                return;
+            }
+            processInotifyEvents(static_cast<std::size_t>(bytesRead));
+        }
+    }
+
+    /**
+     * @brief Parses a kernel uevent: "<action>@<devpath>\0KEY=value\0...".
+     * Only device addition and removal can change the set of hwmon files.
+     */
+    void processUevent(std::size_t bytesTransferred)
+    {
+        std::string_view action;
+        std::string_view devPath;
+        std::string_view message(readBuffer.data(), bytesTransferred);
+        while (!message.empty())
+        {
+            const auto entry = message.substr(0, message.find('\0'));
+            if (entry.starts_with("ACTION="))
+            {
+                action = entry.substr(std::strlen("ACTION="));
+            }
+            else if (entry.starts_with("DEVPATH="))
+            {
+                devPath = entry.substr(std::strlen("DEVPATH="));
+            }
+            message.remove_prefix(
+                std::min(entry.size() + 1, message.size()));
+        }
+
+        if (action != "add" && action != "remove" && action != "bind" &&
+            action != "unbind" && action != "move")
+        {
+            return;
+        }
+
+        for (const auto& root : roots)
+        {
+            // Root is <sysfs>/bus/<bus>/devices
+            const auto bus = root.parent_path().filename().string();
+            if (isBusAdapterInPath(devPath, bus))
+            {
+                Logger::log<LogLevel::debug>(
+                    "[HwmonEventMonitor]: %s %s",
+                    std::string(action), std::string(devPath));
+                callback(root);
+            }
+        }
+    }
+
+    void processInotifyEvents(std::size_t bytesTransferred)
+    {
+        std::vector<std::filesystem::path> affectedRoots;
+        std::size_t index = 0;
+        while (index + sizeof(inotify_event) <= bytesTransferred)
+        {
+            inotify_event event{};
+            std::memcpy(&event, &readBuffer[index], sizeof(inotify_event));
+            const auto nameOffset = index + sizeof(inotify_event);
+            index = nameOffset + event.len;
+            if (index > bytesTransferred)
+            {
+                break;
+            }
+
+            const auto it = inotifyWatches.find(event.wd);
+            if (it == inotifyWatches.end())
+            {
+                continue;
+            }
+            if (event.mask & IN_IGNORED)
+            {
+                inotifyWatches.erase(it);
+                continue;
+            }
+
+            std::filesystem::path path = it->second;
+            if (event.len > 0)
+            {
+                path /= std::string(&readBuffer[nameOffset]);
+            }
+            const auto root = getAffectedRoot(path);
+            if ((event.mask & IN_ISDIR) &&
+                (event.mask & (IN_CREATE | IN_MOVED_TO)) &&
+                (root || isAncestorOfRoot(path)))
+            {
+                addInotifyWatches(path);
+            }
+
+            if (root)
+            {
+                addUnique(affectedRoots, *root);
+            }
+            else
+            {
+                // Roots created together with their ancestor could be
+                // populated before the watches were added
+                std::error_code ec;
+                for (const auto& r : roots)
+                {
+                    if (nextPathComponent(path, r) &&
+                        std::filesystem::exists(r, ec))
+                    {
+                        addUnique(affectedRoots, r);
+                    }
+                }
+            }
+        }
+
+        for (const auto& root : affectedRoots)
+        {
+            callback(root);
+        }
+    }
+
+    static void addUnique(std::vector<std::filesystem::path>& paths,
+                          const std::filesystem::path& path)
+    {
+        if (std::find(paths.begin(), paths.end(), path) == paths.end())
+        {
+            paths.push_back(path);
+        }
+    }
+
+    /**
+     * @brief Returns the root that contains `path`.
+     */
+    std::optional<std::filesystem::path>
+        getAffectedRoot(const std::filesystem::path& path) const
+    {
+        for (const auto& root : roots)
+        {
+            const auto [rootEnd, pathEnd] =
+                std::mismatch(root.begin(), root.end(), path.begin(),
+                              path.end());
+            if (rootEnd == root.end())
+            {
+                return root;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool isAncestorOfRoot(const std::filesystem::path& path) const
+    {
+        for (const auto& root : roots)
+        {
+            if (nextPathComponent(path, root))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the child of `ancestor` on the way to `root`, or nullopt
+     * when `ancestor` is not a proper ancestor of `root`.
+     */
+    static std::optional<std::filesystem::path>
+        nextPathComponent(const std::filesystem::path& ancestor,
+                          const std::filesystem::path& root)
+    {
+        const auto [ancestorEnd, rootIt] = std::mismatch(
+            ancestor.begin(), ancestor.end(), root.begin(), root.end());
+        if (ancestorEnd != ancestor.end() || rootIt == root.end())
+        {
+            return std::nullopt;
+        }
+        return ancestor / *rootIt;
+    }
+};
+
+} // namespace nodemanager
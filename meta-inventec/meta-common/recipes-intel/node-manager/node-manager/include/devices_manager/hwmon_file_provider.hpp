@@ -18,6 +18,7 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "devices_manager/hwmon_event_monitor.hpp"
 #include "flow_control.hpp"
 #include "knobs/knob.hpp"
 #include "sensors/sensor_reading_type.hpp"
@@ -27,10 +28,14 @@
 #include "utility/ranges.hpp"
 #include "utility/types.hpp"
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/container/flat_map.hpp>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <sdbusplus/asio/object_server.hpp>
+#include <set>
 #include <unordered_map>
 
 namespace nodemanager
@@ -41,6 +46,9 @@ static const uint8_t kHwmonPeciPvcBaseAddress = 0x48;
 static const uint8_t kHwmonI2cPsuBaseAddress = 0x58;
 static const uint8_t kHwmonSmbusPvcBaseBus = 40;
 static const std::chrono::seconds kHwmonDiscoveryPeriod{10};
+static const std::chrono::seconds kHwmonConsistencyCheckPeriod{300};
+static const std::chrono::milliseconds kHwmonEventDebounce{100};
+static constexpr const char* kHwmonSysfsBusPath = "/sys/bus";
 
 static const unsigned kBusPathIndex = 1;
 static const unsigned kAddressPathIndex = 2;
@@ -108,22 +116,41 @@ static const boost::container::flat_map<std::string,
         {"psu", std::make_tuple(kHwmonI2cPsuBaseAddress, kMaxPsuNumber)},
 };
 
+enum class HwmonDiscoveryMode
+{
+    periodic,
+    events
+};
+
 /**
- * @brief This class periodically scans folder with hwmon files and
+ * @brief This class discovers hwmon files and maps them to sensor readings
+ * and knobs.
  *
+ * In events mode the bus directory affected by a hotplug event (see
+ * HwmonEventMonitor) is rescanned shortly after the event, and a full rescan
+ * is done only every kHwmonConsistencyCheckPeriod. In periodic mode, or when
+ * no event source is available, all directories are rescanned every
+ * kHwmonDiscoveryPeriod.
  */
 class HwmonFileProvider : public HwmonFileProviderIf
 {
   public:
-    HwmonFileProvider(std::shared_ptr<sdbusplus::asio::connection> busArg,
-                      std::filesystem::path rootPathArg = "/sys/bus",
-                      bool startDiscoveryTimer = true) :
+    HwmonFileProvider(
+        std::shared_ptr<sdbusplus::asio::connection> busArg,
+        std::filesystem::path rootPathArg = kHwmonSysfsBusPath,
+        bool startDiscoveryTimer = true,
+        HwmonDiscoveryMode discoveryMode = HwmonDiscoveryMode::events) :
         hwmonDiscoveryTimer(busArg->get_io_context()),
-        hwmonDiscoveryTimeout(std::chrono::seconds(1))
+        hwmonDiscoveryTimeout(std::chrono::seconds(1)),
+        hwmonEventTimer(busArg->get_io_context()), ioc(busArg->get_io_context())
     {
         installConfigs(rootPathArg);
         if (startDiscoveryTimer)
         {
+            if (discoveryMode == HwmonDiscoveryMode::events)
+            {
+                startEventMonitor(busArg->get_io_context(), rootPathArg);
+            }
             runFileDiscovery();
         }
     }
@@ -151,13 +178,25 @@ class HwmonFileProvider : public HwmonFileProviderIf
         return std::filesystem::path{};
     }
 
+    /**
+     * @brief Applies results of the last scan if it has finished and starts a
+     * new scan of all directories.
+     */
     void discoverFiles()
     {
-        auto perf = Perf("Hwmon-discoveryFiles-duration",
-                         std::chrono::milliseconds{20});
+        for (const auto& matcher : fileMatchers)
+        {
+            pendingRoots.insert(matcher.getRootPath());
+        }
         discoverHwmonFiles();
     }
 
+    HwmonEventSource getEventSource() const
+    {
+        return eventMonitor ? eventMonitor->getSource()
+                            : HwmonEventSource::none;
+    }
+
   protected:
     using FileMatcherResults =
         std::tuple<uint32_t, uint32_t, std::string, std::string>;
@@ -165,7 +204,44 @@ class HwmonFileProvider : public HwmonFileProviderIf
     using DiscoveredPaths =
         FileMatcher<FileMatcherResults>::PathDecompositionMap;
 
-    std::optional<std::future<DiscoveredPaths>> future;
+    struct DiscoveryResults
+    {
+        std::set<std::filesystem::path> scannedRoots;
+        DiscoveredPaths paths;
+    };
+
+    std::optional<std::future<DiscoveryResults>> future;
+
+    /**
+     * @brief Called on the io_context thread when results of a scan have been
+     * applied.
+     */
+    virtual void onFilesDiscovered()
+    {
+    }
+
+    /**
+     * @brief Scans the directories of matchers which root is in `roots`.
+     */
+    static DiscoveryResults
+        findFiles(const std::vector<FileMatcher<FileMatcherResults>>& matchers,
+                  const std::set<std::filesystem::path>& roots)
+    {
+        DiscoveryResults results{roots, {}};
+        for (const auto& matcher : matchers)
+        {
+            if (roots.contains(matcher.getRootPath()))
+            {
+                matcher.findFiles(results.paths, 1);
+            }
+        }
+        return results;
+    }
+
+    const std::vector<FileMatcher<FileMatcherResults>>& getFileMatchers() const
+    {
+        return fileMatchers;
+    }
 
   private:
     template <class T>
@@ -214,37 +290,52 @@ class HwmonFileProvider : public HwmonFileProviderIf
             });
     }
 
+    /**
+     * @brief Applies results of the finished scan, then starts a scan of
+     * pendingRoots if there are any and no other scan is in progress. A
+     * finished scan posts this function to the io_context, so its results
+     * are applied right away.
+     */
     void discoverHwmonFiles()
     {
-        Logger::log<LogLevel::debug>(
-            "[HwmonFileProvider]: discovering hwmon files");
-
         if (future)
         {
             if (future->valid() && future->wait_for(std::chrono::seconds(0)) ==
                                        std::future_status::ready)
             {
-                const DiscoveredPaths& discoveredPaths = future->get();
-                addFileMapping(kHwmonToSensorReadings, discoveredPaths,
+                static const MeasureHandle perfHandle(
+                    "Hwmon-discoveryFiles-duration",
+                    std::chrono::milliseconds{20});
+                auto perf = Perf(perfHandle);
+                const DiscoveryResults results = future->get();
+                addFileMapping(kHwmonToSensorReadings, results.paths,
                                sensorsToHwmonMap);
-                addFileMapping(kHwmonToKnob, discoveredPaths, knobsToHwmonMap);
+                addFileMapping(kHwmonToKnob, results.paths, knobsToHwmonMap);
 
-                removeNonexistentMapping(discoveredPaths, sensorsToHwmonMap);
-                removeNonexistentMapping(discoveredPaths, knobsToHwmonMap);
+                removeNonexistentMapping(results, sensorsToHwmonMap);
+                removeNonexistentMapping(results, knobsToHwmonMap);
+                onFilesDiscovered();
             }
         }
-        if (!future || !future->valid())
+        if ((!future || !future->valid()) && !pendingRoots.empty())
         {
-            future = std::move(
-                std::async(std::launch::async,
-                           [matchers = fileMatchers]() -> DiscoveredPaths {
-                               DiscoveredPaths discoveredPaths;
-                               for (const auto& matcher : matchers)
-                               {
-                                   matcher.findFiles(discoveredPaths, 1);
-                               }
-                               return discoveredPaths;
-                           }));
+            Logger::log<LogLevel::debug>(
+                "[HwmonFileProvider]: discovering hwmon files");
+            auto promise = std::make_shared<std::promise<DiscoveryResults>>();
+            future = promise->get_future();
+            scanTask = std::async(
+                std::launch::async,
+                [&ioc = ioc, promise, matchers = fileMatchers,
+                 roots = std::exchange(pendingRoots, {}),
+                 onFinished = [this, alive = std::weak_ptr<bool>(lifetime)]() {
+                     if (alive.lock())
+                     {
+                         discoverHwmonFiles();
+                     }
+                 }]() {
+                    promise->set_value(findFiles(matchers, roots));
+                    boost::asio::post(ioc, onFinished);
+                });
         }
     }
 
@@ -297,13 +388,14 @@ class HwmonFileProvider : public HwmonFileProviderIf
     }
 
     template <class T>
-    void removeNonexistentMapping(const DiscoveredPaths& newPaths,
+    void removeNonexistentMapping(const DiscoveryResults& results,
                                   ElementToPathMap<T>& output)
     {
         std::vector<std::pair<T, DeviceIndex>> toRemove;
         for (const auto& [key, path] : output)
         {
-            if (!newPaths.contains(path))
+            if (isScanned(results.scannedRoots, path) &&
+                !results.paths.contains(path))
             {
                 Logger::log<LogLevel::info>(
                     "[HwmonFileProvider]: hwmon file %s doesn't exits, "
@@ -359,6 +451,53 @@ class HwmonFileProvider : public HwmonFileProviderIf
         return std::nullopt;
     }
 
+    static bool isScanned(const std::set<std::filesystem::path>& roots,
+                          const std::filesystem::path& path)
+    {
+        return std::any_of(roots.begin(), roots.end(), [&path](const auto& r) {
+            return std::mismatch(r.begin(), r.end(), path.begin(), path.end())
+                       .first == r.end();
+        });
+    }
+
+    void startEventMonitor(boost::asio::io_context& ioc,
+                           const std::filesystem::path& rootPath)
+    {
+        std::vector<std::filesystem::path> roots;
+        for (const auto& matcher : fileMatchers)
+        {
+            if (std::find(roots.begin(), roots.end(), matcher.getRootPath()) ==
+                roots.end())
+            {
+                roots.push_back(matcher.getRootPath());
+            }
+        }
+        eventMonitor = std::make_unique<HwmonEventMonitor>(
+            ioc, roots,
+            [this](const std::filesystem::path& root) { onHwmonEvent(root); },
+            rootPath == kHwmonSysfsBusPath);
+    }
+
+    /**
+     * @brief Events come in bursts when a driver binds, so the rescan is
+     * delayed by kHwmonEventDebounce to cover the whole burst at once.
+     */
+    void onHwmonEvent(const std::filesystem::path& root)
+    {
+        if (!pendingRoots.insert(root).second || pendingRoots.size() > 1)
+        {
+            return;
+        }
+        hwmonEventTimer.expires_after(kHwmonEventDebounce);
+        hwmonEventTimer.async_wait([this](boost::system::error_code ec) {
+            if (ec)
+            {
+                return;
+            }
+            discoverHwmonFiles();
+        });
+    }
+
     void runFileDiscovery()
     {
         discoverFiles();
@@ -373,7 +512,10 @@ class HwmonFileProvider : public HwmonFileProviderIf
                     ec);
                 return;
             }
-            hwmonDiscoveryTimeout = kHwmonDiscoveryPeriod;
+            hwmonDiscoveryTimeout =
+                (getEventSource() == HwmonEventSource::none)
+                    ? kHwmonDiscoveryPeriod
+                    : kHwmonConsistencyCheckPeriod;
             runFileDiscovery();
         });
     }
@@ -383,5 +525,12 @@ class HwmonFileProvider : public HwmonFileProviderIf
     ElementToPathMap<SensorReadingType> sensorsToHwmonMap;
     ElementToPathMap<KnobType> knobsToHwmonMap;
     std::vector<FileMatcher<FileMatcherResults>> fileMatchers;
+    boost::asio::steady_timer hwmonEventTimer;
+    boost::asio::io_context& ioc;
+    std::set<std::filesystem::path> pendingRoots;
+    std::unique_ptr<HwmonEventMonitor> eventMonitor;
+    std::shared_ptr<bool> lifetime = std::make_shared<bool>(true);
+    // Destroyed first, waits for the scan in progress
+    std::future<void> scanTask;
 };
 } // namespace nodemanager
@@ -27,6 +27,8 @@ using AsyncKnobExecutor =
     AsyncExecutorIf<std::pair<KnobType, DeviceIndex>,
                     std::pair<std::ios_base::iostate, uint32_t>>;
 
+static constexpr std::chrono::milliseconds kKnobWriteTimeout{2000};
+
 class AsyncKnob : public Knob
 {
   public:
@@ -39,8 +41,10 @@ class AsyncKnob : public Knob
     AsyncKnob(KnobType typeArg, DeviceIndex deviceIndexArg,
               std::shared_ptr<AsyncKnobExecutor> asyncExecutorArg,
               const std::shared_ptr<SensorReadingsManagerIf>&
-                  sensorReadingsManagerArg) :
-        Knob(typeArg, deviceIndexArg, sensorReadingsManagerArg),
+                  sensorReadingsManagerArg,
+              KnobWritePolicy writePolicyArg = {}) :
+        Knob(typeArg, deviceIndexArg, sensorReadingsManagerArg,
+             writePolicyArg),
         asyncExecutor(asyncExecutorArg)
     {
     }
@@ -49,15 +53,47 @@ class AsyncKnob : public Knob
     {
     }
 
-    virtual void writeValue() override
+    /**
+     * @brief Schedules the write of valueToSave. Nothing is scheduled when
+     * the same value is still being written, so requesting it in consecutive
+     * iterations does not queue additional writes.
+     */
+    virtual bool writeValue() override
     {
-        asyncExecutor->schedule({getKnobType(), getDeviceIndex()}, getTask(),
-                                getTaskCallback());
+        const auto key = std::make_pair(getKnobType(), getDeviceIndex());
+        if (scheduledValue == valueToSave && asyncExecutor->isPending(key))
+        {
+            return false;
+        }
+        if (!asyncExecutor->schedule(key, getTask(), getTaskCallback()))
+        {
+            return false;
+        }
+        scheduledValue = valueToSave;
+        return true;
     }
 
   protected:
     virtual AsyncKnobExecutor::Task getTask() const = 0;
-    virtual AsyncKnobExecutor::TaskCallback getTaskCallback() = 0;
+
+    virtual AsyncKnobExecutor::TaskCallback getTaskCallback()
+    {
+        return [this](std::pair<std::ios_base::iostate, uint32_t> results) {
+            const auto [status, savedValue] = results;
+            lastState = status;
+            lastSavedValue = (lastState == std::ios_base::goodbit)
+                                 ? std::make_optional(savedValue)
+                                 : std::nullopt;
+            if (lastState != std::ios_base::goodbit)
+            {
+                withdrawFailedWrite();
+            }
+        };
+    }
+
     std::shared_ptr<AsyncKnobExecutor> asyncExecutor;
+
+  private:
+    std::optional<uint32_t> scheduledValue = std::nullopt;
 };
 } // namespace nodemanager
\ No newline at end of file
@@ -48,9 +48,10 @@ class HwmonKnob : public AsyncKnob
               std::shared_ptr<HwmonFileProviderIf> hwmonProviderArg,
               std::shared_ptr<AsyncKnobExecutor> asyncExecutorArg,
               const std::shared_ptr<SensorReadingsManagerIf>&
-                  sensorReadingsManagerArg) :
+                  sensorReadingsManagerArg,
+              KnobWritePolicy writePolicyArg = {}) :
         AsyncKnob(typeArg, deviceIndexArg, asyncExecutorArg,
-                  sensorReadingsManagerArg),
+                  sensorReadingsManagerArg, writePolicyArg),
         hwmonProvider(hwmonProviderArg), minValue(minValueArg),
         maxValue(maxValueArg)
     {
@@ -91,7 +92,7 @@ class HwmonKnob : public AsyncKnob
                                std::numeric_limits<uint32_t>::max());
 
         auto clampedMilliwatts = std::clamp(milliwatts, minValue, maxValue);
-        valueToSave = clampedMilliwatts;
+        requestValue(clampedMilliwatts);
     }
 
     /**
@@ -101,7 +102,7 @@ class HwmonKnob : public AsyncKnob
      */
     void resetKnob()
     {
-        valueToSave = 0;
+        requestExactValue(0);
     }
 
     bool isKnobSet() const override
@@ -130,6 +131,7 @@ class HwmonKnob : public AsyncKnob
         tmp["Status"] = lastState;
         tmp["DeviceIndex"] = getDeviceIndex();
         tmp["Value"] = optionalToJson(lastSavedValue);
+        reportWriteCounters(tmp);
         out["Knobs-hwmon"][type].push_back(tmp);
     }
 
@@ -159,16 +161,6 @@ class HwmonKnob : public AsyncKnob
             return {powerLimitFile.rdstate(), value};
         };
     }
-    virtual AsyncKnobExecutor::TaskCallback getTaskCallback() override
-    {
-        return [this](std::pair<std::ios_base::iostate, uint32_t> results) {
-            const auto [status, savedValue] = results;
-            lastState = status;
-            lastSavedValue = (lastState == std::ios_base::goodbit)
-                                 ? std::make_optional(savedValue)
-                                 : std::nullopt;
-        };
-    }
 
   private:
     std::shared_ptr<HwmonFileProviderIf> hwmonProvider;
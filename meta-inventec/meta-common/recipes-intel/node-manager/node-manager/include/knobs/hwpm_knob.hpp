@@ -46,9 +46,10 @@ class HwpmKnob : public AsyncKnob
              std::shared_ptr<PeciCommandsIf> peciIfArg,
              std::shared_ptr<AsyncKnobExecutor> asyncExecutorArg,
              const std::shared_ptr<SensorReadingsManagerIf>&
-                 sensorReadingsManagerArg) :
+                 sensorReadingsManagerArg,
+             KnobWritePolicy writePolicyArg = {}) :
         AsyncKnob(typeArg, deviceIndexArg, asyncExecutorArg,
-                  sensorReadingsManagerArg),
+                  sensorReadingsManagerArg, writePolicyArg),
         defaultValue(defaultValueArg), peciIf(peciIfArg)
     {
     }
@@ -79,7 +80,7 @@ class HwpmKnob : public AsyncKnob
                                    "performance knob are not empty");
         }
 
-        valueToSave = valueToBeSet;
+        requestValue(static_cast<uint32_t>(valueToBeSet));
     }
 
     /**
@@ -88,7 +89,7 @@ class HwpmKnob : public AsyncKnob
      */
     void resetKnob()
     {
-        valueToSave = defaultValue;
+        requestExactValue(defaultValue);
     }
 
     bool isKnobSet() const override
@@ -105,6 +106,7 @@ class HwpmKnob : public AsyncKnob
         tmp["DeviceIndex"] = getDeviceIndex();
         tmp["Value"] = optionalToJson(lastSavedValue);
         tmp["DefaultValue"] = defaultValue;
+        reportWriteCounters(tmp);
         out["Knobs-peci"][type].push_back(tmp);
     }
 
@@ -137,17 +139,6 @@ class HwpmKnob : public AsyncKnob
         };
     }
 
-    virtual AsyncKnobExecutor::TaskCallback getTaskCallback() override
-    {
-        return [this](std::pair<std::ios_base::iostate, uint32_t> results) {
-            const auto [status, savedValue] = results;
-            lastState = status;
-            lastSavedValue = (lastState == std::ios_base::goodbit)
-                                 ? std::make_optional(savedValue)
-                                 : std::nullopt;
-        };
-    }
-
   private:
     bool reservedFieldsEmpty(KnobType type, uint32_t value)
     {
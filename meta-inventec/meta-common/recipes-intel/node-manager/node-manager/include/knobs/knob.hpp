@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "flow_control.hpp"
 #include "sensors/sensor_readings_manager.hpp"
 #include "utility/async_executor.hpp"
@@ -52,6 +53,27 @@ static const std::unordered_map<KnobType, std::string> knobTypeNames = {
     {KnobType::HwpmPerfPreferenceOverride, "HwpmPerfPreferenceOverride"},
 };
 
+/**
+ * @brief Determines when a value requested from a knob is written to the
+ * hardware.
+ *
+ * A value differing from the last successfully written one by no more than
+ * `hysteresis` (in the knob units) is not written, unless it comes from
+ * resetKnob. When `refreshInterval` is not zero, the requested value is
+ * written again after that time even if it did not change.
+ */
+struct KnobWritePolicy
+{
+    uint32_t hysteresis = 0;
+    std::chrono::milliseconds refreshInterval{0};
+};
+
+struct KnobWriteCounters
+{
+    uint64_t issued = 0;
+    uint64_t suppressed = 0;
+};
+
 class KnobIf : public StatusProviderIf, public RunnerIf
 {
   public:
@@ -61,6 +83,7 @@ class KnobIf : public StatusProviderIf, public RunnerIf
     virtual bool isKnobSet() const = 0;
     virtual KnobType getKnobType() const = 0;
     virtual DeviceIndex getDeviceIndex() const = 0;
+    virtual KnobWriteCounters getWriteCounters() const = 0;
 };
 
 class Knob : public KnobIf
@@ -74,10 +97,12 @@ class Knob : public KnobIf
 
     Knob(KnobType typeArg, DeviceIndex deviceIndexArg,
          const std::shared_ptr<SensorReadingsManagerIf>&
-             sensorReadingsManagerArg) :
+             sensorReadingsManagerArg,
+         KnobWritePolicy writePolicyArg = {}) :
         knobType(typeArg),
         deviceIndex(deviceIndexArg),
-        sensorReadingsManager(sensorReadingsManagerArg)
+        sensorReadingsManager(sensorReadingsManagerArg),
+        writePolicy(writePolicyArg)
     {
     }
 
@@ -91,13 +116,32 @@ class Knob : public KnobIf
         {
             lastState = std::ios_base::goodbit;
             lastSavedValue = std::nullopt;
+            lastWriteTime = std::nullopt;
             return;
         }
 
-        if (isSomethingToWrite())
+        if (!isSomethingToWrite())
         {
-            writeValue();
+            if (valueToSave.has_value())
+            {
+                writeCounters.suppressed++;
+            }
+            return;
         }
+
+        // A write that cannot start yet, e.g. because the previous one is
+        // still in progress, is retried in the next iteration
+        if (writeValue())
+        {
+            lastWriteTime = Clock::now();
+            isExactWriteRequested = false;
+            writeCounters.issued++;
+        }
+    }
+
+    KnobWriteCounters getWriteCounters() const override
+    {
+        return writeCounters;
     }
 
     KnobType getKnobType() const override
@@ -122,11 +166,46 @@ class Knob : public KnobIf
   protected:
     virtual bool isSomethingToWrite() const
     {
-        if (valueToSave.has_value() && (valueToSave != lastSavedValue))
+        if (!valueToSave.has_value())
+        {
+            return false;
+        }
+        if (!lastSavedValue.has_value() || isRefreshDue())
         {
             return true;
         }
-        return false;
+        if (isExactWriteRequested)
+        {
+            return *valueToSave != *lastSavedValue;
+        }
+        const auto difference = (*valueToSave > *lastSavedValue)
+                                    ? *valueToSave - *lastSavedValue
+                                    : *lastSavedValue - *valueToSave;
+        return difference > writePolicy.hysteresis;
+    }
+
+    bool isRefreshDue() const
+    {
+        return writePolicy.refreshInterval.count() > 0 &&
+               lastWriteTime.has_value() &&
+               (Clock::now() - *lastWriteTime) >= writePolicy.refreshInterval;
+    }
+
+    void requestValue(uint32_t value)
+    {
+        valueToSave = value;
+        isExactWriteRequested = false;
+    }
+
+    /**
+     * @brief Requests a value that is written even if it lies within the
+     * hysteresis band around the last written value. Used by resetKnob, so
+     * that the default value is always restored exactly.
+     */
+    void requestExactValue(uint32_t value)
+    {
+        valueToSave = value;
+        isExactWriteRequested = true;
     }
 
     virtual bool isKnobEndpointAvailable() const
@@ -135,7 +214,13 @@ class Knob : public KnobIf
                sensorReadingsManager->isCpuAvailable(getDeviceIndex());
     }
 
-    virtual void writeValue() = 0;
+    /**
+     * @brief Writes valueToSave to the hardware.
+     *
+     * @return false if the write could not be started, e.g. because the
+     * previous one is still in progress.
+     */
+    virtual bool writeValue() = 0;
 
     template <class T>
     nlohmann::json optionalToJson(const std::optional<T>& value) const
@@ -147,12 +232,38 @@ class Knob : public KnobIf
         return nullptr;
     }
 
+    /**
+     * @brief Used by knobs learning the result of a write after writeValue()
+     * returned, to withdraw a write that failed. It is not counted as issued
+     * and the refresh interval does not start from it.
+     */
+    void withdrawFailedWrite()
+    {
+        if (writeCounters.issued > 0)
+        {
+            writeCounters.issued--;
+        }
+        lastWriteTime = std::nullopt;
+    }
+
+    void reportWriteCounters(nlohmann::json& out) const
+    {
+        out["IssuedWrites"] = writeCounters.issued;
+        out["SuppressedWrites"] = writeCounters.suppressed;
+    }
+
     KnobType knobType;
     DeviceIndex deviceIndex;
     std::ios_base::iostate lastState = std::ios_base::goodbit;
     std::optional<uint32_t> valueToSave = std::nullopt;
     std::optional<uint32_t> lastSavedValue = std::nullopt;
     std::shared_ptr<SensorReadingsManagerIf> sensorReadingsManager;
+
+  private:
+    KnobWritePolicy writePolicy;
+    KnobWriteCounters writeCounters;
+    std::optional<Clock::time_point> lastWriteTime = std::nullopt;
+    bool isExactWriteRequested = false;
 };
 
 } // namespace nodemanager
\ No newline at end of file
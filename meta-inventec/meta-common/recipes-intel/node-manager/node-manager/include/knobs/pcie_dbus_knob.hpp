@@ -73,8 +73,10 @@ class PcieDbusKnob : public Knob
                  const std::shared_ptr<sdbusplus::asio::connection>& busArg,
                  const std::shared_ptr<SensorReadingsManagerIf>&
                      sensorReadingsManagerArg,
-                 const char* dbusServiceNameArg = kPcieKnobBusName) :
-        Knob(typeArg, deviceIndexArg, sensorReadingsManagerArg),
+                 const char* dbusServiceNameArg = kPcieKnobBusName,
+                 KnobWritePolicy writePolicyArg = {}) :
+        Knob(typeArg, deviceIndexArg, sensorReadingsManagerArg,
+             writePolicyArg),
         pldmEntityProvider(pldmEntityProviderArg), bus(busArg),
         dbusServiceName(dbusServiceNameArg)
     {
@@ -91,7 +93,7 @@ class PcieDbusKnob : public Knob
 
     void setKnob(const double valueToBeSet) override final
     {
-        valueToSave = valueToBeSet;
+        requestValue(static_cast<uint32_t>(valueToBeSet));
     }
     void resetKnob() override final
     {
@@ -107,14 +109,15 @@ class PcieDbusKnob : public Knob
                 if (std::holds_alternative<double>(
                         sensorReadingCapMax->getValue()))
                 {
-                    valueToSave = maxValue =
+                    maxValue =
                         std::get<double>(sensorReadingCapMax->getValue());
+                    requestExactValue(*maxValue);
                 }
             }
         }
         else
         {
-            valueToSave = *maxValue;
+            requestExactValue(*maxValue);
         }
     }
 
@@ -142,6 +145,7 @@ class PcieDbusKnob : public Knob
         tmp["StatusPL2"] = isPL2Available();
         tmp["DeviceIndex"] = getDeviceIndex();
         tmp["Value"] = optionalToJson(lastSavedValue);
+        reportWriteCounters(tmp);
         out["Knobs-pci-dbus"][type].push_back(tmp);
     }
 
@@ -150,6 +154,8 @@ class PcieDbusKnob : public Knob
     std::shared_ptr<sdbusplus::asio::connection> bus;
     const char* dbusServiceName;
     std::optional<uint32_t> maxValue = std::nullopt;
+    unsigned callsInProgress = 0;
+    bool callsFailed = false;
     std::vector<std::unique_ptr<sdbusplus::bus::match::match>>
         operationalStatusMatches;
     std::unordered_map<PcieKnobType, PcieDbusKnobState> pcieKnobsState = {
@@ -187,9 +193,19 @@ class PcieDbusKnob : public Knob
         return isPL1Available() || isPL2Available();
     }
 
-    virtual void writeValue() override
+    /**
+     * @brief Sends the effecter writes of valueToSave. Returns false when the
+     * previous writes are still in progress or no effecter is available. A
+     * D-Bus error reported later withdraws the write, see getCallback().
+     */
+    virtual bool writeValue() override
     {
+        if (callsInProgress > 0 || !isKnobEndpointAvailable())
+        {
+            return false;
+        }
         auto value = valueToSave.value();
+        callsFailed = false;
 
         if (isPL1Available())
         {
@@ -201,6 +217,7 @@ class PcieDbusKnob : public Knob
                 getCallback(PcieKnobType::PL1Tau, value), dbusServiceName,
                 pcieDbusKnobsConfig[PcieKnobType::PL1Tau].dbusPath.value(),
                 kPcieDbusKnobIface, "SetEffecter", kPowerLimitLongTimeWindow);
+            callsInProgress += 2;
         }
 
         if (isPL2Available())
@@ -216,7 +233,9 @@ class PcieDbusKnob : public Knob
                 getCallback(PcieKnobType::PL2Tau, value), dbusServiceName,
                 pcieDbusKnobsConfig[PcieKnobType::PL2Tau].dbusPath.value(),
                 kPcieDbusKnobIface, "SetEffecter", kPowerLimitShortTimeWindow);
+            callsInProgress += 2;
         }
+        return true;
     }
 
     void setObjectPath(PcieDbusKnobConfig& knobConfig, const std::string& tid,
@@ -232,8 +251,13 @@ class PcieDbusKnob : public Knob
         getCallback(PcieKnobType pcieKnobType, uint32_t keyValue)
     {
         return [this, pcieKnobType, keyValue](boost::system::error_code ec) {
+            callsInProgress--;
             if (ec)
             {
+                if (!std::exchange(callsFailed, true))
+                {
+                    withdrawFailedWrite();
+                }
                 pcieKnobsState[pcieKnobType].state = std::ios_base::failbit;
                 pcieKnobsState[pcieKnobType].keyValue = std::nullopt;
                 lastState = std::ios_base::failbit;
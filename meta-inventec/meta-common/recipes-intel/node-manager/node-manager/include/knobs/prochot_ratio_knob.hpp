@@ -44,9 +44,10 @@ class ProchotRatioKnob : public AsyncKnob
                      std::shared_ptr<PeciCommandsIf> peciIfArg,
                      std::shared_ptr<AsyncKnobExecutor> asyncExecutorArg,
                      const std::shared_ptr<SensorReadingsManagerIf>&
-                         sensorReadingsManagerArg) :
+                         sensorReadingsManagerArg,
+                     KnobWritePolicy writePolicyArg = {}) :
         AsyncKnob(typeArg, deviceIndexArg, asyncExecutorArg,
-                  sensorReadingsManagerArg),
+                  sensorReadingsManagerArg, writePolicyArg),
         peciIf(peciIfArg)
     {
     }
@@ -57,7 +58,7 @@ class ProchotRatioKnob : public AsyncKnob
     {
         if (isCastSafe<uint8_t>(valueToBeSet))
         {
-            valueToSave = valueToBeSet;
+            requestValue(static_cast<uint32_t>(valueToBeSet));
         }
         else
         {
@@ -71,7 +72,7 @@ class ProchotRatioKnob : public AsyncKnob
     {
         if (defaultValue)
         {
-            valueToSave = *defaultValue;
+            requestExactValue(*defaultValue);
         }
         else
         {
@@ -83,7 +84,7 @@ class ProchotRatioKnob : public AsyncKnob
                     "Getting default prochot assert ratio from cfg, value: %d",
                     unsigned{confValue});
                 defaultValue = confValue;
-                valueToSave = *defaultValue;
+                requestExactValue(*defaultValue);
                 return;
             }
             auto readTask = [cpuIndex = getDeviceIndex(), peci = peciIf]()
@@ -105,11 +106,11 @@ class ProchotRatioKnob : public AsyncKnob
                     if (status == std::ios_base::goodbit)
                     {
                         defaultValue = static_cast<uint8_t>(value);
-                        valueToSave = *defaultValue;
+                        requestExactValue(*defaultValue);
                     }
                     else
                     {
-                        valueToSave = uint32_t{kDefaultProchotValue};
+                        requestExactValue(kDefaultProchotValue);
                     }
                 };
             asyncExecutor->schedule({getKnobType(), getDeviceIndex()},
@@ -134,6 +135,7 @@ class ProchotRatioKnob : public AsyncKnob
         tmp["DeviceIndex"] = getDeviceIndex();
         tmp["Value"] = optionalToJson(lastSavedValue);
         tmp["DefaultValue"] = optionalToJson(defaultValue);
+        reportWriteCounters(tmp);
         out["Knobs-peci"][type].push_back(tmp);
     }
 
@@ -152,17 +154,6 @@ class ProchotRatioKnob : public AsyncKnob
             };
     }
 
-    virtual AsyncKnobExecutor::TaskCallback getTaskCallback() override
-    {
-        return [this](std::pair<std::ios_base::iostate, uint32_t> results) {
-            const auto [status, savedValue] = results;
-            lastState = status;
-            lastSavedValue = (lastState == std::ios_base::goodbit)
-                                 ? std::make_optional(savedValue)
-                                 : std::nullopt;
-        };
-    }
-
   private:
     std::shared_ptr<PeciCommandsIf> peciIf;
     std::optional<uint8_t> defaultValue = std::nullopt;
@@ -40,9 +40,10 @@ class TurboRatioKnob : public AsyncKnob
                    std::shared_ptr<PeciCommandsIf> peciIfArg,
                    std::shared_ptr<AsyncKnobExecutor> asyncExecutorArg,
                    const std::shared_ptr<SensorReadingsManagerIf>&
-                       sensorReadingsManagerArg) :
+                       sensorReadingsManagerArg,
+                   KnobWritePolicy writePolicyArg = {}) :
         AsyncKnob(typeArg, deviceIndexArg, asyncExecutorArg,
-                  sensorReadingsManagerArg),
+                  sensorReadingsManagerArg, writePolicyArg),
         peciIf(peciIfArg)
     {
     }
@@ -59,7 +60,7 @@ class TurboRatioKnob : public AsyncKnob
     {
         if (isCastSafe<uint8_t>(valueToBeSet))
         {
-            valueToSave = valueToBeSet;
+            requestValue(static_cast<uint32_t>(valueToBeSet));
         }
         else
         {
@@ -81,11 +82,11 @@ class TurboRatioKnob : public AsyncKnob
             Logger::log<LogLevel::debug>(
                 "Getting default turbo ratio limit from cfg, value: %d",
                 unsigned{confValue});
-            valueToSave = confValue;
+            requestExactValue(confValue);
         }
         else
         {
-            valueToSave = std::numeric_limits<uint8_t>::max();
+            requestExactValue(std::numeric_limits<uint8_t>::max());
         }
     }
 
@@ -103,6 +104,7 @@ class TurboRatioKnob : public AsyncKnob
         tmp["Status"] = lastState;
         tmp["DeviceIndex"] = getDeviceIndex();
         tmp["Value"] = optionalToJson(lastSavedValue);
+        reportWriteCounters(tmp);
         out["Knobs-peci"][type].push_back(tmp);
     }
 
@@ -121,17 +123,6 @@ class TurboRatioKnob : public AsyncKnob
             };
     }
 
-    virtual AsyncKnobExecutor::TaskCallback getTaskCallback() override
-    {
-        return [this](std::pair<std::ios_base::iostate, uint32_t> results) {
-            const auto [status, savedValue] = results;
-            lastState = status;
-            lastSavedValue = (lastState == std::ios_base::goodbit)
-                                 ? std::make_optional(savedValue)
-                                 : std::nullopt;
-        };
-    }
-
   private:
     std::shared_ptr<PeciCommandsIf> peciIf;
 };
@@ -39,6 +39,7 @@
 #include "utility/dbus_enable_if.hpp"
 #include "utility/dbus_interfaces.hpp"
 #include "utility/diagnostics.hpp"
+#include "utility/loop_scheduler.hpp"
 #include "utility/performance_monitor.hpp"
 
 #include <systemd/sd-daemon.h>
@@ -85,6 +86,30 @@ static constexpr const auto kSmartParametersDirectory =
 
 static const std::chrono::milliseconds kLoopPeriod{100};
 
+/**
+ * @brief Sensors are sampled at the control chain rate, the control chain
+ * always uses the latest collected readings.
+ */
+static const LoopTaskConfig kSensorsTaskConfig = {
+    "Sensors", kLoopPeriod, std::chrono::milliseconds{0},
+    std::chrono::milliseconds{20}, OverrunPolicy::skip};
+static const LoopTaskConfig kControlTaskConfig = {
+    "Control", kLoopPeriod, std::chrono::milliseconds{0},
+    std::chrono::milliseconds{50}, OverrunPolicy::skip};
+static const LoopTaskConfig kSmartTaskConfig = {
+    "Smart", kLoopPeriod, std::chrono::milliseconds{0},
+    std::chrono::milliseconds{10}, OverrunPolicy::shed};
+static const LoopTaskConfig kStatusTaskConfig = {
+    "Status", std::chrono::milliseconds{1000}, std::chrono::milliseconds{50},
+    std::chrono::milliseconds{20}, OverrunPolicy::shed};
+/**
+ * @brief Keeps the status dump logged on abort at most a minute old.
+ */
+static const LoopTaskConfig kCrashDumpTaskConfig = {
+    "CrashDump", std::chrono::milliseconds{60000},
+    std::chrono::milliseconds{550}, std::chrono::milliseconds{50},
+    OverrunPolicy::shed};
+
 class NodeManager : public RunnerIf, DbusEnableIf
 {
   public:
@@ -104,7 +129,7 @@ class NodeManager : public RunnerIf, DbusEnableIf
         ioc(iocArg), bus(busArg),
         objectServer(std::make_shared<sdbusplus::asio::object_server>(bus)),
         objectPath(objectPathArg), tickTimer(ioc),
-        loopTimer(bus->get_io_context()), loopTimeout(kLoopPeriod)
+        scheduler(bus->get_io_context())
     {
         throttlingLogCollector = std::make_shared<ThrottlingLogCollector>(ioc);
         gpioProvider = std::make_shared<GpioProvider>();
@@ -123,7 +148,8 @@ class NodeManager : public RunnerIf, DbusEnableIf
         budgeting = makeBudgeting();
         triggersManager = std::make_shared<TriggersManager>(
             objectServer, objectPath, gpioProvider);
-        policyStorageManagement = std::make_shared<PolicyStorageManagement>();
+        policyStorageManagement =
+            std::make_shared<PolicyStorageManagement>(bus->get_io_context());
         ptam = std::make_unique<Ptam>(bus, objectServer, objectPath,
                                       devicesManager, gpioProvider, budgeting,
                                       efficiencyControl, triggersManager,
@@ -152,6 +178,7 @@ class NodeManager : public RunnerIf, DbusEnableIf
         statisticsProvider->initializeDbusInterfaces(dbusInterfaces);
 
         syncSimpleDomainBudgetingCapabilities();
+        initializeScheduler();
         initializeDbusInterfaces();
         DbusEnableIf::initializeDbusInterfaces(dbusInterfaces);
         DbusEnableIf::setParentRunning(true);
@@ -168,40 +195,7 @@ class NodeManager : public RunnerIf, DbusEnableIf
 
     void run() override final
     {
-        auto perf1 = std::make_shared<Perf>("NodeManager-run-between",
-                                            std::chrono::milliseconds{150});
-
-        loopTimer.expires_after(loopTimeout);
-        loopTimer.async_wait([this,
-                              perf1](const boost::system::error_code& ec) {
-            perf1->stopMeasure();
-
-            if (ec == boost::asio::error::operation_aborted)
-            {
-                return;
-            }
-
-            // TODO: consider running DeviceManager with seperate timer to
-            // decrease DBus performance impact on Node Manager logic
-            // mechanism
-
-            auto perf2 =
-                Perf("NodeManager-run-duration", std::chrono::milliseconds{50});
-
-            devicesManager->run();
-            ptam->run();
-            budgeting->run();
-            control->run();
-            statusMonitor->run();
-            smartSupervisor->run();
-
-            ptam->postRun();
-
-            perf2.stopMeasure();
-            sd_notify(0, "WATCHDOG=1");
-
-            run();
-        });
+        scheduler.start();
     }
 
     std::shared_ptr<Diagnostics> getDiagnostics()
@@ -224,8 +218,9 @@ class NodeManager : public RunnerIf, DbusEnableIf
     std::shared_ptr<TriggersManager> triggersManager;
     std::shared_ptr<PolicyStorageManagement> policyStorageManagement;
     std::unique_ptr<Ptam> ptam;
-    boost::asio::steady_timer loopTimer;
-    std::chrono::milliseconds loopTimeout;
+    LoopScheduler scheduler;
+    // Measures the time between the end of a control run and the next one
+    std::optional<Perf> runBetweenPerf;
     PropertyPtr<std::underlying_type_t<NmHealth>> health;
     DbusInterfaces dbusInterfaces{objectPath, objectServer};
     std::unique_ptr<StatisticsProvider> statisticsProvider;
@@ -263,6 +258,42 @@ class NodeManager : public RunnerIf, DbusEnableIf
             devicesManager, std::move(compoundBudgeting), control);
     }
 
+    /**
+     * @brief Control chain components are run in a single task, so all of
+     * them operate on the same sensor readings, which are updated only by the
+     * sensors task. The task keeps the NodeManager-run-duration and
+     * NodeManager-run-between measures of the former control loop.
+     */
+    void initializeScheduler()
+    {
+        scheduler.addTask(kSensorsTaskConfig,
+                          [this]() { devicesManager->runSensors(); });
+        scheduler.addTask(kControlTaskConfig, [this]() {
+            static const MeasureHandle perfBetweenHandle(
+                "NodeManager-run-between", std::chrono::milliseconds{150});
+            static const MeasureHandle perfHandle(
+                "NodeManager-run-duration", std::chrono::milliseconds{50});
+            runBetweenPerf.reset();
+            auto perf = Perf(perfHandle);
+
+            devicesManager->runReadingsAndKnobs();
+            ptam->run();
+            budgeting->run();
+            control->run();
+            ptam->postRun();
+
+            perf.stopMeasure();
+            sd_notify(0, "WATCHDOG=1");
+            runBetweenPerf.emplace(perfBetweenHandle);
+        });
+        scheduler.addTask(kSmartTaskConfig,
+                          [this]() { smartSupervisor->run(); });
+        scheduler.addTask(kStatusTaskConfig,
+                          [this]() { statusMonitor->run(); });
+        scheduler.addTask(kCrashDumpTaskConfig,
+                          [this]() { diagnostics->refreshCrashDump(); });
+    }
+
     void syncSimpleDomainBudgetingCapabilities()
     {
         SimpleDomainCapabilities simpleDomainCapabilities;
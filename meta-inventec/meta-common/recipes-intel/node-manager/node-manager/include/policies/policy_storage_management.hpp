@@ -17,13 +17,25 @@
 
 #pragma once
 
+#include "config/append_log.hpp"
 #include "config/persistent_storage.hpp"
 #include "policy_storage_management_if.hpp"
 #include "policy_types.hpp"
 
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
 namespace nodemanager
 {
 
+static constexpr const char* kPolicyStoreFileName = "policies.log";
+static constexpr uint16_t kPolicyStoreVersion = 1;
+/**
+ * @brief Log is compacted when it holds more records than this value and
+ * twice the number of stored policies.
+ */
+static constexpr size_t kPolicyStoreCompactionThreshold = 64;
+
 void to_json(nlohmann::json& j, const DomainId& domainId)
 {
     j = enumToStr(kDomainIdNames, domainId);
@@ -35,7 +47,12 @@ void from_json(const nlohmann::json& j, DomainId& domainId)
 }
 
 /**
- * @brief Class used to manage policy configuration in storage
+ * @brief Class used to manage policy configuration in storage.
+ *
+ * All policies are kept in a single AppendLog file in policiesDir, with the
+ * policy json encoded as CBOR. The file is read once at construction, so
+ * startup does not depend on the number of policies. Policy files in json
+ * format left by previous versions are migrated to the log and removed.
  */
 class PolicyStorageManagement : public PolicyStorageManagementIf
 {
@@ -45,10 +62,33 @@ class PolicyStorageManagement : public PolicyStorageManagementIf
     PolicyStorageManagement(PolicyStorageManagement&&) = delete;
     PolicyStorageManagement& operator=(PolicyStorageManagement&&) = delete;
 
+    /**
+     * @brief Every change is written to the storage before returning.
+     */
     PolicyStorageManagement(std::filesystem::path policiesDirArg =
                                 "/var/lib/node-manager/policies/") :
-        policiesDir(policiesDirArg)
+        policiesDir(policiesDirArg),
+        log(policiesDir / kPolicyStoreFileName, kPolicyStoreVersion)
     {
+        load();
+    }
+
+    /**
+     * @brief Changes are written to the storage from a handler posted to the
+     * io_context, so all changes made while handling a single D-Bus call are
+     * written and synced together.
+     */
+    PolicyStorageManagement(boost::asio::io_context& iocArg,
+                            std::filesystem::path policiesDirArg =
+                                "/var/lib/node-manager/policies/") :
+        PolicyStorageManagement(policiesDirArg)
+    {
+        ioc = &iocArg;
+    }
+
+    virtual ~PolicyStorageManagement()
+    {
+        flush();
     }
 
     /**
@@ -96,78 +136,190 @@ class PolicyStorageManagement : public PolicyStorageManagementIf
         std::vector<
             std::tuple<PolicyId, DomainId, PolicyOwner, bool, PolicyParams>>
             readPolicies;
-        if (storage.exists(policiesDir))
+        std::vector<PolicyId> invalidPolicies;
+        for (const auto& [policyId, encoded] : policies)
         {
-            for (auto const& entry :
-                 std::filesystem::directory_iterator(policiesDir))
+            DomainId domainId;
+            PolicyOwner owner;
+            bool isEnabled;
+            PolicyParams policyParams;
+            const auto policyJson =
+                nlohmann::json::from_cbor(encoded, true, false);
+            if (!policyJson.is_discarded() &&
+                storage.readJson(policyJson,
+                                 getParamsToRead(domainId, owner, isEnabled,
+                                                 policyParams),
+                                 "policy " + policyId))
+            {
+                readPolicies.push_back(std::make_tuple(
+                    policyId, domainId, owner, isEnabled, policyParams));
+            }
+            else
             {
-                if (entry.path().extension().compare(".json") == 0)
-                {
-                    PolicyId policyId = policyIdFromPath(entry.path());
-                    DomainId domainId;
-                    PolicyOwner owner;
-                    bool isEnabled;
-                    PolicyParams policyParams;
-                    if (storage.readJsonFile(entry.path(),
-                                             getParamsToRead(domainId, owner,
-                                                             isEnabled,
-                                                             policyParams)))
-                    {
-                        readPolicies.push_back(
-                            std::make_tuple(policyId, domainId, owner,
-                                            isEnabled, policyParams));
-                    }
-                    else
-                    {
-                        Logger::log<LogLevel::warning>(
-                            "Cannot create policy with id %s from file - "
-                            "format is invalid. Removing the file",
-                            policyId);
-                        policyDelete(policyId);
-                    }
-                }
+                Logger::log<LogLevel::warning>(
+                    "Cannot create policy with id %s from storage - "
+                    "format is invalid. Removing the policy",
+                    policyId);
+                invalidPolicies.push_back(policyId);
             }
-            std::sort(readPolicies.begin(), readPolicies.end(),
-                      [](const auto& a, const auto& b) {
-                          return (std::get<PolicyId>(a) <
-                                  std::get<PolicyId>(b));
-                      });
+        }
+        for (const auto& policyId : invalidPolicies)
+        {
+            policyDelete(policyId);
         }
         return readPolicies;
     }
 
     bool policyWrite(const PolicyId& policyId, const nlohmann::json& policyJson)
     {
-        return storage.store(policyFilePath(policyId), policyJson);
+        const auto cbor = nlohmann::json::to_cbor(policyJson);
+        auto& encoded = policies[policyId];
+        encoded.assign(cbor.begin(), cbor.end());
+        pendingChanges[policyId] = encoded;
+        return scheduleFlush();
     }
 
     bool policyDelete(PolicyId policyId)
     {
-        if (storage.exists(policyFilePath(policyId)))
+        if (policies.erase(policyId) == 0)
         {
-            return storage.remove(policyFilePath(policyId));
+            Logger::log<LogLevel::debug>("Trying to delete policy with id "
+                                         "%s but it is not stored",
+                                         policyId);
+            return true;
         }
-        else
+        pendingChanges[policyId] = std::nullopt;
+        return scheduleFlush();
+    }
+
+    /**
+     * @brief Writes all pending changes with a single append, or compacts the
+     * log when it grew too large or a failed append left it damaged. Changes
+     * that could not be written stay pending and are written by the next
+     * flush.
+     *
+     * @return true when the changes were synced to the storage.
+     */
+    bool flush()
+    {
+        isFlushScheduled = false;
+        if (pendingChanges.empty())
         {
-            Logger::log<LogLevel::debug>("Trying to delete policy file with id "
-                                         "%s but the file does not exist",
-                                         policyId);
             return true;
         }
+
+        const auto compactionThreshold =
+            std::max(kPolicyStoreCompactionThreshold, 2 * policies.size());
+        if (log.isCompactionRequired() ||
+            log.getRecordsCount() + pendingChanges.size() > compactionThreshold)
+        {
+            if (!log.compact(policies))
+            {
+                return false;
+            }
+            pendingChanges.clear();
+            return true;
+        }
+
+        std::vector<AppendLogRecord> records;
+        records.reserve(pendingChanges.size());
+        for (const auto& [policyId, encoded] : pendingChanges)
+        {
+            records.push_back({policyId, encoded});
+        }
+        if (!log.append(records))
+        {
+            return false;
+        }
+        pendingChanges.clear();
+        return true;
     }
 
   private:
     PersistentStorage storage;
     std::filesystem::path policiesDir;
+    AppendLog log;
+    boost::asio::io_context* ioc = nullptr;
+    std::map<PolicyId, std::string> policies;
+    std::map<PolicyId, std::optional<std::string>> pendingChanges;
+    bool isFlushScheduled = false;
+    std::shared_ptr<bool> lifetime = std::make_shared<bool>(true);
 
-    std::filesystem::path policyFilePath(PolicyId policyId)
+    void load()
     {
-        return policiesDir / (policyId + ".json");
+        if (log.exists())
+        {
+            policies = log.load();
+        }
+        else
+        {
+            migrateJsonFiles();
+        }
     }
 
-    PolicyId policyIdFromPath(std::filesystem::path policyFilePath)
+    /**
+     * @brief Moves policies from per policy json files, used by previous
+     * versions, to the log. Files are removed only after the log is stored.
+     */
+    void migrateJsonFiles()
     {
-        return policyFilePath.stem().string();
+        if (!storage.exists(policiesDir))
+        {
+            return;
+        }
+        std::vector<std::filesystem::path> jsonFiles;
+        for (auto const& entry :
+             std::filesystem::directory_iterator(policiesDir))
+        {
+            if (entry.path().extension().compare(".json") != 0)
+            {
+                continue;
+            }
+            jsonFiles.push_back(entry.path());
+            std::ifstream file(entry.path());
+            const auto policyJson = nlohmann::json::parse(file, nullptr, false);
+            if (policyJson.is_discarded())
+            {
+                Logger::log<LogLevel::warning>(
+                    "Cannot migrate policy from file %s - format is invalid",
+                    entry.path().c_str());
+                continue;
+            }
+            const auto cbor = nlohmann::json::to_cbor(policyJson);
+            policies[entry.path().stem().string()].assign(cbor.begin(),
+                                                          cbor.end());
+        }
+        if (jsonFiles.empty() || !log.compact(policies))
+        {
+            return;
+        }
+        for (const auto& jsonFile : jsonFiles)
+        {
+            std::error_code ec;
+            std::filesystem::remove(jsonFile, ec);
+        }
+        Logger::log<LogLevel::info>("Migrated %d policies from json files",
+                                    static_cast<int>(policies.size()));
+    }
+
+    bool scheduleFlush()
+    {
+        if (!ioc)
+        {
+            return flush();
+        }
+        if (!isFlushScheduled)
+        {
+            isFlushScheduled = true;
+            boost::asio::post(*ioc,
+                              [this, token = std::weak_ptr<bool>(lifetime)]() {
+                                  if (token.lock())
+                                  {
+                                      flush();
+                                  }
+                              });
+        }
+        return true;
     }
 };
 
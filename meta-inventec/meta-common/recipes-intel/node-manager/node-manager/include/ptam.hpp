@@ -111,7 +111,9 @@ class Ptam : public RunnerExtIf, public StateIf
 
     void run() override final
     {
-        auto perf = Perf("Ptam-run-duration", std::chrono::milliseconds{20});
+        static const MeasureHandle perfHandle(
+            "Ptam-run-duration", std::chrono::milliseconds{20});
+        auto perf = Perf(perfHandle);
         for (const auto& [domainId, domain] : domains)
         {
             domain->run();
@@ -122,8 +124,9 @@ class Ptam : public RunnerExtIf, public StateIf
 
     void postRun() override final
     {
-        auto perf =
-            Perf("Ptam-postRun-duration", std::chrono::milliseconds{20});
+        static const MeasureHandle perfHandle(
+            "Ptam-postRun-duration", std::chrono::milliseconds{20});
+        auto perf = Perf(perfHandle);
 
         for (const auto& [domainId, domain] : domains)
         {
@@ -68,17 +68,15 @@ class Reading : public ReadingIf
             bool isAnyReadingAvailAndValid = false;
             const auto& deviceIndex = reading.second;
 
-            sensorReadingsManager->forEachSensorReading(
+            sensorReadingsManager->getSnapshot().forEach(
                 mapReadingTypeToSensorReadingType(readingType), deviceIndex,
-                [&value,
-                 &isAnyReadingAvailAndValid](const auto& sensorReading) {
-                    if (sensorReading.isGood())
+                [&value, &isAnyReadingAvailAndValid](const auto& entry) {
+                    if (entry.isGood())
                     {
-                        if (std::holds_alternative<double>(
-                                sensorReading.getValue()))
+                        if (std::holds_alternative<double>(entry.value))
                         {
                             isAnyReadingAvailAndValid = true;
-                            value += std::get<double>(sensorReading.getValue());
+                            value += std::get<double>(entry.value);
                         }
                         else
                         {
@@ -54,16 +54,15 @@ class ReadingAcPlatformLimit : public Reading
         double value = 0;
         auto isAnyReadingAvailAndValid = false;
 
-        sensorReadingsManager->forEachSensorReading(
+        sensorReadingsManager->getSnapshot().forEach(
             SensorReadingType::dcPlatformPowerLimit, 0,
-            [&value, &isAnyReadingAvailAndValid](auto& sensorReading) {
-                if (sensorReading.isGood())
+            [&value, &isAnyReadingAvailAndValid](auto& entry) {
+                if (entry.isGood())
                 {
-                    if (std::holds_alternative<double>(
-                            sensorReading.getValue()))
+                    if (std::holds_alternative<double>(entry.value))
                     {
                         isAnyReadingAvailAndValid = true;
-                        value += std::get<double>(sensorReading.getValue());
+                        value += std::get<double>(entry.value);
                     }
                     else
                     {
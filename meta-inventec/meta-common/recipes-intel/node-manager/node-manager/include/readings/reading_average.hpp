@@ -50,14 +50,14 @@ class ReadingAverage : public Reading
             T value = 0;
             uint32_t devicesNum = 0;
 
-            sensorReadingsManager->forEachSensorReading(
+            sensorReadingsManager->getSnapshot().forEach(
                 mapReadingTypeToSensorReadingType(readingType), deviceIndex,
-                [&value, &devicesNum](const auto& sensorReading) {
-                    if (sensorReading.isGood())
+                [&value, &devicesNum](const auto& entry) {
+                    if (entry.isGood())
                     {
-                        if (std::holds_alternative<T>(sensorReading.getValue()))
+                        if (std::holds_alternative<T>(entry.value))
                         {
-                            value += std::get<T>(sensorReading.getValue());
+                            value += std::get<T>(entry.value);
                             devicesNum++;
                         }
                         else
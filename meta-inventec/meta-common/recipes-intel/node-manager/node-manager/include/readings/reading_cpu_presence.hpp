@@ -44,20 +44,19 @@ class ReadingCpuPresence : public Reading
     {
         std::bitset<kMaxCpuNumber> cpuPresenceMap;
 
-        sensorReadingsManager->forEachSensorReading(
+        sensorReadingsManager->getSnapshot().forEach(
             SensorReadingType::cpuPackagePower, kAllDevices,
-            [&cpuPresenceMap](auto& sensorReading) {
-                if (sensorReading.getDeviceIndex() >= kMaxCpuNumber)
+            [&cpuPresenceMap](auto& entry) {
+                if (entry.deviceIndex >= kMaxCpuNumber)
                 {
                     throw std::logic_error(
                         std::string("CPU DeviceIndex out of range: ") +
-                        std::to_string(sensorReading.getDeviceIndex()) + ">" +
+                        std::to_string(entry.deviceIndex) + ">" +
                         std::to_string(kMaxCpuNumber));
                 }
-                if (sensorReading.getStatus() !=
-                    SensorReadingStatus::unavailable)
+                if (entry.status != SensorReadingStatus::unavailable)
                 {
-                    cpuPresenceMap.set(sensorReading.getDeviceIndex());
+                    cpuPresenceMap.set(entry.deviceIndex);
                 }
             });
 
@@ -55,17 +55,16 @@ class ReadingCpuUtilization : public Reading
             bool isAnyReadingAvailAndValid = false;
             const auto& deviceIndex = reading.second;
 
-            sensorReadingsManager->forEachSensorReading(
+            sensorReadingsManager->getSnapshot().forEach(
                 mapReadingTypeToSensorReadingType(readingType), deviceIndex,
                 [&value, &maxFreq,
-                 &isAnyReadingAvailAndValid](const auto& sensorReading) {
-                    if (sensorReading.isGood())
+                 &isAnyReadingAvailAndValid](const auto& entry) {
+                    if (entry.isGood())
                     {
                         if (std::holds_alternative<CpuUtilizationType>(
-                                sensorReading.getValue()))
+                                entry.value))
                         {
-                            auto c0 = std::get<CpuUtilizationType>(
-                                sensorReading.getValue());
+                            auto c0 = std::get<CpuUtilizationType>(entry.value);
                             if (c0.duration.count() != 0)
                             {
                                 maxFreq += c0.maxCpuUtilization;
@@ -47,15 +47,15 @@ class ReadingMax : public Reading
         bool isAnyValue = false;
         T max = std::numeric_limits<T>::lowest();
 
-        sensorReadingsManager->forEachSensorReading(
+        sensorReadingsManager->getSnapshot().forEach(
             mapReadingTypeToSensorReadingType(getReadingType()), kAllDevices,
-            [&max, &isAnyValue](auto& sensorReading) {
-                if (sensorReading.isGood())
+            [&max, &isAnyValue](auto& entry) {
+                if (entry.isGood())
                 {
-                    if (std::holds_alternative<T>(sensorReading.getValue()))
+                    if (std::holds_alternative<T>(entry.value))
                     {
                         max = std::max(max,
-                                       std::get<T>(sensorReading.getValue()));
+                                       std::get<T>(entry.value));
                         isAnyValue = true;
                     }
                     else
@@ -47,15 +47,15 @@ class ReadingMin : public Reading
         bool isAnyValue = false;
         T min = std::numeric_limits<T>::max();
 
-        sensorReadingsManager->forEachSensorReading(
+        sensorReadingsManager->getSnapshot().forEach(
             mapReadingTypeToSensorReadingType(getReadingType()), kAllDevices,
-            [&min, &isAnyValue](auto& sensorReading) {
-                if (sensorReading.isGood())
+            [&min, &isAnyValue](auto& entry) {
+                if (entry.isGood())
                 {
-                    if (std::holds_alternative<T>(sensorReading.getValue()))
+                    if (std::holds_alternative<T>(entry.value))
                     {
                         min = std::min(min,
-                                       std::get<T>(sensorReading.getValue()));
+                                       std::get<T>(entry.value));
                         isAnyValue = true;
                     }
                     else
@@ -53,17 +53,15 @@ class ReadingMultiSource : public Reading
         {
             isAnyReadingAvailAndValid = false;
             double value = 0.0;
-            sensorReadingsManager->forEachSensorReading(
+            sensorReadingsManager->getSnapshot().forEach(
                 source, kAllDevices,
-                [&value, &isAnyReadingAvailAndValid,
-                 this](const auto& sensorReading) {
-                    if (sensorReading.isGood())
+                [&value, &isAnyReadingAvailAndValid, this](const auto& entry) {
+                    if (entry.isGood())
                     {
-                        if (std::holds_alternative<double>(
-                                sensorReading.getValue()))
+                        if (std::holds_alternative<double>(entry.value))
                         {
                             isAnyReadingAvailAndValid = true;
-                            value += std::get<double>(sensorReading.getValue());
+                            value += std::get<double>(entry.value);
                         }
                         else
                         {
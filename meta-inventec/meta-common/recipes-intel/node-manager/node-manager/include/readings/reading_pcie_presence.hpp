@@ -43,20 +43,19 @@ class ReadingPciePresence : public Reading
     void run() override final
     {
         std::bitset<kMaxPcieNumber> pciPresenceMap;
-        sensorReadingsManager->forEachSensorReading(
+        sensorReadingsManager->getSnapshot().forEach(
             mapReadingTypeToSensorReadingType(ReadingType::pciePower),
-            kAllDevices, [&pciPresenceMap](auto& sensorReading) {
-                if (sensorReading.getDeviceIndex() >= kMaxPcieNumber)
+            kAllDevices, [&pciPresenceMap](auto& entry) {
+                if (entry.deviceIndex >= kMaxPcieNumber)
                 {
                     throw std::logic_error(
                         std::string("Peci DeviceIndex out of range: ") +
-                        std::to_string(sensorReading.getDeviceIndex()) + ">" +
+                        std::to_string(entry.deviceIndex) + ">" +
                         std::to_string(kMaxPcieNumber));
                 }
-                if (sensorReading.getStatus() !=
-                    SensorReadingStatus::unavailable)
+                if (entry.status != SensorReadingStatus::unavailable)
                 {
-                    pciPresenceMap.set(sensorReading.getDeviceIndex());
+                    pciPresenceMap.set(entry.deviceIndex);
                 }
             });
 
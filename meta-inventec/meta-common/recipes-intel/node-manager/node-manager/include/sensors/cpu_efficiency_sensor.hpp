@@ -24,6 +24,7 @@
 #include "sensor_reading.hpp"
 #include "sensor_readings_manager.hpp"
 #include "utility/performance_monitor.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
 #include <iostream>
@@ -60,8 +61,9 @@ class CpuEfficiencySensor : public PeciSampleSensor
 
     void run() override final
     {
-        auto perf = Perf("SensorSet-Efficiency-run-duration",
-                         std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-Efficiency-run-duration", std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
         for (const auto& epiSensorReading : readings)
         {
             DeviceIndex deviceIndex = epiSensorReading->getDeviceIndex();
@@ -106,8 +108,8 @@ class CpuEfficiencySensor : public PeciSampleSensor
             {
                 futureSamples.insert_or_assign(
                     deviceIndex,
-                    std::async(
-                        std::launch::async,
+                    WorkerPool::getInstance().submit(
+                        WorkerQueue::peci,
                         [deviceIndex, peciIf = peciCommands]() -> PeciSample {
                             return {Clock::now(),
                                     peciIf->getEpiCounterSensor(deviceIndex)};
@@ -25,6 +25,7 @@
 #include "sensor_reading.hpp"
 #include "sensor_readings_manager.hpp"
 #include "utility/performance_monitor.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
 #include <optional>
@@ -62,8 +63,9 @@ class CpuFrequencySensor : public PeciSampleSensor
 
     void run() override final
     {
-        auto perf = Perf("SensorSet-Frequency-run-duration",
-                         std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-Frequency-run-duration", std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
         for (const auto& sensorReading : readings)
         {
             DeviceIndex deviceIndex = sensorReading->getDeviceIndex();
@@ -107,8 +109,8 @@ class CpuFrequencySensor : public PeciSampleSensor
             {
                 futureSamples.insert_or_assign(
                     deviceIndex,
-                    std::async(
-                        std::launch::async,
+                    WorkerPool::getInstance().submit(
+                        WorkerQueue::peci,
                         [deviceIndex, peciIf = peciCommands]() -> PeciSample {
                             return {Clock::now(),
                                     peciIf->getC0CounterSensor(deviceIndex)};
@@ -180,8 +182,8 @@ class CpuFrequencySensor : public PeciSampleSensor
         {
             if (!futureNeededRatios.valid())
             {
-                futureNeededRatios = std::move(std::async(
-                    std::launch::async,
+                futureNeededRatios = std::move(WorkerPool::getInstance().submit(
+                    WorkerQueue::peci,
                     [deviceIndex, cpuId,
                      peciIf = peciCommands]() -> NeededRatios {
                         if (cpuId)
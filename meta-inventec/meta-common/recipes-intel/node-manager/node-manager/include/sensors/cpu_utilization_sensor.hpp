@@ -25,6 +25,7 @@
 #include "sensor_reading.hpp"
 #include "sensor_readings_manager.hpp"
 #include "utility/performance_monitor.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
 #include <optional>
@@ -96,8 +97,8 @@ class CpuUtilizationSensor : public PeciSampleSensor
             counter = 0;
             if (!futureMaxCpu.valid())
             {
-                futureMaxCpu = std::move(std::async(
-                    std::launch::async,
+                futureMaxCpu = std::move(WorkerPool::getInstance().submit(
+                    WorkerQueue::peci,
                     [deviceIndex, cpuId,
                      peciIf = peciCommands]() -> std::optional<uint64_t> {
                         if (cpuId)
@@ -116,8 +117,10 @@ class CpuUtilizationSensor : public PeciSampleSensor
 
     void run() override final
     {
-        auto perf = Perf("SensorSet-Utilization-run-duration",
-                         std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-Utilization-run-duration",
+            std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
         for (const auto& sensor : readings)
         {
             DeviceIndex deviceIndex = sensor->getDeviceIndex();
@@ -164,8 +167,8 @@ class CpuUtilizationSensor : public PeciSampleSensor
             {
                 futureSamples.insert_or_assign(
                     deviceIndex,
-                    std::async(
-                        std::launch::async,
+                    WorkerPool::getInstance().submit(
+                        WorkerQueue::peci,
                         [deviceIndex, peciIf = peciCommands]() -> PeciSample {
                             return {Clock::now(),
                                     peciIf->getC0CounterSensor(deviceIndex)};
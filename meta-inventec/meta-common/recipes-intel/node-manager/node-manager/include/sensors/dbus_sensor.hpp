@@ -21,6 +21,7 @@
 #include "loggers/log.hpp"
 #include "sensor.hpp"
 #include "utility/dbus_common.hpp"
+#include "utility/dbus_property_cache.hpp"
 #include "utility/enum_to_string.hpp"
 #include "utility/final_callback.hpp"
 #include "utility/overloaded_helper.hpp"
@@ -40,8 +41,6 @@ static constexpr const auto kMapperBusName = "xyz.openbmc_project.ObjectMapper";
 static constexpr const auto kMapperPath = "/xyz/openbmc_project/object_mapper";
 static constexpr const auto kMapperInterface =
     "xyz.openbmc_project.ObjectMapper";
-static constexpr const auto kPropertiesIface =
-    "org.freedesktop.DBus.Properties";
 template <class T>
 class DbusSensor : public Sensor,
                    public std::enable_shared_from_this<DbusSensor<T>>
@@ -60,28 +59,11 @@ class DbusSensor : public Sensor,
                const std::string& sensorValueIfaceArg) :
         Sensor(sensorReadingsManagerArg),
         bus(busArg), sensorBusName(sensorBusNameArg),
-        sensorValueIface(sensorValueIfaceArg)
+        sensorValueIface(sensorValueIfaceArg),
+        propertyCache(DbusPropertyCache::getInstance(busArg, sensorBusNameArg))
     {
-
-        nameOwnerChangedMatcher =
-            std::make_unique<sdbusplus::bus::match::match>(
-                static_cast<sdbusplus::bus::bus&>(*bus),
-                sdbusplus::bus::match::rules::nameOwnerChanged() +
-                    sdbusplus::bus::match::rules::argN(0, sensorBusName) +
-                    sdbusplus::bus::match::rules::argN(2, ""),
-                nameOwnerChangedHandler);
     }
 
-    std::function<void(sdbusplus::message::message&)> nameOwnerChangedHandler =
-        [&](sdbusplus::message::message& message) {
-            Logger::log<LogLevel::warning>(
-                "Detected service lost from dbus: %s", sensorBusName);
-            for (auto& reading : readings)
-            {
-                reading->setStatus(SensorReadingStatus::unavailable);
-            }
-        };
-
     virtual ~DbusSensor() = default;
 
     virtual void reportStatus(nlohmann::json& out) const override
@@ -98,6 +80,11 @@ class DbusSensor : public Sensor,
             std::visit([&tmp](auto&& value) { tmp["Value"] = value; },
                        sensorReading->getValue());
             tmp["ObjectPath"] = path;
+            if (const auto age =
+                    propertyCache->getAge(makePropertyKey(sensorReading, path)))
+            {
+                tmp["ValueAgeMs"] = age->count();
+            }
             out["Sensors-dbus"][type].push_back(tmp);
         }
     }
@@ -106,7 +93,6 @@ class DbusSensor : public Sensor,
     std::shared_ptr<sdbusplus::asio::connection> bus;
     std::vector<std::tuple<std::shared_ptr<SensorReadingIf>, std::string>>
         objectPathMapping;
-    std::unique_ptr<sdbusplus::bus::match::match> nameOwnerChangedMatcher;
 
     virtual void dbusInterpretSensorValue(
         const std::shared_ptr<SensorReadingIf>& sensorReading,
@@ -133,116 +119,71 @@ class DbusSensor : public Sensor,
         const std::shared_ptr<SensorReadingIf>& sensorReading,
         const T& value) = 0;
 
-    const DbusHandlerCallback dbusGetPropertiesHandler(
-        const std::shared_ptr<SensorReadingIf>& sensorReading,
-        const std::string& objectPath, int retries, int retryInterval)
-    {
-        return [weakSelf = this->weak_from_this(), sensorReading, objectPath,
-                retries, retryInterval](const boost::system::error_code& err,
-                                        const DBusValue& dbusValue) {
-            if (err)
-            {
-                Logger::log<LogLevel::info>(
-                    "Sensor %s-%d has not been read, err=%d, "
-                    "retries left=%d, retry interval=%d\n",
-                    enumToStr(kSensorReadingTypeNames,
-                              sensorReading->getSensorReadingType()),
-                    unsigned{sensorReading->getDeviceIndex()}, err, retries,
-                    retryInterval);
-                sensorReading->setStatus(SensorReadingStatus::unavailable);
-
-                if (auto self = weakSelf.lock())
-                {
-                    if (retries == 0)
-                    {
-                        return;
-                    }
-                    auto timer = std::make_shared<boost::asio::steady_timer>(
-                        self->bus->get_io_context());
-                    timer->expires_after(std::chrono::seconds(retryInterval));
-                    timer->async_wait(
-                        [weakSelf, sensorReading, objectPath, retries,
-                         retryInterval](boost::system::error_code ec) {
-                            if (ec)
-                            {
-                                return;
-                            }
-                            if (auto selfInTimer = weakSelf.lock())
-                            {
-                                selfInTimer->bus->async_method_call(
-                                    selfInTimer->dbusGetPropertiesHandler(
-                                        sensorReading, objectPath, retries - 1,
-                                        retryInterval),
-                                    selfInTimer->sensorBusName, objectPath,
-                                    kPropertiesIface, "Get",
-                                    selfInTimer->sensorValueIface,
-                                    mapSensorReadingTypeToRequestedValue(
-                                        sensorReading->getSensorReadingType()));
-                            }
-                        });
-                }
-            }
-            else
-            {
-                Logger::log<LogLevel::info>(
-                    "Correct reading value for sensor %s-%d\n",
-                    enumToStr(kSensorReadingTypeNames,
-                              sensorReading->getSensorReadingType()),
-                    unsigned{sensorReading->getDeviceIndex()});
-                if (auto self = weakSelf.lock())
-                {
-                    self->dbusInterpretSensorValue(sensorReading, dbusValue);
-                }
-            }
-        };
-    }
-
     void dbusUpdateDeviceReadings(const DeviceIndex deviceIndex,
                                   int retries = 3, int retryInterval = 1)
     {
-        for (auto& tup : objectPathMapping)
+        for (auto& [sensorReading, objectPath] : objectPathMapping)
         {
-            auto&& sensorReading = std::get<0>(tup);
-            std::string& objectPath = std::get<1>(tup);
-
-            if (sensorReading->getDeviceIndex() == deviceIndex)
+            if (sensorReading->getDeviceIndex() != deviceIndex)
             {
-                bus->async_method_call(
-                    dbusGetPropertiesHandler(sensorReading, objectPath, retries,
-                                             retryInterval),
-                    sensorBusName, objectPath, kPropertiesIface, "Get",
-                    sensorValueIface,
-                    mapSensorReadingTypeToRequestedValue(
-                        sensorReading->getSensorReadingType()));
+                continue;
             }
+            propertyCache->read(
+                makePropertyKey(sensorReading, objectPath),
+                [weakSelf = this->weak_from_this(), sensorReading = sensorReading,
+                 retryInterval](const std::optional<DBusValue>& dbusValue) {
+                    if (!dbusValue)
+                    {
+                        Logger::log<LogLevel::info>(
+                            "Sensor %s-%d has not been read, retry "
+                            "interval=%d\n",
+                            enumToStr(kSensorReadingTypeNames,
+                                      sensorReading->getSensorReadingType()),
+                            unsigned{sensorReading->getDeviceIndex()},
+                            retryInterval);
+                        sensorReading->setStatus(
+                            SensorReadingStatus::unavailable);
+                        return;
+                    }
+                    Logger::log<LogLevel::info>(
+                        "Correct reading value for sensor %s-%d\n",
+                        enumToStr(kSensorReadingTypeNames,
+                                  sensorReading->getSensorReadingType()),
+                        unsigned{sensorReading->getDeviceIndex()});
+                    if (auto self = weakSelf.lock())
+                    {
+                        self->dbusInterpretSensorValue(sensorReading,
+                                                       *dbusValue);
+                    }
+                },
+                retries, std::chrono::seconds(retryInterval));
         }
     }
 
     void dbusRegisterForSensorValueUpdateEvent(void)
     {
-        for (auto& tup : objectPathMapping)
+        for (auto& [sensorReading, objectPath] : objectPathMapping)
         {
-            auto&& sensorReading = std::get<0>(tup);
-            std::string objectPath = std::get<1>(tup);
-
-            // Register for signal called when sensor is updated
-            readingMatches.emplace_back(
-                std::make_unique<sdbusplus::bus::match::match>(
-                    static_cast<sdbusplus::bus::bus&>(*bus),
-                    sdbusplus::bus::match::rules::type::signal() +
-                        sdbusplus::bus::match::rules::member(
-                            "PropertiesChanged") +
-                        sdbusplus::bus::match::rules::path_namespace(
-                            objectPath) +
-                        sdbusplus::bus::match::rules::arg0namespace(
-                            sensorValueIface),
-                    dbusSensorPropertiesChangedHandler(sensorReading)));
-        };
+            readingSubscriptions.push_back(propertyCache->subscribe(
+                makePropertyKey(sensorReading, objectPath),
+                [this, sensorReading = sensorReading](
+                    const std::optional<DBusValue>& dbusValue) {
+                    if (dbusValue)
+                    {
+                        dbusInterpretSensorValue(sensorReading, *dbusValue);
+                    }
+                    else
+                    {
+                        sensorReading->setStatus(
+                            SensorReadingStatus::unavailable);
+                    }
+                }));
+        }
     }
 
     void dbusUnregisterSensorValueUpdateEvent()
     {
-        readingMatches.clear();
+        readingSubscriptions.clear();
     }
 
     std::optional<DeviceIndex> getIndexFromPath(const std::string& path) const
@@ -260,31 +201,16 @@ class DbusSensor : public Sensor,
   private:
     const std::string sensorBusName;
     const std::string sensorValueIface;
-    std::vector<std::unique_ptr<sdbusplus::bus::match::match>> readingMatches;
+    std::shared_ptr<DbusPropertyCache> propertyCache;
+    std::vector<DbusPropertyCache::Subscription> readingSubscriptions;
 
-    const std::function<void(sdbusplus::message::message&)>
-        dbusSensorPropertiesChangedHandler(
-            std::shared_ptr<nodemanager::SensorReadingIf>& sensorReading)
+    DbusPropertyKey
+        makePropertyKey(const std::shared_ptr<SensorReadingIf>& sensorReading,
+                        const std::string& objectPath) const
     {
-        return [this, &sensorReading](sdbusplus::message::message& message) {
-            std::string iface;
-            boost::container::flat_map<std::string, DBusValue>
-                changedProperties;
-            std::vector<std::string> invalidatedProperties;
-
-            message.read(iface, changedProperties, invalidatedProperties);
-
-            if (iface.compare(sensorValueIface) == 0)
-            {
-                auto requestedValue = mapSensorReadingTypeToRequestedValue(
-                    sensorReading->getSensorReadingType());
-                const auto it = changedProperties.find(requestedValue);
-                if (it != changedProperties.end())
-                {
-                    dbusInterpretSensorValue(sensorReading, it->second);
-                }
-            }
-        };
+        return {objectPath, sensorValueIface,
+                mapSensorReadingTypeToRequestedValue(
+                    sensorReading->getSensorReadingType())};
     }
 
     static std::string
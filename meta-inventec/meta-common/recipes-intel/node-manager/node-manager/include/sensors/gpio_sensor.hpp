@@ -63,8 +63,9 @@ class GpioSensor : public Sensor
 
     void run() override final
     {
-        auto perf =
-            Perf("SensorSet-Gpio-run-duration", std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-Gpio-run-duration", std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
         for (const auto& sensorReading : readings)
         {
             DeviceIndex deviceIndex = sensorReading->getDeviceIndex();
@@ -0,0 +1,136 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "common_types.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+
+namespace nodemanager
+{
+
+static constexpr size_t kHwmonFileBufferSize = 32;
+
+/**
+ * @brief Keeps a single hwmon attribute open and rereads it with pread()
+ * instead of opening, parsing with iostreams and closing the file on every
+ * sample.
+ *
+ * The descriptor is opened lazily on the first read and kept until the object
+ * is destroyed or a read fails. Owner is responsible for creating a new reader
+ * when HwmonFileProvider reports a different path for the attribute. A reader
+ * must not be used by more than one thread at a time.
+ */
+class HwmonFileReader
+{
+  public:
+    HwmonFileReader() = delete;
+    HwmonFileReader(const HwmonFileReader&) = delete;
+    HwmonFileReader& operator=(const HwmonFileReader&) = delete;
+    HwmonFileReader(HwmonFileReader&&) = delete;
+    HwmonFileReader& operator=(HwmonFileReader&&) = delete;
+
+    explicit HwmonFileReader(const std::filesystem::path& pathArg) :
+        path(pathArg)
+    {
+    }
+
+    ~HwmonFileReader()
+    {
+        closeFile();
+    }
+
+    const std::filesystem::path& getPath() const
+    {
+        return path;
+    }
+
+    bool isOpen() const
+    {
+        return fd >= 0;
+    }
+
+    /**
+     * @brief Reads an integer value from the attribute.
+     *
+     * @return std::pair<int64_t, SensorReadingStatus> value with status:
+     * unavailable when the file cannot be opened, invalid when it cannot be
+     * read or parsed, valid otherwise.
+     */
+    std::pair<int64_t, SensorReadingStatus> read()
+    {
+        if (!isOpen() && !openFile())
+        {
+            return std::make_pair(int64_t{0}, SensorReadingStatus::unavailable);
+        }
+
+        ssize_t bytesRead = 0;
+        do
+        {
+            bytesRead = ::pread(fd, buffer.data(), buffer.size(), 0);
+        } while (bytesRead < 0 && errno == EINTR);
+
+        if (bytesRead <= 0)
+        {
+            closeFile();
+            return std::make_pair(int64_t{0}, SensorReadingStatus::invalid);
+        }
+
+        const char* begin = buffer.data();
+        const char* end = begin + bytesRead;
+        int64_t value = 0;
+        const auto [ptr, ec] = std::from_chars(begin, end, value);
+        if (ec != std::errc() || ptr == begin)
+        {
+            return std::make_pair(int64_t{0}, SensorReadingStatus::invalid);
+        }
+        return std::make_pair(value, SensorReadingStatus::valid);
+    }
+
+  private:
+    std::filesystem::path path;
+    int fd = -1;
+    std::array<char, kHwmonFileBufferSize> buffer;
+
+    bool openFile()
+    {
+        if (path.empty())
+        {
+            return false;
+        }
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        return isOpen();
+    }
+
+    void closeFile()
+    {
+        if (isOpen())
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+} // namespace nodemanager
@@ -19,11 +19,13 @@
 
 #include "common_types.hpp"
 #include "devices_manager/hwmon_file_provider.hpp"
+#include "hwmon_file_reader.hpp"
 #include "loggers/log.hpp"
 #include "sensor.hpp"
 #include "utility/devices_configuration.hpp"
 #include "utility/ranges.hpp"
 #include "utility/units.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <filesystem>
 #include <fstream>
@@ -159,10 +161,41 @@ class HwmonSensor : public Sensor
             .count();
     }
 
+    /**
+     * @brief Reads and converts a single hwmon value. Executed on a worker
+     * thread.
+     */
+    static std::pair<double, SensorReadingStatus>
+        readHwmonFile(HwmonFileReader& hwmonFile, const SensorReadingType type)
+    {
+        const auto [valueFromHwmonFile, status] = hwmonFile.read();
+        if (status != SensorReadingStatus::valid)
+        {
+            return std::make_pair(double{0}, status);
+        }
+
+        double value = 0;
+        if (type == SensorReadingType::acPlatformPower ||
+            type == SensorReadingType::acPlatformPowerCapabilitiesMax ||
+            type == SensorReadingType::dcPlatformPowerPsu ||
+            type == SensorReadingType::dcPlatformPowerCapabilitiesMaxPsu)
+        {
+            value = convertHwmonUnitsToNmUnitsPsu(
+                static_cast<double>(valueFromHwmonFile));
+        }
+        else
+        {
+            value = convertHwmonUnitsToNmUnits(
+                static_cast<double>(valueFromHwmonFile));
+        }
+        return std::make_pair(value, SensorReadingStatus::valid);
+    }
+
     void run() override final
     {
-        auto perf =
-            Perf("SensorSet-Hwmon-run-duration", std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-Hwmon-run-duration", std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
         for (const auto& sensorReading : readings)
         {
             SensorReadingType type = sensorReading->getSensorReadingType();
@@ -201,53 +234,29 @@ class HwmonSensor : public Sensor
 
             if (future == futures.end() || future->second.valid() == false)
             {
+                const auto filePath = hwmonProvider->getFile(type, index);
+                if (filePath.empty())
+                {
+                    files.erase(typeAndIndex);
+                    sensorReading->setStatus(SensorReadingStatus::unavailable);
+                    continue;
+                }
                 if (!isEndpointAvailable(type, index))
                 {
                     sensorReading->setStatus(SensorReadingStatus::unavailable);
                     continue;
                 }
-                auto filePath = hwmonProvider->getFile(type, index);
+                auto& file = files[typeAndIndex];
+                if (!file || file->getPath() != filePath)
+                {
+                    file = std::make_shared<HwmonFileReader>(filePath);
+                }
                 futures.insert_or_assign(
                     typeAndIndex,
-                    std::async(std::launch::async, [filePath, type]() {
-                        std::ifstream hwmonFile(filePath);
-                        if (!hwmonFile.good())
-                        {
-                            return std::make_pair(
-                                double{0}, SensorReadingStatus::unavailable);
-                        }
-
-                        double valueFromHwmonFile = 0;
-                        double value = 0;
-
-                        hwmonFile >> valueFromHwmonFile;
-                        if (hwmonFile.good())
-                        {
-                            if (type == SensorReadingType::acPlatformPower ||
-                                type == SensorReadingType::
-                                            acPlatformPowerCapabilitiesMax ||
-                                type == SensorReadingType::dcPlatformPowerPsu ||
-                                type == SensorReadingType::
-                                            dcPlatformPowerCapabilitiesMaxPsu)
-                            {
-                                value =
-                                    HwmonSensor::convertHwmonUnitsToNmUnitsPsu(
-                                        valueFromHwmonFile);
-                            }
-                            else
-                            {
-                                value = HwmonSensor::convertHwmonUnitsToNmUnits(
-                                    valueFromHwmonFile);
-                            }
-                            return std::make_pair(value,
-                                                  SensorReadingStatus::valid);
-                        }
-                        else
-                        {
-                            return std::make_pair(double{0},
-                                                  SensorReadingStatus::invalid);
-                        }
-                    }));
+                    WorkerPool::getInstance().submit(
+                        WorkerQueue::hwmon, [file, type]() {
+                            return readHwmonFile(*file, type);
+                        }));
             }
         }
     }
@@ -259,16 +268,14 @@ class HwmonSensor : public Sensor
              std::future<std::pair<double, SensorReadingStatus>>>
         futures;
     std::map<std::pair<SensorReadingType, DeviceIndex>, uint8_t> retries;
+    std::map<std::pair<SensorReadingType, DeviceIndex>,
+             std::shared_ptr<HwmonFileReader>>
+        files;
 
   private:
     bool isEndpointAvailable(const SensorReadingType type,
                              const DeviceIndex index) const
     {
-        auto filePath = hwmonProvider->getFile(type, index);
-        if (filePath.empty())
-        {
-            return false;
-        }
         switch (type)
         {
             case SensorReadingType::cpuPackagePower:
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "common_types.hpp"
+#include "peci_scheduler.hpp"
 #include "peci_types.hpp"
 #include "utility/performance_monitor.hpp"
 
@@ -89,7 +90,11 @@ class PeciCommandsIf
 class PeciCommands : public PeciCommandsIf
 {
   public:
-    PeciCommands() = default;
+    explicit PeciCommands(
+        PeciScheduler& schedulerArg = PeciScheduler::getInstance()) :
+        scheduler(schedulerArg)
+    {
+    }
     virtual ~PeciCommands() = default;
 
     virtual std::optional<uint8_t>
@@ -151,8 +156,8 @@ class PeciCommands : public PeciCommandsIf
     {
         request::SetProchotRatio req;
         req.payload.prochot_ratio = newProchotRatio;
-        const auto res =
-            executePeciCmd<response::SetProchotRatio>(__func__, cpuIndex, req);
+        const auto res = executePeciCmd<response::SetProchotRatio>(
+            __func__, cpuIndex, req, PeciPriority::knob);
         if (res)
         {
             return true;
@@ -178,7 +183,7 @@ class PeciCommands : public PeciCommandsIf
         request::SetTurboRatioLimit req;
         req.payload.ratioLimit = newRatioLimit;
         const auto res = executePeciCmd<response::SetTurboRatioLimit>(
-            __func__, cpuIndex, req);
+            __func__, cpuIndex, req, PeciPriority::knob);
         if (res)
         {
             return true;
@@ -460,7 +465,7 @@ class PeciCommands : public PeciCommandsIf
         request::SetHwpmPreferencePkgConfig req;
         req.data = value;
         const auto res = executePeciCmd<response::SetHwpmPreference>(
-            __func__, cpuIndex, req);
+            __func__, cpuIndex, req, PeciPriority::knob);
         if (res)
         {
             return true;
@@ -473,7 +478,7 @@ class PeciCommands : public PeciCommandsIf
         request::SetHwpmPreferenceBiasPkgConfig req;
         req.data = value;
         const auto res = executePeciCmd<response::SetHwpmPreferenceBias>(
-            __func__, cpuIndex, req);
+            __func__, cpuIndex, req, PeciPriority::knob);
         if (res)
         {
             return true;
@@ -487,7 +492,7 @@ class PeciCommands : public PeciCommandsIf
         request::SetHwpmPreferenceOverridePkgConfig req;
         req.data = value;
         const auto res = executePeciCmd<response::SetHwpmPreferenceOverride>(
-            __func__, cpuIndex, req);
+            __func__, cpuIndex, req, PeciPriority::knob);
         if (res)
         {
             return true;
@@ -508,14 +513,17 @@ class PeciCommands : public PeciCommandsIf
         }
     }
 
+    PeciScheduler& scheduler;
+
     template <class Response, class Request>
-    std::optional<Response> executePeciCmd(const char* funName,
-                                           const DeviceIndex cpuIndex,
-                                           Request& req) const
+    std::optional<Response>
+        executePeciCmd(const char* funName, const DeviceIndex cpuIndex,
+                       Request& req,
+                       PeciPriority priority = PeciPriority::telemetry) const
     {
         Response rsp{};
         const EPECIStatus ret =
-            executePeciCmd(getPeciCPUAddress(cpuIndex), req, rsp);
+            executePeciCmd(getPeciCPUAddress(cpuIndex), priority, req, rsp);
         if (ret == PECI_CC_SUCCESS && rsp.compCode == COMPLETION_CODE_SUCCESS)
         {
             return rsp;
@@ -532,18 +540,14 @@ class PeciCommands : public PeciCommandsIf
     }
 
     template <typename Req, typename Rsp>
-    EPECIStatus executePeciCmd(uint8_t target, Req& req, Rsp& rsp) const
+    EPECIStatus executePeciCmd(uint8_t target, PeciPriority priority,
+                               Req& req, Rsp& rsp) const
     {
-#ifdef ENABLE_PECI
-        const auto pReq = reinterpret_cast<uint8_t*>(&req);
+        const auto pReq = reinterpret_cast<const uint8_t*>(&req);
         const auto pRsp = reinterpret_cast<uint8_t*>(&rsp);
 
-        return peci_raw(target, static_cast<uint8_t>(sizeof(Rsp)), pReq,
-                        static_cast<uint8_t>(sizeof(Req)), pRsp,
-                        static_cast<uint8_t>(sizeof(Rsp)));
-#else  // ENABLE_PECI
-        return EPECIStatus::PECI_CC_TIMEOUT;
-#endif // ENABLE_PECI
+        return scheduler.execute(target, priority, pReq, sizeof(Req), pRsp,
+                                 sizeof(Rsp));
     }
 };
 
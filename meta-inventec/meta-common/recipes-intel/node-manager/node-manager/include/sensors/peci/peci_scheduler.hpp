@@ -0,0 +1,427 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "loggers/log.hpp"
+#include "peci_transport.hpp"
+#include "peci_types.hpp"
+#include "utility/performance_monitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Transactions of higher priority (lower value) are sent first.
+ */
+enum class PeciPriority : uint8_t
+{
+    knob = 0,
+    telemetry
+};
+
+struct PeciSchedulerConfig
+{
+    uint8_t maxRetries;
+    std::chrono::milliseconds retryDelay;
+    size_t maxBusTransactions;
+};
+
+static constexpr PeciSchedulerConfig kPeciSchedulerConfig = {
+    2, std::chrono::milliseconds{1}, 1};
+static constexpr size_t kPeciSchedulerMaxPendingSamples = 1024;
+static constexpr std::chrono::seconds kPeciBusOccupancyWindow{1};
+static constexpr size_t kPeciHostIdOffset = 1;
+static constexpr uint8_t kPeciRetryBit = 0x01;
+
+struct PeciCpuCounters
+{
+    uint64_t transactions = 0;
+    uint64_t coalesced = 0;
+    uint64_t retries = 0;
+    uint64_t failures = 0;
+};
+
+/**
+ * @brief Serializes PECI transactions issued by sensors and knobs from worker
+ * threads.
+ *
+ * Every CPU address has its own queue with at most one transaction on the
+ * bus, and no more than maxBusTransactions are on the bus at once. Queued
+ * knob writes are sent before telemetry of any CPU, within the queue of one
+ * CPU transactions of equal priority are sent in order of arrival. Telemetry
+ * requests identical to one still waiting in the queue are not sent again,
+ * the caller shares the result of the queued one. Requests completed with a
+ * retry completion code are repeated up to maxRetries times with the retry
+ * bit of the host ID byte set.
+ *
+ * Queue latency and duration of every transaction are published to the
+ * PerformanceCollector by publishStatistics(), which must be called from the
+ * io_context thread.
+ */
+class PeciScheduler
+{
+    using SteadyClock = std::chrono::steady_clock;
+
+    struct Transaction
+    {
+        uint8_t address;
+        PeciPriority priority;
+        uint64_t sequence;
+        std::vector<uint8_t> request;
+        std::vector<uint8_t> response;
+        EPECIStatus status = PECI_CC_TIMEOUT;
+        bool finished = false;
+    };
+
+    struct TransactionSample
+    {
+        SteadyClock::duration queueLatency;
+        SteadyClock::duration duration;
+    };
+
+    struct CpuQueue
+    {
+        std::vector<std::shared_ptr<Transaction>> pending;
+        bool busy = false;
+        PeciCpuCounters counters;
+        std::vector<TransactionSample> samples;
+    };
+
+  public:
+    PeciScheduler(const PeciScheduler&) = delete;
+    PeciScheduler& operator=(const PeciScheduler&) = delete;
+    PeciScheduler(PeciScheduler&&) = delete;
+    PeciScheduler& operator=(PeciScheduler&&) = delete;
+
+    explicit PeciScheduler(
+        PeciTransport transportArg = peciRawTransport,
+        const PeciSchedulerConfig& configArg = kPeciSchedulerConfig) :
+        transport(std::move(transportArg)),
+        config(configArg), windowStart(SteadyClock::now())
+    {
+    }
+
+    static PeciScheduler& getInstance()
+    {
+        static PeciScheduler instance;
+        return instance;
+    }
+
+    /**
+     * @brief Replaces the transport, must be called at startup before the
+     * first transaction.
+     */
+    void setTransport(PeciTransport transportArg)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        transport = std::move(transportArg);
+    }
+
+    /**
+     * @brief Sends the request to the CPU at `address` and waits for the
+     * response. Blocks the calling thread, must not be called from the
+     * io_context thread.
+     */
+    EPECIStatus execute(uint8_t address, PeciPriority priority,
+                        const uint8_t* request, size_t requestSize,
+                        uint8_t* response, size_t responseSize)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto& queue = queues[address];
+
+        if (priority == PeciPriority::telemetry)
+        {
+            if (auto queued =
+                    findQueued(queue, request, requestSize, responseSize))
+            {
+                queue.counters.coalesced++;
+                changed.wait(lock, [&queued]() { return queued->finished; });
+                std::copy(queued->response.cbegin(), queued->response.cend(),
+                          response);
+                return queued->status;
+            }
+        }
+
+        auto transaction = std::make_shared<Transaction>();
+        transaction->address = address;
+        transaction->priority = priority;
+        transaction->sequence = nextSequence++;
+        transaction->request.assign(request, request + requestSize);
+        transaction->response.resize(responseSize);
+        queue.pending.push_back(transaction);
+
+        const auto enqueued = SteadyClock::now();
+        changed.wait(lock,
+                     [this, &transaction]() { return isNext(*transaction); });
+        std::erase(queue.pending, transaction);
+        queue.busy = true;
+        busTransactions++;
+        lock.unlock();
+
+        const auto started = SteadyClock::now();
+        const auto retries = transmit(*transaction);
+        const auto finished = SteadyClock::now();
+
+        lock.lock();
+        queue.busy = false;
+        busTransactions--;
+        busyTime += finished - started;
+        queue.counters.transactions++;
+        queue.counters.retries += retries;
+        if (!isSuccess(*transaction))
+        {
+            queue.counters.failures++;
+        }
+        if (queue.samples.size() < kPeciSchedulerMaxPendingSamples)
+        {
+            queue.samples.push_back(
+                {started - enqueued, finished - started});
+        }
+        transaction->finished = true;
+        lock.unlock();
+        changed.notify_all();
+
+        std::copy(transaction->response.cbegin(),
+                  transaction->response.cend(), response);
+        return transaction->status;
+    }
+
+    PeciCpuCounters getCounters(uint8_t address) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = queues.find(address);
+        if (it == queues.cend())
+        {
+            return {};
+        }
+        return it->second.counters;
+    }
+
+    /**
+     * @brief Number of transactions waiting for the bus, not including the
+     * ones on the bus and the coalesced ones.
+     */
+    size_t getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = 0;
+        for (const auto& [address, queue] : queues)
+        {
+            count += queue.pending.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Moves statistics gathered by worker threads to the performance
+     * collector. Must be called from the io_context thread.
+     */
+    void publishStatistics()
+    {
+        std::map<uint8_t, std::vector<TransactionSample>> samples;
+        std::map<uint8_t, PeciCpuCounters> counters;
+        SteadyClock::duration busy{0};
+        SteadyClock::duration window{0};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& [address, queue] : queues)
+            {
+                samples[address].swap(queue.samples);
+                counters[address] = queue.counters;
+            }
+            const auto now = SteadyClock::now();
+            if (now - windowStart >= kPeciBusOccupancyWindow)
+            {
+                window = now - windowStart;
+                busy = busyTime;
+                busyTime = SteadyClock::duration{0};
+                windowStart = now;
+            }
+        }
+
+        auto performance = performanceCollectorWp.lock();
+        if (!performance)
+        {
+            return;
+        }
+        for (const auto& [address, cpuSamples] : samples)
+        {
+            const auto name = "Peci-cpu" + std::to_string(static_cast<int>(
+                                               address -
+                                               PECI_TRANSPORT_CPU0_ADDRESS));
+            auto latency = performance->getMeasure(
+                getMeasureHandle(name + "-queue-latency",
+                                 std::chrono::milliseconds{50}));
+            auto duration = performance->getMeasure(
+                getMeasureHandle(name + "-transaction-duration",
+                                 std::chrono::milliseconds{10}));
+            for (const auto& sample : cpuSamples)
+            {
+                latency->addSample(sample.queueLatency);
+                duration->addSample(sample.duration);
+            }
+            const auto& cpuCounters = counters[address];
+            performance->setGauge(
+                name + "-retries", static_cast<double>(cpuCounters.retries));
+            performance->setGauge(name + "-coalesced",
+                                  static_cast<double>(cpuCounters.coalesced));
+            performance->setGauge(name + "-failures",
+                                  static_cast<double>(cpuCounters.failures));
+        }
+        if (window.count() > 0)
+        {
+            performance->setGauge(
+                "Peci-bus-occupancy[%]",
+                100.0 * static_cast<double>(busy.count()) /
+                    static_cast<double>(window.count()));
+        }
+    }
+
+  private:
+    PeciTransport transport;
+    const PeciSchedulerConfig config;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::map<uint8_t, CpuQueue> queues;
+    uint64_t nextSequence = 0;
+    size_t busTransactions = 0;
+    SteadyClock::duration busyTime{0};
+    SteadyClock::time_point windowStart;
+    std::map<std::string, MeasureHandle> measureHandles;
+
+    static bool isSuccess(const Transaction& transaction)
+    {
+        return transaction.status == PECI_CC_SUCCESS &&
+               !transaction.response.empty() &&
+               transaction.response[0] == COMPLETION_CODE_SUCCESS;
+    }
+
+    static bool needsRetry(const Transaction& transaction)
+    {
+        return transaction.status == PECI_CC_SUCCESS &&
+               !transaction.response.empty() &&
+               (transaction.response[0] == COMPLETION_CODE_NEED_RETRY ||
+                transaction.response[0] == COMPLETION_CODE_OUT_OF_RESOURCES);
+    }
+
+    /**
+     * @brief Returns telemetry transaction with the same request waiting in
+     * the queue. Must be called with mutex locked.
+     */
+    static std::shared_ptr<Transaction> findQueued(const CpuQueue& queue,
+                                                   const uint8_t* request,
+                                                   size_t requestSize,
+                                                   size_t responseSize)
+    {
+        const auto it = std::find_if(
+            queue.pending.cbegin(), queue.pending.cend(),
+            [request, requestSize, responseSize](const auto& queued) {
+                return queued->priority == PeciPriority::telemetry &&
+                       queued->response.size() == responseSize &&
+                       std::equal(queued->request.cbegin(),
+                                  queued->request.cend(), request,
+                                  request + requestSize);
+            });
+        return it != queue.pending.cend() ? *it : nullptr;
+    }
+
+    /**
+     * @brief Checks if the transaction can be sent now, that is no
+     * transaction of higher priority waits in an idle queue and none of the
+     * same priority arrived earlier to the queue of the same CPU. Must be
+     * called with mutex locked.
+     */
+    bool isNext(const Transaction& transaction) const
+    {
+        if (busTransactions >= config.maxBusTransactions ||
+            queues.at(transaction.address).busy)
+        {
+            return false;
+        }
+        for (const auto& [address, queue] : queues)
+        {
+            if (queue.busy)
+            {
+                continue;
+            }
+            for (const auto& pending : queue.pending)
+            {
+                if (pending->priority < transaction.priority ||
+                    (address == transaction.address &&
+                     pending->priority == transaction.priority &&
+                     pending->sequence < transaction.sequence))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sends the transaction, repeating it when the CPU asks for a
+     * retry. Repeated requests have the retry bit set in the host ID byte
+     * following the command code, so the CPU does not execute a write twice.
+     * Returns the number of retries.
+     */
+    uint8_t transmit(Transaction& transaction)
+    {
+        uint8_t retries = 0;
+        while (true)
+        {
+            std::fill(transaction.response.begin(), transaction.response.end(),
+                      0);
+            transaction.status = transport(
+                transaction.address, transaction.request, transaction.response);
+            if (!needsRetry(transaction) || retries >= config.maxRetries)
+            {
+                return retries;
+            }
+            retries++;
+            if (transaction.request.size() > kPeciHostIdOffset)
+            {
+                transaction.request[kPeciHostIdOffset] |= kPeciRetryBit;
+            }
+            std::this_thread::sleep_for(config.retryDelay);
+        }
+    }
+
+    const MeasureHandle& getMeasureHandle(const std::string& name,
+                                          Clock::duration threshold)
+    {
+        auto it = measureHandles.find(name);
+        if (it == measureHandles.end())
+        {
+            it = measureHandles.emplace(name, MeasureHandle(name, threshold))
+                     .first;
+        }
+        return it->second;
+    }
+};
+
+} // namespace nodemanager
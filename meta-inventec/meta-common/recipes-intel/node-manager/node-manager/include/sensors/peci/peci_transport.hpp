@@ -0,0 +1,504 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "loggers/log.hpp"
+#include "peci_types.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "peci.h"
+
+namespace nodemanager
+{
+
+/**
+ * @brief Sends a single raw PECI request to the CPU at `address`. Response
+ * is sized to the expected length before the call.
+ */
+using PeciTransport =
+    std::function<EPECIStatus(uint8_t address, const std::vector<uint8_t>&,
+                              std::vector<uint8_t>&)>;
+
+inline EPECIStatus peciRawTransport([[maybe_unused]] uint8_t address,
+                                    [[maybe_unused]] const std::vector<uint8_t>&
+                                        request,
+                                    [[maybe_unused]] std::vector<uint8_t>&
+                                        response)
+{
+#ifdef ENABLE_PECI
+    return peci_raw(address, static_cast<uint8_t>(response.size()),
+                    request.data(), static_cast<uint8_t>(request.size()),
+                    response.data(), static_cast<uint8_t>(response.size()));
+#else  // ENABLE_PECI
+    return EPECIStatus::PECI_CC_TIMEOUT;
+#endif // ENABLE_PECI
+}
+
+struct PeciTraceRecord
+{
+    uint8_t address;
+    EPECIStatus status;
+    std::vector<uint8_t> request;
+    std::vector<uint8_t> response;
+    std::chrono::microseconds latency;
+};
+
+/**
+ * @brief Binary file with PECI transactions, the same format is used by
+ * CupsService.
+ *
+ * File starts with a header holding magic and format version, followed by
+ * records encoded as:
+ * | address (u8) | status (u8) | request size (u8) | response size (u8) |
+ * | latency in us (u32) | request | response |
+ * All integers are little endian.
+ *
+ * CupsService has its own copy of this code in
+ * cups/src/peci/transport/transport.cpp, any change of the format must be
+ * made in both and kVersion increased, so traces of one service can still be
+ * replayed by the other.
+ */
+class PeciTraceFile
+{
+  public:
+    static constexpr std::string_view kMagic = "PECT";
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderSize = kMagic.size() + 4;
+    static constexpr size_t kRecordHeaderSize = 8;
+
+    static std::string encodeHeader()
+    {
+        std::string header(kMagic);
+        putInt(header, kVersion, 2);
+        putInt(header, 0, 2);
+        return header;
+    }
+
+    static std::string encodeRecord(const PeciTraceRecord& record)
+    {
+        std::string encoded;
+        putInt(encoded, record.address, 1);
+        putInt(encoded, static_cast<uint32_t>(record.status), 1);
+        putInt(encoded, static_cast<uint32_t>(record.request.size()), 1);
+        putInt(encoded, static_cast<uint32_t>(record.response.size()), 1);
+        putInt(encoded, static_cast<uint32_t>(record.latency.count()), 4);
+        encoded.append(record.request.cbegin(), record.request.cend());
+        encoded.append(record.response.cbegin(), record.response.cend());
+        return encoded;
+    }
+
+    /**
+     * @brief Reads all records, stops at the first incomplete one. Returns
+     * std::nullopt when the file cannot be read or has unknown header.
+     */
+    static std::optional<std::vector<PeciTraceRecord>>
+        load(const std::filesystem::path& filePath)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file)
+        {
+            return std::nullopt;
+        }
+        const std::string content{std::istreambuf_iterator<char>(file),
+                                  std::istreambuf_iterator<char>()};
+        if (content.size() < kHeaderSize ||
+            content.compare(0, kMagic.size(), kMagic) != 0 ||
+            getInt(content, kMagic.size(), 2) != kVersion)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<PeciTraceRecord> records;
+        size_t offset = kHeaderSize;
+        while (content.size() - offset >= kRecordHeaderSize)
+        {
+            const size_t requestSize = getInt(content, offset + 2, 1);
+            const size_t responseSize = getInt(content, offset + 3, 1);
+            const size_t dataOffset = offset + kRecordHeaderSize;
+            if (content.size() - dataOffset < requestSize + responseSize)
+            {
+                break;
+            }
+            PeciTraceRecord& record = records.emplace_back();
+            record.address = static_cast<uint8_t>(getInt(content, offset, 1));
+            record.status =
+                static_cast<EPECIStatus>(getInt(content, offset + 1, 1));
+            record.latency =
+                std::chrono::microseconds{getInt(content, offset + 4, 4)};
+            record.request.assign(content.cbegin() + dataOffset,
+                                  content.cbegin() + dataOffset + requestSize);
+            record.response.assign(
+                content.cbegin() + dataOffset + requestSize,
+                content.cbegin() + dataOffset + requestSize + responseSize);
+            offset = dataOffset + requestSize + responseSize;
+        }
+        return records;
+    }
+
+  private:
+    static void putInt(std::string& out, uint32_t value, size_t bytes)
+    {
+        for (size_t idx = 0; idx < bytes; ++idx)
+        {
+            out.push_back(static_cast<char>((value >> (8 * idx)) & 0xff));
+        }
+    }
+
+    static uint32_t getInt(std::string_view in, size_t offset, size_t bytes)
+    {
+        uint32_t value = 0;
+        for (size_t idx = 0; idx < bytes; ++idx)
+        {
+            value |= static_cast<uint32_t>(
+                         static_cast<uint8_t>(in[offset + idx]))
+                     << (8 * idx);
+        }
+        return value;
+    }
+};
+
+/**
+ * @brief Passes transactions to the inner transport and appends them with
+ * their latency to a trace file, which is truncated when recording starts.
+ */
+class PeciTraceRecorder
+{
+  public:
+    PeciTraceRecorder(PeciTransport innerArg,
+                      const std::filesystem::path& filePath) :
+        inner(std::move(innerArg)),
+        file(filePath, std::ios::binary | std::ios::trunc)
+    {
+        if (!file)
+        {
+            Logger::log<LogLevel::error>("Cannot open PECI trace file %s",
+                                         filePath.c_str());
+        }
+        file << PeciTraceFile::encodeHeader();
+        file.flush();
+    }
+
+    EPECIStatus operator()(uint8_t address, const std::vector<uint8_t>& request,
+                           std::vector<uint8_t>& response)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        const auto status = inner(address, request, response);
+        const auto latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        file << PeciTraceFile::encodeRecord(
+            {address, status, request, response, latency});
+        file.flush();
+        return status;
+    }
+
+  private:
+    PeciTransport inner;
+    std::mutex mutex;
+    std::ofstream file;
+};
+
+/**
+ * @brief Serves responses from a trace file. Identical requests are answered
+ * with their recorded responses in the recorded order, starting over when all
+ * have been used. Each response is delayed by its recorded latency multiplied
+ * by timeScale, 0 disables the delay. Requests missing in the trace time out.
+ */
+class PeciTraceReplayer
+{
+    using Key = std::tuple<uint8_t, std::vector<uint8_t>, size_t>;
+
+    struct Responses
+    {
+        std::vector<PeciTraceRecord> records;
+        size_t next = 0;
+    };
+
+  public:
+    PeciTraceReplayer(const std::vector<PeciTraceRecord>& recordsArg,
+                      double timeScaleArg) :
+        timeScale(timeScaleArg)
+    {
+        for (const auto& record : recordsArg)
+        {
+            responses[{record.address, record.request, record.response.size()}]
+                .records.push_back(record);
+        }
+    }
+
+    EPECIStatus operator()(uint8_t address, const std::vector<uint8_t>& request,
+                           std::vector<uint8_t>& response)
+    {
+        std::optional<PeciTraceRecord> record;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto it =
+                responses.find({address, request, response.size()});
+            if (it != responses.end())
+            {
+                auto& entry = it->second;
+                record = entry.records[entry.next];
+                entry.next = (entry.next + 1) % entry.records.size();
+            }
+        }
+        if (!record)
+        {
+            Logger::log<LogLevel::debug>(
+                "No recorded PECI response for address 0x%x",
+                unsigned{address});
+            return EPECIStatus::PECI_CC_TIMEOUT;
+        }
+        if (timeScale > 0)
+        {
+            std::this_thread::sleep_for(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    record->latency * timeScale));
+        }
+        response = record->response;
+        return record->status;
+    }
+
+  private:
+    double timeScale;
+    std::mutex mutex;
+    std::map<Key, Responses> responses;
+};
+
+/**
+ * @brief Answers like a platform with cpuCount Sapphire Rapids CPUs, 56
+ * cores each. Activity counters advance with a load slowly oscillating
+ * around 50%, shifted in phase for every CPU. Writes always succeed and reads
+ * not simulated return zeros.
+ */
+class PeciSynthesizer
+{
+    static constexpr uint32_t kCpuId = 0x000806F0;
+    static constexpr uint8_t kNonTurboRatio = 20;
+    static constexpr uint8_t kTurboRatio = 35;
+    static constexpr uint8_t kMinOperatingRatio = 8;
+    static constexpr uint32_t kCoreMaskLow = 0xFFFFFFFF;
+    static constexpr uint32_t kCoreMaskHigh = 0x00FFFFFF;
+    static constexpr double kCores = 56;
+    static constexpr double kLoadPeriodS = 60;
+
+    enum Command : uint8_t
+    {
+        rdPkgConfig = 0xA1,
+        rdEndpointConfig = 0xC1
+    };
+
+  public:
+    explicit PeciSynthesizer(uint8_t cpuCountArg) :
+        cpuCount(cpuCountArg), started(std::chrono::steady_clock::now())
+    {
+    }
+
+    EPECIStatus operator()(uint8_t address, const std::vector<uint8_t>& request,
+                           std::vector<uint8_t>& response)
+    {
+        const int cpu = address - PECI_TRANSPORT_CPU0_ADDRESS;
+        if (cpu < 0 || cpu >= cpuCount || request.empty() || response.empty())
+        {
+            return EPECIStatus::PECI_CC_TIMEOUT;
+        }
+        std::fill(response.begin(), response.end(), 0);
+        response[0] = COMPLETION_CODE_SUCCESS;
+
+        if (request[0] == rdPkgConfig && request.size() >= 5)
+        {
+            const uint16_t param =
+                static_cast<uint16_t>(request[3] | (request[4] << 8));
+            readPkgConfig(cpu, request[2], param, response);
+        }
+        else if (request[0] == rdEndpointConfig && request.size() >= 12)
+        {
+            const uint32_t reg =
+                static_cast<uint32_t>(request[8] | (request[9] << 8)) & 0xFFF;
+            readPciLocal(reg, response);
+        }
+        return EPECIStatus::PECI_CC_SUCCESS;
+    }
+
+  private:
+    int cpuCount;
+    std::chrono::steady_clock::time_point started;
+
+    /**
+     * @brief Busy time in seconds accumulated by a single core since start.
+     */
+    double busyTime(int cpu) const
+    {
+        const double t = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - started)
+                             .count();
+        const double omega = 2 * M_PI / kLoadPeriodS;
+        const double phase = static_cast<double>(cpu);
+        return 0.5 * t +
+               0.3 / omega * (std::cos(phase) - std::cos(omega * t + phase));
+    }
+
+    static void put(std::vector<uint8_t>& response, size_t offset,
+                    uint64_t value, size_t bytes)
+    {
+        for (size_t idx = 0; idx < bytes && offset + idx < response.size();
+             ++idx)
+        {
+            response[offset + idx] =
+                static_cast<uint8_t>((value >> (8 * idx)) & 0xff);
+        }
+    }
+
+    void readPkgConfig(int cpu, uint8_t index, uint16_t param,
+                       std::vector<uint8_t>& response) const
+    {
+        switch (index)
+        {
+            case 0:
+                put(response, 1, param == 0 ? kCpuId : 1, 4);
+                break;
+            case 0x06:
+                put(response, 1, static_cast<uint64_t>(busyTime(cpu) * 1e6),
+                    8);
+                break;
+            case 0x1F:
+                put(response, 1,
+                    static_cast<uint64_t>(busyTime(cpu) * kCores *
+                                          kNonTurboRatio * 100e6),
+                    8);
+                break;
+            case 49:
+                put(response, 1, 0x01010101ull * kTurboRatio, 4);
+                break;
+            case 50:
+                put(response, 1, kTurboRatio, 1);
+                break;
+            default:
+                break;
+        }
+    }
+
+    static void readPciLocal(uint32_t reg, std::vector<uint8_t>& response)
+    {
+        switch (reg)
+        {
+            case 0x80:
+                put(response, 1, kCoreMaskLow, 4);
+                break;
+            case 0x84:
+                put(response, 1, kCoreMaskHigh, 4);
+                break;
+            case 0x94:
+                put(response, 1, 1u << 26, 4);
+                break;
+            case 0xA8:
+                put(response, 2, kNonTurboRatio, 1);
+                break;
+            case 0xAC:
+                put(response, 2, kNonTurboRatio, 1);
+                put(response, 3, kMinOperatingRatio, 1);
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+enum class PeciTransportMode
+{
+    hardware,
+    record,
+    replay,
+    synthetic
+};
+
+struct PeciTransportOptions
+{
+    PeciTransportMode mode = PeciTransportMode::hardware;
+    std::filesystem::path traceFile = "/tmp/node-manager-peci.trace";
+    double timeScale = 1.0;
+    uint8_t cpuCount = 2;
+};
+
+/**
+ * @brief Creates transport selected at startup. Returns std::nullopt when the
+ * replay trace cannot be read.
+ */
+inline std::optional<PeciTransport>
+    makePeciTransport(const PeciTransportOptions& options)
+{
+    switch (options.mode)
+    {
+        case PeciTransportMode::record:
+        {
+            auto recorder = std::make_shared<PeciTraceRecorder>(
+                peciRawTransport, options.traceFile);
+            return [recorder](uint8_t address,
+                              const std::vector<uint8_t>& request,
+                              std::vector<uint8_t>& response) {
+                return (*recorder)(address, request, response);
+            };
+        }
+        case PeciTransportMode::replay:
+        {
+            const auto records = PeciTraceFile::load(options.traceFile);
+            if (!records)
+            {
+                Logger::log<LogLevel::error>(
+                    "Cannot read PECI trace file %s",
+                    options.traceFile.c_str());
+                return std::nullopt;
+            }
+            auto replayer = std::make_shared<PeciTraceReplayer>(
+                *records, options.timeScale);
+            return [replayer](uint8_t address,
+                              const std::vector<uint8_t>& request,
+                              std::vector<uint8_t>& response) {
+                return (*replayer)(address, request, response);
+            };
+        }
+        case PeciTransportMode::synthetic:
+        {
+            auto synthesizer =
+                std::make_shared<PeciSynthesizer>(options.cpuCount);
+            return [synthesizer](uint8_t address,
+                                 const std::vector<uint8_t>& request,
+                                 std::vector<uint8_t>& response) {
+                return (*synthesizer)(address, request, response);
+            };
+        }
+        default:
+            return peciRawTransport;
+    }
+}
+
+} // namespace nodemanager
@@ -27,6 +27,8 @@ namespace nodemanager
 {
 
 constexpr unsigned COMPLETION_CODE_SUCCESS = 0x40;
+constexpr unsigned COMPLETION_CODE_NEED_RETRY = 0x80;
+constexpr unsigned COMPLETION_CODE_OUT_OF_RESOURCES = 0x81;
 constexpr auto PECI_TRANSPORT_CPU0_ADDRESS = 0x30;
 static constexpr uint8_t turboRatioCoreCount = 4U;
 
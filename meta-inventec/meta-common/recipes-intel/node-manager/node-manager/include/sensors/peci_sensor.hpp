@@ -22,6 +22,7 @@
 #include "peci/peci_types.hpp"
 #include "sensor.hpp"
 #include "sensor_readings_manager.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
 
@@ -50,8 +51,9 @@ class PeciSensor : public Sensor
 
     void run() override final
     {
-        auto perf =
-            Perf("SensorSet-peci-run-duration", std::chrono::milliseconds{10});
+        static const MeasureHandle perfHandle(
+            "SensorSet-peci-run-duration", std::chrono::milliseconds{10});
+        auto perf = Perf(perfHandle);
 
         std::vector<std::optional<uint32_t>> cpuIds(maxCpuNumber, std::nullopt);
         for (DeviceIndex cpuIndex = 0; cpuIndex < maxCpuNumber; cpuIndex++)
@@ -109,8 +111,8 @@ class PeciSensor : public Sensor
             {
                 futureSamples.insert_or_assign(
                     key,
-                    std::async(
-                        std::launch::async,
+                    WorkerPool::getInstance().submit(
+                        WorkerQueue::peci,
                         [key, cpuIds,
                          peciIf = peciCommands]() -> std::optional<ValueType> {
                             auto& [idx, sensorType] = key;
@@ -26,8 +26,13 @@
 
 namespace nodemanager
 {
+/**
+ * @brief Callback invoked synchronously on every status transition. It must not
+ * call back into the sensor reading, SensorReadingsManager only queues the
+ * event and delivers it to consumers at the end of the sensor phase.
+ */
 using SensorReadingEventCallback = std::function<void(
-    SensorEventType eventType, std::shared_ptr<SensorReadingIf> sensorReading)>;
+    SensorEventType eventType, const SensorReadingIf& sensorReading)>;
 
 static const std::unordered_map<
     std::pair<SensorReadingStatus, SensorReadingStatus>,
@@ -48,8 +53,7 @@ static const std::unordered_map<
          {SensorEventType::readingMissing}},
 };
 
-class SensorReading : public SensorReadingIf,
-                      public std::enable_shared_from_this<SensorReading>
+class SensorReading : public SensorReadingIf
 {
   public:
     SensorReading(
@@ -101,7 +105,7 @@ class SensorReading : public SensorReadingIf,
             {
                 for (SensorEventType event : it->second)
                 {
-                    eventCallback(event, shared_from_this());
+                    eventCallback(event, *this);
                 }
             }
         }
@@ -116,6 +120,12 @@ class SensorReading : public SensorReadingIf,
     void updateValue(ValueType newValue)
     {
         value = newValue;
+        updateTimestamp = Clock::now();
+    }
+
+    Clock::time_point getUpdateTimestamp() const override
+    {
+        return updateTimestamp;
     }
 
     SensorReadingType getSensorReadingType() const override
@@ -130,6 +140,7 @@ class SensorReading : public SensorReadingIf,
 
   private:
     ValueType value{std::numeric_limits<double>::quiet_NaN()};
+    Clock::time_point updateTimestamp{};
     SensorReadingType sensorReadingType;
     DeviceIndex deviceIndex;
     SensorReadingEventCallback eventCallback;
@@ -145,18 +156,14 @@ class SensorReading : public SensorReadingIf,
         switch (newStatus)
         {
             case SensorReadingStatus::unavailable:
-                eventCallback(SensorEventType::sensorDisappear,
-                              shared_from_this());
+                eventCallback(SensorEventType::sensorDisappear, *this);
                 break;
             case SensorReadingStatus::invalid:
-                eventCallback(SensorEventType::sensorAppear,
-                              shared_from_this());
+                eventCallback(SensorEventType::sensorAppear, *this);
                 break;
             case SensorReadingStatus::valid:
-                eventCallback(SensorEventType::sensorAppear,
-                              shared_from_this());
-                eventCallback(SensorEventType::readingAvailable,
-                              shared_from_this());
+                eventCallback(SensorEventType::sensorAppear, *this);
+                eventCallback(SensorEventType::readingAvailable, *this);
                 break;
             default:
                 throw std::logic_error("Unsupported sensor reading status");
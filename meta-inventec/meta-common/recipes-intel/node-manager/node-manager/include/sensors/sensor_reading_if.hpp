@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "common_types.hpp"
 #include "devices_manager/gpio_provider.hpp"
 #include "nlohmann/json.hpp"
@@ -105,6 +106,13 @@ class SensorReadingIf
      */
     virtual void updateValue(ValueType newValue) = 0;
 
+    /**
+     * @brief Get the time of the last value update
+     *
+     * @return Clock::time_point
+     */
+    virtual Clock::time_point getUpdateTimestamp() const = 0;
+
     /**
      * @brief Get the Sensor Reading Type object
      *
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace nodemanager
 {
 
@@ -64,6 +66,13 @@ enum class SensorReadingType
     cpuDieMask,
 };
 
+/**
+ * @brief Number of SensorReadingType values, must be updated when a new type
+ * is appended to the enum.
+ */
+static constexpr size_t kSensorReadingTypesCount =
+    static_cast<size_t>(SensorReadingType::cpuDieMask) + 1;
+
 enum class SmartStatusType
 {
     uninitialized,
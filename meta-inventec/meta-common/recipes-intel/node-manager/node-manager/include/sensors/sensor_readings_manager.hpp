@@ -23,13 +23,18 @@
 #include "sensor_reading_if.hpp"
 #include "sensor_reading_type.hpp"
 #include "sensors/sensor_reading_type.hpp"
+#include "sensors/sensor_snapshot.hpp"
+#include "utility/devices_configuration.hpp"
 #include "utility/enum_to_string.hpp"
 
+#include <array>
+#include <atomic>
 #include <boost/range/adaptors.hpp>
 #include <iostream>
+#include <map>
 #include <ranges>
 #include <sstream>
-#include <unordered_map>
+#include <vector>
 
 namespace nodemanager
 {
@@ -45,6 +50,12 @@ class SensorReadingsManagerIf : public ReadingEventDispatcherIf
 
     virtual void deleteSensorReading(SensorReadingType type) = 0;
 
+    virtual void dispatchEvents() = 0;
+
+    virtual void publishSnapshot() = 0;
+
+    virtual const SensorSnapshot& getSnapshot() const = 0;
+
     virtual bool forEachSensorReading(
         SensorReadingType sensorReadingType, DeviceIndex deviceIndex,
         std::function<void(SensorReadingIf&)>&& action) = 0;
@@ -63,9 +74,54 @@ class SensorReadingsManagerIf : public ReadingEventDispatcherIf
     virtual bool isGpuPowerStateOn() const = 0;
 };
 
-class SensorReadingsManager
-    : public SensorReadingsManagerIf,
-      public std::enable_shared_from_this<SensorReadingsManager>
+/**
+ * @brief Returns expected number of devices for the sensor reading type. It
+ * is used only to preallocate storage, readings with higher device indexes
+ * are still accepted.
+ */
+constexpr DeviceIndex getExpectedDevicesCount(SensorReadingType type)
+{
+    switch (type)
+    {
+        case SensorReadingType::cpuPackagePower:
+        case SensorReadingType::cpuPackagePowerCapabilitiesMin:
+        case SensorReadingType::cpuPackagePowerCapabilitiesMax:
+        case SensorReadingType::cpuPackagePowerLimit:
+        case SensorReadingType::cpuEnergy:
+        case SensorReadingType::cpuEfficiency:
+        case SensorReadingType::cpuAverageFrequency:
+        case SensorReadingType::cpuUtilization:
+        case SensorReadingType::cpuPackageId:
+        case SensorReadingType::cpuDieMask:
+        case SensorReadingType::dramPower:
+        case SensorReadingType::dramPackagePowerCapabilitiesMax:
+        case SensorReadingType::dramPowerLimit:
+        case SensorReadingType::dramEnergy:
+        case SensorReadingType::prochotRatioCapabilitiesMin:
+        case SensorReadingType::prochotRatioCapabilitiesMax:
+        case SensorReadingType::turboRatioCapabilitiesMin:
+        case SensorReadingType::turboRatioCapabilitiesMax:
+            return kMaxCpuNumber;
+        case SensorReadingType::pciePower:
+        case SensorReadingType::pciePowerPldm:
+        case SensorReadingType::pciePowerLimitPldm:
+        case SensorReadingType::pciePowerCapabilitiesMaxPldm:
+        case SensorReadingType::pciePowerCapabilitiesMinPldm:
+            return kMaxPcieNumber;
+        case SensorReadingType::acPlatformPower:
+        case SensorReadingType::acPlatformPowerCapabilitiesMax:
+        case SensorReadingType::dcPlatformPowerPsu:
+        case SensorReadingType::dcPlatformPowerCapabilitiesMaxPsu:
+            return kMaxPsuNumber;
+        case SensorReadingType::gpioState:
+            // Number of GPIO lines is known only at runtime
+            return 0;
+        default:
+            return kMaxPlatformNumber;
+    }
+}
+
+class SensorReadingsManager : public SensorReadingsManagerIf
 {
   public:
     SensorReadingsManager(const SensorReadingsManager&) = delete;
@@ -73,15 +129,29 @@ class SensorReadingsManager
     SensorReadingsManager(SensorReadingsManager&&) = delete;
     SensorReadingsManager& operator=(SensorReadingsManager&&) = delete;
 
-    SensorReadingsManager()
+    SensorReadingsManager() :
+        pendingEvents(std::make_shared<std::vector<PendingEvent>>()),
+        eventCallback([events = pendingEvents](
+                          SensorEventType eventType,
+                          const SensorReadingIf& sensorReading) {
+            events->push_back({eventType,
+                               {sensorReading.getSensorReadingType(),
+                                sensorReading.getDeviceIndex()}});
+        })
     {
+        for (size_t idx = 0; idx < kSensorReadingTypesCount; ++idx)
+        {
+            allSensorReadings[idx].reserve(
+                getExpectedDevicesCount(static_cast<SensorReadingType>(idx)));
+        }
     }
 
     virtual ~SensorReadingsManager() = default;
 
     bool isCpuAvailable(const DeviceIndex idx) const final
     {
-        auto sensor = getSensorReading(SensorReadingType::cpuPackagePower, idx);
+        const auto& sensor =
+            findSensorReading(SensorReadingType::cpuPackagePower, idx);
         if (!sensor || sensor->getStatus() == SensorReadingStatus::unavailable)
         {
             return false;
@@ -98,8 +168,9 @@ class SensorReadingsManager
      */
     bool isPowerStateOn() const final
     {
-        if (auto sensor = getAvailableAndValueValidSensorReading(
-                SensorReadingType::powerState, 0))
+        const auto& sensor =
+            findSensorReading(SensorReadingType::powerState, 0);
+        if (sensor && sensor->isGood())
         {
             const auto v = sensor->getValue();
             if (const PowerStateType* s = std::get_if<PowerStateType>(&v))
@@ -124,8 +195,9 @@ class SensorReadingsManager
      */
     bool isGpuPowerStateOn() const final
     {
-        if (auto sensor = getAvailableAndValueValidSensorReading(
-                SensorReadingType::gpuPowerState, 0))
+        const auto& sensor =
+            findSensorReading(SensorReadingType::gpuPowerState, 0);
+        if (sensor && sensor->isGood())
         {
             const auto v = sensor->getValue();
             if (const GpuPowerState* s = std::get_if<GpuPowerState>(&v))
@@ -146,13 +218,128 @@ class SensorReadingsManager
         std::shared_ptr<ReadingConsumer> readingConsumer, ReadingType type,
         DeviceIndex deviceIndex = kAllDevices) final
     {
-        readingConsumers[readingConsumer] = {type, deviceIndex};
+        unregisterReadingConsumer(readingConsumer);
+        subscriptions[static_cast<size_t>(
+                          mapReadingTypeToSensorReadingType(type))][deviceIndex]
+            .push_back({readingConsumer, {type, deviceIndex}});
     }
 
     virtual void unregisterReadingConsumer(
         std::shared_ptr<ReadingConsumer> readingConsumer) final
     {
-        readingConsumers.erase(readingConsumer);
+        for (auto& subscriptionsByDevice : subscriptions)
+        {
+            for (auto& [deviceIndex, consumers] : subscriptionsByDevice)
+            {
+                if (dispatching)
+                {
+                    // Removal is deferred, so dispatch does not skip consumers
+                    for (auto& subscription : consumers)
+                    {
+                        if (subscription.consumer == readingConsumer)
+                        {
+                            subscription.consumer = nullptr;
+                            subscriptionsRemoved = true;
+                        }
+                    }
+                    continue;
+                }
+                std::erase_if(consumers, [&readingConsumer](
+                                             const Subscription& subscription) {
+                    return subscription.consumer == readingConsumer;
+                });
+            }
+        }
+    }
+
+    /**
+     * @brief Delivers events queued by sensor readings since the previous call
+     * to consumers subscribed for the sensor reading type and either its
+     * device index or kAllDevices. Called once at the end of the sensor phase.
+     */
+    void dispatchEvents() final
+    {
+        std::vector<PendingEvent> events;
+        events.swap(*pendingEvents);
+        dispatching = true;
+        for (const auto& [eventType, sensorCtx] : events)
+        {
+            Logger::log<LogLevel::debug>(
+                "Sensor event %d from SensorReadingType: %d, deviceIndex: %d",
+                std::underlying_type_t<SensorEventType>(eventType),
+                std::underlying_type_t<SensorReadingType>(sensorCtx.type),
+                unsigned{sensorCtx.deviceIndex});
+            auto& subscriptionsByDevice =
+                subscriptions[static_cast<size_t>(sensorCtx.type)];
+            for (const DeviceIndex deviceIndex :
+                 {sensorCtx.deviceIndex, kAllDevices})
+            {
+                const auto it = subscriptionsByDevice.find(deviceIndex);
+                if (it == subscriptionsByDevice.end())
+                {
+                    continue;
+                }
+                // Consumers may (un)register while handling the event
+                const auto& consumers = it->second;
+                for (size_t idx = 0; idx < consumers.size(); ++idx)
+                {
+                    const auto subscription = consumers[idx];
+                    if (subscription.consumer)
+                    {
+                        subscription.consumer->reportEvent(
+                            eventType, sensorCtx, subscription.readingCtx);
+                    }
+                }
+            }
+        }
+        dispatching = false;
+        if (std::exchange(subscriptionsRemoved, false))
+        {
+            for (auto& subscriptionsByDevice : subscriptions)
+            {
+                for (auto& [deviceIndex, consumers] : subscriptionsByDevice)
+                {
+                    std::erase_if(consumers,
+                                  [](const Subscription& subscription) {
+                                      return !subscription.consumer;
+                                  });
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Copies all sensor readings into the back snapshot buffer and
+     * makes it the one returned by getSnapshot(). Called once at the end of
+     * the sensor phase, so all control phases of the cycle work on the same
+     * values even if sensors are updated in the meantime.
+     */
+    void publishSnapshot() final
+    {
+        const size_t back = 1 - frontSnapshot.load(std::memory_order_relaxed);
+        auto& snapshot = snapshots[back];
+        snapshot.clear();
+        for (const auto& sensorReadings : allSensorReadings)
+        {
+            for (const auto& sensorReading : sensorReadings)
+            {
+                if (sensorReading)
+                {
+                    snapshot.add(*sensorReading);
+                }
+            }
+        }
+        snapshot.finalize();
+        frontSnapshot.store(back, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns the most recently published snapshot, which is empty
+     * until publishSnapshot() is called for the first time.
+     */
+    const SensorSnapshot& getSnapshot() const final
+    {
+        return snapshots[frontSnapshot.load(std::memory_order_acquire)];
     }
 
     /**
@@ -166,41 +353,7 @@ class SensorReadingsManager
     std::shared_ptr<SensorReadingIf>
         createSensorReading(SensorReadingType type, DeviceIndex deviceIndex)
     {
-        if (eventCallback == nullptr)
-        {
-            eventCallback =
-                [weakSelf = this->weak_from_this()](
-                    SensorEventType eventType,
-                    std::shared_ptr<SensorReadingIf> sensorReading) {
-                    Logger::log<LogLevel::debug>(
-                        "Sensor event %d from SensorReadingType: %d, "
-                        "deviceIndex: %d",
-                        std::underlying_type_t<SensorEventType>(eventType),
-                        std::underlying_type_t<SensorReadingType>(
-                            sensorReading->getSensorReadingType()),
-                        unsigned{sensorReading->getDeviceIndex()});
-                    SensorContext sensorCtx = {
-                        sensorReading->getSensorReadingType(),
-                        sensorReading->getDeviceIndex()};
-                    if (auto self = weakSelf.lock())
-                    {
-                        for (const auto& [consumer, readingCtx] :
-                             self->readingConsumers)
-                        {
-                            if ((readingCtx.deviceIndex == kAllDevices ||
-                                 sensorCtx.deviceIndex ==
-                                     readingCtx.deviceIndex) &&
-                                mapReadingTypeToSensorReadingType(
-                                    readingCtx.type) == sensorCtx.type)
-                            {
-                                consumer->reportEvent(eventType, sensorCtx,
-                                                      readingCtx);
-                            }
-                        }
-                    }
-                };
-        }
-        if (deviceIndex == kAllDevices || getSensorReading(type, deviceIndex))
+        if (deviceIndex == kAllDevices || findSensorReading(type, deviceIndex))
         {
             std::ostringstream msg;
             msg << "Sensor Reading with the provided type and index: "
@@ -210,7 +363,12 @@ class SensorReadingsManager
             throw std::runtime_error(msg.str());
         }
 
-        return allSensorReadings[type][deviceIndex] =
+        auto& sensorReadings = getSensorReadings(type);
+        if (sensorReadings.size() <= deviceIndex)
+        {
+            sensorReadings.resize(deviceIndex + 1);
+        }
+        return sensorReadings[deviceIndex] =
                    std::make_shared<SensorReading>(type, deviceIndex,
                                                    eventCallback);
     }
@@ -223,7 +381,7 @@ class SensorReadingsManager
      */
     void deleteSensorReading(SensorReadingType type)
     {
-        allSensorReadings.erase(type);
+        getSensorReadings(type).clear();
     }
 
     /**
@@ -240,19 +398,26 @@ class SensorReadingsManager
                               DeviceIndex deviceIndex,
                               std::function<void(SensorReadingIf&)>&& action)
     {
-        bool anySensorFound = false;
+        if (deviceIndex != kAllDevices)
+        {
+            const auto& sensorReading =
+                findSensorReading(sensorReadingType, deviceIndex);
+            if (sensorReading)
+            {
+                action(*sensorReading);
+            }
+            return sensorReading != nullptr;
+        }
 
-        for (auto& [index, sensorReadingHandle] :
-             allSensorReadings[sensorReadingType])
+        bool anySensorFound = false;
+        for (const auto& sensorReading : getSensorReadings(sensorReadingType))
         {
-            SensorReadingIf& sensorReading = *sensorReadingHandle;
-            if (index == deviceIndex || deviceIndex == kAllDevices)
+            if (sensorReading)
             {
-                action(sensorReading);
+                action(*sensorReading);
                 anySensorFound = true;
             }
         }
-
         return anySensorFound;
     }
 
@@ -270,15 +435,12 @@ class SensorReadingsManager
         const SensorReadingType sensorReadingType,
         const DeviceIndex deviceIndex) const
     {
-        if (auto sensorReading =
-                getSensorReading(sensorReadingType, deviceIndex))
+        const auto& sensorReading =
+            findSensorReading(sensorReadingType, deviceIndex);
+        if (sensorReading && sensorReading->isGood())
         {
-            if (sensorReading->isGood())
-            {
-                return sensorReading;
-            }
+            return sensorReading;
         }
-
         return nullptr;
     }
 
@@ -296,29 +458,65 @@ class SensorReadingsManager
         getSensorReading(const SensorReadingType sensorReadingType,
                          const DeviceIndex deviceIndex) const
     {
-        auto sensorReadingsIterator = allSensorReadings.find(sensorReadingType);
+        return findSensorReading(sensorReadingType, deviceIndex);
+    }
+
+  private:
+    using SensorReadings = std::vector<std::shared_ptr<SensorReadingIf>>;
+
+    SensorReadings& getSensorReadings(SensorReadingType type)
+    {
+        return allSensorReadings.at(static_cast<size_t>(type));
+    }
 
-        if (sensorReadingsIterator != allSensorReadings.end())
-        {
-            auto sensorReadingsByType = sensorReadingsIterator->second;
-            auto sensorReading = sensorReadingsByType.find(deviceIndex);
+    const SensorReadings& getSensorReadings(SensorReadingType type) const
+    {
+        return allSensorReadings.at(static_cast<size_t>(type));
+    }
 
-            if (sensorReading != sensorReadingsByType.end())
-            {
-                return sensorReading->second;
-            }
+    /**
+     * @brief Returns a reference to the stored handle, or to an empty handle
+     * when the reading does not exist, without touching the reference count.
+     */
+    const std::shared_ptr<SensorReadingIf>&
+        findSensorReading(const SensorReadingType type,
+                          const DeviceIndex deviceIndex) const
+    {
+        static const std::shared_ptr<SensorReadingIf> kNoSensorReading;
+        const auto& sensorReadings = getSensorReadings(type);
+        if (deviceIndex < sensorReadings.size())
+        {
+            return sensorReadings[deviceIndex];
         }
-        return nullptr;
+        return kNoSensorReading;
     }
 
-  private:
-    std::unordered_map<std::shared_ptr<ReadingConsumer>, ReadingContext>
-        readingConsumers;
+    struct Subscription
+    {
+        std::shared_ptr<ReadingConsumer> consumer;
+        ReadingContext readingCtx;
+    };
+
+    struct PendingEvent
+    {
+        SensorEventType eventType;
+        SensorContext sensorCtx;
+    };
+
+    /**
+     * @brief Consumers indexed by sensor reading type and device index, where
+     * kAllDevices holds consumers interested in every device of the type.
+     */
+    std::array<std::map<DeviceIndex, std::vector<Subscription>>,
+               kSensorReadingTypesCount>
+        subscriptions;
+    bool dispatching = false;
+    bool subscriptionsRemoved = false;
+    std::shared_ptr<std::vector<PendingEvent>> pendingEvents;
     SensorReadingEventCallback eventCallback;
-    std::unordered_map<
-        SensorReadingType,
-        std::unordered_map<DeviceIndex, std::shared_ptr<SensorReadingIf>>>
-        allSensorReadings;
+    std::array<SensorReadings, kSensorReadingTypesCount> allSensorReadings;
+    std::array<SensorSnapshot, 2> snapshots;
+    std::atomic<size_t> frontSnapshot{0};
 };
 
 } // namespace nodemanager
\ No newline at end of file
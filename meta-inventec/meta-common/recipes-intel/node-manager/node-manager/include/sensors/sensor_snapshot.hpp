@@ -0,0 +1,171 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "clock.hpp"
+#include "common_types.hpp"
+#include "sensors/sensor_reading_if.hpp"
+#include "sensors/sensor_reading_type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Copy of a single sensor reading taken at the end of the sensor phase.
+ */
+struct SensorSnapshotEntry
+{
+    SensorReadingType type;
+    DeviceIndex deviceIndex;
+    SensorReadingStatus status;
+    ValueType value;
+    Clock::time_point timestamp;
+
+    bool isGood() const
+    {
+        return status == SensorReadingStatus::valid;
+    }
+};
+
+/**
+ * @brief Immutable view of all sensor readings used by the control phases.
+ *
+ * Entries are stored contiguously, ordered by sensor reading type and device
+ * index, so iterating over all devices of one type touches a single range of
+ * memory and involves no virtual calls.
+ */
+class SensorSnapshot
+{
+    struct Range
+    {
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+  public:
+    /**
+     * @brief Removes all entries, allocated memory is kept for the next cycle.
+     */
+    void clear()
+    {
+        entries.clear();
+        ranges.fill(Range{});
+    }
+
+    void add(const SensorSnapshotEntry& entry)
+    {
+        entries.push_back(entry);
+    }
+
+    void add(const SensorReadingIf& sensorReading)
+    {
+        entries.push_back({sensorReading.getSensorReadingType(),
+                           sensorReading.getDeviceIndex(),
+                           sensorReading.getStatus(), sensorReading.getValue(),
+                           sensorReading.getUpdateTimestamp()});
+    }
+
+    /**
+     * @brief Builds the per type index, must be called after the last add()
+     * and before the snapshot is read.
+     */
+    void finalize()
+    {
+        if (!std::is_sorted(entries.begin(), entries.end(), isBefore))
+        {
+            std::stable_sort(entries.begin(), entries.end(), isBefore);
+        }
+        ranges.fill(Range{});
+        for (size_t idx = 0; idx < entries.size(); ++idx)
+        {
+            auto& range = ranges[static_cast<size_t>(entries[idx].type)];
+            if (range.begin == range.end)
+            {
+                range.begin = idx;
+            }
+            range.end = idx + 1;
+        }
+    }
+
+    /**
+     * @brief Executes provided function for each entry of the given type, or
+     * only for the given device if deviceIndex is not kAllDevices. Returns
+     * true if any entry has been found.
+     */
+    template <class Action>
+    bool forEach(SensorReadingType type, DeviceIndex deviceIndex,
+                 Action&& action) const
+    {
+        if (deviceIndex != kAllDevices)
+        {
+            const auto entry = find(type, deviceIndex);
+            if (entry)
+            {
+                action(*entry);
+            }
+            return entry != nullptr;
+        }
+
+        const auto& range = ranges[static_cast<size_t>(type)];
+        for (size_t idx = range.begin; idx < range.end; ++idx)
+        {
+            action(entries[idx]);
+        }
+        return range.begin != range.end;
+    }
+
+    const SensorSnapshotEntry* find(SensorReadingType type,
+                                    DeviceIndex deviceIndex) const
+    {
+        const auto& range = ranges[static_cast<size_t>(type)];
+        const auto first = entries.begin() + range.begin;
+        const auto last = entries.begin() + range.end;
+        const auto it = std::lower_bound(
+            first, last, deviceIndex,
+            [](const SensorSnapshotEntry& entry, DeviceIndex idx) {
+                return entry.deviceIndex < idx;
+            });
+        if (it != last && it->deviceIndex == deviceIndex)
+        {
+            return &(*it);
+        }
+        return nullptr;
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+  private:
+    std::vector<SensorSnapshotEntry> entries;
+    std::array<Range, kSensorReadingTypesCount> ranges{};
+
+    static bool isBefore(const SensorSnapshotEntry& lhs,
+                         const SensorSnapshotEntry& rhs)
+    {
+        return std::make_pair(lhs.type, lhs.deviceIndex) <
+               std::make_pair(rhs.type, rhs.deviceIndex);
+    }
+};
+
+} // namespace nodemanager
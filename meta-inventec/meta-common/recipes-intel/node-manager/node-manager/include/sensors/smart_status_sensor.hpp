@@ -22,6 +22,7 @@
 #include "sensor_reading_type.hpp"
 #include "sensor_readings_manager.hpp"
 #include "utility/devices_configuration.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
 #include <thread>
@@ -79,7 +80,7 @@ class SmartStatusSensor : public Sensor
 
         if (!future || !future->valid())
         {
-            future = std::async(std::launch::async, []() {
+            future = WorkerPool::getInstance().submit(WorkerQueue::smart, []() {
                 std::ifstream file(kSmartStatusFilePath);
                 if (!file.good())
                 {
@@ -66,8 +66,9 @@ class SmartSupervisor : public RunnerIf
 
     void run() override final
     {
-        auto perf1 = std::make_shared<Perf>("SmartSupervisor-run-duration",
-                                            std::chrono::milliseconds{10});
+        static const MeasureHandle perf1Handle(
+            "SmartSupervisor-run-duration", std::chrono::milliseconds{10});
+        auto perf1 = std::make_shared<Perf>(perf1Handle);
 
         kernelModulePresent.set(isKernelModule());
 
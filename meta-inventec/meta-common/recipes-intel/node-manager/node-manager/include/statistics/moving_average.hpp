@@ -19,21 +19,14 @@
 
 #include "average.hpp"
 #include "clock.hpp"
+#include "sliding_window.hpp"
 
 #include <algorithm>
-#include <boost/circular_buffer.hpp>
 #include <chrono>
 #include <cmath>
-#include <numeric>
 
 namespace nodemanager
 {
-struct Sample
-{
-    double acc;
-    double max;
-    double min;
-};
 
 static constexpr int kPtamStatsWindowCount = 30;
 
@@ -97,9 +90,7 @@ class MovingAverage : public Average
         DurationMs totalTime{accTime};
 
         // add accumulated values for already averaged periods
-        totalAccReading += std::accumulate(
-            bufferedSamples.begin(), bufferedSamples.end(), 0.0,
-            [this](double sum, const Sample& curr) { return sum + curr.acc; });
+        totalAccReading += bufferedSamples.getSum();
         totalTime +=
             samplingWindow * static_cast<double>(bufferedSamples.size());
 
@@ -122,14 +113,7 @@ class MovingAverage : public Average
             return std::numeric_limits<double>::quiet_NaN();
         }
         addSample(lastSample);
-        auto it = std::min_element(
-            bufferedSamples.begin(), bufferedSamples.end(),
-            [](const auto& a, const auto& b) { return a.min < b.min; });
-        if (it != bufferedSamples.end())
-        {
-            return std::min(accMin, it->min);
-        }
-        return accMin;
+        return std::min(accMin, bufferedSamples.getMin());
     }
 
     virtual double getMax() override
@@ -139,14 +123,7 @@ class MovingAverage : public Average
             return std::numeric_limits<double>::quiet_NaN();
         }
         addSample(lastSample);
-        auto it = std::max_element(
-            bufferedSamples.begin(), bufferedSamples.end(),
-            [](const auto& a, const auto& b) { return a.max < b.max; });
-        if (it != bufferedSamples.end())
-        {
-            return std::max(accMax, it->max);
-        }
-        return accMax;
+        return std::max(accMax, bufferedSamples.getMax());
     }
 
     void reset() override
@@ -176,7 +153,7 @@ class MovingAverage : public Average
     {
         DurationMs durationToCloseSample = samplingWindow - accTime;
         accReading += calculateSampleValue(lastSample, durationToCloseSample);
-        bufferedSamples.push_back(Sample{accReading, accMax, accMin});
+        bufferedSamples.push(Sample{accReading, accMax, accMin});
         return sampleDuration - durationToCloseSample;
     }
 
@@ -196,7 +173,7 @@ class MovingAverage : public Average
         for (; remainingDuration > samplingWindow;
              remainingDuration -= samplingWindow)
         {
-            bufferedSamples.push_back(
+            bufferedSamples.push(
                 Sample{sampleValue * samplingWindow.count(), sampleValue,
                        sampleValue});
         }
@@ -208,7 +185,7 @@ class MovingAverage : public Average
         return accTime + sampleDuration >= samplingWindow;
     }
 
-    boost::circular_buffer<Sample> bufferedSamples{kPtamStatsWindowCount};
+    SlidingWindow bufferedSamples{kPtamStatsWindowCount};
     DurationMs samplingWindow;
 };
 
@@ -0,0 +1,158 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include <boost/circular_buffer.hpp>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace nodemanager
+{
+
+struct Sample
+{
+    double acc;
+    double max;
+    double min;
+};
+
+/**
+ * @brief Window of the last `capacity` samples with O(1) amortized push and
+ * O(1) queries of the accumulated value, minimum and maximum.
+ *
+ * The sum is updated incrementally and recalculated from the stored samples
+ * each time the window wraps around, so rounding errors of the additions and
+ * subtractions cannot build up over the lifetime of the window. Minimum and
+ * maximum are kept in monotonic queues of (sample index, value) pairs, which
+ * never hold more than `capacity` elements.
+ */
+class SlidingWindow
+{
+  public:
+    explicit SlidingWindow(size_t capacity) :
+        samples(capacity), minQueue(capacity), maxQueue(capacity)
+    {
+    }
+
+    void push(const Sample& sample)
+    {
+        if (samples.capacity() == 0)
+        {
+            return;
+        }
+        if (samples.full())
+        {
+            const uint64_t oldestIndex = nextIndex - samples.size();
+            if (minQueue.front().first == oldestIndex)
+            {
+                minQueue.pop_front();
+            }
+            if (maxQueue.front().first == oldestIndex)
+            {
+                maxQueue.pop_front();
+            }
+            sum -= samples.front().acc;
+        }
+
+        samples.push_back(sample);
+        sum += sample.acc;
+        if (++pushesSinceRecalculation >= samples.capacity())
+        {
+            recalculateSum();
+        }
+
+        while (!minQueue.empty() && minQueue.back().second >= sample.min)
+        {
+            minQueue.pop_back();
+        }
+        minQueue.push_back({nextIndex, sample.min});
+        while (!maxQueue.empty() && maxQueue.back().second <= sample.max)
+        {
+            maxQueue.pop_back();
+        }
+        maxQueue.push_back({nextIndex, sample.max});
+        nextIndex++;
+    }
+
+    void clear()
+    {
+        samples.clear();
+        minQueue.clear();
+        maxQueue.clear();
+        sum = 0.0;
+        pushesSinceRecalculation = 0;
+    }
+
+    size_t size() const
+    {
+        return samples.size();
+    }
+
+    bool empty() const
+    {
+        return samples.empty();
+    }
+
+    /**
+     * @brief Returns sum of Sample::acc of all samples in the window.
+     */
+    double getSum() const
+    {
+        return sum;
+    }
+
+    /**
+     * @brief Returns the lowest Sample::min in the window, or
+     * std::numeric_limits<double>::max() when the window is empty.
+     */
+    double getMin() const
+    {
+        return minQueue.empty() ? std::numeric_limits<double>::max()
+                                : minQueue.front().second;
+    }
+
+    /**
+     * @brief Returns the highest Sample::max in the window, or
+     * std::numeric_limits<double>::lowest() when the window is empty.
+     */
+    double getMax() const
+    {
+        return maxQueue.empty() ? std::numeric_limits<double>::lowest()
+                                : maxQueue.front().second;
+    }
+
+  private:
+    boost::circular_buffer<Sample> samples;
+    boost::circular_buffer<std::pair<uint64_t, double>> minQueue;
+    boost::circular_buffer<std::pair<uint64_t, double>> maxQueue;
+    uint64_t nextIndex = 0;
+    double sum = 0.0;
+    size_t pushesSinceRecalculation = 0;
+
+    void recalculateSum()
+    {
+        sum = std::accumulate(
+            samples.begin(), samples.end(), 0.0,
+            [](double acc, const Sample& curr) { return acc + curr.acc; });
+        pushesSinceRecalculation = 0;
+    }
+};
+
+} // namespace nodemanager
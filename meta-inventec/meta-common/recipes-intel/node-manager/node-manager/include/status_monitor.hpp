@@ -70,8 +70,9 @@ class StatusMonitor : public RunnerIf
 
     virtual void run() override final
     {
-        auto perf =
-            Perf("StatusMonitor-run-duration", std::chrono::milliseconds{20});
+        static const MeasureHandle perfHandle(
+            "StatusMonitor-run-duration", std::chrono::milliseconds{20});
+        auto perf = Perf(perfHandle);
         if (!actionHandler)
         {
             return;
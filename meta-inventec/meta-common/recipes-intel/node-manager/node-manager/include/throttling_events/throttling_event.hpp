@@ -71,6 +71,37 @@ class ThrottlingEvent
         return eventJson;
     }
 
+    /**
+     * @brief Complete state of the event, unlike toJson() which returns only
+     * the fields reported to the user.
+     */
+    nlohmann::json toStorageJson() const
+    {
+        nlohmann::json eventJson;
+        eventJson["Start"] = startTimestamp.count();
+        eventJson["Id"] = id;
+        eventJson["Policy"] = policyJson;
+        eventJson["Reason"] = reason;
+        if (isFinished())
+        {
+            eventJson["Stop"] = stopTimestamp.count();
+        }
+        return eventJson;
+    }
+
+    static ThrottlingEvent fromStorageJson(const nlohmann::json& eventJson)
+    {
+        ThrottlingEvent event(
+            std::chrono::seconds{eventJson.at("Start").get<int64_t>()},
+            eventJson.at("Id").get<std::string>(), eventJson.at("Policy"),
+            eventJson.at("Reason").get<std::string>());
+        if (eventJson.contains("Stop"))
+        {
+            event.stop(std::chrono::seconds{eventJson["Stop"].get<int64_t>()});
+        }
+        return event;
+    }
+
   private:
     std::chrono::seconds startTimestamp;
     std::chrono::seconds stopTimestamp;
@@ -0,0 +1,176 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "throttling_event.hpp"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Fixed capacity ring buffer of throttling events ordered from the
+ * oldest to the most recent.
+ *
+ * Unfinished events are indexed by their id, so stopping an event does not
+ * walk the buffer. When the buffer is full the oldest finished event is
+ * dropped. It is the oldest event in practice, any other one is removed by
+ * shifting the newer events.
+ */
+class ThrottlingEventBuffer
+{
+  public:
+    explicit ThrottlingEventBuffer(size_t capacityArg) : slots(capacityArg)
+    {
+    }
+
+    /**
+     * @brief Adds event at the end. Returns false when the buffer is full and
+     * none of the events is finished.
+     */
+    bool push(const ThrottlingEvent& event)
+    {
+        if (size() == slots.size() && !freeSlot())
+        {
+            return false;
+        }
+        const uint64_t sequence = tail++;
+        slot(sequence) = event;
+        if (!event.isFinished())
+        {
+            unfinishedEvents[event.getId()].push_back(sequence);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Stops the most recent unfinished event with the id. Returns false
+     * when there is no such event.
+     */
+    bool stop(const std::string& id, std::chrono::seconds timestamp)
+    {
+        const auto it = unfinishedEvents.find(id);
+        if (it == unfinishedEvents.end())
+        {
+            return false;
+        }
+        slot(it->second.back())->stop(timestamp);
+        it->second.pop_back();
+        if (it->second.empty())
+        {
+            unfinishedEvents.erase(it);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Stops all unfinished events generated by NodeManager policies.
+     */
+    void stopNmEvents(std::chrono::seconds timestamp)
+    {
+        for (auto it = unfinishedEvents.begin(); it != unfinishedEvents.end();)
+        {
+            auto& sequences = it->second;
+            std::erase_if(sequences, [this, timestamp](uint64_t sequence) {
+                auto& event = slot(sequence);
+                if (event->isNmEvent())
+                {
+                    event->stop(timestamp);
+                    return true;
+                }
+                return false;
+            });
+            it = sequences.empty() ? unfinishedEvents.erase(it) : std::next(it);
+        }
+    }
+
+    size_t size() const
+    {
+        return static_cast<size_t>(tail - head);
+    }
+
+    /**
+     * @brief Returns event at position idx, where 0 is the oldest event.
+     */
+    const ThrottlingEvent& at(size_t idx) const
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range("ThrottlingEventBuffer index out of range");
+        }
+        return *slots[(head + idx) % slots.size()];
+    }
+
+    template <class Action>
+    void forEach(Action&& action) const
+    {
+        for (size_t idx = 0; idx < size(); ++idx)
+        {
+            action(at(idx));
+        }
+    }
+
+  private:
+    std::vector<std::optional<ThrottlingEvent>> slots;
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    std::unordered_map<std::string, std::vector<uint64_t>> unfinishedEvents;
+
+    std::optional<ThrottlingEvent>& slot(uint64_t sequence)
+    {
+        return slots[sequence % slots.size()];
+    }
+
+    bool freeSlot()
+    {
+        for (uint64_t sequence = head; sequence < tail; ++sequence)
+        {
+            if (slot(sequence)->isFinished())
+            {
+                erase(sequence);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void erase(uint64_t erased)
+    {
+        for (uint64_t sequence = erased; sequence > head; --sequence)
+        {
+            slot(sequence) = std::move(slot(sequence - 1));
+        }
+        slot(head).reset();
+        head++;
+        for (auto& [id, sequences] : unfinishedEvents)
+        {
+            for (auto& sequence : sequences)
+            {
+                if (sequence < erased)
+                {
+                    sequence++;
+                }
+            }
+        }
+    }
+};
+
+} // namespace nodemanager
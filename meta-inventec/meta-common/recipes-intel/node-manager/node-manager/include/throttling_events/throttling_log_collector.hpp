@@ -19,19 +19,34 @@
 
 #include "config/persistent_storage.hpp"
 #include "throttling_event.hpp"
+#include "throttling_event_buffer.hpp"
 #include "utility/file_watcher.hpp"
+#include "utility/log_tail_reader.hpp"
+
+#include <deque>
 
 namespace nodemanager
 {
 static const std::filesystem::path kThrottlingLogFilePath =
     "/var/log/nm_events";
+static const std::filesystem::path kThrottlingEventsMirrorPath =
+    "/var/lib/node-manager/throttling_events";
 static constexpr const auto kMaxThrottlingEvents = 128;
 static constexpr const auto kMaxThrottlingLogFiles = 3;
+static constexpr const auto kThrottlingEventsMirrorVersion = 1;
 
 static constexpr const auto kThrottlingLogTagStart = "+";
 static constexpr const auto kThrottlingLogTagStop = "-";
 static constexpr const auto kThrottlingLogTagRestart = "R";
 
+/**
+ * @brief Collects throttling events from the throttling log.
+ *
+ * Only lines appended to the log are parsed. Collected events together with
+ * the log position are mirrored in a binary (CBOR) file, so after restart
+ * only lines appended since the last run are parsed. All log files are
+ * parsed only when the mirror is missing or the log has been rotated.
+ */
 class ThrottlingLogCollector
 {
   public:
@@ -40,44 +55,65 @@ class ThrottlingLogCollector
     ThrottlingLogCollector(ThrottlingLogCollector&&) = delete;
     ThrottlingLogCollector& operator=(ThrottlingLogCollector&&) = delete;
 
-    ThrottlingLogCollector(boost::asio::io_context& ioc) :
-        fileWatcher(ioc, kThrottlingLogFilePath,
-                    [this](const std::vector<std::string>& lines) {
-                        processLogs(lines);
-                    })
+    ThrottlingLogCollector(
+        boost::asio::io_context& ioc,
+        const std::filesystem::path& logFilePathArg = kThrottlingLogFilePath,
+        const std::filesystem::path& mirrorFilePathArg =
+            kThrottlingEventsMirrorPath) :
+        logFilePath(logFilePathArg),
+        mirrorFilePath(mirrorFilePathArg), tailReader(logFilePath),
+        fileWatcher(ioc, logFilePath, [this]() { processNewLogs(); })
     {
-        const auto& logs = readLogFiles();
-        processLogs(logs);
+        if (!restoreMirror())
+        {
+            processLogs(readRotatedLogFiles());
+        }
+        processNewLogs();
     }
 
     nlohmann::json getJson() const
     {
         nlohmann::json eventsJson;
         eventsJson["ThrottlingEvents"] = nlohmann::json::array();
-        for (const auto& event : throttlingEventBuffer)
-        {
+        throttlingEventBuffer.forEach([&eventsJson](const auto& event) {
             eventsJson["ThrottlingEvents"].push_back(event.toJson());
-        }
+        });
         return eventsJson;
     }
 
+    size_t getEventsCount() const
+    {
+        return throttlingEventBuffer.size();
+    }
+
+    /**
+     * @brief Returns event at position idx, where 0 is the oldest event.
+     */
+    const ThrottlingEvent& getEvent(size_t idx) const
+    {
+        return throttlingEventBuffer.at(idx);
+    }
+
   private:
     PersistentStorage storage;
-    std::list<ThrottlingEvent> throttlingEventBuffer;
+    std::filesystem::path logFilePath;
+    std::filesystem::path mirrorFilePath;
+    ThrottlingEventBuffer throttlingEventBuffer{kMaxThrottlingEvents};
+    LogTailReader tailReader;
     FileWatcher fileWatcher;
 
     /**
-     * @brief Read throttling log files.
+     * @brief Read rotated throttling log files.
      *
      * @return std::vector<std::string> all logs in order from oldest to most
      * recent.
      */
-    std::vector<std::string> readLogFiles()
+    std::vector<std::string> readRotatedLogFiles()
     {
-        std::deque<std::filesystem::path> filesToRead({kThrottlingLogFilePath});
+        std::deque<std::filesystem::path> filesToRead;
         for (auto i = 1; i < kMaxThrottlingLogFiles; ++i)
         {
-            std::filesystem::path rotatedFilePath = kThrottlingLogFilePath;
+            std::filesystem::path rotatedFilePath = logFilePath;
             rotatedFilePath += "." + std::to_string(i);
             if (storage.exists(rotatedFilePath))
             {
@@ -95,42 +131,91 @@ class ThrottlingLogCollector
         return lines;
     }
 
-    void processLogs(const std::vector<std::string>& lines)
+    void processNewLogs()
     {
-        for (const auto& line : lines)
+        const auto lines = tailReader.readNewLines();
+        if (!lines.empty())
         {
-            try
+            processLogs(lines);
+            storeMirror();
+        }
+    }
+
+    /**
+     * @brief Restores events and the log position from the mirror. Returns
+     * false when the mirror does not exist, is invalid or does not match the
+     * current log file.
+     */
+    bool restoreMirror()
+    {
+        const auto content = storage.readFile(mirrorFilePath);
+        if (!content)
+        {
+            return false;
+        }
+        const auto mirror = nlohmann::json::from_cbor(*content, true, false);
+        try
+        {
+            if (mirror.is_discarded() ||
+                mirror.at("Version") != kThrottlingEventsMirrorVersion ||
+                !tailReader.seek({mirror.at("Inode").get<uint64_t>(),
+                                  mirror.at("Offset").get<uint64_t>()}))
             {
-                processLogLine(line);
+                Logger::log<LogLevel::info>(
+                    "Throttling events mirror is outdated, reading log files");
+                return false;
             }
-            catch (std::exception& e)
+            for (const auto& eventJson : mirror.at("Events"))
             {
-                Logger::log<LogLevel::error>(
-                    "Error processing throttling log: %s : %s", line, e.what());
+                throttlingEventBuffer.push(
+                    ThrottlingEvent::fromStorageJson(eventJson));
             }
         }
+        catch (const std::exception& e)
+        {
+            Logger::log<LogLevel::error>(
+                "Cannot restore throttling events mirror: %s", e.what());
+            throttlingEventBuffer = ThrottlingEventBuffer{kMaxThrottlingEvents};
+            tailReader.seek({0, 0});
+            return false;
+        }
+        return true;
     }
 
-    /**
-     * @brief Checks for free slot in event buffer. If buffer is full removes
-     * oldest, finished entry.
-     *
-     */
-    bool freeSlot()
+    void storeMirror()
     {
-        if (throttlingEventBuffer.size() < kMaxThrottlingEvents)
+        const auto position = tailReader.getPosition();
+        if (!position)
         {
-            return true;
+            return;
         }
-        auto it = std::find_if(
-            throttlingEventBuffer.begin(), throttlingEventBuffer.end(),
-            [](ThrottlingEvent event) { return event.isFinished(); });
-        if (it != throttlingEventBuffer.end())
+        nlohmann::json mirror;
+        mirror["Version"] = kThrottlingEventsMirrorVersion;
+        mirror["Inode"] = position->inode;
+        mirror["Offset"] = position->offset;
+        mirror["Events"] = nlohmann::json::array();
+        throttlingEventBuffer.forEach([&mirror](const auto& event) {
+            mirror["Events"].push_back(event.toStorageJson());
+        });
+        const auto cbor = nlohmann::json::to_cbor(mirror);
+        storage.storeAtomically(mirrorFilePath,
+                                std::string(cbor.begin(), cbor.end()));
+    }
+
+    void processLogs(const std::vector<std::string>& lines)
+    {
+        for (const auto& line : lines)
         {
-            throttlingEventBuffer.erase(it);
-            return true;
+            try
+            {
+                processLogLine(line);
+            }
+            catch (std::exception& e)
+            {
+                Logger::log<LogLevel::error>(
+                    "Error processing throttling log: %s : %s", line, e.what());
+            }
         }
-        return false;
     }
 
     /**
@@ -159,12 +244,8 @@ class ThrottlingLogCollector
             nlohmann::json policyJson =
                 lineJson.value("Policy", nlohmann::json());
             std::string reason = lineJson.value("Reason", "");
-            if (freeSlot())
-            {
-                throttlingEventBuffer.emplace_back(timestamp, id, policyJson,
-                                                   reason);
-            }
-            else
+            if (!throttlingEventBuffer.push(
+                    ThrottlingEvent(timestamp, id, policyJson, reason)))
             {
                 throw std::length_error("Event buffer full");
             }
@@ -172,25 +253,11 @@ class ThrottlingLogCollector
         else if (tag == kThrottlingLogTagStop)
         {
             std::string id = lineJson.value("Id", from);
-            for (auto it = throttlingEventBuffer.rbegin();
-                 it != throttlingEventBuffer.rend(); ++it)
-            {
-                if (!it->isFinished() && it->getId() == id)
-                {
-                    it->stop(timestamp);
-                    break;
-                }
-            }
+            throttlingEventBuffer.stop(id, timestamp);
         }
         else if (tag == kThrottlingLogTagRestart)
         {
-            for (auto& event : throttlingEventBuffer)
-            {
-                if (!event.isFinished() && event.isNmEvent())
-                {
-                    event.stop(timestamp);
-                }
-            }
+            throttlingEventBuffer.stopNmEvents(timestamp);
         }
         else
         {
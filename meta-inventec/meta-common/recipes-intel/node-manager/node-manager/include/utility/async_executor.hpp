@@ -17,19 +17,32 @@
 
 #pragma once
 
+#include "boost/asio/post.hpp"
 #include "boost/asio/steady_timer.hpp"
 #include "common_types.hpp"
 #include "loggers/log.hpp"
 #include "utility/dbus_interfaces.hpp"
 #include "utility/property.hpp"
 #include "utility/state_if.hpp"
+#include "utility/worker_pool.hpp"
 
 #include <future>
+#include <map>
 #include <memory>
 namespace nodemanager
 {
 
-static constexpr const std::chrono::milliseconds kDefaultCheckInterval{20};
+/**
+ * @brief Maximum execution time of a task after which its callback is called
+ * with `result` instead of the task result. The same `result` is passed to
+ * the callback of a task that threw.
+ */
+template <typename R>
+struct AsyncTaskTimeout
+{
+    std::chrono::milliseconds duration;
+    R result;
+};
 
 template <typename K, typename R>
 class AsyncExecutorIf
@@ -40,88 +53,243 @@ class AsyncExecutorIf
 
     virtual ~AsyncExecutorIf() = default;
 
-    virtual void schedule(const K& key, Task task, TaskCallback callback) = 0;
+    virtual bool schedule(const K& key, Task task, TaskCallback callback) = 0;
+    virtual bool isPending(const K& key) const = 0;
 };
 
+/**
+ * @brief Executes tasks on the WorkerPool and calls their callbacks from the
+ * io_context thread as soon as they finish.
+ *
+ * At most one task per key is running at a time. Task scheduled while another
+ * one with the same key is running waits for it and replaces any task that
+ * was already waiting, so only the newest one is executed. No timer is used
+ * for collecting results, workers post completions to the io_context. When
+ * a timeout is configured, a timer is armed only for the running tasks. A
+ * timed out task gets its callback called right away, but its key stays busy
+ * until the task really finishes, so tasks with the same key never overlap.
+ */
 template <class K, class R>
 class AsyncExecutor : public AsyncExecutorIf<K, R>
 {
+    using Task = typename AsyncExecutorIf<K, R>::Task;
+    using TaskCallback = typename AsyncExecutorIf<K, R>::TaskCallback;
+
+    struct QueuedTask
+    {
+        Task task;
+        TaskCallback callback;
+    };
+
+    struct RunningTask
+    {
+        uint64_t id;
+        // Empty once the task timed out and the callback was called
+        TaskCallback callback;
+        std::future<void> done;
+        std::unique_ptr<boost::asio::steady_timer> timeoutTimer;
+        std::optional<QueuedTask> next;
+    };
+
   public:
     AsyncExecutor(
         std::shared_ptr<sdbusplus::asio::connection> busArg,
-        std::chrono::milliseconds checkIntervalArg = kDefaultCheckInterval) :
-        checkResultsTimer(busArg->get_io_context()),
-        checkInterval(checkIntervalArg)
+        std::optional<AsyncTaskTimeout<R>> timeoutArg = std::nullopt,
+        WorkerQueue queueArg = WorkerQueue::knob) :
+        ioc(busArg->get_io_context()),
+        timeout(timeoutArg), queue(queueArg)
     {
-        timerHandler();
-    };
-    virtual ~AsyncExecutor() = default;
+    }
 
     /**
-     * @brief Immediately starts asynchronously the `task` if it was not already
-     * pending. Does nothing when task or callback are nulls or task with given
-     * ‘key’ is still pending.
+     * @brief Waits for the running tasks and executes the waiting ones, so
+     * that values written on shutdown are not lost. Callbacks are not called.
+     * Running tasks do not refer to the executor, so when a timeout is
+     * configured the wait is limited to it. The waiting task is then dropped
+     * if the running one has not finished, to not overlap with it.
+     */
+    virtual ~AsyncExecutor()
+    {
+        lifetime.reset();
+        for (auto& [key, running] : runningTasks)
+        {
+            if (!timeout)
+            {
+                running.done.wait();
+            }
+            else if (running.done.wait_for(timeout->duration) !=
+                     std::future_status::ready)
+            {
+                Logger::log<LogLevel::warning>(
+                    "[AsyncExecutor] task still running on shutdown");
+                continue;
+            }
+            if (running.next)
+            {
+                try
+                {
+                    running.next->task();
+                }
+                catch (const std::exception& e)
+                {
+                    Logger::log<LogLevel::error>(
+                        "[AsyncExecutor] task failed on shutdown: %s",
+                        e.what());
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Starts asynchronously the `task` if no task with given `key` is
+     * running, otherwise queues it to be started after the running one
+     * finishes. A task already waiting for the same `key` is dropped together
+     * with its callback. Does nothing when task or callback are nulls.
      *
      * @param key a key that identifies the task
      * @param task Task to execute.  Important Note: the `task` will be executed
-     * asynchronously so it must be thread-safe.
-     * @param callback a method that will be called when the task is finished.
-     * The callback will be called from the thread that is executing current
-     * io_context.
+     * asynchronously so it must be thread-safe. A task that throws is treated
+     * as timed out, its callback is not called when no timeout is configured.
+     * @param callback a method that will be called when the task is finished
+     * or timed out. The callback will be called from the thread that is
+     * executing current io_context.
+     *
+     * @return true if the task was started or queued, false if it was
+     * rejected.
      */
-    void
-        schedule(const K& key, typename AsyncExecutorIf<K, R>::Task task,
-                 typename AsyncExecutorIf<K, R>::TaskCallback callback) override
+    bool schedule(const K& key, Task task, TaskCallback callback) override
     {
-        auto& [f, c] = futureCallbackMap[key];
-        if (!f.valid())
+        if (!task || !callback)
+        {
+            return false;
+        }
+        auto it = runningTasks.find(key);
+        if (it != runningTasks.end())
         {
-            f = std::async(std::launch::async, std::move(task));
-            c = std::move(callback);
+            it->second.next = QueuedTask{std::move(task), std::move(callback)};
+            return true;
         }
+        return start(key, std::move(task), std::move(callback));
+    }
+
+    /**
+     * @brief Returns true while a task with given `key` is running or waiting
+     * for the running one.
+     */
+    bool isPending(const K& key) const override
+    {
+        return runningTasks.contains(key);
     }
 
   private:
-    void timerHandler()
+    bool start(const K& key, Task task, TaskCallback callback)
     {
-        checkResultsTimer.expires_after(checkInterval);
-        checkResultsTimer.async_wait([this](boost::system::error_code ec) {
-            if (ec)
-            {
-                Logger::log<LogLevel::info>(
-                    "[AsyncExecutor] timer cancelled, ec: %d", ec);
-                return;
-            }
-            executeCallback();
-            timerHandler();
-        });
+        const uint64_t id = nextTaskId++;
+        // The worker dereferences only the io_context, which outlives the
+        // executor. The completion is always posted, also when task throws.
+        auto done = WorkerPool::getInstance().submit(
+            queue, [&ioc = ioc, this, token = std::weak_ptr<bool>(lifetime),
+                    key, id, task = std::move(task)]() {
+                std::optional<R> result;
+                try
+                {
+                    result = task();
+                }
+                catch (const std::exception& e)
+                {
+                    Logger::log<LogLevel::error>(
+                        "[AsyncExecutor] task failed: %s", e.what());
+                }
+                boost::asio::post(ioc, [this, token, key, id,
+                                        result = std::move(result)]() mutable {
+                    if (token.lock())
+                    {
+                        onTaskFinished(key, id, std::move(result));
+                    }
+                });
+            });
+        if (!done.valid())
+        {
+            Logger::log<LogLevel::warning>(
+                "[AsyncExecutor] task rejected by the worker pool");
+            return false;
+        }
+
+        auto& running = runningTasks[key];
+        running.id = id;
+        running.callback = std::move(callback);
+        running.done = std::move(done);
+        if (timeout)
+        {
+            running.timeoutTimer =
+                std::make_unique<boost::asio::steady_timer>(ioc);
+            running.timeoutTimer->expires_after(timeout->duration);
+            running.timeoutTimer->async_wait(
+                [this, token = std::weak_ptr<bool>(lifetime), key,
+                 id](boost::system::error_code ec) {
+                    if (!ec && token.lock())
+                    {
+                        onTimeout(key, id);
+                    }
+                });
+        }
+        return true;
     }
 
     /**
-     * @brief Iterates over futureCallbackMap and executes callback for all
-     * future objects that has finished, then removes them from the
-     * futureCallbackMap.
-     *
+     * @brief Removes the finished task, starts the one waiting for the same
+     * key and calls the callback of the finished task, unless it was already
+     * called on timeout. `result` is empty when the task threw.
      */
-    void executeCallback()
+    void onTaskFinished(const K& key, uint64_t id, std::optional<R> result)
     {
-        for (auto& [key, valuePair] : futureCallbackMap)
+        auto it = runningTasks.find(key);
+        if (it == runningTasks.end() || it->second.id != id)
         {
-            auto& [futureRef, callbackRef] = valuePair;
-            if (futureRef.valid() && futureRef.wait_for(std::chrono::seconds(
-                                         0)) == std::future_status::ready)
-            {
-                auto callback = std::move(callbackRef);
-                callback(futureRef.get());
-            }
+            return;
+        }
+        auto callback = std::move(it->second.callback);
+        auto next = std::move(it->second.next);
+        runningTasks.erase(it);
+        if (next)
+        {
+            start(key, std::move(next->task), std::move(next->callback));
+        }
+        if (!result && timeout)
+        {
+            result = timeout->result;
+        }
+        if (callback && result)
+        {
+            callback(std::move(*result));
+        }
+    }
+
+    /**
+     * @brief Calls the callback with the timeout result. The task keeps its
+     * key until it finishes, a task scheduled meanwhile waits for it.
+     */
+    void onTimeout(const K& key, uint64_t id)
+    {
+        auto it = runningTasks.find(key);
+        if (it != runningTasks.end() && it->second.id == id &&
+            it->second.callback)
+        {
+            Logger::log<LogLevel::warning>(
+                "[AsyncExecutor] task timed out after %d ms",
+                static_cast<int>(timeout->duration.count()));
+            auto callback = std::move(it->second.callback);
+            it->second.callback = nullptr;
+            callback(timeout->result);
         }
     }
 
-    std::map<K, std::tuple<std::future<R>,
-                           typename AsyncExecutorIf<K, R>::TaskCallback>>
-        futureCallbackMap;
-    boost::asio::steady_timer checkResultsTimer;
-    std::chrono::milliseconds checkInterval;
+    boost::asio::io_context& ioc;
+    std::optional<AsyncTaskTimeout<R>> timeout;
+    WorkerQueue queue;
+    std::map<K, RunningTask> runningTasks;
+    uint64_t nextTaskId = 0;
+    std::shared_ptr<bool> lifetime = std::make_shared<bool>(true);
 };
 
 } // namespace nodemanager
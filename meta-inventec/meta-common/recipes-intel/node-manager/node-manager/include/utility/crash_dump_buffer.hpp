@@ -0,0 +1,68 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Preallocated copy of the latest diagnostics report.
+ *
+ * The report is copied in while the service is healthy, so reporting it when
+ * the service is being aborted does not need to collect the status or
+ * allocate memory. Reports longer than the capacity are truncated.
+ */
+class CrashDumpBuffer
+{
+  public:
+    static constexpr size_t kCapacity = 128 * 1024;
+
+    void store(std::string_view content)
+    {
+        static constexpr std::string_view kTruncatedMarker = "...";
+        if (content.size() < kCapacity)
+        {
+            std::copy(content.begin(), content.end(), buffer.begin());
+            buffer[content.size()] = '\0';
+            return;
+        }
+        const size_t length = kCapacity - 1 - kTruncatedMarker.size();
+        std::copy_n(content.begin(), length, buffer.begin());
+        std::copy(kTruncatedMarker.begin(), kTruncatedMarker.end(),
+                  buffer.begin() + length);
+        buffer[kCapacity - 1] = '\0';
+    }
+
+    /**
+     * @brief Null terminated content of the last store(), empty string if
+     * nothing has been stored.
+     */
+    const char* get() const
+    {
+        return buffer.data();
+    }
+
+  private:
+    std::array<char, kCapacity> buffer{};
+};
+
+} // namespace nodemanager
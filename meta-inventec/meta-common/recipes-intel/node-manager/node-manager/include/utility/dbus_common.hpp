@@ -22,6 +22,8 @@ namespace nodemanager
 static constexpr const auto kOperationalStatusInterface =
     "xyz.openbmc_project.State.Decorator.OperationalStatus";
 static constexpr const auto kOperationalStatusProperty = "Functional";
+static constexpr const auto kPropertiesIface =
+    "org.freedesktop.DBus.Properties";
 
 using DBusValue = std::variant<double, bool, std::string>;
 using DbusHandlerCallback = std::function<void(
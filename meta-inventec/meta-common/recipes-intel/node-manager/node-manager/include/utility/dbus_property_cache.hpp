@@ -0,0 +1,502 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "clock.hpp"
+#include "loggers/log.hpp"
+#include "utility/dbus_common.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/container/flat_map.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sdbusplus/asio/object_server.hpp>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace nodemanager
+{
+
+static constexpr const auto kObjectManagerIface =
+    "org.freedesktop.DBus.ObjectManager";
+
+struct DbusPropertyKey
+{
+    std::string path;
+    std::string interface;
+    std::string property;
+
+    auto operator<=>(const DbusPropertyKey&) const = default;
+};
+
+/**
+ * @brief Local copy of the properties exposed by a single D-Bus service.
+ *
+ * The copy is loaded with one GetManagedObjects call and then kept up to
+ * date with PropertiesChanged, InterfacesAdded and InterfacesRemoved signals
+ * of the service, so reading a property does not involve a D-Bus call.
+ * Properties not returned by GetManagedObjects, e.g. when the service has no
+ * object manager at the root path, are read with Properties.Get on the first
+ * request.
+ *
+ * There is a single instance per service, shared by all its users.
+ */
+class DbusPropertyCache : public std::enable_shared_from_this<DbusPropertyCache>
+{
+    /**
+     * @brief Wider than DBusValue, so that objects having properties of other
+     * types can still be read. Such properties are not cached.
+     */
+    using DbusAnyValue =
+        std::variant<double, bool, std::string, int64_t, uint64_t, int32_t,
+                     uint32_t, int16_t, uint16_t, uint8_t,
+                     std::vector<std::string>>;
+    using DbusPropertiesMap =
+        boost::container::flat_map<std::string, DbusAnyValue>;
+    using DbusInterfacesMap =
+        boost::container::flat_map<std::string, DbusPropertiesMap>;
+    using ManagedObjects = std::vector<
+        std::pair<sdbusplus::message::object_path, DbusInterfacesMap>>;
+
+  public:
+    /**
+     * @brief Receives value of the property, std::nullopt means that the
+     * property is not available.
+     */
+    using Callback = std::function<void(const std::optional<DBusValue>&)>;
+    /**
+     * @brief Subscription is active as long as the handle is kept.
+     */
+    using Subscription = std::shared_ptr<Callback>;
+
+    DbusPropertyCache(const DbusPropertyCache&) = delete;
+    DbusPropertyCache& operator=(const DbusPropertyCache&) = delete;
+    DbusPropertyCache(DbusPropertyCache&&) = delete;
+    DbusPropertyCache& operator=(DbusPropertyCache&&) = delete;
+
+    DbusPropertyCache(
+        const std::shared_ptr<sdbusplus::asio::connection>& busArg,
+        const std::string& serviceNameArg) :
+        bus(busArg),
+        serviceName(serviceNameArg)
+    {
+        installMatches();
+    }
+
+    virtual ~DbusPropertyCache() = default;
+
+    static std::shared_ptr<DbusPropertyCache> getInstance(
+        const std::shared_ptr<sdbusplus::asio::connection>& bus,
+        const std::string& serviceName)
+    {
+        static std::map<std::pair<sdbusplus::asio::connection*, std::string>,
+                        std::weak_ptr<DbusPropertyCache>>
+            instances;
+        auto& instance = instances[{bus.get(), serviceName}];
+        auto cache = instance.lock();
+        if (!cache)
+        {
+            cache = std::make_shared<DbusPropertyCache>(bus, serviceName);
+            instance = cache;
+        }
+        return cache;
+    }
+
+    /**
+     * @brief Calls the callback with every change of the property made after
+     * the subscription.
+     */
+    Subscription subscribe(const DbusPropertyKey& key, Callback callback)
+    {
+        auto subscription = std::make_shared<Callback>(std::move(callback));
+        subscribers.emplace(key, subscription);
+        return subscription;
+    }
+
+    /**
+     * @brief Calls the callback once with the current value of the property.
+     * The cached value is used when present, otherwise the property is read
+     * from D-Bus, up to `retries` more times after `retryInterval` if the
+     * read fails. Each failed attempt is reported as std::nullopt.
+     */
+    void read(const DbusPropertyKey& key, Callback callback, int retries,
+              std::chrono::seconds retryInterval)
+    {
+        if (state == State::loaded)
+        {
+            resolveRead({key, std::move(callback), retries, retryInterval});
+            return;
+        }
+        pendingReads.push_back(
+            {key, std::move(callback), retries, retryInterval});
+        if (state == State::idle)
+        {
+            load(false);
+        }
+    }
+
+    /**
+     * @brief Time since the cached value was last confirmed by the service.
+     */
+    std::optional<std::chrono::milliseconds>
+        getAge(const DbusPropertyKey& key) const
+    {
+        const auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            return std::nullopt;
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now() - it->second.updated);
+    }
+
+  private:
+    enum class State
+    {
+        idle,
+        loading,
+        loaded
+    };
+
+    struct Entry
+    {
+        DBusValue value;
+        Clock::time_point updated;
+    };
+
+    struct PendingRead
+    {
+        DbusPropertyKey key;
+        Callback callback;
+        int retries;
+        std::chrono::seconds retryInterval;
+    };
+
+    std::shared_ptr<sdbusplus::asio::connection> bus;
+    const std::string serviceName;
+    State state = State::idle;
+    std::map<DbusPropertyKey, Entry> entries;
+    std::multimap<DbusPropertyKey, std::weak_ptr<Callback>> subscribers;
+    std::vector<PendingRead> pendingReads;
+    std::vector<std::unique_ptr<sdbusplus::bus::match::match>> matches;
+
+    void installMatches()
+    {
+        auto& connection = static_cast<sdbusplus::bus::bus&>(*bus);
+        const auto senderRule = sdbusplus::bus::match::rules::sender(
+            serviceName);
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            connection,
+            sdbusplus::bus::match::rules::type::signal() + senderRule +
+                sdbusplus::bus::match::rules::interface(kPropertiesIface) +
+                sdbusplus::bus::match::rules::member("PropertiesChanged"),
+            [this](sdbusplus::message::message& message) {
+                onPropertiesChanged(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            connection,
+            sdbusplus::bus::match::rules::interfacesAdded() + senderRule,
+            [this](sdbusplus::message::message& message) {
+                onInterfacesAdded(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            connection,
+            sdbusplus::bus::match::rules::interfacesRemoved() + senderRule,
+            [this](sdbusplus::message::message& message) {
+                onInterfacesRemoved(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            connection,
+            sdbusplus::bus::match::rules::nameOwnerChanged() +
+                sdbusplus::bus::match::rules::argN(0, serviceName),
+            [this](sdbusplus::message::message& message) {
+                onNameOwnerChanged(message);
+            }));
+    }
+
+    /**
+     * @brief Loads all objects of the service. When reloading after the
+     * service has been restarted subscribers are notified about the values.
+     */
+    void load(bool notify)
+    {
+        state = State::loading;
+        bus->async_method_call(
+            [weakSelf = weak_from_this(),
+             notify](const boost::system::error_code& ec,
+                     const ManagedObjects& objects) {
+                if (auto self = weakSelf.lock())
+                {
+                    self->onLoaded(ec, objects, notify);
+                }
+            },
+            serviceName, "/", kObjectManagerIface, "GetManagedObjects");
+    }
+
+    void onLoaded(const boost::system::error_code& ec,
+                  const ManagedObjects& objects, bool notify)
+    {
+        if (ec)
+        {
+            Logger::log<LogLevel::debug>(
+                "No object manager in %s, properties will be read one by one, "
+                "err=%s",
+                serviceName, ec.message());
+        }
+        else
+        {
+            for (const auto& [path, interfaces] : objects)
+            {
+                storeInterfaces(path, interfaces, notify);
+            }
+        }
+        state = State::loaded;
+        auto reads = std::move(pendingReads);
+        pendingReads.clear();
+        for (auto& pendingRead : reads)
+        {
+            resolveRead(std::move(pendingRead));
+        }
+    }
+
+    void resolveRead(PendingRead pendingRead)
+    {
+        const auto it = entries.find(pendingRead.key);
+        if (it == entries.end())
+        {
+            getProperty(std::move(pendingRead));
+            return;
+        }
+        boost::asio::post(bus->get_io_context(),
+                          [callback = std::move(pendingRead.callback),
+                           value = it->second.value]() { callback(value); });
+    }
+
+    void getProperty(PendingRead pendingRead)
+    {
+        const auto key = pendingRead.key;
+        bus->async_method_call(
+            DbusHandlerCallback([weakSelf = weak_from_this(),
+                                 pendingRead = std::move(pendingRead)](
+                                    const boost::system::error_code& ec,
+                                    const DBusValue& value) mutable {
+                auto self = weakSelf.lock();
+                if (!ec)
+                {
+                    if (self)
+                    {
+                        self->store(pendingRead.key, value, false);
+                    }
+                    pendingRead.callback(value);
+                    return;
+                }
+                pendingRead.callback(std::nullopt);
+                if (self && pendingRead.retries > 0)
+                {
+                    self->retryGetProperty(std::move(pendingRead));
+                }
+            }),
+            serviceName, key.path, kPropertiesIface, "Get", key.interface,
+            key.property);
+    }
+
+    void retryGetProperty(PendingRead pendingRead)
+    {
+        auto timer = std::make_shared<boost::asio::steady_timer>(
+            bus->get_io_context());
+        timer->expires_after(pendingRead.retryInterval);
+        pendingRead.retries--;
+        timer->async_wait([weakSelf = weak_from_this(), timer,
+                           pendingRead = std::move(pendingRead)](
+                              boost::system::error_code ec) mutable {
+            if (ec)
+            {
+                return;
+            }
+            if (auto self = weakSelf.lock())
+            {
+                self->getProperty(std::move(pendingRead));
+            }
+        });
+    }
+
+    void store(const DbusPropertyKey& key, const DBusValue& value, bool notify)
+    {
+        auto& entry = entries[key];
+        const bool changed = entry.updated == Clock::time_point{} ||
+                             entry.value != value;
+        entry.value = value;
+        entry.updated = Clock::now();
+        if (notify && changed)
+        {
+            notifySubscribers(key, value);
+        }
+    }
+
+    void storeInterfaces(const std::string& path,
+                         const DbusInterfacesMap& interfaces, bool notify)
+    {
+        for (const auto& [interface, properties] : interfaces)
+        {
+            for (const auto& [property, anyValue] : properties)
+            {
+                if (auto value = toDbusValue(anyValue))
+                {
+                    store({path, interface, property}, *value, notify);
+                }
+            }
+        }
+    }
+
+    void notifySubscribers(const DbusPropertyKey& key,
+                           const std::optional<DBusValue>& value)
+    {
+        auto [it, end] = subscribers.equal_range(key);
+        while (it != end)
+        {
+            if (auto callback = it->second.lock())
+            {
+                (*callback)(value);
+                ++it;
+            }
+            else
+            {
+                it = subscribers.erase(it);
+            }
+        }
+    }
+
+    void onPropertiesChanged(sdbusplus::message::message& message)
+    {
+        try
+        {
+            std::string interface;
+            DbusPropertiesMap changedProperties;
+            std::vector<std::string> invalidatedProperties;
+            message.read(interface, changedProperties, invalidatedProperties);
+            storeInterfaces(message.get_path(),
+                            DbusInterfacesMap{{interface, changedProperties}},
+                            true);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::log<LogLevel::warning>(
+                "Cannot read PropertiesChanged signal from %s: %s",
+                serviceName, e.what());
+        }
+    }
+
+    void onInterfacesAdded(sdbusplus::message::message& message)
+    {
+        try
+        {
+            sdbusplus::message::object_path path;
+            DbusInterfacesMap interfaces;
+            message.read(path, interfaces);
+            storeInterfaces(path, interfaces, true);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::log<LogLevel::warning>(
+                "Cannot read InterfacesAdded signal from %s: %s", serviceName,
+                e.what());
+        }
+    }
+
+    void onInterfacesRemoved(sdbusplus::message::message& message)
+    {
+        try
+        {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+            message.read(path, interfaces);
+            for (const auto& interface : interfaces)
+            {
+                removeInterface(path, interface);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Logger::log<LogLevel::warning>(
+                "Cannot read InterfacesRemoved signal from %s: %s",
+                serviceName, e.what());
+        }
+    }
+
+    void removeInterface(const std::string& path, const std::string& interface)
+    {
+        auto it = entries.lower_bound({path, interface, ""});
+        while (it != entries.end() && it->first.path == path &&
+               it->first.interface == interface)
+        {
+            const auto key = it->first;
+            it = entries.erase(it);
+            notifySubscribers(key, std::nullopt);
+        }
+    }
+
+    void onNameOwnerChanged(sdbusplus::message::message& message)
+    {
+        std::string name;
+        std::string oldOwner;
+        std::string newOwner;
+        message.read(name, oldOwner, newOwner);
+        if (newOwner.empty())
+        {
+            Logger::log<LogLevel::warning>(
+                "Detected service lost from dbus: %s", serviceName);
+            entries.clear();
+            std::set<DbusPropertyKey> keys;
+            for (const auto& [key, subscriber] : subscribers)
+            {
+                keys.insert(key);
+            }
+            for (const auto& key : keys)
+            {
+                notifySubscribers(key, std::nullopt);
+            }
+        }
+        else if (state == State::loaded)
+        {
+            load(true);
+        }
+    }
+
+    static std::optional<DBusValue> toDbusValue(const DbusAnyValue& anyValue)
+    {
+        return std::visit(
+            [](const auto& value) -> std::optional<DBusValue> {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, double> ||
+                              std::is_same_v<T, bool> ||
+                              std::is_same_v<T, std::string>)
+                {
+                    return DBusValue{value};
+                }
+                return std::nullopt;
+            },
+            anyValue);
+    }
+};
+
+} // namespace nodemanager
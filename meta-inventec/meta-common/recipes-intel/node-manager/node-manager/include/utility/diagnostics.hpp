@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "common_types.hpp"
+#include "crash_dump_buffer.hpp"
 #include "devices_manager/devices_manager.hpp"
+#include "diagnostics_writer.hpp"
 #include "performance_monitor.hpp"
 #include "status_provider_if.hpp"
 
@@ -33,6 +36,12 @@ static constexpr const char* kOsReleasePath{"/etc/os-release"};
 static constexpr const char* kVersionTag{"VERSION_ID="};
 static constexpr const char* kOpenbmcVersionTag{"OPENBMC_VERSION="};
 
+/**
+ * @brief Status dumps requested more often are served from the cache, so
+ * polling the diagnostics does not disturb the control loop.
+ */
+static constexpr std::chrono::milliseconds kDiagnosticsCacheTtl{1000};
+
 class Diagnostics : public StatusProviderIf
 {
   private:
@@ -97,6 +106,24 @@ class Diagnostics : public StatusProviderIf
         return getMostRestrictiveHealth(allHealth);
     }
 
+    /**
+     * @brief Copies the current status dump to the crash dump buffer.
+     */
+    void refreshCrashDump()
+    {
+        getStatusDump(DiagnosticsFormat::json);
+    }
+
+    /**
+     * @brief Returns the status dump stored by the last refresh. Neither
+     * collects the status nor allocates memory, so it is safe to call when
+     * the service is being aborted.
+     */
+    const char* getCrashDump() const
+    {
+        return crashDump.get();
+    }
+
   private:
     std::shared_ptr<sdbusplus::asio::connection> bus;
     std::shared_ptr<DevicesManager> devicesManager;
@@ -105,6 +132,15 @@ class Diagnostics : public StatusProviderIf
     std::string const objectPath;
     DbusInterfaces dbusInterfaces{objectPath, objectServer};
     std::shared_ptr<PerformanceCollector> performance = nullptr;
+    const DiagnosticsSection imageSection{"Image", readImageVersion()};
+    CrashDumpBuffer crashDump;
+
+    struct StatusDumpCache
+    {
+        std::string content;
+        std::optional<Clock::time_point> timestamp;
+    };
+    std::array<StatusDumpCache, 2> statusDumpCache;
 
     /**
      * @brief Class used to summarize asynchronous calls.
@@ -136,8 +172,9 @@ class Diagnostics : public StatusProviderIf
         Callback callback;
     };
 
-    void addImageVersion(nlohmann::json& out)
+    static nlohmann::json readImageVersion()
     {
+        nlohmann::json version;
         if (std::filesystem::exists(kOsReleasePath))
         {
             std::ifstream in(kOsReleasePath);
@@ -149,21 +186,72 @@ class Diagnostics : public StatusProviderIf
                     line.end());
                 if (line.starts_with(kVersionTag))
                 {
-                    out["Image"]["Version"]["openbmc-meta-intel"] =
+                    version["Version"]["openbmc-meta-intel"] =
                         line.substr(strlen(kVersionTag));
                 }
                 else if (line.starts_with(kOpenbmcVersionTag))
                 {
-                    out["Image"]["Version"]["openbmc-openbmc"] =
+                    version["Version"]["openbmc-openbmc"] =
                         line.substr(strlen(kOpenbmcVersionTag));
                 }
             }
         }
+        return version;
     }
 
-    void addConfiguration(nlohmann::json& out)
+    /**
+     * @brief Returns the status dump, regenerated only when the cached one is
+     * older than kDiagnosticsCacheTtl.
+     */
+    const std::string& getStatusDump(DiagnosticsFormat format)
     {
-        out["Configuration"] = Config::getInstance().toJson();
+        auto& cache = statusDumpCache[static_cast<size_t>(format)];
+        const auto now = Clock::now();
+        if (cache.timestamp && now - *cache.timestamp < kDiagnosticsCacheTtl)
+        {
+            return cache.content;
+        }
+
+        DiagnosticsWriter writer(format, cache.content);
+        writer.add("Timestamp", getTimeStamp());
+        writeStatus(writer);
+        writer.add(imageSection);
+        writer.add("Configuration", Config::getInstance().toJson());
+        writer.finish();
+        cache.timestamp = now;
+
+        if (format == DiagnosticsFormat::json)
+        {
+            crashDump.store(cache.content);
+        }
+        return cache.content;
+    }
+
+    /**
+     * @brief Same members as reportStatus(), but each provider is serialized
+     * and released before the next one is collected.
+     */
+    void writeStatus(DiagnosticsWriter& writer) const
+    {
+        if (devicesManager)
+        {
+            nlohmann::json devicesStatus;
+            devicesManager->reportStatus(devicesStatus);
+            writer.addMembers(devicesStatus);
+        }
+        writePerformance(writer);
+    }
+
+    void writePerformance(DiagnosticsWriter& writer) const
+    {
+        nlohmann::json performanceStatus;
+        performanceStatus["Performance"]["MeasurementEnabled"] =
+            static_cast<bool>(performance);
+        if (performance)
+        {
+            performance->reportStatus(performanceStatus);
+        }
+        writer.addMembers(performanceStatus);
     }
 
     void dumpStatusToLog()
@@ -172,10 +260,10 @@ class Diagnostics : public StatusProviderIf
             std::make_shared<AsyncJson>([](nlohmann::json& jsonOut) {
                 Logger::log<LogLevel::info>(jsonOut.dump());
             });
-        addTimeStamp(out->getJson());
+        out->getJson()["Timestamp"] = getTimeStamp();
         reportStatus(out->getJson());
-        addImageVersion(out->getJson());
-        addConfiguration(out->getJson());
+        out->getJson()["Image"] = imageSection.getValue();
+        out->getJson()["Configuration"] = Config::getInstance().toJson();
 
         // get Sx states
         bus->async_method_call(
@@ -255,20 +343,22 @@ class Diagnostics : public StatusProviderIf
             "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
     }
 
-    void addTimeStamp(nlohmann::json& out)
+    static int64_t getTimeStamp()
     {
-        out["Timestamp"] =
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch())
-                .count();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
     }
 
-    void createPerformanceReport(nlohmann::json& out)
+    std::string createPerformanceReport()
     {
-        addTimeStamp(out);
-        out["Performance"]["MeasurementEnabled"] = true;
-        performance->reportStatus(out);
-        addImageVersion(out);
+        std::string out;
+        DiagnosticsWriter writer(DiagnosticsFormat::json, out);
+        writer.add("Timestamp", getTimeStamp());
+        writePerformance(writer);
+        writer.add(imageSection);
+        writer.finish();
+        return out;
     }
 
     void initializeDbusInterfaces()
@@ -278,12 +368,11 @@ class Diagnostics : public StatusProviderIf
                 iface.register_method("DumpToLog",
                                       [this]() { dumpStatusToLog(); });
                 iface.register_method("DumpToJson", [this]() {
-                    nlohmann::json out;
-                    addTimeStamp(out);
-                    reportStatus(out);
-                    addImageVersion(out);
-                    addConfiguration(out);
-                    return out.dump();
+                    return getStatusDump(DiagnosticsFormat::json);
+                });
+                iface.register_method("DumpToCbor", [this]() {
+                    const auto& dump = getStatusDump(DiagnosticsFormat::cbor);
+                    return std::vector<uint8_t>(dump.begin(), dump.end());
                 });
                 iface.register_method("GetThrottlingLog", [this]() {
                     return throttlingLogCollector->getJson().dump();
@@ -328,20 +417,25 @@ class Diagnostics : public StatusProviderIf
                 });
 
                 iface.register_method("DumpToJson", [this]() {
-                    nlohmann::json out;
                     if (performance)
                     {
-                        createPerformanceReport(out);
+                        return createPerformanceReport();
+                    }
+                    return nlohmann::json().dump();
+                });
+
+                iface.register_method("GetLatencyPercentiles", [this]() {
+                    if (performance)
+                    {
+                        return performance->getLatencyPercentiles();
                     }
-                    return out.dump();
+                    return std::vector<LatencyPercentiles>{};
                 });
 
                 iface.register_method("DumpToLog", [this]() {
                     if (performance)
                     {
-                        nlohmann::json out;
-                        createPerformanceReport(out);
-                        Logger::log<LogLevel::info>(out.dump());
+                        Logger::log<LogLevel::info>(createPerformanceReport());
                         return true;
                     }
                     return false;
@@ -0,0 +1,143 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace nodemanager
+{
+
+enum class DiagnosticsFormat
+{
+    json,
+    cbor
+};
+
+/**
+ * @brief Top level member of the diagnostics report which does not change at
+ * runtime. It is serialized once, in every supported format.
+ */
+class DiagnosticsSection
+{
+  public:
+    DiagnosticsSection(std::string_view name, const nlohmann::json& valueArg) :
+        value(valueArg)
+    {
+        jsonText = nlohmann::json(name).dump() + ":" + value.dump();
+        nlohmann::json::to_cbor(nlohmann::json(name), cborBytes);
+        nlohmann::json::to_cbor(value, cborBytes);
+    }
+
+    const nlohmann::json& getValue() const
+    {
+        return value;
+    }
+
+    std::string_view get(DiagnosticsFormat format) const
+    {
+        if (format == DiagnosticsFormat::cbor)
+        {
+            return cborBytes;
+        }
+        return jsonText;
+    }
+
+  private:
+    nlohmann::json value;
+    std::string jsonText;
+    std::string cborBytes;
+};
+
+/**
+ * @brief Serializes the diagnostics report as a single object, member by
+ * member, into the provided buffer.
+ *
+ * Only the member being added has to be kept as a json tree. CBOR output uses
+ * an indefinite length map, so members can be appended without knowing their
+ * number up front. The buffer is cleared but its memory is reused.
+ */
+class DiagnosticsWriter
+{
+  public:
+    DiagnosticsWriter(DiagnosticsFormat formatArg, std::string& outArg) :
+        format(formatArg), out(outArg)
+    {
+        out.clear();
+        out.push_back(format == DiagnosticsFormat::cbor ? kCborMapStart : '{');
+    }
+
+    void add(std::string_view name, const nlohmann::json& value)
+    {
+        if (format == DiagnosticsFormat::cbor)
+        {
+            nlohmann::json::to_cbor(nlohmann::json(name), out);
+            nlohmann::json::to_cbor(value, out);
+            return;
+        }
+        addSeparator();
+        out += nlohmann::json(name).dump();
+        out.push_back(':');
+        out += value.dump();
+    }
+
+    void add(const DiagnosticsSection& section)
+    {
+        if (format == DiagnosticsFormat::json)
+        {
+            addSeparator();
+        }
+        out += section.get(format);
+    }
+
+    /**
+     * @brief Adds every member of the object as a top level member.
+     */
+    void addMembers(const nlohmann::json& object)
+    {
+        for (const auto& [name, value] : object.items())
+        {
+            add(name, value);
+        }
+    }
+
+    void finish()
+    {
+        out.push_back(format == DiagnosticsFormat::cbor ? kCborBreak : '}');
+    }
+
+  private:
+    static constexpr char kCborMapStart = static_cast<char>(0xbf);
+    static constexpr char kCborBreak = static_cast<char>(0xff);
+
+    DiagnosticsFormat format;
+    std::string& out;
+    bool empty = true;
+
+    void addSeparator()
+    {
+        if (!empty)
+        {
+            out.push_back(',');
+        }
+        empty = false;
+    }
+};
+
+} // namespace nodemanager
@@ -39,6 +39,11 @@ class FileMatcher
         pathRegex(pathRegexArg), extractResults(extractResultsArg){};
     virtual ~FileMatcher() = default;
 
+    const std::filesystem::path& getRootPath() const
+    {
+        return rootPath;
+    }
+
     void findFiles(PathDecompositionMap& foundPaths,
                    unsigned int symlinkDepth = 0U) const
     {
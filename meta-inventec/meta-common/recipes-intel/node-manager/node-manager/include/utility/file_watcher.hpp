@@ -22,9 +22,13 @@
 namespace nodemanager
 {
 
-using FileWatcherCallback =
-    std::function<void(const std::vector<std::string>&)>;
+using FileWatcherCallback = std::function<void()>;
 
+/**
+ * @brief Calls the callback when the file is modified or when a new file with
+ * the same name is created, e.g. after rotation. Reading the file is left to
+ * the callback.
+ */
 class FileWatcher
 {
   public:
@@ -40,7 +44,6 @@ class FileWatcher
         filePath(filePathArg),
         callback(callbackArg)
     {
-        cacheFile();
         startMonitor(ioc);
     }
 
@@ -65,7 +68,6 @@ class FileWatcher
     int inotifyFd = -1;
     int dirWatchDesc = -1;
     int fileWatchDesc = -1;
-    std::streampos filePosition{0};
 
     void startMonitor(boost::asio::io_context& ioc)
     {
@@ -102,50 +104,6 @@ class FileWatcher
         watchFile();
     }
 
-    void resetFilePosition()
-    {
-        filePosition = 0;
-    }
-
-    void cacheFile()
-    {
-        std::ifstream fileStream(filePath);
-        if (!fileStream.good())
-        {
-            Logger::log<LogLevel::error>("File open failed for %s",
-                                         filePath.string());
-            return;
-        }
-        std::string logEntry;
-        while (std::getline(fileStream, logEntry))
-        {
-            filePosition = fileStream.tellg();
-        }
-    }
-
-    void readFromFile()
-    {
-        std::ifstream fileStream(filePath);
-        if (!fileStream.good())
-        {
-            Logger::log<LogLevel::error>("File open failed for %s",
-                                         filePath.string());
-            return;
-        }
-
-        fileStream.seekg(filePosition);
-
-        std::string line;
-        std::vector<std::string> lines;
-
-        while (std::getline(fileStream, line))
-        {
-            filePosition = fileStream.tellg();
-            lines.push_back(line);
-        }
-        callback(lines);
-    }
-
     void watchFile()
     {
         if (!inotifyConn)
@@ -224,8 +182,7 @@ class FileWatcher
                         return;
                     }
 
-                    resetFilePosition();
-                    readFromFile();
+                    callback();
                 }
                 else if ((event.mask == IN_DELETE) ||
                          (event.mask == IN_MOVED_TO))
@@ -241,7 +198,7 @@ class FileWatcher
             {
                 if (event.mask == IN_MODIFY)
                 {
-                    readFromFile();
+                    callback();
                 }
             }
             index += (eventSize + event.len);
@@ -0,0 +1,141 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace nodemanager
+{
+
+static constexpr unsigned kHistogramSubBucketBits = 4;
+
+/**
+ * @brief Fixed-memory log-linear histogram of non-negative integer values.
+ *
+ * Values below 2^kHistogramSubBucketBits are counted exactly. Each following
+ * power of two range is split into 2^kHistogramSubBucketBits linear
+ * sub-buckets, so the relative error of a reported value does not exceed
+ * 1/2^kHistogramSubBucketBits (6.25%). Values above uint32_t max are clamped.
+ */
+class LatencyHistogram
+{
+  public:
+    static constexpr uint32_t kSubBucketsCount = 1u << kHistogramSubBucketBits;
+    static constexpr size_t kBucketsCount =
+        (std::numeric_limits<uint32_t>::digits - kHistogramSubBucketBits + 1) *
+        kSubBucketsCount;
+
+    void record(const uint64_t valueArg)
+    {
+        const auto value = static_cast<uint32_t>(std::min<uint64_t>(
+            valueArg, std::numeric_limits<uint32_t>::max()));
+        counts[getBucketIndex(value)]++;
+        totalCount++;
+        maxValue = std::max(maxValue, value);
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for (size_t idx = 0; idx < kBucketsCount; ++idx)
+        {
+            counts[idx] += other.counts[idx];
+        }
+        totalCount += other.totalCount;
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    void reset()
+    {
+        counts.fill(0);
+        totalCount = 0;
+        maxValue = 0;
+    }
+
+    uint64_t getCount() const
+    {
+        return totalCount;
+    }
+
+    uint32_t getMax() const
+    {
+        return maxValue;
+    }
+
+    /**
+     * @brief Returns the highest value equivalent to the one below which
+     * `percentile` percent of the recorded values fall, 0 when empty.
+     */
+    uint32_t getValueAtPercentile(const double percentile) const
+    {
+        if (totalCount == 0)
+        {
+            return 0;
+        }
+        const auto rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(
+                   std::clamp(percentile, 0.0, 100.0) / 100.0 *
+                   static_cast<double>(totalCount))));
+        uint64_t accumulated = 0;
+        for (size_t idx = 0; idx < kBucketsCount; ++idx)
+        {
+            accumulated += counts[idx];
+            if (accumulated >= rank)
+            {
+                return std::min(getBucketUpperBound(idx), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    static constexpr size_t getBucketIndex(const uint32_t value)
+    {
+        if (value < kSubBucketsCount)
+        {
+            return value;
+        }
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) -
+                               1 - kHistogramSubBucketBits;
+        return (shift + 1) * kSubBucketsCount +
+               ((value >> shift) - kSubBucketsCount);
+    }
+
+    static constexpr uint32_t getBucketUpperBound(const size_t index)
+    {
+        if (index < kSubBucketsCount)
+        {
+            return static_cast<uint32_t>(index);
+        }
+        const auto shift = static_cast<unsigned>(index / kSubBucketsCount - 1);
+        const auto lowerBound =
+            static_cast<uint64_t>(kSubBucketsCount + index % kSubBucketsCount)
+            << shift;
+        return static_cast<uint32_t>(lowerBound + (uint64_t{1} << shift) - 1);
+    }
+
+  private:
+    std::array<uint32_t, kBucketsCount> counts{};
+    uint64_t totalCount = 0;
+    uint32_t maxValue = 0;
+};
+
+} // namespace nodemanager
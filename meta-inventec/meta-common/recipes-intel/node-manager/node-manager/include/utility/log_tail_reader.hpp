@@ -0,0 +1,235 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "loggers/log.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Identifies position in a particular file, stays valid when the file
+ * is renamed.
+ */
+struct LogTailPosition
+{
+    uint64_t inode;
+    uint64_t offset;
+};
+
+/**
+ * @brief Returns lines appended to a log file since the previous call.
+ *
+ * The file is kept open and only the appended bytes are read. When the file
+ * is rotated, i.e. renamed and replaced with a new one, the rest of the
+ * rotated file is read through the open descriptor before switching to the
+ * new file, so no lines are lost. Incomplete last line is kept until its
+ * newline is written.
+ */
+class LogTailReader
+{
+  public:
+    LogTailReader(const LogTailReader&) = delete;
+    LogTailReader& operator=(const LogTailReader&) = delete;
+    LogTailReader(LogTailReader&&) = delete;
+    LogTailReader& operator=(LogTailReader&&) = delete;
+
+    explicit LogTailReader(const std::filesystem::path& filePathArg) :
+        filePath(filePathArg)
+    {
+    }
+
+    virtual ~LogTailReader()
+    {
+        closeFile();
+    }
+
+    /**
+     * @brief Skips the current content of the file.
+     */
+    void seekToEnd()
+    {
+        closeFile();
+        if (openFile())
+        {
+            struct stat fileStat = {};
+            if (::fstat(fd, &fileStat) == 0)
+            {
+                offset = static_cast<uint64_t>(fileStat.st_size);
+            }
+        }
+    }
+
+    /**
+     * @brief Continues reading from the position returned earlier by
+     * getPosition(). Returns false, leaving the reader at the beginning of
+     * the file, when the position does not refer to the current file.
+     */
+    bool seek(const LogTailPosition& position)
+    {
+        closeFile();
+        if (!openFile())
+        {
+            return false;
+        }
+        struct stat fileStat = {};
+        if (::fstat(fd, &fileStat) != 0 ||
+            static_cast<uint64_t>(fileStat.st_ino) != position.inode ||
+            static_cast<uint64_t>(fileStat.st_size) < position.offset)
+        {
+            return false;
+        }
+        offset = position.offset;
+        return true;
+    }
+
+    /**
+     * @brief Position right after the last returned line.
+     */
+    std::optional<LogTailPosition> getPosition() const
+    {
+        if (fd < 0)
+        {
+            return std::nullopt;
+        }
+        return LogTailPosition{inode, offset - partialLine.size()};
+    }
+
+    std::vector<std::string> readNewLines()
+    {
+        std::vector<std::string> lines;
+        if (fd >= 0)
+        {
+            readAppended(lines);
+        }
+        if (isReplaced())
+        {
+            if (!partialLine.empty())
+            {
+                lines.push_back(std::move(partialLine));
+                partialLine.clear();
+            }
+            closeFile();
+            if (openFile())
+            {
+                readAppended(lines);
+            }
+        }
+        return lines;
+    }
+
+  private:
+    std::filesystem::path filePath;
+    int fd = -1;
+    uint64_t inode = 0;
+    uint64_t offset = 0;
+    std::string partialLine;
+
+    bool openFile()
+    {
+        fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat fileStat = {};
+        if (::fstat(fd, &fileStat) == 0)
+        {
+            inode = static_cast<uint64_t>(fileStat.st_ino);
+        }
+        return true;
+    }
+
+    void closeFile()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        fd = -1;
+        inode = 0;
+        offset = 0;
+        partialLine.clear();
+    }
+
+    bool isReplaced() const
+    {
+        struct stat pathStat = {};
+        if (::stat(filePath.c_str(), &pathStat) != 0)
+        {
+            return false;
+        }
+        return fd < 0 || static_cast<uint64_t>(pathStat.st_ino) != inode;
+    }
+
+    void readAppended(std::vector<std::string>& lines)
+    {
+        struct stat fileStat = {};
+        if (::fstat(fd, &fileStat) == 0 &&
+            static_cast<uint64_t>(fileStat.st_size) < offset)
+        {
+            Logger::log<LogLevel::debug>("File %s truncated, reading from start",
+                                         filePath.c_str());
+            offset = 0;
+            partialLine.clear();
+        }
+
+        std::array<char, 4096> buffer;
+        while (true)
+        {
+            const auto bytesRead = ::pread(fd, buffer.data(), buffer.size(),
+                                           static_cast<off_t>(offset));
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            offset += static_cast<uint64_t>(bytesRead);
+            splitLines(std::string_view(buffer.data(),
+                                        static_cast<size_t>(bytesRead)),
+                       lines);
+        }
+    }
+
+    void splitLines(std::string_view data, std::vector<std::string>& lines)
+    {
+        size_t lineStart = 0;
+        for (size_t idx = 0; idx < data.size(); ++idx)
+        {
+            if (data[idx] == '\n')
+            {
+                partialLine.append(data.substr(lineStart, idx - lineStart));
+                lines.push_back(std::move(partialLine));
+                partialLine.clear();
+                lineStart = idx + 1;
+            }
+        }
+        partialLine.append(data.substr(lineStart));
+    }
+};
+
+} // namespace nodemanager
@@ -0,0 +1,280 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "clock.hpp"
+#include "loggers/log.hpp"
+#include "utility/performance_monitor.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Determines what happens when a task does not finish within its
+ * deadline. With both policies periods missed because of a late run are
+ * skipped instead of being executed back to back.
+ */
+enum class OverrunPolicy
+{
+    /**
+     * @brief Only the missed periods are skipped.
+     */
+    skip,
+    /**
+     * @brief Additionally the next run after the overrun is dropped, so the
+     * time is given back to the remaining tasks.
+     */
+    shed
+};
+
+struct LoopTaskConfig
+{
+    /**
+     * @brief It must be a valid dbus object name, it is used to name the
+     * performance measures of the task.
+     */
+    std::string name;
+    std::chrono::milliseconds period;
+    /**
+     * @brief Delay of the first run after the scheduler is started. Tasks with
+     * the same period and offset are executed together, in the order in which
+     * they were added.
+     */
+    std::chrono::milliseconds offset;
+    std::chrono::milliseconds deadline;
+    OverrunPolicy overrunPolicy;
+};
+
+struct LoopTaskCounters
+{
+    uint64_t runs = 0;
+    uint64_t overruns = 0;
+    uint64_t skippedPeriods = 0;
+    uint64_t shedRuns = 0;
+};
+
+/**
+ * @brief Executes periodic tasks, each with its own period, phase offset and
+ * deadline, from the io_context thread.
+ *
+ * A single timer is armed for the earliest due task. Run duration of each task
+ * is reported as `Scheduler-<name>-run-duration` measure with the deadline as
+ * its threshold and the counters are reported as gauges.
+ */
+class LoopScheduler
+{
+    struct Task
+    {
+        LoopTaskConfig config;
+        std::function<void()> run;
+        MeasureHandle durationMeasure;
+        Clock::time_point nextDue{};
+        bool shedNextRun = false;
+        LoopTaskCounters counters;
+    };
+
+  public:
+    LoopScheduler(const LoopScheduler&) = delete;
+    LoopScheduler& operator=(const LoopScheduler&) = delete;
+    LoopScheduler(LoopScheduler&&) = delete;
+    LoopScheduler& operator=(LoopScheduler&&) = delete;
+
+    explicit LoopScheduler(boost::asio::io_context& iocArg) : timer(iocArg)
+    {
+    }
+
+    virtual ~LoopScheduler() = default;
+
+    void addTask(const LoopTaskConfig& config, std::function<void()> run)
+    {
+        if (config.period.count() <= 0)
+        {
+            throw std::logic_error("LoopScheduler task period must be > 0");
+        }
+        tasks.push_back(
+            {config, std::move(run),
+             MeasureHandle("Scheduler-" + config.name + "-run-duration",
+                           config.deadline)});
+        if (isStarted)
+        {
+            tasks.back().nextDue = Clock::now() + config.offset;
+            armTimer();
+        }
+    }
+
+    void start()
+    {
+        const auto now = Clock::now();
+        for (auto& task : tasks)
+        {
+            task.nextDue = now + task.config.offset;
+        }
+        isStarted = true;
+        armTimer();
+    }
+
+    void stop()
+    {
+        isStarted = false;
+        timer.cancel();
+    }
+
+    /**
+     * @brief Executes all tasks that are due, in the order in which they were
+     * added, and schedules their next runs.
+     */
+    void runDueTasks()
+    {
+        const auto now = Clock::now();
+        for (auto& task : tasks)
+        {
+            if (task.nextDue > now)
+            {
+                continue;
+            }
+            if (task.shedNextRun)
+            {
+                task.shedNextRun = false;
+                task.counters.shedRuns++;
+            }
+            else
+            {
+                runTask(task);
+            }
+            scheduleNextRun(task);
+        }
+        publishCounters();
+    }
+
+    Clock::time_point getNextDueTime() const
+    {
+        auto nextDue = Clock::time_point::max();
+        for (const auto& task : tasks)
+        {
+            nextDue = std::min(nextDue, task.nextDue);
+        }
+        return nextDue;
+    }
+
+    LoopTaskCounters getCounters(const std::string& name) const
+    {
+        for (const auto& task : tasks)
+        {
+            if (task.config.name == name)
+            {
+                return task.counters;
+            }
+        }
+        throw std::out_of_range("Unknown LoopScheduler task: " + name);
+    }
+
+  private:
+    boost::asio::steady_timer timer;
+    std::vector<Task> tasks;
+    bool isStarted = false;
+
+    void runTask(Task& task)
+    {
+        const auto start = Clock::now();
+        {
+            auto perf = Perf(task.durationMeasure);
+            task.run();
+        }
+        task.counters.runs++;
+
+        const auto duration = Clock::now() - start;
+        if (duration > task.config.deadline)
+        {
+            task.counters.overruns++;
+            task.shedNextRun =
+                (task.config.overrunPolicy == OverrunPolicy::shed);
+            Logger::log<LogLevel::debug>(
+                "[LoopScheduler] %s exceeded its deadline, took %d us",
+                task.config.name.c_str(),
+                static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        duration)
+                        .count()));
+        }
+    }
+
+    /**
+     * @brief Moves the due time by one period. Periods that already passed
+     * are skipped, so a late task does not run several times in a row.
+     */
+    void scheduleNextRun(Task& task)
+    {
+        task.nextDue += task.config.period;
+        const auto now = Clock::now();
+        if (task.nextDue <= now)
+        {
+            const auto missed = (now - task.nextDue) / task.config.period + 1;
+            task.nextDue += missed * task.config.period;
+            task.counters.skippedPeriods += static_cast<uint64_t>(missed);
+        }
+    }
+
+    void publishCounters() const
+    {
+        auto performance = performanceCollectorWp.lock();
+        if (!performance)
+        {
+            return;
+        }
+        for (const auto& task : tasks)
+        {
+            const auto prefix = "Scheduler-" + task.config.name;
+            performance->setGauge(
+                prefix + "-overruns",
+                static_cast<double>(task.counters.overruns));
+            performance->setGauge(
+                prefix + "-skipped-periods",
+                static_cast<double>(task.counters.skippedPeriods));
+            performance->setGauge(
+                prefix + "-shed-runs",
+                static_cast<double>(task.counters.shedRuns));
+        }
+    }
+
+    void armTimer()
+    {
+        if (!isStarted || tasks.empty())
+        {
+            return;
+        }
+        timer.expires_at(
+            std::chrono::time_point_cast<
+                boost::asio::steady_timer::clock_type::duration>(
+                getNextDueTime()));
+        timer.async_wait([this](const boost::system::error_code& ec) {
+            if (ec == boost::asio::error::operation_aborted || !isStarted)
+            {
+                return;
+            }
+            runDueTasks();
+            armTimer();
+        });
+    }
+};
+
+} // namespace nodemanager
@@ -20,10 +20,13 @@
 #include "clock.hpp"
 #include "loggers/log.hpp"
 #include "utility/dbus_interfaces.hpp"
+#include "utility/latency_histogram.hpp"
 #include "utility/status_provider_if.hpp"
 
 #include <boost/algorithm/string/replace.hpp>
+#include <deque>
 #include <filesystem>
+#include <mutex>
 #include <nlohmann/json.hpp>
 
 namespace nodemanager
@@ -32,6 +35,19 @@ namespace nodemanager
 class Performance;
 class PerformanceCollector;
 
+/**
+ * @brief Percentiles are calculated from samples collected in the current and
+ * the previous window, so they always cover between one and two windows.
+ */
+static constexpr auto kPerformanceHistogramWindow = std::chrono::seconds{60};
+
+/**
+ * @brief Measure name, number of samples in the histogram window, p50, p90,
+ * p99, p99.9 and max of the window in microseconds.
+ */
+using LatencyPercentiles = std::tuple<std::string, uint64_t, uint32_t,
+                                      uint32_t, uint32_t, uint32_t, uint32_t>;
+
 /**
  * @brief A class that represents all performace measurements.
  *
@@ -39,7 +55,8 @@ class PerformanceCollector;
  * max value that ever occured.
  * This class also exposes on dbus its values. Units of: Value, ValueMax are
  * microseconds. The hitCounter attribute holds value of how many times this
- * measure was hit.
+ * measure was hit. Samples are additionally recorded in a histogram which is
+ * reset every kPerformanceHistogramWindow.
  */
 class Measure
 {
@@ -69,25 +86,57 @@ class Measure
     {
         if (isMeasuring)
         {
-            if (std::numeric_limits<uint32_t>::max() == hitCounter ||
-                ((Clock::duration::max() - valueAccumulator) < value))
+            const auto now = Clock::now();
+            addSample(now - start, now);
+            isMeasuring = false;
+        }
+        else
+        {
+            throw std::logic_error("Performance measuring cannot be stopped "
+                                   "because it was not started, name: " +
+                                   name);
+        }
+    }
+
+    /**
+     * @brief Adds a value measured outside of the start/stop methods, e.g. by
+     * a worker thread.
+     */
+    void addSample(const Clock::duration sample)
+    {
+        addSample(sample, Clock::now());
+    }
+
+    void addSample(const Clock::duration sample, const Clock::time_point now)
+    {
+        if (now - windowStart >= kPerformanceHistogramWindow)
+        {
+            if (now - windowStart >= 2 * kPerformanceHistogramWindow)
             {
-                resetStatistics();
+                previousWindow.reset();
             }
             else
             {
-                value = Clock::now() - start;
-                value_max = std::max(value_max, value);
-                valueAccumulator += value;
-                hitCounter++;
+                previousWindow = currentWindow;
             }
-            isMeasuring = false;
+            currentWindow.reset();
+            windowStart = now;
+        }
+        currentWindow.record(static_cast<uint64_t>(std::max<int64_t>(
+            0, std::chrono::duration_cast<std::chrono::microseconds>(sample)
+                   .count())));
+
+        if (std::numeric_limits<uint32_t>::max() == hitCounter ||
+            ((Clock::duration::max() - valueAccumulator) < sample))
+        {
+            resetStatistics();
         }
         else
         {
-            throw std::logic_error("Performance measuring cannot be stopped "
-                                   "because it was not started, name: " +
-                                   name);
+            value = sample;
+            value_max = std::max(value_max, value);
+            valueAccumulator += value;
+            hitCounter++;
         }
     }
 
@@ -101,6 +150,23 @@ class Measure
         return NmHealth::ok;
     }
 
+    /**
+     * @brief Returns histogram of samples from the last one to two windows.
+     */
+    LatencyHistogram getHistogram(const Clock::time_point now) const
+    {
+        LatencyHistogram histogram;
+        if (now - windowStart < 2 * kPerformanceHistogramWindow)
+        {
+            histogram = currentWindow;
+            if (now - windowStart < kPerformanceHistogramWindow)
+            {
+                histogram.merge(previousWindow);
+            }
+        }
+        return histogram;
+    }
+
     std::string name; // @brief unique name identifing this mesurement
     Clock::duration
         value; // @brief a distance measured from start to stop calls
@@ -115,6 +181,9 @@ class Measure
                       // progress
     Clock::duration threshold; // @brief if valueAccumulator exceeds threshold
                                // value then counter reports warning.
+    LatencyHistogram currentWindow;
+    LatencyHistogram previousWindow;
+    Clock::time_point windowStart = Clock::now();
 
     void resetStatistics()
     {
@@ -126,9 +195,27 @@ class Measure
 
 void to_json(nlohmann::json& j, const Measure& measure)
 {
+    const auto histogram = measure.getHistogram(Clock::now());
+    if (histogram.getCount() > 0)
+    {
+        j["WindowHitCounter"] = histogram.getCount();
+        j["P50[us]"] = histogram.getValueAtPercentile(50.0);
+        j["P90[us]"] = histogram.getValueAtPercentile(90.0);
+        j["P99[us]"] = histogram.getValueAtPercentile(99.0);
+        j["P99.9[us]"] = histogram.getValueAtPercentile(99.9);
+    }
+    else
+    {
+        j["WindowHitCounter"] = 0;
+        j["P50[us]"] = std::numeric_limits<double>::quiet_NaN();
+        j["P90[us]"] = std::numeric_limits<double>::quiet_NaN();
+        j["P99[us]"] = std::numeric_limits<double>::quiet_NaN();
+        j["P99.9[us]"] = std::numeric_limits<double>::quiet_NaN();
+    }
+
     if (measure.hitCounter > 0)
     {
-        j = nlohmann::json{
+        j.update(nlohmann::json{
             {"HitCounter", measure.hitCounter},
             {"Value[us]", std::chrono::duration_cast<std::chrono::microseconds>(
                               measure.value)
@@ -142,19 +229,88 @@ void to_json(nlohmann::json& j, const Measure& measure)
                  measure.valueAccumulator)
                      .count() /
                  measure.hitCounter},
-            {"Health", enumToStr(healthNames, measure.getHealth())}};
+            {"Health", enumToStr(healthNames, measure.getHealth())}});
     }
     else
     {
-        j = nlohmann::json{
+        j.update(nlohmann::json{
             {"HitCounter", measure.hitCounter},
             {"Value[us]", std::numeric_limits<double>::quiet_NaN()},
             {"ValueMax[us]", std::numeric_limits<double>::quiet_NaN()},
             {"ValueAverage[us]", std::numeric_limits<double>::quiet_NaN()},
-            {"Health", enumToStr(healthNames, measure.getHealth())}};
+            {"Health", enumToStr(healthNames, measure.getHealth())}});
     }
 }
 
+/**
+ * @brief Identifies a measure registered once by name, e.g. as a function-local
+ * static, so that starting a measurement is an index into the collector instead
+ * of a lookup by name. Handles created with the same name share the measure.
+ */
+class MeasureHandle
+{
+  public:
+    struct Definition
+    {
+        std::string name;
+        Clock::duration threshold;
+    };
+
+    /**
+     * @param nameArg It must ba a valid dbus object name.
+     * @param thresholdArg - when the measurement exceeds this value then health
+     * status will be reported as warning.
+     */
+    explicit MeasureHandle(
+        const std::string& nameArg,
+        const Clock::duration thresholdArg = Clock::duration::zero()) :
+        id(registerMeasure(nameArg, thresholdArg))
+    {
+    }
+
+    size_t getId() const
+    {
+        return id;
+    }
+
+    static Definition getDefinition(const size_t idArg)
+    {
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        return getDefinitions().at(idArg);
+    }
+
+  private:
+    size_t id;
+
+    static size_t registerMeasure(const std::string& nameArg,
+                                  const Clock::duration thresholdArg)
+    {
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        auto& definitions = getDefinitions();
+        const auto it = std::find_if(
+            definitions.cbegin(), definitions.cend(),
+            [&nameArg](const auto& def) { return def.name == nameArg; });
+        if (it != definitions.cend())
+        {
+            return static_cast<size_t>(it - definitions.cbegin());
+        }
+        definitions.push_back({nameArg, thresholdArg});
+        return definitions.size() - 1;
+    }
+
+    static std::deque<Definition>& getDefinitions()
+    {
+        static std::deque<Definition> definitions;
+        return definitions;
+    }
+
+    static std::mutex& getRegistryMutex()
+    {
+        static std::mutex registryMutex;
+        return registryMutex;
+    }
+};
+
 /**
  * @brief This class holds all mesuremenets.
  */
@@ -167,23 +323,46 @@ class PerformanceCollector : public StatusProviderIf
     PerformanceCollector(PerformanceCollector&&) = delete;
     PerformanceCollector& operator=(PerformanceCollector&&) = delete;
 
-    std::shared_ptr<Measure> getMeasure(const std::string& nameArg,
-                                        const Clock::duration thresholdArg)
+    std::shared_ptr<Measure> getMeasure(const MeasureHandle& handle)
     {
-        auto& ret = measureMap[nameArg];
+        const auto id = handle.getId();
+        if (id >= measures.size())
+        {
+            measures.resize(id + 1);
+        }
+        auto& ret = measures[id];
         if (!ret)
         {
-            ret = std::make_shared<Measure>(nameArg, thresholdArg);
+            const auto definition = MeasureHandle::getDefinition(id);
+            ret = std::make_shared<Measure>(definition.name,
+                                            definition.threshold);
         }
         return ret;
     }
 
+    /**
+     * @brief Returns measure by name. Registers the name on the first call,
+     * prefer keeping a MeasureHandle for measures updated periodically.
+     */
+    std::shared_ptr<Measure> getMeasure(const std::string& nameArg,
+                                        const Clock::duration thresholdArg)
+    {
+        return getMeasure(MeasureHandle(nameArg, thresholdArg));
+    }
+
     void reportStatus(nlohmann::json& out) const final
     {
         auto& perfJson = out["Performance"];
-        for (auto const& [key, measure] : measureMap)
+        for (auto const& measure : measures)
+        {
+            if (measure)
+            {
+                perfJson[measure->name] = *measure;
+            }
+        }
+        for (auto const& [key, gauge] : gaugeMap)
         {
-            perfJson[key] = *measure;
+            perfJson[key] = gauge;
         }
         perfJson["Health"] = enumToStr(healthNames, getHealth());
     }
@@ -191,20 +370,54 @@ class PerformanceCollector : public StatusProviderIf
     NmHealth getHealth() const final
     {
         std::set<NmHealth> allHealth;
-        for (auto const& [key, measure] : measureMap)
+        for (auto const& measure : measures)
         {
-            allHealth.insert(measure->getHealth());
+            if (measure)
+            {
+                allHealth.insert(measure->getHealth());
+            }
         }
         return getMostRestrictiveHealth(allHealth);
     }
 
+    std::vector<LatencyPercentiles> getLatencyPercentiles() const
+    {
+        std::vector<LatencyPercentiles> ret;
+        const auto now = Clock::now();
+        for (auto const& measure : measures)
+        {
+            if (measure)
+            {
+                const auto histogram = measure->getHistogram(now);
+                ret.emplace_back(measure->name, histogram.getCount(),
+                                 histogram.getValueAtPercentile(50.0),
+                                 histogram.getValueAtPercentile(90.0),
+                                 histogram.getValueAtPercentile(99.0),
+                                 histogram.getValueAtPercentile(99.9),
+                                 histogram.getMax());
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Sets a value which is not a duration, e.g. utilization or
+     * counter, to be reported together with the measures.
+     */
+    void setGauge(const std::string& nameArg, const double valueArg)
+    {
+        gaugeMap[nameArg] = valueArg;
+    }
+
     void reset()
     {
-        measureMap.clear();
+        measures.clear();
+        gaugeMap.clear();
     }
 
   private:
-    std::unordered_map<std::string, std::shared_ptr<Measure>> measureMap;
+    std::vector<std::shared_ptr<Measure>> measures;
+    std::unordered_map<std::string, double> gaugeMap;
 };
 
 std::weak_ptr<PerformanceCollector> performanceCollectorWp;
@@ -236,18 +449,15 @@ class MeasureWrapper
     }
 
     /**
-     * @param nameArg It must ba a valid dbus object name.
-     * The name should follow this naming convention:
+     * @param handle Handle of a measure registered with a name that must ba a
+     * valid dbus object name. The name should follow this naming convention:
      * <component>-<method>-<time measure approach>
-     * @param thresholdArg - when the measurement exceeds this value then health
-     * status will be reported as warning.
      */
-    MeasureWrapper(const std::string& nameArg,
-                   const Clock::duration thresholdArg = Clock::duration::zero())
+    explicit MeasureWrapper(const MeasureHandle& handle)
     {
         if (auto spt = performanceCollectorWp.lock())
         {
-            measure = spt->getMeasure(nameArg, thresholdArg);
+            measure = spt->getMeasure(handle);
             measure->startMeasure();
         }
     }
@@ -0,0 +1,423 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "common_types.hpp"
+#include "loggers/log.hpp"
+#include "utility/performance_monitor.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Families of jobs executed by the WorkerPool. Every family has its own
+ * bounded queue and concurrency limit so a stalled bus (e.g. PECI timeouts)
+ * cannot starve the remaining families.
+ */
+enum class WorkerQueue : uint8_t
+{
+    hwmon = 0,
+    peci,
+    smart,
+    knob,
+    count
+};
+
+static const std::unordered_map<WorkerQueue, std::string> kWorkerQueueNames = {
+    {WorkerQueue::hwmon, "hwmon"},
+    {WorkerQueue::peci, "peci"},
+    {WorkerQueue::smart, "smart"},
+    {WorkerQueue::knob, "knob"}};
+
+struct WorkerQueueConfig
+{
+    size_t maxDepth;
+    size_t maxConcurrency;
+};
+
+static constexpr size_t kWorkerPoolThreadsCount = 4;
+static constexpr size_t kWorkerQueuesCount =
+    static_cast<size_t>(WorkerQueue::count);
+static constexpr std::array<WorkerQueueConfig, kWorkerQueuesCount>
+    kWorkerQueueConfigs = {{
+        {128, 2}, // hwmon
+        {128, 2}, // peci
+        {4, 1},   // smart
+        {128, 2}, // knob
+    }};
+static constexpr size_t kWorkerPoolMaxPendingSamples = 1024;
+static constexpr std::chrono::seconds kWorkerPoolUtilizationWindow{1};
+
+/**
+ * @brief Process-wide, fixed-size pool of worker threads used by sensors and
+ * knobs to execute blocking I/O (sysfs, PECI) outside of the io_context
+ * thread.
+ *
+ * Jobs are queued per WorkerQueue family. Each queue has a bounded depth, when
+ * it is full the job is rejected and an invalid (default constructed) future is
+ * returned, so the caller simply retries on the next tick. Jobs dropped before
+ * they started complete their futures with a value initialized result, the
+ * same as a job that could not read anything. Statistics about
+ * queue latency, job duration and pool utilization are gathered by worker
+ * threads and published to the PerformanceCollector from the io_context thread
+ * by publishStatistics().
+ */
+class WorkerPool
+{
+    using SteadyClock = std::chrono::steady_clock;
+
+    /**
+     * @brief Job executes the task and returns a completion which makes its
+     * future ready. Completions run after the job statistics are gathered,
+     * so a ready future means the job is fully accounted.
+     */
+    using Completion = std::function<void()>;
+
+    struct Job
+    {
+        std::function<Completion()> task;
+        Completion drop;
+        SteadyClock::time_point enqueued;
+    };
+
+    struct JobSample
+    {
+        SteadyClock::duration queueLatency;
+        SteadyClock::duration duration;
+    };
+
+    struct QueueState
+    {
+        WorkerQueueConfig config;
+        std::deque<Job> pending;
+        size_t running = 0;
+        uint64_t rejected = 0;
+        uint64_t cancelled = 0;
+        std::vector<JobSample> samples;
+        std::optional<MeasureHandle> latencyMeasure;
+        std::optional<MeasureHandle> durationMeasure;
+    };
+
+  public:
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    explicit WorkerPool(
+        const size_t threadsCountArg = kWorkerPoolThreadsCount,
+        const std::array<WorkerQueueConfig, kWorkerQueuesCount>& configsArg =
+            kWorkerQueueConfigs) :
+        threadsCount(threadsCountArg),
+        windowStart(SteadyClock::now())
+    {
+        for (size_t idx = 0; idx < kWorkerQueuesCount; ++idx)
+        {
+            queues[idx].config = configsArg[idx];
+            const auto name =
+                "WorkerPool-" + enumToStr(kWorkerQueueNames,
+                                          static_cast<WorkerQueue>(idx));
+            queues[idx].latencyMeasure.emplace(name + "-queue-latency",
+                                               std::chrono::milliseconds{50});
+            queues[idx].durationMeasure.emplace(name + "-job-duration");
+        }
+        for (size_t idx = 0; idx < threadsCount; ++idx)
+        {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool()
+    {
+        std::deque<Job> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            for (auto& queue : queues)
+            {
+                queue.cancelled += queue.pending.size();
+                std::move(queue.pending.begin(), queue.pending.end(),
+                          std::back_inserter(dropped));
+                queue.pending.clear();
+            }
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        for (auto& job : dropped)
+        {
+            job.drop();
+        }
+    }
+
+    static WorkerPool& getInstance()
+    {
+        static WorkerPool instance; // Guaranteed to be destroyed.
+                                    // Instantiated on first use.
+        return instance;
+    }
+
+    /**
+     * @brief Enqueues the `task` to the selected queue.
+     *
+     * @param queueId queue family the task belongs to
+     * @param task callable to execute. Important Note: the `task` is executed
+     * on a worker thread so it must be thread-safe.
+     * @return std::future with the task result, or an invalid future when the
+     * queue is full or the pool is stopping. When the job is cancelled the
+     * result is value initialized.
+     */
+    template <class F>
+    std::future<std::invoke_result_t<F>> submit(const WorkerQueue queueId,
+                                                F&& task)
+    {
+        using R = std::invoke_result_t<F>;
+        static_assert(std::is_void_v<R> || std::is_default_constructible_v<R>,
+                      "Cancelled jobs complete with a value initialized R");
+        auto promise = std::make_shared<std::promise<R>>();
+        auto future = promise->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& queue = getQueue(queueId);
+            if (stopping || queue.pending.size() >= queue.config.maxDepth)
+            {
+                queue.rejected++;
+                return {};
+            }
+            queue.pending.push_back(
+                {[promise, task = std::forward<F>(task)]() mutable -> Completion {
+                     try
+                     {
+                         if constexpr (std::is_void_v<R>)
+                         {
+                             task();
+                             return [promise]() { promise->set_value(); };
+                         }
+                         else
+                         {
+                             return [promise, result = std::make_shared<R>(
+                                                  task())]() {
+                                 promise->set_value(std::move(*result));
+                             };
+                         }
+                     }
+                     catch (...)
+                     {
+                         return [promise, error = std::current_exception()]() {
+                             promise->set_exception(error);
+                         };
+                     }
+                 },
+                 [promise]() {
+                     if constexpr (std::is_void_v<R>)
+                     {
+                         promise->set_value();
+                     }
+                     else
+                     {
+                         promise->set_value(R{});
+                     }
+                 },
+                 SteadyClock::now()});
+        }
+        wakeUp.notify_one();
+        return future;
+    }
+
+    /**
+     * @brief Drops all jobs of the selected queue that have not been started
+     * yet. Futures of the dropped jobs become ready with a value initialized
+     * result, jobs in progress are not interrupted.
+     *
+     * @param queueId
+     * @return size_t number of dropped jobs
+     */
+    size_t cancel(const WorkerQueue queueId)
+    {
+        std::deque<Job> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& queue = getQueue(queueId);
+            dropped.swap(queue.pending);
+            queue.cancelled += dropped.size();
+        }
+        for (auto& job : dropped)
+        {
+            job.drop();
+        }
+        return dropped.size();
+    }
+
+    /**
+     * @brief Moves statistics gathered by worker threads to the performance
+     * collector. Must be called from the io_context thread.
+     */
+    void publishStatistics()
+    {
+        std::array<std::vector<JobSample>, kWorkerQueuesCount> samples;
+        std::array<uint64_t, kWorkerQueuesCount> rejected;
+        SteadyClock::duration busy{0};
+        SteadyClock::duration window{0};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t idx = 0; idx < kWorkerQueuesCount; ++idx)
+            {
+                samples[idx].swap(queues[idx].samples);
+                rejected[idx] = queues[idx].rejected;
+            }
+            const auto now = SteadyClock::now();
+            if (now - windowStart >= kWorkerPoolUtilizationWindow)
+            {
+                window = now - windowStart;
+                busy = busyTime;
+                busyTime = SteadyClock::duration{0};
+                windowStart = now;
+            }
+        }
+
+        auto performance = performanceCollectorWp.lock();
+        if (!performance)
+        {
+            return;
+        }
+        for (size_t idx = 0; idx < kWorkerQueuesCount; ++idx)
+        {
+            const auto name = "WorkerPool-" +
+                              enumToStr(kWorkerQueueNames,
+                                        static_cast<WorkerQueue>(idx));
+            auto latency =
+                performance->getMeasure(*queues[idx].latencyMeasure);
+            auto duration =
+                performance->getMeasure(*queues[idx].durationMeasure);
+            for (const auto& sample : samples[idx])
+            {
+                latency->addSample(sample.queueLatency);
+                duration->addSample(sample.duration);
+            }
+            performance->setGauge(name + "-rejected",
+                                  static_cast<double>(rejected[idx]));
+        }
+        if (window.count() > 0 && threadsCount > 0)
+        {
+            performance->setGauge(
+                "WorkerPool-utilization[%]",
+                100.0 * static_cast<double>(busy.count()) /
+                    (static_cast<double>(window.count()) *
+                     static_cast<double>(threadsCount)));
+        }
+    }
+
+  private:
+    const size_t threadsCount;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::array<QueueState, kWorkerQueuesCount> queues;
+    size_t nextQueue = 0;
+    bool stopping = false;
+    SteadyClock::duration busyTime{0};
+    SteadyClock::time_point windowStart;
+    std::vector<std::thread> workers;
+
+    QueueState& getQueue(const WorkerQueue queueId)
+    {
+        const auto idx = static_cast<size_t>(queueId);
+        if (idx >= kWorkerQueuesCount)
+        {
+            throw std::logic_error("Unsupported WorkerQueue");
+        }
+        return queues[idx];
+    }
+
+    /**
+     * @brief Returns the next queue (round robin) that has a pending job and
+     * did not reach its concurrency limit. Must be called with mutex locked.
+     */
+    QueueState* findRunnableQueue()
+    {
+        for (size_t step = 0; step < kWorkerQueuesCount; ++step)
+        {
+            auto& queue = queues[(nextQueue + step) % kWorkerQueuesCount];
+            if (!queue.pending.empty() &&
+                queue.running < queue.config.maxConcurrency)
+            {
+                nextQueue = (nextQueue + step + 1) % kWorkerQueuesCount;
+                return &queue;
+            }
+        }
+        return nullptr;
+    }
+
+    void workerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            QueueState* queue = nullptr;
+            wakeUp.wait(lock, [this, &queue]() {
+                return stopping || (queue = findRunnableQueue()) != nullptr;
+            });
+            if (stopping)
+            {
+                return;
+            }
+
+            Job job = std::move(queue->pending.front());
+            queue->pending.pop_front();
+            queue->running++;
+            lock.unlock();
+
+            const auto started = SteadyClock::now();
+            auto complete = job.task();
+            const auto finished = SteadyClock::now();
+            job.task = nullptr;
+            job.drop = nullptr;
+
+            lock.lock();
+            queue->running--;
+            busyTime += finished - started;
+            if (queue->samples.size() < kWorkerPoolMaxPendingSamples)
+            {
+                queue->samples.push_back(
+                    {started - job.enqueued, finished - started});
+            }
+            if (!queue->pending.empty())
+            {
+                wakeUp.notify_one();
+            }
+            lock.unlock();
+            complete();
+            complete = nullptr;
+            lock.lock();
+        }
+    }
+};
+
+} // namespace nodemanager
@@ -0,0 +1,374 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+#include "nm_dbus_const.hpp"
+#include "nm_logger.hpp"
+#include "nm_property_cache.hpp"
+
+#include <ipmid/api.hpp>
+#include <ipmid/utils.hpp>
+#include <memory>
+#include <optional>
+#include <sdbusplus/bus/match.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nmipmi
+{
+
+static constexpr auto kNmPropertiesCacheTtl = std::chrono::milliseconds{1000};
+static constexpr auto kNmSubTreeCacheTtl = std::chrono::milliseconds{1000};
+static constexpr auto kNmStatisticsCacheTtl = std::chrono::milliseconds{200};
+
+using StatisticsValues =
+    std::unordered_map<std::string,
+                       std::variant<double, uint32_t, uint64_t, bool>>;
+using AllStatisticsValues = std::unordered_map<std::string, StatisticsValues>;
+
+/**
+ * @brief Results of NodeManager D-Bus reads shared by all IPMI commands
+ * handled by the process.
+ *
+ * Properties are kept per object path and interface, as returned by GetAll.
+ * Entries are invalidated by PropertiesChanged, InterfacesAdded and
+ * InterfacesRemoved signals of the NodeManager service and by writes made
+ * through NmDbusClient. Everything is dropped when the service restarts.
+ * Properties computed on read do not emit signals, so the TTL bounds how
+ * long such values may be stale.
+ */
+class NmDbusCache
+{
+  public:
+    using PropertiesKey = std::pair<std::string, std::string>;
+
+    NmDbusCache(const NmDbusCache&) = delete;
+    NmDbusCache& operator=(const NmDbusCache&) = delete;
+    NmDbusCache(NmDbusCache&&) = delete;
+    NmDbusCache& operator=(NmDbusCache&&) = delete;
+
+    NmDbusCache(sdbusplus::bus::bus& bus, const std::string& serviceName)
+    {
+        const auto senderRule =
+            sdbusplus::bus::match::rules::sender(serviceName);
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            bus,
+            sdbusplus::bus::match::rules::type::signal() + senderRule +
+                sdbusplus::bus::match::rules::interface(kPropertiesInterface) +
+                sdbusplus::bus::match::rules::member("PropertiesChanged"),
+            [this](sdbusplus::message::message& message) {
+                onPropertiesChanged(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            bus, sdbusplus::bus::match::rules::interfacesAdded() + senderRule,
+            [this](sdbusplus::message::message& message) {
+                onInterfacesChanged(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            bus, sdbusplus::bus::match::rules::interfacesRemoved() + senderRule,
+            [this](sdbusplus::message::message& message) {
+                onInterfacesChanged(message);
+            }));
+        matches.emplace_back(std::make_unique<sdbusplus::bus::match::match>(
+            bus,
+            sdbusplus::bus::match::rules::nameOwnerChanged() +
+                sdbusplus::bus::match::rules::argN(0, serviceName),
+            [this](sdbusplus::message::message&) { clear(); }));
+    }
+
+    /**
+     * @brief Drops everything read from the object and its children.
+     */
+    void invalidate(const std::string& path)
+    {
+        const auto isAffected = [&path](const std::string& keyPath) {
+            return keyPath == path || (keyPath.size() > path.size() &&
+                                       keyPath.starts_with(path) &&
+                                       keyPath[path.size()] == '/');
+        };
+        properties.eraseIf([&isAffected](const PropertiesKey& key) {
+            return isAffected(key.first);
+        });
+        statistics.eraseIf(isAffected);
+    }
+
+    void invalidate(const std::string& path, const std::string& interface)
+    {
+        properties.eraseIf([&path, &interface](const PropertiesKey& key) {
+            return key.first == path && key.second == interface;
+        });
+    }
+
+    void clear()
+    {
+        properties.clear();
+        subTrees.clear();
+        statistics.clear();
+    }
+
+    NmTtlCache<PropertiesKey, NmPropertyMap> properties{kNmPropertiesCacheTtl};
+    NmTtlCache<std::string, std::vector<std::string>> subTrees{
+        kNmSubTreeCacheTtl};
+    NmTtlCache<std::string, AllStatisticsValues> statistics{
+        kNmStatisticsCacheTtl};
+    std::optional<ipmi::DbusObjectInfo> objectMapper;
+
+  private:
+    std::vector<std::unique_ptr<sdbusplus::bus::match::match>> matches;
+
+    void onPropertiesChanged(sdbusplus::message::message& message)
+    {
+        try
+        {
+            std::string interface;
+            message.read(interface);
+            invalidate(message.get_path(), interface);
+        }
+        catch (const std::exception& e)
+        {
+            LOGGER_WARN << "Cannot read PropertiesChanged signal, ex: "
+                        << e.what();
+            properties.clear();
+        }
+    }
+
+    void onInterfacesChanged(sdbusplus::message::message& message)
+    {
+        subTrees.clear();
+        try
+        {
+            sdbusplus::message::object_path path;
+            message.read(path);
+            invalidate(path.str);
+        }
+        catch (const std::exception& e)
+        {
+            LOGGER_WARN << "Cannot read " << message.get_member()
+                        << " signal, ex: " << e.what();
+            clear();
+        }
+    }
+};
+
+/**
+ * @brief Coroutine based access to the NodeManager service.
+ *
+ * All calls suspend the IPMI command coroutine instead of blocking the ipmid
+ * event loop. Reads are served from NmDbusCache when possible, properties
+ * are always read with a single GetAll of the whole interface, so several
+ * properties of one object cost one round trip.
+ */
+class NmDbusClient
+{
+  public:
+    NmDbusClient(ipmi::Context::ptr ctxArg, const std::string& serviceNameArg) :
+        ctx(ctxArg), serviceName(serviceNameArg)
+    {
+    }
+
+    boost::system::error_code getAll(const std::string& path,
+                                     const std::string& interface,
+                                     NmPropertyMap& properties) const
+    {
+        const NmPropertyMap* cached = nullptr;
+        if (const auto ec = findAll(path, interface, cached))
+        {
+            return ec;
+        }
+        properties = *cached;
+        return {};
+    }
+
+    template <class T>
+    boost::system::error_code getProperty(const std::string& path,
+                                          const std::string& interface,
+                                          const std::string& name,
+                                          T& value) const
+    {
+        const NmPropertyMap* cached = nullptr;
+        if (const auto ec = findAll(path, interface, cached))
+        {
+            return ec;
+        }
+        const auto it = cached->find(name);
+        if (it == cached->cend() || !std::holds_alternative<T>(it->second))
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        }
+        value = std::get<T>(it->second);
+        return {};
+    }
+
+    template <class T>
+    boost::system::error_code setProperty(const std::string& path,
+                                          const std::string& interface,
+                                          const std::string& name,
+                                          const T& value) const
+    {
+        const auto ec = ipmi::setDbusProperty(ctx, serviceName, path,
+                                              interface, name, value);
+        getCache().invalidate(path, interface);
+        return ec;
+    }
+
+    /**
+     * @brief Returns paths of objects below root implementing any of the
+     * interfaces, as returned by ObjectMapper GetSubTreePaths.
+     */
+    boost::system::error_code
+        getSubTreePaths(const std::string& root, int32_t depth,
+                        const std::vector<std::string>& interfaces,
+                        std::vector<std::string>& paths) const
+    {
+        auto& cache = getCache();
+        std::string key = root + ":" + std::to_string(depth);
+        for (const auto& interface : interfaces)
+        {
+            key += ":" + interface;
+        }
+        if (const auto cached = cache.subTrees.find(key))
+        {
+            paths = *cached;
+            return {};
+        }
+
+        boost::system::error_code ec;
+        if (!cache.objectMapper)
+        {
+            ipmi::DbusObjectInfo objectMapper;
+            ec = ipmi::getDbusObject(ctx, kObjectMapperService, objectMapper);
+            if (ec)
+            {
+                return ec;
+            }
+            cache.objectMapper = objectMapper;
+        }
+        const auto generation = cache.subTrees.getGeneration();
+        paths = ctx->bus->yield_method_call<std::vector<std::string>>(
+            ctx->yield, ec, cache.objectMapper->second,
+            cache.objectMapper->first, kObjectMapperInterface,
+            "GetSubTreePaths", root, depth, interfaces);
+        if (ec)
+        {
+            cache.objectMapper.reset();
+            return ec;
+        }
+        cache.subTrees.insert(key, std::vector<std::string>(paths), generation);
+        return {};
+    }
+
+    /**
+     * @brief Returns all statistics of the object. Statistics change all the
+     * time, they are cached only for kNmStatisticsCacheTtl to merge
+     * consecutive commands reading different statistics of the same object.
+     */
+    boost::system::error_code getStatistics(const std::string& path,
+                                            AllStatisticsValues& values) const
+    {
+        auto& cache = getCache();
+        if (const auto cached = cache.statistics.find(path))
+        {
+            values = *cached;
+            return {};
+        }
+        boost::system::error_code ec;
+        const auto generation = cache.statistics.getGeneration();
+        values = ctx->bus->yield_method_call<AllStatisticsValues>(
+            ctx->yield, ec, serviceName, path, kStatisticsInterface,
+            "GetStatistics");
+        if (!ec)
+        {
+            cache.statistics.insert(path, AllStatisticsValues(values),
+                                    generation);
+        }
+        return ec;
+    }
+
+    /**
+     * @brief Drops cached values of the object and its children, must be
+     * called after a method call modifying them.
+     */
+    void invalidate(const std::string& path) const
+    {
+        getCache().invalidate(path);
+    }
+
+    /**
+     * @brief Drops cached object paths, must be called after an object has
+     * been created or deleted.
+     */
+    void invalidateSubTrees() const
+    {
+        getCache().subTrees.clear();
+    }
+
+  private:
+    ipmi::Context::ptr ctx;
+    std::string serviceName;
+    /**
+     * @brief Holds properties which could not be cached, because they had
+     * been invalidated while being read.
+     */
+    mutable NmPropertyMap lastRead;
+
+    NmDbusCache& getCache() const
+    {
+        static NmDbusCache cache(*ctx->bus, serviceName);
+        return cache;
+    }
+
+    /**
+     * @brief Points `properties` to the cached properties of the interface,
+     * reading them first if needed. The pointer is valid until the next
+     * suspension of the coroutine.
+     */
+    boost::system::error_code findAll(const std::string& path,
+                                      const std::string& interface,
+                                      const NmPropertyMap*& properties) const
+    {
+        auto& cache = getCache();
+        const NmDbusCache::PropertiesKey key{path, interface};
+        properties = cache.properties.find(key);
+        if (properties)
+        {
+            return {};
+        }
+
+        boost::system::error_code ec;
+        const auto generation = cache.properties.getGeneration();
+        auto values = ctx->bus->yield_method_call<NmPropertyMap>(
+            ctx->yield, ec, serviceName, path, kPropertiesInterface, "GetAll",
+            interface);
+        if (ec)
+        {
+            return ec;
+        }
+        properties =
+            cache.properties.insert(key, std::move(values), generation);
+        if (!properties)
+        {
+            lastRead = std::move(values);
+            properties = &lastRead;
+        }
+        return {};
+    }
+};
+
+} // namespace nmipmi
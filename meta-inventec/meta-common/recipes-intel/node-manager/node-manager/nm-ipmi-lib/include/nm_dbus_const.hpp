@@ -42,6 +42,8 @@ const static constexpr char* kNmCapabilitiesInterface =
 const static constexpr char* kNmTriggerInterface =
     "xyz.openbmc_project.NodeManager.Trigger";
 
+const static constexpr char* kPropertiesInterface =
+    "org.freedesktop.DBus.Properties";
 const static constexpr char* kObjectMapperInterface =
     "xyz.openbmc_project.ObjectMapper";
 
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "nm_cc.hpp"
+#include "nm_dbus_client.hpp"
 #include "nm_dbus_const.hpp"
 #include "nm_logger.hpp"
 
@@ -91,9 +92,14 @@ class NmService
     NmService& operator=(const NmService&) = delete;
     NmService(NmService&&) = delete;
     NmService& operator=(NmService&&) = delete;
-    NmService(ipmi::Context::ptr ctxPtr) : ctx(ctxPtr){};
+    NmService(ipmi::Context::ptr ctxPtr) : client(ctxPtr, getServiceName()){};
     ~NmService() = default;
 
+    const NmDbusClient& getClient() const
+    {
+        return client;
+    }
+
     std::string getDomainPath(const uint4_t id) const
     {
         return getRootPath() + "/Domain/" + domainIdToName(id);
@@ -146,24 +152,10 @@ class NmService
 
     std::map<uint4_t, std::set<uint8_t>> getDomainPolicyMap() const
     {
-        boost::system::error_code ec;
-
-        ipmi::DbusObjectInfo nmObject;
-        ec = ipmi::getDbusObject(ctx, kObjectMapperService, nmObject);
-        if (ec)
-        {
-            LOGGER_ERR << "Failed to perform ipmi::getDbusObject for the "
-                          "ObjectMapper interface, err: "
-                       << ec.message();
-            return {};
-        }
-        const auto objVect =
-            ctx->bus->yield_method_call<std::vector<std::string>>(
-                ctx->yield, ec, nmObject.second, nmObject.first,
-                kObjectMapperInterface, "GetSubTreePaths", getRootPath(),
-                kMaxSearchDepth,
-                std::vector(
-                    {kDomainAttributesInterface, kPolicyAttributesInterface}));
+        std::vector<std::string> objVect;
+        const auto ec = client.getSubTreePaths(
+            getRootPath(), kMaxSearchDepth,
+            {kDomainAttributesInterface, kPolicyAttributesInterface}, objVect);
         if (ec)
         {
             LOGGER_ERR << "Failed to call GetSubTreePaths, err: "
@@ -175,22 +167,9 @@ class NmService
 
     std::optional<std::vector<std::string>> getAllPoliciesPaths() const
     {
-        boost::system::error_code ec;
-
-        ipmi::DbusObjectInfo nmObject;
-        ec = ipmi::getDbusObject(ctx, kObjectMapperService, nmObject);
-        if (ec)
-        {
-            LOGGER_ERR << "Failed to perform ipmi::getDbusObject for the "
-                          "ObjectMapper interface, err: "
-                       << ec.message();
-            return std::nullopt;
-        }
-        const auto objVect =
-            ctx->bus->yield_method_call<std::vector<std::string>>(
-                ctx->yield, ec, nmObject.second, nmObject.first,
-                kObjectMapperInterface, "GetSubTreePaths", getRootPath(), 0,
-                std::vector({kPolicyAttributesInterface}));
+        std::vector<std::string> objVect;
+        const auto ec = client.getSubTreePaths(
+            getRootPath(), 0, {kPolicyAttributesInterface}, objVect);
         if (ec)
         {
             LOGGER_ERR << "Failed to call GetSubTreePaths, err: "
@@ -262,10 +241,9 @@ class NmService
 
     std::optional<bool> isEnabled(const std::string& objectPath) const
     {
-        boost::system::error_code ec;
         auto enabledFlag = false;
-        ec = getDbusProperty(ctx, getServiceName(), objectPath,
-                             kObjectEnableInterface, "Enabled", enabledFlag);
+        const auto ec = client.getProperty(objectPath, kObjectEnableInterface,
+                                           "Enabled", enabledFlag);
         if (ec)
         {
             LOGGER_ERR << "Failed to get Enabled property, err:" << ec.message()
@@ -350,7 +328,7 @@ class NmService
         return retMap;
     }
 
-    ipmi::Context::ptr ctx;
+    NmDbusClient client;
 };
 
 } // namespace nmipmi
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace nmipmi
+{
+
+/**
+ * @brief Property values read from the NodeManager service. Besides the
+ * scalar types of ipmi::Value it holds the arrays used by DomainAttributes,
+ * so reading them with a single GetAll does not lose any property.
+ */
+using NmPropertyValue =
+    std::variant<bool, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
+                 uint64_t, double, std::string, std::vector<std::string>,
+                 std::vector<uint8_t>>;
+using NmPropertyMap = std::map<std::string, NmPropertyValue>;
+
+/**
+ * @brief Map of values which expire after a fixed time.
+ *
+ * Values are fetched asynchronously, so an invalidation may arrive while a
+ * value is being fetched. Every invalidation bumps the generation and insert()
+ * drops values fetched in an older generation, so a value older than the
+ * invalidating signal is never cached.
+ */
+template <class Key, class Value>
+class NmTtlCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit NmTtlCache(Clock::duration ttlArg) : ttl(ttlArg)
+    {
+    }
+
+    /**
+     * @brief Returns cached value or nullptr when it is missing or expired.
+     * Pointer is valid until the next call modifying the cache.
+     */
+    const Value* find(const Key& key, Clock::time_point now = Clock::now())
+    {
+        const auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            return nullptr;
+        }
+        if (now >= it->second.expiry)
+        {
+            entries.erase(it);
+            return nullptr;
+        }
+        return &it->second.value;
+    }
+
+    /**
+     * @brief Stores value fetched after getGeneration() returned generationArg
+     * and returns pointer to the stored value. Returns nullptr, leaving value
+     * untouched, if the cache was invalidated in the meantime.
+     */
+    const Value* insert(const Key& key, Value&& value, uint64_t generationArg,
+                        Clock::time_point now = Clock::now())
+    {
+        if (generationArg != generation)
+        {
+            return nullptr;
+        }
+        const auto [it, inserted] = entries.insert_or_assign(
+            key, Entry{std::move(value), now + ttl});
+        return &it->second.value;
+    }
+
+    uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
+    template <class Predicate>
+    void eraseIf(Predicate&& predicate)
+    {
+        generation++;
+        std::erase_if(entries, [&predicate](const auto& entry) {
+            return predicate(entry.first);
+        });
+    }
+
+    void clear()
+    {
+        generation++;
+        entries.clear();
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+  private:
+    struct Entry
+    {
+        Value value;
+        Clock::time_point expiry;
+    };
+
+    Clock::duration ttl;
+    uint64_t generation = 0;
+    std::map<Key, Entry> entries;
+};
+
+} // namespace nmipmi
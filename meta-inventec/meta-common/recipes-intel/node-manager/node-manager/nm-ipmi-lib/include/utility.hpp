@@ -133,6 +133,9 @@ ipmi::RspType<> deletePolicy(ipmi::Context::ptr ctx, uint4_t domainId,
         ctx->yield, ec, nmService.getServiceName(),
         nmService.getPolicyPath(domainId, policyId), kObjectDeleteInterface,
         "Delete");
+    nmService.getClient().invalidate(
+        nmService.getPolicyPath(domainId, policyId));
+    nmService.getClient().invalidateSubTrees();
     const auto cc = getCc(ctx->cmd, ec);
     if (cc)
     {
@@ -253,11 +256,6 @@ struct NmStatistics
     uint32_t timestamp;
 };
 
-using StatisticsValues =
-    std::unordered_map<std::string,
-                       std::variant<double, uint32_t, uint64_t, bool>>;
-using AllStatisticsValues = std::unordered_map<std::string, StatisticsValues>;
-
 bool parseStatValuesMap(const AllStatisticsValues& allStatsMap,
                         const std::string& statType, NmStatistics& out,
                         uint1_t& measurementState)
@@ -379,10 +377,9 @@ StatPolicyResponse responsePolicyStat(ipmi::Context::ptr ctx,
     int policyState = 0;
     boost::system::error_code ec;
     // get policyState
-    ec =
-        getDbusProperty(ctx, nmService.getServiceName(),
-                        nmService.getPolicyPath(domainId, policyId),
-                        kPolicyAttributesInterface, "PolicyState", policyState);
+    ec = nmService.getClient().getProperty(
+        nmService.getPolicyPath(domainId, policyId), kPolicyAttributesInterface,
+        "PolicyState", policyState);
     if (ec)
     {
         LOGGER_ERR << "Failed to get PolicyState properties, error:"
@@ -410,11 +407,9 @@ StatPolicyResponse responsePolicyStat(ipmi::Context::ptr ctx,
     ec.clear();
     NmStatistics nmStatistics;
 
-    const AllStatisticsValues allStats =
-        ctx->bus->yield_method_call<AllStatisticsValues>(
-            ctx->yield, ec, nmService.getServiceName(),
-            nmService.getPolicyPath(domainId, policyId), kStatisticsInterface,
-            "GetStatistics");
+    AllStatisticsValues allStats;
+    ec = nmService.getClient().getStatistics(
+        nmService.getPolicyPath(domainId, policyId), allStats);
     if (const ipmi::Cc cc = getCc(ctx->cmd, ec))
     {
         return ipmi::response(cc);
@@ -463,11 +458,9 @@ StatDomainResponse responseDomainStat(ipmi::Context::ptr ctx,
     // getting statistics
     boost::system::error_code ec;
     NmStatistics nmStatistics;
-    const AllStatisticsValues allStats =
-        ctx->bus->yield_method_call<AllStatisticsValues>(
-            ctx->yield, ec, nmService.getServiceName(),
-            nmService.getDomainPath(domainId), kStatisticsInterface,
-            "GetStatistics");
+    AllStatisticsValues allStats;
+    ec = nmService.getClient().getStatistics(nmService.getDomainPath(domainId),
+                                             allStats);
     if (const ipmi::Cc cc = getCc(ctx->cmd, ec))
     {
         return ipmi::response(cc);
@@ -518,11 +511,9 @@ StatDomainEnergyResponse responseDomainEnergyStat(ipmi::Context::ptr ctx,
 
     // getting statistics
     boost::system::error_code ec;
-    const AllStatisticsValues allStats =
-        ctx->bus->yield_method_call<AllStatisticsValues>(
-            ctx->yield, ec, nmService.getServiceName(),
-            nmService.getDomainPath(domainId), kStatisticsInterface,
-            "GetStatistics");
+    AllStatisticsValues allStats;
+    ec = nmService.getClient().getStatistics(nmService.getDomainPath(domainId),
+                                             allStats);
     if (const ipmi::Cc cc = getCc(ctx->cmd, ec))
     {
         return ipmi::response(cc);
@@ -593,10 +584,8 @@ StatGlobalResponse responseGlobalStat(ipmi::Context::ptr ctx,
     // getting statistics
     boost::system::error_code ec;
     NmStatistics nmStatistics;
-    const AllStatisticsValues allStats =
-        ctx->bus->yield_method_call<AllStatisticsValues>(
-            ctx->yield, ec, nmService.getServiceName(), nmService.getRootPath(),
-            kStatisticsInterface, "GetStatistics");
+    AllStatisticsValues allStats;
+    ec = nmService.getClient().getStatistics(nmService.getRootPath(), allStats);
     if (const ipmi::Cc cc = getCc(ctx->cmd, ec))
     {
         return ipmi::response(cc);
@@ -641,9 +630,9 @@ std::optional<std::vector<uint8_t>>
     NmService nmService(ctx);
     boost::system::error_code ec;
 
-    ec = getDbusProperty(
-        ctx, nmService.getServiceName(), nmService.getDomainPath(domainId),
-        kDomainAttributesInterface, "AvailableComponents", availableComponents);
+    ec = nmService.getClient().getProperty(
+        nmService.getDomainPath(domainId), kDomainAttributesInterface,
+        "AvailableComponents", availableComponents);
     if (ec)
     {
         LOGGER_ERR << "Failed to get AvailableComponents property, error:"
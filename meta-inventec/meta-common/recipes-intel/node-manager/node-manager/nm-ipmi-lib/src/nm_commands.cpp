@@ -110,9 +110,9 @@ ipmi::RspType<> enableNmPolicyControl(ipmi::Context::ptr ctx,
     }
 
     // Try to set state for NodeManager, Domain or Policy object
-    boost::system::error_code ec =
-        setDbusProperty(ctx, nmService.getServiceName(), pathToObjectToSetState,
-                        kObjectEnableInterface, "Enabled", enableObject);
+    boost::system::error_code ec = nmService.getClient().setProperty(
+        pathToObjectToSetState, kObjectEnableInterface, "Enabled",
+        enableObject);
     if (ec)
     {
         LOGGER_ERR << "Failed to disable/enable Node Manager component, error: "
@@ -228,6 +228,7 @@ ipmi::RspType<> setNmPolicy(ipmi::Context::ptr ctx, uint4_t domainId,
                 ctx->yield, ec, nmService.getServiceName(),
                 nmService.getDomainPath(domainId), kPolicyManagerInterface,
                 "CreateWithId", std::to_string(policyId), policyParamsTuple);
+        nmService.getClient().invalidateSubTrees();
         cc = getCc(ctx->cmd, ec);
         if (cc)
         {
@@ -242,6 +243,8 @@ ipmi::RspType<> setNmPolicy(ipmi::Context::ptr ctx, uint4_t domainId,
             ctx->yield, ec, nmService.getServiceName(),
             nmService.getPolicyPath(domainId, policyId),
             kPolicyAttributesInterface, "Update", policyParamsTuple);
+        nmService.getClient().invalidate(
+            nmService.getPolicyPath(domainId, policyId));
         cc = getCc(ctx->cmd, ec);
         if (cc)
         {
@@ -251,10 +254,9 @@ ipmi::RspType<> setNmPolicy(ipmi::Context::ptr ctx, uint4_t domainId,
                     << nmService.getPolicyPath(domainId, policyId);
     }
     ec.clear();
-    ec = setDbusProperty(ctx, nmService.getServiceName(),
-                         nmService.getPolicyPath(domainId, policyId).c_str(),
-                         kObjectEnableInterface, "Enabled",
-                         static_cast<bool>(policyEnabled));
+    ec = nmService.getClient().setProperty(
+        nmService.getPolicyPath(domainId, policyId), kObjectEnableInterface,
+        "Enabled", static_cast<bool>(policyEnabled));
     if (ec)
     {
         LOGGER_ERR << "Failed to enable Policy: "
@@ -332,11 +334,11 @@ ipmi::RspType<uint4_t,  // domainId
         return ipmi::responseUnspecifiedError();
     }
 
-    ipmi::PropertyMap propMap;
+    NmPropertyMap propMap;
     boost::system::error_code ec;
-    ec = getAllDbusProperties(ctx, nmService.getServiceName(),
-                              nmService.getPolicyPath(domainId, policyId),
-                              kPolicyAttributesInterface, propMap);
+    ec = nmService.getClient().getAll(
+        nmService.getPolicyPath(domainId, policyId), kPolicyAttributesInterface,
+        propMap);
     if (ec)
     {
         LOGGER_ERR << "Failed to getAll Policy properties, err: "
@@ -556,6 +558,7 @@ ipmi::RspType<> resetNmStatistics(ipmi::Context::ptr ctx, uint5_t mode,
                 ctx->yield, ec, nmService.getServiceName(),
                 nmService.getRootPath(), kStatisticsInterface,
                 "ResetStatistics");
+            nmService.getClient().invalidate(nmService.getRootPath());
         }
 
         // get requested domain and reset its statistics.
@@ -563,6 +566,7 @@ ipmi::RspType<> resetNmStatistics(ipmi::Context::ptr ctx, uint5_t mode,
             ctx->yield, ec, nmService.getServiceName(),
             nmService.getDomainPath(domainId), kStatisticsInterface,
             "ResetStatistics");
+        nmService.getClient().invalidate(nmService.getDomainPath(domainId));
     }
     else if (mode == kResetStatModePolicy)
     {
@@ -575,6 +579,8 @@ ipmi::RspType<> resetNmStatistics(ipmi::Context::ptr ctx, uint5_t mode,
             ctx->yield, ec, nmService.getServiceName(),
             nmService.getPolicyPath(domainId, policyId), kStatisticsInterface,
             "ResetStatistics");
+        nmService.getClient().invalidate(
+            nmService.getPolicyPath(domainId, policyId));
     }
     cc = getCc(ctx->cmd, ec);
     if (cc)
@@ -750,9 +756,9 @@ ipmi::RspType<uint8_t,  // Max Concurrent Settings
     }
 
     // Verify if trigger is supported by domain
-    ec = ipmi::getDbusProperty<std::vector<std::string>>(
-        ctx, nmService.getServiceName(), nmService.getDomainPath(domainId),
-        kDomainAttributesInterface, "AvailableTriggers", availableTriggers);
+    ec = nmService.getClient().getProperty(
+        nmService.getDomainPath(domainId), kDomainAttributesInterface,
+        "AvailableTriggers", availableTriggers);
     if (ec)
     {
         LOGGER_ERR << "Failed to get the list of available trigger "
@@ -769,9 +775,9 @@ ipmi::RspType<uint8_t,  // Max Concurrent Settings
         return ipmi::response(ccUnsupportedPolicyTriggerType);
     }
 
-    ec = ipmi::getDbusProperty<std::uint8_t>(
-        ctx, nmService.getServiceName(), nmService.getRootPath(),
-        kNodeManagerInterface, "MaxNumberOfPolicies", maxConcurrentSettings);
+    ec = nmService.getClient().getProperty(
+        nmService.getRootPath(), kNodeManagerInterface, "MaxNumberOfPolicies",
+        maxConcurrentSettings);
 
     if (ec)
     {
@@ -781,10 +787,9 @@ ipmi::RspType<uint8_t,  // Max Concurrent Settings
         return ipmi::responseUnspecifiedError();
     }
 
-    ipmi::PropertyMap capPropMap;
-    ec = ipmi::getAllDbusProperties(ctx, nmService.getServiceName(),
-                                    nmService.getDomainPath(domainId),
-                                    kNmCapabilitiesInterface, capPropMap);
+    NmPropertyMap capPropMap;
+    ec = nmService.getClient().getAll(nmService.getDomainPath(domainId),
+                                      kNmCapabilitiesInterface, capPropMap);
     if (ec)
     {
         LOGGER_ERR << "Failed to getAll Capabilities properties, err: "
@@ -792,13 +797,12 @@ ipmi::RspType<uint8_t,  // Max Concurrent Settings
         return ipmi::response(ccInvalidDomainId);
     }
 
-    ipmi::PropertyMap triggerPropMap;
+    NmPropertyMap triggerPropMap;
     const static std::set<uint4_t> dummyTriggers = {0, 6, 8, 9};
     if (dummyTriggers.find(triggerType) == dummyTriggers.cend())
     {
-        ec = ipmi::getAllDbusProperties(ctx, nmService.getServiceName(),
-                                        nmService.getTriggerPath(triggerName),
-                                        kNmTriggerInterface, triggerPropMap);
+        ec = nmService.getClient().getAll(nmService.getTriggerPath(triggerName),
+                                          kNmTriggerInterface, triggerPropMap);
 
         if (ec)
         {
@@ -884,9 +888,9 @@ ipmi::RspType<uint8_t, // Node Manager Version
 
     NmService nmService(ctx);
 
-    ec = ipmi::getDbusProperty<std::string>(
-        ctx, nmService.getServiceName(), nmService.getRootPath(),
-        kNodeManagerInterface, "Version", nmVersionStr);
+    ec = nmService.getClient().getProperty(
+        nmService.getRootPath(), kNodeManagerInterface, "Version",
+        nmVersionStr);
 
     if (ec)
     {
@@ -966,9 +970,9 @@ ipmi::RspType<> setNmPowerDrawRange(ipmi::Context::ptr ctx, uint4_t domainId,
     {
         return ipmi::response(cc);
     }
-    boost::system::error_code ec = setDbusProperty(
-        ctx, nmService.getServiceName(), domainPath, kNmCapabilitiesInterface,
-        "Max", static_cast<double>(maxPowerDraw));
+    boost::system::error_code ec = nmService.getClient().setProperty(
+        domainPath, kNmCapabilitiesInterface, "Max",
+        static_cast<double>(maxPowerDraw));
     if (ec)
     {
         LOGGER_ERR << "Failed to set Max Power Draw, error: " << ec.message()
@@ -976,9 +980,9 @@ ipmi::RspType<> setNmPowerDrawRange(ipmi::Context::ptr ctx, uint4_t domainId,
         return ipmi::responseUnspecifiedError();
     }
 
-    ec = setDbusProperty(ctx, nmService.getServiceName(), domainPath,
-                         kNmCapabilitiesInterface, "Min",
-                         static_cast<double>(minPowerDraw));
+    ec = nmService.getClient().setProperty(domainPath,
+                                           kNmCapabilitiesInterface, "Min",
+                                           static_cast<double>(minPowerDraw));
     if (ec)
     {
         LOGGER_ERR << "Failed to set Min Power Draw, error: " << ec.message()
@@ -1125,6 +1129,7 @@ ipmi::RspType<> setTotalPowerBudget(ipmi::Context::ptr ctx, uint4_t domainIdArg,
                     ctx->yield, ec, nmService.getServiceName(),
                     nmService.getDomainPath(domainId), kPolicyManagerInterface,
                     "CreateForTotalBudget", policyId, policyParamsTuple);
+            nmService.getClient().invalidateSubTrees();
             cc = getCc(ctx->cmd, ec);
             return ipmi::response(cc);
         }
@@ -1137,6 +1142,8 @@ ipmi::RspType<> setTotalPowerBudget(ipmi::Context::ptr ctx, uint4_t domainIdArg,
                 ctx->bus->yield_method_call<void>(
                     ctx->yield, ec, nmService.getServiceName(), *it,
                     kObjectDeleteInterface, "Delete");
+                nmService.getClient().invalidate(*it);
+                nmService.getClient().invalidateSubTrees();
                 cc = getCc(ctx->cmd, ec);
             }
             // If targetPowerBudget not null - update policy
@@ -1145,6 +1152,7 @@ ipmi::RspType<> setTotalPowerBudget(ipmi::Context::ptr ctx, uint4_t domainIdArg,
                 ctx->bus->yield_method_call<void>(
                     ctx->yield, ec, nmService.getServiceName(), *it,
                     kPolicyAttributesInterface, "Update", policyParamsTuple);
+                nmService.getClient().invalidate(*it);
                 cc = getCc(ctx->cmd, ec);
             }
             return ipmi::response(cc);
@@ -1200,9 +1208,8 @@ ipmi::RspType<uint16_t> // Target Power Budget
             // policy exists, get policy limit
             uint16_t policyLimit = 0;
             boost::system::error_code ec;
-            ec = ipmi::getDbusProperty<uint16_t>(
-                ctx, nmService.getServiceName(), *it,
-                kPolicyAttributesInterface, "Limit", policyLimit);
+            ec = nmService.getClient().getProperty(
+                *it, kPolicyAttributesInterface, "Limit", policyLimit);
             if (ec)
             {
                 LOGGER_ERR << "Failed to get Policy " << *it
@@ -18,15 +18,88 @@
 #include "common_types.hpp"
 #include "loggers/log.hpp"
 #include "node_manager.hpp"
+#include "sensors/peci/peci_scheduler.hpp"
 #include "sps_integrator.hpp"
 
+#include <getopt.h>
 #include <systemd/sd-daemon.h>
 
 #include <iostream>
 #include <sdbusplus/asio/object_server.hpp>
 
-int main()
+/**
+ * @brief Parses PECI transport selection, used to run the service without
+ * PECI hardware:
+ *   --peci-transport=hardware|record|replay|synthetic
+ *   --peci-trace-file=<path>    trace written by record, read by replay
+ *   --peci-time-scale=<factor>  replay latency multiplier, 0 disables delays
+ *   --peci-cpus=<count>         number of CPUs simulated by synthetic
+ */
+static std::optional<nodemanager::PeciTransportOptions>
+    parsePeciTransportOptions(int argc, char** argv)
 {
+    static const std::map<std::string, nodemanager::PeciTransportMode> modes =
+        {{"hardware", nodemanager::PeciTransportMode::hardware},
+         {"record", nodemanager::PeciTransportMode::record},
+         {"replay", nodemanager::PeciTransportMode::replay},
+         {"synthetic", nodemanager::PeciTransportMode::synthetic}};
+    static const option longOptions[] = {
+        {"peci-transport", required_argument, nullptr, 't'},
+        {"peci-trace-file", required_argument, nullptr, 'f'},
+        {"peci-time-scale", required_argument, nullptr, 's'},
+        {"peci-cpus", required_argument, nullptr, 'c'},
+        {nullptr, 0, nullptr, 0}};
+
+    nodemanager::PeciTransportOptions options;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1)
+    {
+        try
+        {
+            switch (opt)
+            {
+                case 't':
+                    options.mode = modes.at(optarg);
+                    break;
+                case 'f':
+                    options.traceFile = optarg;
+                    break;
+                case 's':
+                    options.timeScale = std::stod(optarg);
+                    break;
+                case 'c':
+                    options.cpuCount =
+                        static_cast<uint8_t>(std::stoul(optarg));
+                    break;
+                default:
+                    return std::nullopt;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid value of option " << argv[optind - 1]
+                      << std::endl;
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv)
+{
+    const auto peciTransportOptions = parsePeciTransportOptions(argc, argv);
+    if (!peciTransportOptions)
+    {
+        return EXIT_FAILURE;
+    }
+    auto peciTransport = nodemanager::makePeciTransport(*peciTransportOptions);
+    if (!peciTransport)
+    {
+        return EXIT_FAILURE;
+    }
+    nodemanager::PeciScheduler::getInstance().setTransport(
+        std::move(*peciTransport));
+
     boost::asio::io_context ioc;
     boost::asio::signal_set signals(ioc, SIGINT, SIGTERM, SIGABRT);
     auto bus = std::make_shared<sdbusplus::asio::connection>(ioc);
@@ -47,11 +120,10 @@ int main()
         if (code == SIGABRT)
         {
             nodemanager::Logger::log<nodemanager::LogLevel::info>(
-                "Catching abort signal from WD, closing gracefully with status "
-                "dump");
-            nlohmann::json out;
-            nodeManager.getDiagnostics()->reportStatus(out);
-            nodemanager::Logger::log<nodemanager::LogLevel::info>(out.dump());
+                "Catching abort signal from WD, closing gracefully with last "
+                "status dump");
+            nodemanager::Logger::log<nodemanager::LogLevel::info>(
+                nodeManager.getDiagnostics()->getCrashDump());
         }
         ioc.stop();
     });
@@ -92,6 +92,21 @@ include_directories (${CMAKE_BINARY_DIR}/googletest-src/googletest/include)
 include_directories (${CMAKE_BINARY_DIR}/googletest-src/googlemock/include)
 link_directories (${CMAKE_BINARY_DIR}/googletest-build/lib)
 
+####### google benchmark #######
+externalproject_add (
+    googlebenchmark
+    GIT_REPOSITORY "https://github.com/google/benchmark.git"
+    GIT_TAG v1.7.1
+    SOURCE_DIR "${CMAKE_BINARY_DIR}/googlebenchmark-src"
+    BINARY_DIR "${CMAKE_BINARY_DIR}/googlebenchmark-build"
+    CMAKE_ARGS -DCMAKE_BUILD_TYPE=Release
+               -DBENCHMARK_ENABLE_TESTING=OFF
+               -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+    INSTALL_COMMAND ""
+)
+include_directories (${CMAKE_BINARY_DIR}/googlebenchmark-src/include)
+link_directories (${CMAKE_BINARY_DIR}/googlebenchmark-build/src)
+
 ####### nlohmann-json-v3.9.1 #######
 externalproject_add (
     nlohmann-json
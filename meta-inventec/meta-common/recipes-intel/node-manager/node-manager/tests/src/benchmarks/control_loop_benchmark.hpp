@@ -0,0 +1,361 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "clock.hpp"
+#include "mocks/gpio_provider_mock.hpp"
+#include "mocks/policy_storage_management_mock.hpp"
+#include "node_manager.hpp"
+#include "stubs/hwmon_file_stub.hpp"
+#include "utils/dbus_environment.hpp"
+#include "utils/policy_config.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace nodemanager;
+
+static constexpr std::array kBenchmarkPolicyDomains = {
+    DomainId::CpuSubsystem, DomainId::MemorySubsystem, DomainId::Pcie,
+    DomainId::DcTotalPower};
+
+/**
+ * @brief Hwmon files of a platform with `cpus` CPUs, a PCIe card and two
+ * PSUs, with values that keep all readings valid.
+ */
+class BenchmarkPlatform
+{
+  public:
+    explicit BenchmarkPlatform(unsigned cpus)
+    {
+        hwmon.removeHwmonDirectories();
+        for (unsigned cpu = 0; cpu < cpus; ++cpu)
+        {
+            const auto address = kHwmonPeciCpuBaseAddress + cpu;
+            for (auto group : {HwmonGroup::cpu, HwmonGroup::dimm})
+            {
+                createLimitedFiles(address, group, 40000000);
+                hwmon.createCpuFile(address, group, HwmonFileType::energy, 0,
+                                    1000000);
+            }
+        }
+        createLimitedFiles(kHwmonPeciCpuBaseAddress, HwmonGroup::platform,
+                           200000000);
+        hwmon.createPvcFile(kHwmonSmbusPvcBaseBus, kHwmonPeciPvcBaseAddress,
+                            HwmonGroup::pvc, HwmonFileType::pciePower, 0,
+                            20000000);
+        hwmon.createPvcFile(kHwmonSmbusPvcBaseBus, kHwmonPeciPvcBaseAddress,
+                            HwmonGroup::pvc, HwmonFileType::limit, 0, 0);
+        for (uint32_t psu = 0; psu < 2; ++psu)
+        {
+            hwmon.createPsuFile(7, kHwmonI2cPsuBaseAddress + psu,
+                                HwmonGroup::psu, HwmonFileType::psuAcPower,
+                                "150000000");
+        }
+    }
+
+    ~BenchmarkPlatform()
+    {
+        hwmon.removeHwmonDirectories();
+    }
+
+    HwmonFileManager hwmon;
+
+  private:
+    void createLimitedFiles(uint32_t address, HwmonGroup group,
+                            unsigned int current)
+    {
+        hwmon.createCpuFile(address, group, HwmonFileType::current, 0, current);
+        hwmon.createCpuFile(address, group, HwmonFileType::limit, 0, 0);
+        hwmon.createCpuFile(address, group, HwmonFileType::min, 0, 0);
+        hwmon.createCpuFile(address, group, HwmonFileType::max, 0,
+                            2 * current);
+    }
+};
+
+enum class LoopStage
+{
+    sensors,
+    devicesManager,
+    ptam,
+    budgeting,
+    control,
+    statusMonitor,
+    all
+};
+
+/**
+ * @brief Node Manager components wired the same way as in NodeManager. Hwmon
+ * files are taken from BenchmarkPlatform, GPIOs are mocked and
+ * `policiesPerDomain` enabled policies are loaded from a mocked storage into
+ * every domain from kBenchmarkPolicyDomains. SmartSupervisor is not created as
+ * it depends on a kernel module. Components are run by LoopScheduler tasks
+ * configured as in NodeManager, driven by the mocked clock instead of the
+ * scheduler timer.
+ */
+class BenchmarkNodeManager
+{
+  public:
+    BenchmarkNodeManager(unsigned cpus, unsigned policiesPerDomain) :
+        platform(cpus)
+    {
+        ON_CALL(*policyStorageManagement, policiesRead())
+            .WillByDefault(testing::Return(makePolicies(policiesPerDomain)));
+        ON_CALL(*policyStorageManagement, policyWrite(testing::_, testing::_))
+            .WillByDefault(testing::Return(true));
+
+        devicesManager = std::make_shared<DevicesManager>(
+            bus, sensorReadingsManager,
+            std::make_shared<HwmonFileProvider>(
+                bus, platform.hwmon.getRootPath().c_str()),
+            gpioProvider, std::make_shared<PldmEntityProvider>(bus));
+        statusMonitor = std::make_shared<StatusMonitor>(
+            devicesManager, std::make_shared<StatusMonitorActions>());
+        efficiencyControl = std::make_shared<EfficiencyControl>(devicesManager);
+        control = std::make_shared<Control>(devicesManager);
+        budgeting = makeBudgeting();
+        triggersManager = std::make_shared<TriggersManager>(
+            objectServer, objectPath, gpioProvider);
+        ptam = std::make_unique<Ptam>(bus, objectServer, objectPath,
+                                      devicesManager, gpioProvider, budgeting,
+                                      efficiencyControl, triggersManager,
+                                      policyStorageManagement);
+        ptam->setParentRunning(true);
+        initializeScheduler();
+
+        auto powerState = sensorReadingsManager->getSensorReading(
+            SensorReadingType::powerState, DeviceIndex{0});
+        powerState->setStatus(SensorReadingStatus::valid);
+        powerState->updateValue(PowerStateType::s0);
+
+        // Let hwmon discovery finish and the first asynchronous sensor reads
+        // complete, so the measured iterations operate on valid readings
+        DbusEnvironment::sleepFor(std::chrono::milliseconds{200});
+        for (int i = 0; i < 3; ++i)
+        {
+            runLoopPeriod();
+            DbusEnvironment::sleepFor(std::chrono::milliseconds{20});
+        }
+    }
+
+    ~BenchmarkNodeManager()
+    {
+        DbusEnvironment::synchronizeIoc();
+    }
+
+    /**
+     * @brief Advances the mocked clock by kLoopPeriod in steps of the sensors
+     * task period. After every step work posted to the io_context is handled
+     * and the due tasks are run, so the control chain runs once and the
+     * sensors as often as on the BMC.
+     *
+     * @return time spent in the `measured` stage
+     */
+    std::chrono::steady_clock::duration
+        runLoopPeriod(LoopStage measuredArg = LoopStage::all)
+    {
+        measured = measuredArg;
+        measuredTime = std::chrono::steady_clock::duration{0};
+        for (auto elapsed = std::chrono::milliseconds{0};
+             elapsed < kLoopPeriod; elapsed += kSensorsTaskConfig.period)
+        {
+            Clock::stepMs(kSensorsTaskConfig.period.count());
+            DbusEnvironment::getIoc().poll();
+            scheduler.runDueTasks();
+        }
+        return measuredTime;
+    }
+
+    BenchmarkPlatform platform;
+    std::shared_ptr<sdbusplus::asio::connection> bus =
+        DbusEnvironment::getBus();
+    std::shared_ptr<sdbusplus::asio::object_server> objectServer =
+        std::make_shared<sdbusplus::asio::object_server>(bus);
+    std::string const objectPath{kRootObjectPath};
+    std::shared_ptr<SensorReadingsManagerIf> sensorReadingsManager =
+        std::make_shared<SensorReadingsManager>();
+    std::shared_ptr<GpioProviderIf> gpioProvider =
+        std::make_shared<testing::NiceMock<GpioProviderMock>>();
+    std::shared_ptr<PolicyStorageManagementMock> policyStorageManagement =
+        std::make_shared<testing::NiceMock<PolicyStorageManagementMock>>();
+    std::shared_ptr<DevicesManager> devicesManager;
+    std::shared_ptr<StatusMonitor> statusMonitor;
+    std::shared_ptr<EfficiencyControl> efficiencyControl;
+    std::shared_ptr<Control> control;
+    std::shared_ptr<Budgeting> budgeting;
+    std::shared_ptr<TriggersManager> triggersManager;
+    std::unique_ptr<Ptam> ptam;
+    LoopScheduler scheduler{DbusEnvironment::getIoc()};
+
+  private:
+    LoopStage measured = LoopStage::all;
+    std::chrono::steady_clock::duration measuredTime{0};
+
+    /**
+     * @brief Same tasks as NodeManager::initializeScheduler, except the
+     * SmartSupervisor and crash dump ones.
+     */
+    void initializeScheduler()
+    {
+        scheduler.addTask(kSensorsTaskConfig, [this]() {
+            runStage(LoopStage::sensors,
+                     [this]() { devicesManager->runSensors(); });
+        });
+        scheduler.addTask(kControlTaskConfig, [this]() {
+            runStage(LoopStage::devicesManager,
+                     [this]() { devicesManager->runReadingsAndKnobs(); });
+            runStage(LoopStage::ptam, [this]() { ptam->run(); });
+            runStage(LoopStage::budgeting, [this]() { budgeting->run(); });
+            runStage(LoopStage::control, [this]() { control->run(); });
+            runStage(LoopStage::ptam, [this]() { ptam->postRun(); });
+        });
+        scheduler.addTask(kStatusTaskConfig, [this]() {
+            runStage(LoopStage::statusMonitor,
+                     [this]() { statusMonitor->run(); });
+        });
+    }
+
+    void runStage(LoopStage stage, const std::function<void()>& run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        if (measured == LoopStage::all || measured == stage)
+        {
+            measuredTime += std::chrono::steady_clock::now() - start;
+        }
+    }
+
+    static std::vector<
+        std::tuple<PolicyId, DomainId, PolicyOwner, bool, PolicyParams>>
+        makePolicies(unsigned policiesPerDomain)
+    {
+        std::vector<
+            std::tuple<PolicyId, DomainId, PolicyOwner, bool, PolicyParams>>
+            policies;
+        for (const auto domainId : kBenchmarkPolicyDomains)
+        {
+            for (unsigned idx = 0; idx < policiesPerDomain; ++idx)
+            {
+                PolicyConfig config;
+                config.limit(static_cast<uint16_t>(50 + idx));
+                policies.emplace_back(
+                    "Benchmark_" +
+                        std::to_string(static_cast<unsigned>(domainId)) + "_" +
+                        std::to_string(idx),
+                    domainId, PolicyOwner::bmc, true, config._getStruct());
+            }
+        }
+        return policies;
+    }
+
+    std::shared_ptr<Budgeting> makeBudgeting()
+    {
+        SimpleDomainDistributors simpleDomainDistributors;
+        for (const auto& config : kSimpleDomainDistributorsConfig)
+        {
+            simpleDomainDistributors.emplace_back(
+                config.raplDomainId,
+                std::make_unique<SimpleDomainBudgeting>(
+                    std::make_unique<RegulatorP>(
+                        devicesManager, config.regulatorPCoeff,
+                        config.regulatorFeedbackReading),
+                    std::make_unique<EfficiencyHelper>(
+                        devicesManager, config.efficiencyReading,
+                        config.efficiencyAveragingPeriod),
+                    config.budgetCorrection));
+        }
+        return std::make_shared<Budgeting>(
+            devicesManager,
+            std::make_unique<CompoundDomainBudgeting>(
+                std::move(simpleDomainDistributors)),
+            control);
+    }
+};
+
+static void controlLoopArguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"cpus", "policies"})
+        ->ArgsProduct({{1, 2, 4, 8}, {1, 16}})
+        ->UseManualTime()
+        ->Unit(benchmark::kMicrosecond);
+}
+
+/**
+ * @brief Executes the scheduler tasks for one control loop period per
+ * iteration and reports the time spent in the `measured` stage only, so every
+ * component operates on the state produced by the preceding ones. The status
+ * task runs once every ten iterations, as its period is one second.
+ */
+static void runLoopBenchmark(benchmark::State& state, LoopStage measured)
+{
+    BenchmarkNodeManager nm(static_cast<unsigned>(state.range(0)),
+                            static_cast<unsigned>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        const auto elapsed = nm.runLoopPeriod(measured);
+        state.SetIterationTime(
+            std::chrono::duration<double>(elapsed).count());
+    }
+}
+
+/**
+ * @brief DevicesManager::runSensors, run twice per control loop period.
+ */
+static void BM_SensorsRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::sensors);
+}
+BENCHMARK(BM_SensorsRun)->Apply(controlLoopArguments);
+
+/**
+ * @brief DevicesManager::runReadingsAndKnobs.
+ */
+static void BM_DevicesManagerRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::devicesManager);
+}
+BENCHMARK(BM_DevicesManagerRun)->Apply(controlLoopArguments);
+
+/**
+ * @brief Ptam::run and Ptam::postRun.
+ */
+static void BM_PtamRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::ptam);
+}
+BENCHMARK(BM_PtamRun)->Apply(controlLoopArguments);
+
+static void BM_BudgetingRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::budgeting);
+}
+BENCHMARK(BM_BudgetingRun)->Apply(controlLoopArguments);
+
+static void BM_ControlRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::control);
+}
+BENCHMARK(BM_ControlRun)->Apply(controlLoopArguments);
+
+/**
+ * @brief All tasks run within one control loop period, which have to fit into
+ * kLoopPeriod on the BMC.
+ */
+static void BM_NodeManagerRun(benchmark::State& state)
+{
+    runLoopBenchmark(state, LoopStage::all);
+}
+BENCHMARK(BM_NodeManagerRun)->Apply(controlLoopArguments);
@@ -0,0 +1,202 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "devices_manager/hwmon_file_provider.hpp"
+#include "stubs/hwmon_file_stub.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace nodemanager;
+
+static constexpr unsigned kBenchmarkNoiseAttributes = 16;
+static constexpr unsigned kBenchmarkNoiseI2cDevices = 32;
+
+/**
+ * @brief Gives access to the scanning part of HwmonFileProvider, so its cost
+ * can be measured without timers and the io_context.
+ */
+struct HwmonFileProviderScanner : public HwmonFileProvider
+{
+    HwmonFileProviderScanner(
+        std::shared_ptr<sdbusplus::asio::connection> busArg,
+        std::filesystem::path rootPathArg) :
+        HwmonFileProvider(busArg, rootPathArg, false)
+    {
+    }
+
+    size_t scan(const std::set<std::filesystem::path>& roots) const
+    {
+        return findFiles(getFileMatchers(), roots).paths.size();
+    }
+
+    std::set<std::filesystem::path> getRoots() const
+    {
+        std::set<std::filesystem::path> roots;
+        for (const auto& matcher : getFileMatchers())
+        {
+            roots.insert(matcher.getRootPath());
+        }
+        return roots;
+    }
+};
+
+/**
+ * @brief Synthetic sysfs tree resembling a platform with `cpus` CPUs, two PSUs
+ * and a number of unrelated I2C devices. Every hwmon directory contains
+ * additional attributes that are not used by NodeManager.
+ */
+class SyntheticHwmonTree
+{
+  public:
+    explicit SyntheticHwmonTree(unsigned cpus)
+    {
+        hwmon.removeHwmonDirectories();
+        for (unsigned cpu = 0; cpu < cpus; ++cpu)
+        {
+            const auto address = kHwmonPeciCpuBaseAddress + cpu;
+            for (auto group : {HwmonGroup::cpu, HwmonGroup::dimm})
+            {
+                for (auto type : {HwmonFileType::current, HwmonFileType::limit,
+                                  HwmonFileType::max, HwmonFileType::energy})
+                {
+                    addNoise(hwmon.createCpuFile(address, group, type, 0)
+                                 .parent_path());
+                }
+            }
+        }
+        addNoise(hwmon
+                     .createCpuFile(kHwmonPeciCpuBaseAddress,
+                                    HwmonGroup::platform,
+                                    HwmonFileType::current, 0)
+                     .parent_path());
+        for (uint32_t psu = 0; psu < 2; ++psu)
+        {
+            addNoise(hwmon
+                         .createPsuFile(7, kHwmonI2cPsuBaseAddress + psu,
+                                        HwmonGroup::psu,
+                                        HwmonFileType::psuAcPower)
+                         .parent_path());
+        }
+        for (unsigned device = 0; device < kBenchmarkNoiseI2cDevices; ++device)
+        {
+            const auto bus = std::to_string(device % 8);
+            auto dir = hwmon.getRootPath() / "i2c/devices" / ("i2c-" + bus) /
+                       (bus + "-00" + numberToHexString(0x10 + device)) /
+                       "hwmon" / ("hwmon" + std::to_string(100 + device));
+            std::filesystem::create_directories(dir);
+            addNoise(dir);
+        }
+    }
+
+    HwmonFileManager hwmon;
+
+  private:
+    static void addNoise(const std::filesystem::path& dir)
+    {
+        for (unsigned idx = 1; idx <= kBenchmarkNoiseAttributes; ++idx)
+        {
+            std::ofstream(dir / ("temp" + std::to_string(idx) + "_input"))
+                << 0 << "\n";
+        }
+    }
+};
+
+/**
+ * @brief Cost of the consistency rescan of all bus directories, which used to
+ * be executed every kHwmonDiscoveryPeriod.
+ */
+static void BM_HwmonFullRescan(benchmark::State& state)
+{
+    SyntheticHwmonTree tree(static_cast<unsigned>(state.range(0)));
+    HwmonFileProviderScanner scanner(DbusEnvironment::getBus(),
+                                     tree.hwmon.getRootPath());
+    const auto roots = scanner.getRoots();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(scanner.scan(roots));
+    }
+}
+BENCHMARK(BM_HwmonFullRescan)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+/**
+ * @brief Cost of the rescan triggered by a hotplug event on the I2C bus.
+ */
+static void BM_HwmonSubtreeRescan(benchmark::State& state)
+{
+    SyntheticHwmonTree tree(static_cast<unsigned>(state.range(0)));
+    HwmonFileProviderScanner scanner(DbusEnvironment::getBus(),
+                                     tree.hwmon.getRootPath());
+    const std::set<std::filesystem::path> roots = {tree.hwmon.getRootPath() /
+                                                   "i2c/devices"};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(scanner.scan(roots));
+    }
+}
+BENCHMARK(BM_HwmonSubtreeRescan)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+/**
+ * @brief Time from creation of a PSU hwmon directory until its file is
+ * returned by the provider. The io_context is driven by the benchmark thread.
+ */
+static void BM_HwmonTimeToDetect(benchmark::State& state)
+{
+    SyntheticHwmonTree tree(4);
+    const auto mode = static_cast<HwmonDiscoveryMode>(state.range(0));
+    HwmonFileProvider sut(DbusEnvironment::getBus(), tree.hwmon.getRootPath(),
+                          true, mode);
+    DbusEnvironment::sleepFor(std::chrono::milliseconds{100});
+
+    for (auto _ : state)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto file = tree.hwmon.createPsuFile(7, kHwmonI2cPsuBaseAddress + 2,
+                                             HwmonGroup::psu,
+                                             HwmonFileType::psuAcPower);
+        while (sut.getFile(SensorReadingType::acPlatformPower, DeviceIndex{2})
+                   .empty())
+        {
+            DbusEnvironment::sleepFor(std::chrono::milliseconds{1});
+        }
+        state.SetIterationTime(
+            std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          start)
+                .count());
+
+        std::filesystem::remove_all(file.parent_path().parent_path());
+        while (!sut.getFile(SensorReadingType::acPlatformPower, DeviceIndex{2})
+                    .empty())
+        {
+            DbusEnvironment::sleepFor(std::chrono::milliseconds{1});
+        }
+    }
+}
+BENCHMARK(BM_HwmonTimeToDetect)
+    ->ArgName("periodic")
+    ->Arg(static_cast<int64_t>(HwmonDiscoveryMode::periodic))
+    ->Iterations(3)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HwmonTimeToDetect)
+    ->ArgName("events")
+    ->Arg(static_cast<int64_t>(HwmonDiscoveryMode::events))
+    ->Iterations(20)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
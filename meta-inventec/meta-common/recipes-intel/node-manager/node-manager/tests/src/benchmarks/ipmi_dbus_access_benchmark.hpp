@@ -0,0 +1,195 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "nm_property_cache.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <benchmark/benchmark.h>
+
+static constexpr const char* kBenchmarkNmDomainPath =
+    "/xyz/openbmc_project/NodeManager/Domain/ACTotalPlatformPower";
+static constexpr const char* kBenchmarkNmCapabilitiesInterface =
+    "xyz.openbmc_project.NodeManager.Capabilities";
+static const std::vector<std::string> kBenchmarkNmCapabilities = {
+    "Max",
+    "Min",
+    "MaxCorrectionTimeInMs",
+    "MinCorrectionTimeInMs",
+    "MaxStatisticsReportingPeriod",
+    "MinStatisticsReportingPeriod"};
+
+/**
+ * @brief Stand-in for the NodeManager service exposing the Capabilities
+ * interface of a domain, as read by the Get NM Capabilities IPMI command.
+ * It is served on the benchmark connection, so every call makes a full
+ * round trip through the D-Bus daemon.
+ */
+class NmCapabilitiesStandIn
+{
+  public:
+    NmCapabilitiesStandIn()
+    {
+        iface = DbusEnvironment::getObjServer()->add_interface(
+            kBenchmarkNmDomainPath, kBenchmarkNmCapabilitiesInterface);
+        iface->register_property("Max", double{32767});
+        iface->register_property("Min", double{0});
+        iface->register_property("MaxCorrectionTimeInMs", uint32_t{600000});
+        iface->register_property("MinCorrectionTimeInMs", uint32_t{1000});
+        iface->register_property("MaxStatisticsReportingPeriod",
+                                 uint16_t{3600});
+        iface->register_property("MinStatisticsReportingPeriod", uint16_t{1});
+        iface->initialize();
+    }
+
+    ~NmCapabilitiesStandIn()
+    {
+        DbusEnvironment::getObjServer()->remove_interface(iface);
+    }
+
+  private:
+    std::shared_ptr<sdbusplus::asio::dbus_interface> iface;
+};
+
+/**
+ * @brief Calls Properties method of the stand-in and runs the io_context until
+ * the reply arrives, the way an IPMI command coroutine waits for it.
+ */
+template <class Result, class... Args>
+static bool callNmStandIn(Result& result, const char* method, Args&&... args)
+{
+    bool done = false;
+    boost::system::error_code error;
+    DbusEnvironment::getBus()->async_method_call(
+        [&done, &error, &result](boost::system::error_code ec, Result value) {
+            error = ec;
+            result = std::move(value);
+            done = true;
+        },
+        DbusEnvironment::serviceName(), kBenchmarkNmDomainPath,
+        "org.freedesktop.DBus.Properties", method,
+        std::forward<Args>(args)...);
+    while (!done)
+    {
+        DbusEnvironment::getIoc().run_one();
+    }
+    return !error;
+}
+
+/**
+ * @brief Latency of reading `count` capabilities with one Get per property,
+ * as done by the IPMI handlers without the cache.
+ */
+static void BM_IpmiPropertiesGetEach(benchmark::State& state)
+{
+    NmCapabilitiesStandIn standIn;
+    const auto count = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            nmipmi::NmPropertyValue value;
+            if (!callNmStandIn(value, "Get", kBenchmarkNmCapabilitiesInterface,
+                               kBenchmarkNmCapabilities[idx]))
+            {
+                state.SkipWithError("Get failed");
+                return;
+            }
+            benchmark::DoNotOptimize(value);
+        }
+    }
+}
+BENCHMARK(BM_IpmiPropertiesGetEach)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(6)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Latency of reading `count` capabilities with a single GetAll.
+ */
+static void BM_IpmiPropertiesGetAll(benchmark::State& state)
+{
+    NmCapabilitiesStandIn standIn;
+    const auto count = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        nmipmi::NmPropertyMap properties;
+        if (!callNmStandIn(properties, "GetAll",
+                           kBenchmarkNmCapabilitiesInterface))
+        {
+            state.SkipWithError("GetAll failed");
+            return;
+        }
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            benchmark::DoNotOptimize(
+                properties.at(kBenchmarkNmCapabilities[idx]));
+        }
+    }
+}
+BENCHMARK(BM_IpmiPropertiesGetAll)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(6)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Latency of reading `count` capabilities through the cache used by
+ * the IPMI handlers. Values are fetched with GetAll whenever the cached ones
+ * expire, so the result includes a refresh every second, the TTL used for
+ * properties by the handlers.
+ */
+static void BM_IpmiPropertiesCached(benchmark::State& state)
+{
+    NmCapabilitiesStandIn standIn;
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto key =
+        std::make_pair(std::string(kBenchmarkNmDomainPath),
+                       std::string(kBenchmarkNmCapabilitiesInterface));
+    nmipmi::NmTtlCache<std::pair<std::string, std::string>,
+                       nmipmi::NmPropertyMap>
+        cache{std::chrono::milliseconds{1000}};
+
+    for (auto _ : state)
+    {
+        auto properties = cache.find(key);
+        if (!properties)
+        {
+            nmipmi::NmPropertyMap values;
+            if (!callNmStandIn(values, "GetAll",
+                               kBenchmarkNmCapabilitiesInterface))
+            {
+                state.SkipWithError("GetAll failed");
+                return;
+            }
+            properties =
+                cache.insert(key, std::move(values), cache.getGeneration());
+        }
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            benchmark::DoNotOptimize(
+                properties->at(kBenchmarkNmCapabilities[idx]));
+        }
+    }
+}
+BENCHMARK(BM_IpmiPropertiesCached)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(6)
+    ->Unit(benchmark::kMicrosecond);
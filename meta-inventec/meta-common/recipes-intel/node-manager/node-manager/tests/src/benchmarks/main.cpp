@@ -0,0 +1,40 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#include "benchmarks/control_loop_benchmark.hpp"
+#include "benchmarks/hwmon_discovery_benchmark.hpp"
+#include "benchmarks/ipmi_dbus_access_benchmark.hpp"
+#include "benchmarks/policy_storage_benchmark.hpp"
+#include "benchmarks/statistics_benchmark.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv)
+{
+    DbusEnvironment env;
+    env.SetUp();
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    env.teardown();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "policies/policy_storage_management.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace nodemanager;
+
+static const std::filesystem::path kBenchmarkPoliciesDir =
+    std::filesystem::temp_directory_path() / "benchmark_policies";
+
+static nlohmann::json makeBenchmarkPolicyJson()
+{
+    PolicyParams policyParams{};
+    policyParams.correctionInMs = 1000u;
+    policyParams.limit = 250u;
+    policyParams.statReportingPeriod = 10u;
+    policyParams.policyStorage = PolicyStorage::persistentStorage;
+    policyParams.componentId = kComponentIdAll;
+    return {{"domainId", DomainId::AcTotalPower},
+            {"owner", PolicyOwner::bmc},
+            {"isEnabled", true},
+            {"policyParams", policyParams}};
+}
+
+/**
+ * @brief Startup cost of reading `policies` policies stored in the policy
+ * log, from construction of PolicyStorageManagement until policiesRead()
+ * returns.
+ */
+static void BM_PolicyStorageLoad(benchmark::State& state)
+{
+    std::filesystem::remove_all(kBenchmarkPoliciesDir);
+    {
+        PolicyStorageManagement storage(kBenchmarkPoliciesDir);
+        for (int64_t idx = 0; idx < state.range(0); ++idx)
+        {
+            storage.policyWrite(std::to_string(idx), makeBenchmarkPolicyJson());
+        }
+    }
+
+    for (auto _ : state)
+    {
+        PolicyStorageManagement storage(kBenchmarkPoliciesDir);
+        benchmark::DoNotOptimize(storage.policiesRead());
+    }
+    std::filesystem::remove_all(kBenchmarkPoliciesDir);
+}
+BENCHMARK(BM_PolicyStorageLoad)
+    ->ArgName("policies")
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief One time cost of the first startup after update, when `policies`
+ * json files written by previous versions are moved to the policy log.
+ */
+static void BM_PolicyStorageMigration(benchmark::State& state)
+{
+    PersistentStorage jsonStorage;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::filesystem::remove_all(kBenchmarkPoliciesDir);
+        for (int64_t idx = 0; idx < state.range(0); ++idx)
+        {
+            jsonStorage.store(kBenchmarkPoliciesDir /
+                                  (std::to_string(idx) + ".json"),
+                              makeBenchmarkPolicyJson());
+        }
+        state.ResumeTiming();
+
+        PolicyStorageManagement storage(kBenchmarkPoliciesDir);
+        benchmark::DoNotOptimize(storage.policiesRead());
+    }
+    std::filesystem::remove_all(kBenchmarkPoliciesDir);
+}
+BENCHMARK(BM_PolicyStorageMigration)
+    ->ArgName("policies")
+    ->Arg(256)
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Cost of storing a change of all `policies` policies made while
+ * handling a single D-Bus call.
+ */
+static void BM_PolicyStorageBatchedWrite(benchmark::State& state)
+{
+    std::filesystem::remove_all(kBenchmarkPoliciesDir);
+    boost::asio::io_context ioc;
+    PolicyStorageManagement storage(ioc, kBenchmarkPoliciesDir);
+    const auto policyJson = makeBenchmarkPolicyJson();
+
+    for (auto _ : state)
+    {
+        for (int64_t idx = 0; idx < state.range(0); ++idx)
+        {
+            storage.policyWrite(std::to_string(idx), policyJson);
+        }
+        ioc.poll();
+        ioc.restart();
+    }
+    std::filesystem::remove_all(kBenchmarkPoliciesDir);
+}
+BENCHMARK(BM_PolicyStorageBatchedWrite)
+    ->ArgName("policies")
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,96 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "clock.hpp"
+#include "statistics/policy_accumulator.hpp"
+#include "utils/naive_sliding_window.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace nodemanager;
+
+// Same as kLoopPeriod, the header is kept independent from NodeManager
+static constexpr int64_t kBenchmarkTickMs = 100;
+
+/**
+ * @brief Per-tick cost of policy statistics: every accumulator gets a new
+ * sample and all of its statistics are read, as is done for each policy in
+ * every iteration of the control loop.
+ */
+static void BM_PolicyAccumulatorsTick(benchmark::State& state)
+{
+    std::vector<std::unique_ptr<PolicyAccumulator>> accumulators;
+    for (int64_t idx = 0; idx < state.range(0); ++idx)
+    {
+        accumulators.emplace_back(std::make_unique<PolicyAccumulator>(
+            DurationMs{std::chrono::seconds{30}}));
+    }
+    double sample = 0.0;
+
+    for (auto _ : state)
+    {
+        Clock::stepMs(kBenchmarkTickMs);
+        sample = sample < 100.0 ? sample + 1.0 : 0.0;
+        for (const auto& accumulator : accumulators)
+        {
+            accumulator->addSample(sample);
+            benchmark::DoNotOptimize(accumulator->getAvg());
+            benchmark::DoNotOptimize(accumulator->getMin());
+            benchmark::DoNotOptimize(accumulator->getMax());
+            benchmark::DoNotOptimize(accumulator->getCurrentValue());
+        }
+    }
+}
+BENCHMARK(BM_PolicyAccumulatorsTick)
+    ->ArgName("policies")
+    ->Arg(64)
+    ->Arg(128)
+    ->Arg(256);
+
+/**
+ * @brief Single push followed by all queries on a full window of `capacity`
+ * samples. Compares SlidingWindow with iterating over all samples.
+ */
+template <class Window>
+static void BM_WindowPushAndQuery(benchmark::State& state)
+{
+    const auto capacity = static_cast<size_t>(state.range(0));
+    Window window(capacity);
+    for (size_t idx = 0; idx < capacity; ++idx)
+    {
+        const auto value = static_cast<double>(idx);
+        window.push(Sample{value, value, value});
+    }
+    double value = 0.0;
+
+    for (auto _ : state)
+    {
+        value = value < 1000.0 ? value + 1.0 : 0.0;
+        window.push(Sample{value, value + 1.0, value - 1.0});
+        benchmark::DoNotOptimize(window.getSum());
+        benchmark::DoNotOptimize(window.getMin());
+        benchmark::DoNotOptimize(window.getMax());
+    }
+}
+BENCHMARK_TEMPLATE(BM_WindowPushAndQuery, NaiveSlidingWindow)
+    ->Arg(kPtamStatsWindowCount)
+    ->Arg(300)
+    ->Arg(3000);
+BENCHMARK_TEMPLATE(BM_WindowPushAndQuery, SlidingWindow)
+    ->Arg(kPtamStatsWindowCount)
+    ->Arg(300)
+    ->Arg(3000);
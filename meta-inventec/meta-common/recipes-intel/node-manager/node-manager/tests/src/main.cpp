@@ -67,20 +67,33 @@
 #include "unit_tests/sensors/cpu_utilization_sensor_test.hpp"
 #include "unit_tests/sensors/gpio_sensor_test.hpp"
 #include "unit_tests/sensors/gpu_power_state_dbus_sensor_test.hpp"
+#include "unit_tests/sensors/hwmon_file_reader_test.hpp"
 #include "unit_tests/sensors/hwmon_sensor_test.hpp"
+#include "unit_tests/sensors/peci_scheduler_test.hpp"
 #include "unit_tests/sensors/peci_sensor_test.hpp"
+#include "unit_tests/sensors/peci_transport_test.hpp"
 #include "unit_tests/sensors/power_state_dbus_sensor_test.hpp"
 #include "unit_tests/sensors/sensor_reading_test.hpp"
 #include "unit_tests/sensors/sensor_readings_manager_test.hpp"
+#include "unit_tests/sensors/sensor_snapshot_test.hpp"
 #include "unit_tests/sensors/sensor_test.hpp"
 #include "unit_tests/statistics/energy_statistic_test.hpp"
 #include "unit_tests/statistics/moving_average_test.hpp"
 #include "unit_tests/statistics/normal_average_test.hpp"
+#include "unit_tests/statistics/sliding_window_test.hpp"
 #include "unit_tests/statistics/statistic_test.hpp"
 #include "unit_tests/statistics/throttling_statistic_test.hpp"
 #include "unit_tests/status_monitor_test.hpp"
+#include "unit_tests/throttling_events/throttling_log_collector_test.hpp"
 #include "unit_tests/triggers/trigger_test.hpp"
 #include "unit_tests/utility/async_executor_test.hpp"
+#include "unit_tests/utility/dbus_property_cache_test.hpp"
+#include "unit_tests/utility/diagnostics_writer_test.hpp"
+#include "unit_tests/utility/latency_histogram_test.hpp"
+#include "unit_tests/utility/log_tail_reader_test.hpp"
+#include "unit_tests/utility/loop_scheduler_test.hpp"
+#include "unit_tests/utility/performance_monitor_test.hpp"
+#include "unit_tests/utility/worker_pool_test.hpp"
 #include "utils/dbus_environment.hpp"
 
 #include "gtest/gtest.h"
@@ -25,8 +25,9 @@ template <typename K, typename T>
 class AsyncExecutorMock : public AsyncExecutorIf<K, T>
 {
   public:
-    MOCK_METHOD(void, schedule,
+    MOCK_METHOD(bool, schedule,
                 ((const K& key), (typename AsyncExecutorIf<K, T>::Task task),
                  (typename AsyncExecutorIf<K, T>::TaskCallback callback)),
                 (override));
+    MOCK_METHOD(bool, isPending, (const K& key), (const, override));
 };
@@ -29,5 +29,6 @@ class KnobMock : public KnobIf
     MOCK_METHOD(DeviceIndex, getDeviceIndex, (), (const override));
     MOCK_METHOD(void, reportStatus, (nlohmann::json & out), (const override));
     MOCK_METHOD(NmHealth, getHealth, (), (const override));
+    MOCK_METHOD(KnobWriteCounters, getWriteCounters, (), (const override));
     MOCK_METHOD(void, run, (), (override));
 };
\ No newline at end of file
@@ -36,6 +36,7 @@ class SensorReadingMock : public SensorReadingIf
     MOCK_METHOD(bool, isGood, (), (const));
     MOCK_METHOD(ValueType, getValue, (), (const));
     MOCK_METHOD(void, updateValue, (ValueType newValue));
+    MOCK_METHOD(Clock::time_point, getUpdateTimestamp, (), (const));
     MOCK_METHOD(SensorReadingType, getSensorReadingType, (), (const));
     MOCK_METHOD(DeviceIndex, getDeviceIndex, (), (const));
 };
\ No newline at end of file
@@ -29,11 +29,20 @@ using namespace nodemanager;
 class SensorReadingsManagerMock : public SensorReadingsManagerIf
 {
   public:
+    SensorReadingsManagerMock()
+    {
+        ON_CALL(*this, getSnapshot())
+            .WillByDefault(testing::ReturnRef(snapshot));
+    }
+
     MOCK_METHOD(std::shared_ptr<SensorReadingIf>, sensorReadingExists,
                 (SensorReadingType type, DeviceIndex deviceIndex));
     MOCK_METHOD(std::shared_ptr<SensorReadingIf>, createSensorReading,
                 (SensorReadingType type, DeviceIndex deviceIndex));
     MOCK_METHOD(void, deleteSensorReading, (SensorReadingType type));
+    MOCK_METHOD(void, dispatchEvents, (), (override));
+    MOCK_METHOD(void, publishSnapshot, (), (override));
+    MOCK_METHOD(const SensorSnapshot&, getSnapshot, (), (const, override));
     MOCK_METHOD(bool, forEachSensorReading,
                 (SensorReadingType sensorReadingType, DeviceIndex deviceIndex,
                  std::function<void(SensorReadingIf&)>&& action));
@@ -56,4 +65,10 @@ class SensorReadingsManagerMock : public SensorReadingsManagerIf
     MOCK_METHOD(bool, isCpuAvailable, (const DeviceIndex idx), (const));
     MOCK_METHOD(bool, isPowerStateOn, (), (const));
     MOCK_METHOD(bool, isGpuPowerStateOn, (), (const));
+
+    /**
+     * @brief Snapshot returned by default from getSnapshot(), tests fill it
+     * and call finalize() before running the unit under test.
+     */
+    SensorSnapshot snapshot;
 };
@@ -325,4 +325,137 @@ TEST_F(HwmonFileProviderTest, PsuPowerFileDetected)
         sut_->getFile(SensorReadingType::acPlatformPower, DeviceIndex{0})
             .c_str(),
         createdFile.c_str());
-}
\ No newline at end of file
+}
+
+struct HwmonFileProviderNotifyingDiscovery : public HwmonFileProvider
+{
+    using HwmonFileProvider::HwmonFileProvider;
+
+    void onFilesDiscovered() override
+    {
+        if (auto notify = std::exchange(onDiscovered, nullptr))
+        {
+            notify();
+        }
+    }
+
+    std::function<void()> onDiscovered;
+};
+
+class HwmonFileProviderEventsTest : public ::testing::Test
+{
+  public:
+    virtual ~HwmonFileProviderEventsTest()
+    {
+        sut_ = nullptr;
+        DbusEnvironment::synchronizeIoc();
+    }
+
+  protected:
+    void createSut(HwmonDiscoveryMode mode)
+    {
+        sut_ = std::make_shared<HwmonFileProviderNotifyingDiscovery>(
+            DbusEnvironment::getBus(), hwmon_.getRootPath(), true, mode);
+    }
+
+    void waitForDiscovery()
+    {
+        sut_->onDiscovered = DbusEnvironment::setPromise("hwmonDiscovered");
+        ASSERT_TRUE(DbusEnvironment::waitForFuture("hwmonDiscovered"));
+    }
+
+    void waitForFile(std::function<bool()> detected)
+    {
+        for (unsigned scan = 0; scan < kMaxScans && !detected(); scan++)
+        {
+            waitForDiscovery();
+        }
+    }
+
+    static constexpr unsigned kMaxScans = 5;
+    HwmonFileManager hwmon_;
+    std::shared_ptr<HwmonFileProviderNotifyingDiscovery> sut_;
+};
+
+TEST_F(HwmonFileProviderEventsTest, InotifyUsedWhenRootIsNotSysfs)
+{
+    createSut(HwmonDiscoveryMode::events);
+
+    EXPECT_EQ(sut_->getEventSource(), HwmonEventSource::inotify);
+}
+
+TEST_F(HwmonFileProviderEventsTest, NoEventSourceInPeriodicMode)
+{
+    createSut(HwmonDiscoveryMode::periodic);
+
+    EXPECT_EQ(sut_->getEventSource(), HwmonEventSource::none);
+}
+
+TEST_F(HwmonFileProviderEventsTest, DeviceAddedAfterStartDetectedBeforeRescan)
+{
+    createSut(HwmonDiscoveryMode::events);
+    waitForDiscovery();
+
+    auto createdFile = hwmon_.createPsuFile(7, 0x58, HwmonGroup::psu,
+                                            HwmonFileType::psuAcPower);
+    waitForFile([this] {
+        return !sut_->getFile(SensorReadingType::acPlatformPower,
+                              DeviceIndex{0})
+                    .empty();
+    });
+
+    EXPECT_STREQ(
+        sut_->getFile(SensorReadingType::acPlatformPower, DeviceIndex{0})
+            .c_str(),
+        createdFile.c_str());
+}
+
+TEST_F(HwmonFileProviderEventsTest, DeviceRemovedFromOneBusOtherBusNotAffected)
+{
+    createSut(HwmonDiscoveryMode::events);
+    auto psuFile = hwmon_.createPsuFile(7, 0x58, HwmonGroup::psu,
+                                        HwmonFileType::psuAcPower);
+    auto cpuFile = hwmon_.createCpuFile(kHwmonPeciCpuBaseAddress,
+                                        HwmonGroup::cpu, HwmonFileType::limit);
+    waitForFile([this] {
+        return !sut_->getFile(SensorReadingType::acPlatformPower,
+                              DeviceIndex{0})
+                    .empty() &&
+               !sut_->getFile(KnobType::CpuPackagePower, DeviceIndex{0})
+                    .empty();
+    });
+    ASSERT_STREQ(
+        sut_->getFile(SensorReadingType::acPlatformPower, DeviceIndex{0})
+            .c_str(),
+        psuFile.c_str());
+
+    std::filesystem::remove_all(psuFile.parent_path());
+    waitForFile([this] {
+        return sut_->getFile(SensorReadingType::acPlatformPower,
+                             DeviceIndex{0})
+            .empty();
+    });
+
+    EXPECT_TRUE(
+        sut_->getFile(SensorReadingType::acPlatformPower, DeviceIndex{0})
+            .empty());
+    EXPECT_STREQ(
+        sut_->getFile(KnobType::CpuPackagePower, DeviceIndex{0}).c_str(),
+        cpuFile.c_str());
+}
+
+TEST(HwmonEventMonitorTest, BusAdapterMatchedAsWholePathComponent)
+{
+    EXPECT_TRUE(HwmonEventMonitor::isBusAdapterInPath(
+        "/devices/platform/ahb/1e78a000.i2c-bus/i2c-7/7-0058/hwmon/hwmon3",
+        "i2c"));
+    EXPECT_TRUE(HwmonEventMonitor::isBusAdapterInPath("/devices/i2c-12", "i2c"));
+    EXPECT_FALSE(HwmonEventMonitor::isBusAdapterInPath(
+        "/devices/platform/xi2c-7/hwmon/hwmon3", "i2c"));
+    EXPECT_FALSE(HwmonEventMonitor::isBusAdapterInPath(
+        "/devices/platform/i2c-7a/hwmon/hwmon3", "i2c"));
+    EXPECT_FALSE(HwmonEventMonitor::isBusAdapterInPath(
+        "/devices/platform/i2c-/hwmon/hwmon3", "i2c"));
+    EXPECT_FALSE(HwmonEventMonitor::isBusAdapterInPath(
+        "/devices/platform/peci-0/hwmon/hwmon3", "i2c"));
+}
@@ -46,7 +46,8 @@ class HwmonKnobTest : public testing::Test
                      testing::_, testing::_))
             .WillByDefault(
                 testing::DoAll(testing::SaveArg<1>(&asyncTask_),
-                               testing::SaveArg<2>(&asyncTaskCallback_)));
+                               testing::SaveArg<2>(&asyncTaskCallback_),
+                               testing::Return(true)));
 
         path_ = hwmonFileManager_.createCpuFile(kHwmonPeciCpuBaseAddress,
                                                 HwmonGroup::cpu,
@@ -393,4 +394,163 @@ TEST_F(HwmonKnobTest, ResetKnobIsKnobSetReturnsFalse)
     EXPECT_FALSE(sut_->isKnobSet());
 }
 
-} // namespace nodemanager
\ No newline at end of file
+class HwmonKnobWritePolicyTest : public HwmonKnobTest
+{
+  public:
+    static constexpr KnobWritePolicy kWritePolicy{
+        500, std::chrono::milliseconds{1000}};
+
+    virtual void SetUp() override
+    {
+        HwmonKnobTest::SetUp();
+        sut_ = std::make_shared<HwmonKnob>(
+            KnobType::CpuPackagePower, DeviceIndex{0}, 1,
+            maxKnobValueInMilliWatts, hwmonFileProvider_, asyncExecutorMock_,
+            sensorReadingsManager_, kWritePolicy);
+    }
+
+    void setAndWrite(double value)
+    {
+        sut_->setKnob(value);
+        sut_->run();
+        asyncTaskCallback_(asyncTask_());
+    }
+};
+
+TEST_F(HwmonKnobWritePolicyTest, ValueWithinHysteresisIsNotWritten)
+{
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(1);
+    setAndWrite(5);
+    sut_->setKnob(5.5);
+    sut_->run();
+
+    EXPECT_EQ(hwmonFileManager_.readFile(path_), "5000");
+}
+
+TEST_F(HwmonKnobWritePolicyTest, ValueOutsideHysteresisIsWritten)
+{
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(2);
+    setAndWrite(5);
+    setAndWrite(4.4);
+
+    EXPECT_EQ(hwmonFileManager_.readFile(path_), "4400");
+}
+
+TEST_F(HwmonKnobWritePolicyTest, ResetValueWithinHysteresisIsWritten)
+{
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(2);
+    setAndWrite(0.3);
+    sut_->resetKnob();
+    sut_->run();
+    asyncTaskCallback_(asyncTask_());
+
+    EXPECT_EQ(hwmonFileManager_.readFile(path_), "0");
+    EXPECT_FALSE(sut_->isKnobSet());
+}
+
+TEST_F(HwmonKnobWritePolicyTest,
+       UnchangedValueIsWrittenAgainAfterRefreshInterval)
+{
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(2);
+    setAndWrite(5);
+    Clock::stepMs(kWritePolicy.refreshInterval.count() - 1);
+    sut_->run();
+    Clock::stepMs(1);
+    sut_->run();
+}
+
+TEST_F(HwmonKnobWritePolicyTest, WriteCountersCountIssuedAndSuppressedWrites)
+{
+    setAndWrite(5);
+    sut_->run();
+    sut_->setKnob(5.2);
+    sut_->run();
+    setAndWrite(10);
+
+    const auto counters = sut_->getWriteCounters();
+    EXPECT_EQ(counters.issued, 2u);
+    EXPECT_EQ(counters.suppressed, 2u);
+}
+
+TEST_F(HwmonKnobWritePolicyTest,
+       WriteRejectedByExecutorIsNotCountedAsSuppressed)
+{
+    ON_CALL(*asyncExecutorMock_,
+            schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                     testing::_, testing::_))
+        .WillByDefault(testing::Return(false));
+    sut_->setKnob(5);
+    sut_->run();
+
+    const auto counters = sut_->getWriteCounters();
+    EXPECT_EQ(counters.issued, 0u);
+    EXPECT_EQ(counters.suppressed, 0u);
+}
+
+TEST_F(HwmonKnobWritePolicyTest, FailedWriteIsNotCountedAsIssued)
+{
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(2);
+    sut_->setKnob(5);
+    sut_->run();
+    asyncTaskCallback_({std::ios_base::badbit, 0});
+    EXPECT_EQ(sut_->getWriteCounters().issued, 0u);
+
+    sut_->run();
+    asyncTaskCallback_(asyncTask_());
+    EXPECT_EQ(sut_->getWriteCounters().issued, 1u);
+}
+
+TEST_F(HwmonKnobWritePolicyTest, SameValueIsNotScheduledWhileItsWriteIsPending)
+{
+    ON_CALL(*asyncExecutorMock_,
+            isPending(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0})))
+        .WillByDefault(testing::Return(true));
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(1);
+    sut_->setKnob(5);
+    sut_->run();
+    sut_->run();
+
+    EXPECT_EQ(sut_->getWriteCounters().suppressed, 0u);
+}
+
+TEST_F(HwmonKnobWritePolicyTest, NewValueIsScheduledWhileAnotherWriteIsPending)
+{
+    ON_CALL(*asyncExecutorMock_,
+            isPending(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0})))
+        .WillByDefault(testing::Return(true));
+    EXPECT_CALL(
+        *asyncExecutorMock_,
+        schedule(testing::Pair(KnobType::CpuPackagePower, DeviceIndex{0}),
+                 testing::_, testing::_))
+        .Times(2);
+    sut_->setKnob(5);
+    sut_->run();
+    sut_->setKnob(10);
+    sut_->run();
+}
+
+} // namespace nodemanager
@@ -45,7 +45,8 @@ class HwpmKnobTest : public testing::Test
                      testing::_, testing::_))
             .WillByDefault(
                 testing::DoAll(testing::SaveArg<1>(&asyncTask_),
-                               testing::SaveArg<2>(&asyncTaskCallback_)));
+                               testing::SaveArg<2>(&asyncTaskCallback_),
+                               testing::Return(true)));
 
         ON_CALL(*sensorReadingsManager_, isCpuAvailable(testing::_))
             .WillByDefault(testing::Return(true));
@@ -248,7 +249,8 @@ TEST_F(HwpmKnobTest, bias_knob_type_calls_bias_peci_command)
                 schedule(testing::Pair(KnobType::HwpmPerfBias, kDeviceIndex),
                          testing::_, testing::_))
         .WillOnce(testing::DoAll(testing::SaveArg<1>(&asyncTask_),
-                                 testing::SaveArg<2>(&asyncTaskCallback_)));
+                                 testing::SaveArg<2>(&asyncTaskCallback_),
+                                 testing::Return(true)));
     EXPECT_CALL(*peciCommands_, setHwpmPreferenceBias(kDeviceIndex, 5))
         .WillOnce(testing::Return(true));
 
@@ -271,7 +273,8 @@ TEST_F(HwpmKnobTest, override_knob_type_calls_override_peci_command)
                                        kDeviceIndex),
                          testing::_, testing::_))
         .WillOnce(testing::DoAll(testing::SaveArg<1>(&asyncTask_),
-                                 testing::SaveArg<2>(&asyncTaskCallback_)));
+                                 testing::SaveArg<2>(&asyncTaskCallback_),
+                                 testing::Return(true)));
     EXPECT_CALL(*peciCommands_, setHwpmPreferenceOverride(kDeviceIndex, 5))
         .WillOnce(testing::Return(true));
 
@@ -526,6 +526,33 @@ TEST_F(PcieDbusKnobTest, SetKnobReturnError_HealthIsWarning)
     ASSERT_TRUE(waitForHealthSet(NmHealth::warning));
 }
 
+TEST_F(PcieDbusKnobTest, SetKnobReturnError_WriteIsNotCountedAsIssued)
+{
+    setDbusSetEffecterExpectation(PcieKnobType::PL1, 5.0, getAts());
+    setErrorLimitExpectation(PcieKnobType::PL2, 6.0, getAts());
+
+    sut_->setKnob(5);
+    sut_->run();
+
+    ASSERT_TRUE(waitForHealthSet(NmHealth::warning));
+    EXPECT_EQ(sut_->getWriteCounters().issued, 0u);
+}
+
+TEST_F(PcieDbusKnobTest, WriteInProgress_NextWriteIsNotStarted)
+{
+    setDbusSetEffecterExpectation(PcieKnobType::PL1, 5.0, getAts());
+    setDbusSetEffecterExpectation(PcieKnobType::PL2, 6.0, getAts());
+
+    sut_->setKnob(5);
+    sut_->run();
+    sut_->setKnob(10);
+    sut_->run();
+
+    ASSERT_TRUE(waitForValueSet(5.0));
+    EXPECT_EQ(sut_->getWriteCounters().issued, 1u);
+    EXPECT_EQ(sut_->getWriteCounters().suppressed, 0u);
+}
+
 TEST_F(PcieDbusKnobTest, InittialyHealthIsOk)
 {
     sut_->run();
@@ -43,7 +43,8 @@ class ProchotRatioKnobTest : public testing::Test
                          testing::_, testing::_))
             .WillByDefault(
                 testing::DoAll(testing::SaveArg<1>(&asyncTask_),
-                               testing::SaveArg<2>(&asyncTaskCallback_)));
+                               testing::SaveArg<2>(&asyncTaskCallback_),
+                               testing::Return(true)));
 
         ON_CALL(*sensorReadingsManager_, isCpuAvailable(testing::_))
             .WillByDefault(testing::Return(true));
@@ -63,6 +63,19 @@ class PolicyStorageManagementTest : public ::testing::Test
         };
     }
 
+    nlohmann::json getTestPolicyJson()
+    {
+        return {{"domainId", DomainId::HwProtection},
+                {"owner", PolicyOwner::bmc},
+                {"isEnabled", false},
+                {"policyParams", getTestPolicyParams()}};
+    }
+
+    std::filesystem::path getLogPath()
+    {
+        return policyFilesDir_ / kPolicyStoreFileName;
+    }
+
     std::shared_ptr<PolicyStorageManagement> sut_;
     std::filesystem::path policyFilesDir_ =
         std::filesystem::temp_directory_path() / "policies";
@@ -144,4 +157,141 @@ TEST_F(PolicyStorageManagementTest, PolicyDeletePolicyIsDeleted)
     std::vector<std::tuple<PolicyId, DomainId, PolicyOwner, bool, PolicyParams>>
         policies = sut_->policiesRead();
     EXPECT_EQ(policies.size(), 0u);
-}
\ No newline at end of file
+}
+
+TEST_F(PolicyStorageManagementTest, PoliciesWrittenAreReadByNewInstance)
+{
+    sut_->policyWrite("0", getTestPolicyJson());
+    sut_->policyWrite("1", getTestPolicyJson());
+    sut_->policyDelete("0");
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    auto policies = sut_->policiesRead();
+
+    ASSERT_EQ(policies.size(), 1u);
+    EXPECT_EQ(std::get<PolicyId>(policies.at(0)), "1");
+    EXPECT_EQ(std::get<PolicyParams>(policies.at(0)), getTestPolicyParams());
+}
+
+TEST_F(PolicyStorageManagementTest, JsonPolicyFilesAreMigratedAndRemoved)
+{
+    PersistentStorage storage;
+    storage.store(policyFilesDir_ / "5.json", getTestPolicyJson());
+    storage.store(policyFilesDir_ / "7.json", getTestPolicyJson());
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    auto policies = sut_->policiesRead();
+
+    ASSERT_EQ(policies.size(), 2u);
+    EXPECT_EQ(std::get<PolicyId>(policies.at(0)), "5");
+    EXPECT_EQ(std::get<PolicyId>(policies.at(1)), "7");
+    EXPECT_FALSE(std::filesystem::exists(policyFilesDir_ / "5.json"));
+    EXPECT_FALSE(std::filesystem::exists(policyFilesDir_ / "7.json"));
+    EXPECT_TRUE(std::filesystem::exists(getLogPath()));
+}
+
+TEST_F(PolicyStorageManagementTest, TruncatedLastRecordIsDroppedOthersAreRead)
+{
+    sut_->policyWrite("0", getTestPolicyJson());
+    sut_->policyWrite("1", getTestPolicyJson());
+    sut_.reset();
+    std::filesystem::resize_file(getLogPath(),
+                                 std::filesystem::file_size(getLogPath()) - 3);
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    sut_->policyWrite("2", getTestPolicyJson());
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    auto policies = sut_->policiesRead();
+
+    ASSERT_EQ(policies.size(), 2u);
+    EXPECT_EQ(std::get<PolicyId>(policies.at(0)), "0");
+    EXPECT_EQ(std::get<PolicyId>(policies.at(1)), "2");
+}
+
+TEST_F(PolicyStorageManagementTest, RecordWithInvalidCrcIsDropped)
+{
+    sut_->policyWrite("0", getTestPolicyJson());
+    sut_.reset();
+    std::fstream file(getLogPath(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(-1, std::ios::end);
+    const auto lastByte = static_cast<char>(file.get());
+    file.seekp(-1, std::ios::end);
+    file.put(static_cast<char>(~lastByte));
+    file.close();
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+
+    EXPECT_EQ(sut_->policiesRead().size(), 0u);
+}
+
+TEST_F(PolicyStorageManagementTest, RepeatedWritesOfSamePolicyAreCompacted)
+{
+    sut_->policyWrite("0", getTestPolicyJson());
+    const auto singleRecordSize = std::filesystem::file_size(getLogPath());
+
+    for (size_t idx = 0; idx < 10 * kPolicyStoreCompactionThreshold; ++idx)
+    {
+        sut_->policyWrite("0", getTestPolicyJson());
+    }
+
+    EXPECT_LE(std::filesystem::file_size(getLogPath()),
+              (kPolicyStoreCompactionThreshold + 1) * singleRecordSize);
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    EXPECT_EQ(sut_->policiesRead().size(), 1u);
+}
+
+TEST_F(PolicyStorageManagementTest, ChangesNotWrittenBecauseOfErrorAreWrittenLater)
+{
+    sut_->policyWrite("0", getTestPolicyJson());
+    std::filesystem::remove(getLogPath());
+    std::filesystem::create_directory(getLogPath());
+
+    EXPECT_FALSE(sut_->policyWrite("1", getTestPolicyJson()));
+
+    std::filesystem::remove(getLogPath());
+    EXPECT_TRUE(sut_->policyWrite("2", getTestPolicyJson()));
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    const auto policies = sut_->policiesRead();
+    ASSERT_EQ(policies.size(), 3u);
+    EXPECT_EQ(std::get<0>(policies[0]), "0");
+    EXPECT_EQ(std::get<0>(policies[1]), "1");
+    EXPECT_EQ(std::get<0>(policies[2]), "2");
+}
+
+TEST_F(PolicyStorageManagementTest, WritesFromOneHandlerAreStoredTogether)
+{
+    boost::asio::io_context ioc;
+    sut_ = std::make_shared<PolicyStorageManagement>(ioc, policyFilesDir_);
+    for (const auto& policyId : {"0", "1", "2"})
+    {
+        sut_->policyWrite(policyId, getTestPolicyJson());
+    }
+    EXPECT_FALSE(std::filesystem::exists(getLogPath()));
+
+    ioc.poll();
+
+    EXPECT_EQ(
+        PolicyStorageManagement(policyFilesDir_).policiesRead().size(), 3u);
+}
+
+TEST_F(PolicyStorageManagementTest, TornRecordOfFailedWriteDoesNotHideLaterWrites)
+{
+    PersistentStorage storage;
+    sut_->policyWrite("0", getTestPolicyJson());
+    const auto validContent = *storage.readFile(getLogPath());
+    std::filesystem::remove(getLogPath());
+    std::filesystem::create_directory(getLogPath());
+
+    EXPECT_FALSE(sut_->policyWrite("1", getTestPolicyJson()));
+
+    std::filesystem::remove(getLogPath());
+    std::ofstream(getLogPath(), std::ios::binary) << validContent << "torn";
+    EXPECT_TRUE(sut_->policyWrite("2", getTestPolicyJson()));
+
+    sut_ = std::make_shared<PolicyStorageManagement>(policyFilesDir_);
+    const auto policies = sut_->policiesRead();
+    ASSERT_EQ(policies.size(), 3u);
+    EXPECT_EQ(std::get<0>(policies[2]), "2");
+}
@@ -33,28 +33,13 @@ class ReadingAcPowerLimitTest : public ::testing::Test
         std::make_shared<testing::NiceMock<ReadingEventDispatcherMock>>();
     std::shared_ptr<SensorReadingsManagerMock> sensorReadingsManager_ =
         std::make_shared<testing::NiceMock<SensorReadingsManagerMock>>();
-    std::shared_ptr<SensorReadingMock> sensorPowerLimitReading =
-        std::make_shared<testing::NiceMock<SensorReadingMock>>();
     std::shared_ptr<ReadingConsumerMock> readingConsumer =
         std::make_shared<testing::NiceMock<ReadingConsumerMock>>();
     std::shared_ptr<ReadingConsumer> efficiencyReadingConsumer = nullptr;
 
     void SetUp() override
     {
-        ON_CALL(*sensorPowerLimitReading, getValue)
-            .WillByDefault(testing::Return(200.0));
-        ON_CALL(*sensorPowerLimitReading, isGood)
-            .WillByDefault(testing::Return(true));
-
-        ON_CALL(*sensorReadingsManager_,
-                forEachSensorReading(testing::_,
-                                     testing::Lt(unsigned(kMaxPlatformNumber)),
-                                     testing::_))
-            .WillByDefault(testing::Invoke(
-                [this](auto type, auto deviceIndex, auto action) {
-                    action(*(sensorPowerLimitReading));
-                    return true;
-                }));
+        setupPowerLimit(true);
 
         ON_CALL(
             *powerEfficiencyReading,
@@ -68,6 +53,17 @@ class ReadingAcPowerLimitTest : public ::testing::Test
         sut_->registerReadingConsumer(readingConsumer,
                                       ReadingType::acPlatformPowerLimit);
     }
+
+    void setupPowerLimit(bool isValid)
+    {
+        sensorReadingsManager_->snapshot.clear();
+        sensorReadingsManager_->snapshot.add(
+            {SensorReadingType::dcPlatformPowerLimit, 0,
+             isValid ? SensorReadingStatus::valid
+                     : SensorReadingStatus::invalid,
+             200.0, Clock::time_point{}});
+        sensorReadingsManager_->snapshot.finalize();
+    }
 };
 
 TEST_F(ReadingAcPowerLimitTest, CorrectReadingProducedExpectValuesInRange)
@@ -108,8 +104,7 @@ TEST_F(ReadingAcPowerLimitTest, LimitNanExpectNanReading)
 TEST_F(ReadingAcPowerLimitTest, ReadingNotAvailableExpectNanReading)
 {
     efficiencyReadingConsumer->updateValue(0.5);
-    ON_CALL(*sensorPowerLimitReading, isGood)
-        .WillByDefault(testing::Return(false));
+    setupPowerLimit(false);
     EXPECT_CALL(*readingConsumer,
                 updateValue(testing::NanSensitiveDoubleEq(
                     std::numeric_limits<double>::quiet_NaN())));
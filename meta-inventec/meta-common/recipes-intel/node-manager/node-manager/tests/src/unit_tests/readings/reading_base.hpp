@@ -66,17 +66,6 @@ class ReadingTestBase
                     .WillByDefault(testing::Return(config.value));
                 ON_CALL(*sensorReadings_.at(index), isGood())
                     .WillByDefault(testing::Return(config.isValidAndAvailable));
-
-                ON_CALL(*sensorReadingsManager_,
-                        forEachSensorReading(sensorReadingType,
-                                             static_cast<DeviceIndex>(index),
-                                             testing::_))
-                    .WillByDefault(testing::Invoke(
-                        [this, index](auto type, auto deviceIndex,
-                                      auto action) {
-                            action(*(sensorReadings_.at(index)));
-                            return true;
-                        }));
             }
             else
             {
@@ -85,8 +74,14 @@ class ReadingTestBase
                             sensorReadingType, static_cast<DeviceIndex>(index)))
                     .WillByDefault(testing::Return(nullptr));
             }
+            sensorReadingsManager_->snapshot.add(
+                {sensorReadingType, static_cast<DeviceIndex>(index),
+                 config.isValidAndAvailable ? SensorReadingStatus::valid
+                                            : SensorReadingStatus::invalid,
+                 config.value, Clock::time_point{}});
             index++;
         }
+        sensorReadingsManager_->snapshot.finalize();
     }
 
     void setupExpectedReadings(std::vector<std::vector<double>> values)
@@ -35,7 +35,6 @@ struct SensorCpuUtilizationConfiguration
 class ReadingCpuUtilizationTest : public ::testing::Test
 {
   public:
-    std::map<DeviceIndex, std::shared_ptr<SensorReadingMock>> sensors_;
     std::shared_ptr<ReadingConsumerMock> readingConsumer_ =
         std::make_shared<testing::NiceMock<ReadingConsumerMock>>();
     std::shared_ptr<SensorReadingsManagerMock> sensorReadingsManager_ =
@@ -45,30 +44,6 @@ class ReadingCpuUtilizationTest : public ::testing::Test
 
     void SetUp() override
     {
-        for (DeviceIndex cpuIndex = 0; cpuIndex < 3; ++cpuIndex)
-        {
-            sensors_[cpuIndex] =
-                std::make_shared<testing::NiceMock<SensorReadingMock>>();
-        }
-        ON_CALL(*sensorReadingsManager_,
-                forEachSensorReading(SensorReadingType::cpuUtilization,
-                                     testing::_, testing::_))
-            .WillByDefault(testing::Invoke(
-                [this](auto type, auto deviceIndex, auto action) {
-                    if (deviceIndex == kAllDevices)
-                    {
-                        for (auto& [idx, sensor] : sensors_)
-                        {
-                            action(*sensor);
-                        }
-                    }
-                    else
-                    {
-                        action(*sensors_[deviceIndex]);
-                    }
-                    return true;
-                }));
-
         sut_ = std::make_shared<ReadingCpuUtilization>(sensorReadingsManager_);
         sut_->registerReadingConsumer(readingConsumer_,
                                       ReadingType::cpuUtilization,
@@ -77,8 +52,12 @@ class ReadingCpuUtilizationTest : public ::testing::Test
 
     void setupSensor(DeviceIndex idx, bool isValid, CpuUtilizationType value)
     {
-        ON_CALL(*sensors_[idx], getValue).WillByDefault(testing::Return(value));
-        ON_CALL(*sensors_[idx], isGood).WillByDefault(testing::Return(isValid));
+        sensorReadingsManager_->snapshot.add(
+            {SensorReadingType::cpuUtilization, idx,
+             isValid ? SensorReadingStatus::valid
+                     : SensorReadingStatus::invalid,
+             value, Clock::time_point{}});
+        sensorReadingsManager_->snapshot.finalize();
     }
 };
 
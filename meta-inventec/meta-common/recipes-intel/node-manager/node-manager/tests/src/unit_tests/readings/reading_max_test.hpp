@@ -60,18 +60,6 @@ class ReadingMaxTest : public ReadingTestBase, public ::testing::Test
             std::make_shared<testing::NiceMock<ReadingConsumerMock>>());
         sut_->registerReadingConsumer(readingConsumers_.at(kAllDevicesNum),
                                       readingType, kAllDevices);
-
-        ON_CALL(
-            *sensorReadingsManager_,
-            forEachSensorReading(sensorReadingType, kAllDevices, testing::_))
-            .WillByDefault(testing::Invoke(
-                [this](auto type, auto deviceIndex, auto action) {
-                    for (auto sensor : sensorReadings_)
-                    {
-                        action(*(sensor));
-                    }
-                    return true;
-                }));
     }
 };
 
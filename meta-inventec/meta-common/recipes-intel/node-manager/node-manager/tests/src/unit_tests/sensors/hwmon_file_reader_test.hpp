@@ -0,0 +1,98 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+#include "common_types.hpp"
+#include "sensors/hwmon_file_reader.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+class HwmonFileReaderTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::filesystem::create_directories(rootPath_);
+        writeFile("123456");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(rootPath_);
+    }
+
+    void writeFile(const std::string& content)
+    {
+        std::ofstream(filePath_, std::ios_base::out | std::ios_base::trunc)
+            << content << "\n";
+    }
+
+    std::filesystem::path rootPath_ =
+        std::filesystem::temp_directory_path() / "nm-hwmon-reader-ut";
+    std::filesystem::path filePath_ = rootPath_ / "power1_average";
+};
+
+TEST_F(HwmonFileReaderTest, ReadValidValueExpectValidStatusAndOpenDescriptor)
+{
+    HwmonFileReader sut{filePath_};
+
+    EXPECT_EQ(sut.read(),
+              std::make_pair(int64_t{123456}, SensorReadingStatus::valid));
+    EXPECT_TRUE(sut.isOpen());
+}
+
+TEST_F(HwmonFileReaderTest, ConsecutiveReadsExpectUpdatedValues)
+{
+    HwmonFileReader sut{filePath_};
+
+    EXPECT_EQ(sut.read(),
+              std::make_pair(int64_t{123456}, SensorReadingStatus::valid));
+    writeFile("-42");
+    EXPECT_EQ(sut.read(),
+              std::make_pair(int64_t{-42}, SensorReadingStatus::valid));
+}
+
+TEST_F(HwmonFileReaderTest, ReadNotNumericValueExpectInvalidStatus)
+{
+    HwmonFileReader sut{filePath_};
+    writeFile("not-a-number");
+
+    EXPECT_EQ(sut.read().second, SensorReadingStatus::invalid);
+}
+
+TEST_F(HwmonFileReaderTest, ReadEmptyFileExpectInvalidStatusAndClosedDescriptor)
+{
+    HwmonFileReader sut{filePath_};
+    std::ofstream(filePath_, std::ios_base::out | std::ios_base::trunc);
+
+    EXPECT_EQ(sut.read().second, SensorReadingStatus::invalid);
+    EXPECT_FALSE(sut.isOpen());
+}
+
+TEST_F(HwmonFileReaderTest, ReadMissingFileExpectUnavailableStatus)
+{
+    HwmonFileReader sut{rootPath_ / "missing"};
+
+    EXPECT_EQ(sut.read().second, SensorReadingStatus::unavailable);
+    EXPECT_FALSE(sut.isOpen());
+}
@@ -349,6 +349,32 @@ TEST_P(HwmonSensorTest,
     sut_->waitForAllTasks(std::chrono::seconds{5});
 
     hwmonFileManager.removeHwmonDirectories();
+    ON_CALL(*hwmonFileProvider_, getFile(param, DeviceIndex{0}))
+        .WillByDefault(testing::Return(""));
+    sut_->run();
+    sut_->waitForAllTasks(std::chrono::seconds{5});
+}
+
+TEST_P(HwmonSensorTest, HwmonFileUnreadableExpectReadingsInvalidAfterRetries)
+{
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                setStatus(testing::Eq(SensorReadingStatus::valid)));
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                updateValue(testing::VariantWith<double>(0.789)));
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                setStatus(testing::Eq(SensorReadingStatus::invalid)));
+
+    auto path_ = hwmonFileManager.createCpuFile(hwmonGroupToBaseAddress(group),
+                                                group, filetype, 0, 789);
+
+    ON_CALL(*hwmonFileProvider_, getFile(param, DeviceIndex{0}))
+        .WillByDefault(testing::Return(path_));
+
+    sut_->run();
+    sut_->waitForAllTasks(std::chrono::seconds{5});
+
+    std::ofstream(path_, std::ios_base::out | std::ios_base::trunc)
+        << "invalid\n";
     sut_->run();
     sut_->waitForAllTasks(std::chrono::seconds{5});
     for (int i = 0; i < kHwmonReadRetriesCount; i++)
@@ -360,6 +386,39 @@ TEST_P(HwmonSensorTest,
     sut_->waitForAllTasks(std::chrono::seconds{5});
 }
 
+TEST_P(HwmonSensorTest, HwmonFilePathChangedExpectReadingFromNewPath)
+{
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                setStatus(testing::Eq(SensorReadingStatus::valid)))
+        .Times(2);
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                updateValue(testing::VariantWith<double>(0.123)));
+    EXPECT_CALL(*sensorReadings_.at({param, DeviceIndex(0)}),
+                updateValue(testing::VariantWith<double>(0.456)));
+
+    auto oldPath = hwmonFileManager.createCpuFile(
+        hwmonGroupToBaseAddress(group), group, filetype, 0, 123);
+    ON_CALL(*hwmonFileProvider_, getFile(param, DeviceIndex{0}))
+        .WillByDefault(testing::Return(oldPath));
+
+    sut_->run();
+    sut_->waitForAllTasks(std::chrono::seconds{5});
+
+    auto newPath = oldPath.parent_path().parent_path() / "hwmon66" /
+                   oldPath.filename();
+    std::filesystem::create_directories(newPath.parent_path());
+    std::ofstream(newPath) << 456 << "\n";
+    std::filesystem::remove(oldPath);
+    ON_CALL(*hwmonFileProvider_, getFile(param, DeviceIndex{0}))
+        .WillByDefault(testing::Return(newPath));
+
+    sut_->run();
+    sut_->waitForAllTasks(std::chrono::seconds{5});
+
+    sut_->run();
+    sut_->waitForAllTasks(std::chrono::seconds{5});
+}
+
 class HwmonSensorTestWithoutPlatformGroup : public HwmonSensorTest
 {
   public:
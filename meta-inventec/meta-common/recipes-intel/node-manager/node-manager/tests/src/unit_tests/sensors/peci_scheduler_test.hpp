@@ -0,0 +1,307 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "sensors/peci/peci_scheduler.hpp"
+
+#include <future>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace nodemanager
+{
+
+static constexpr uint8_t kCpu0 = PECI_TRANSPORT_CPU0_ADDRESS;
+static constexpr uint8_t kCpu1 = PECI_TRANSPORT_CPU0_ADDRESS + 1;
+
+/**
+ * @brief Transport recording sent requests. Requests with the first byte
+ * equal to kHoldOpcode wait on the bus until release() is called.
+ */
+class FakePeciBus
+{
+  public:
+    static constexpr uint8_t kHoldOpcode = 0xff;
+
+    EPECIStatus transfer(uint8_t address, const std::vector<uint8_t>& request,
+                         std::vector<uint8_t>& response)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        sent.emplace_back(address, request.at(0));
+        requests.push_back(request);
+        changed.notify_all();
+        if (request.at(0) == kHoldOpcode)
+        {
+            changed.wait(lock, [this]() { return released; });
+        }
+        if (completionCodes.empty())
+        {
+            response.at(0) = COMPLETION_CODE_SUCCESS;
+        }
+        else
+        {
+            response.at(0) = completionCodes.front();
+            completionCodes.pop_front();
+        }
+        response.at(1) = request.at(0);
+        return status;
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        changed.notify_all();
+    }
+
+    bool waitForSent(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds{5}, [this, count]() {
+            return sent.size() >= count;
+        });
+    }
+
+    std::vector<std::pair<uint8_t, uint8_t>> getSent()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sent;
+    }
+
+    std::vector<std::vector<uint8_t>> getRequests()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests;
+    }
+
+    EPECIStatus status = PECI_CC_SUCCESS;
+    std::deque<uint8_t> completionCodes;
+
+  private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool released = false;
+    std::vector<std::pair<uint8_t, uint8_t>> sent;
+    std::vector<std::vector<uint8_t>> requests;
+};
+
+class PeciSchedulerTest : public testing::Test
+{
+  public:
+    virtual ~PeciSchedulerTest()
+    {
+        bus_.release();
+    }
+
+    std::future<std::pair<EPECIStatus, std::array<uint8_t, 2>>>
+        executeAsync(uint8_t address, PeciPriority priority, uint8_t opcode)
+    {
+        return std::async(std::launch::async, [this, address, priority,
+                                               opcode]() {
+            std::array<uint8_t, 2> response{};
+            const auto status = sut_->execute(address, priority, &opcode, 1,
+                                              response.data(), response.size());
+            return std::make_pair(status, response);
+        });
+    }
+
+    template <class Predicate>
+    bool waitUntil(Predicate&& predicate)
+    {
+        for (int idx = 0; idx < 500; ++idx)
+        {
+            if (predicate())
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return false;
+    }
+
+    void createScheduler(size_t maxBusTransactions = 1)
+    {
+        sut_ = std::make_unique<PeciScheduler>(
+            [this](uint8_t address, const std::vector<uint8_t>& request,
+                   std::vector<uint8_t>& response) {
+                return bus_.transfer(address, request, response);
+            },
+            PeciSchedulerConfig{2, std::chrono::milliseconds{0},
+                                maxBusTransactions});
+    }
+
+    FakePeciBus bus_;
+    std::unique_ptr<PeciScheduler> sut_;
+};
+
+TEST_F(PeciSchedulerTest, ResponseIsReturnedToCaller)
+{
+    createScheduler();
+
+    const auto [status, response] =
+        executeAsync(kCpu0, PeciPriority::telemetry, 0x01).get();
+
+    EXPECT_EQ(status, PECI_CC_SUCCESS);
+    EXPECT_EQ(response[0], COMPLETION_CODE_SUCCESS);
+    EXPECT_EQ(response[1], 0x01);
+    EXPECT_EQ(sut_->getCounters(kCpu0).transactions, 1u);
+}
+
+TEST_F(PeciSchedulerTest, RequestIsRetriedWhenCpuAsksForRetry)
+{
+    createScheduler();
+    bus_.completionCodes = {COMPLETION_CODE_NEED_RETRY,
+                            COMPLETION_CODE_OUT_OF_RESOURCES};
+
+    const auto [status, response] =
+        executeAsync(kCpu0, PeciPriority::telemetry, 0x01).get();
+
+    EXPECT_EQ(response[0], COMPLETION_CODE_SUCCESS);
+    EXPECT_EQ(bus_.getSent().size(), 3u);
+    const auto counters = sut_->getCounters(kCpu0);
+    EXPECT_EQ(counters.retries, 2u);
+    EXPECT_EQ(counters.failures, 0u);
+}
+
+TEST_F(PeciSchedulerTest, RetriedRequestHasRetryBitSet)
+{
+    createScheduler();
+    bus_.completionCodes = {COMPLETION_CODE_NEED_RETRY};
+    const std::array<uint8_t, 3> request{0xa5, 0x02, 0x10};
+    std::array<uint8_t, 2> response{};
+
+    sut_->execute(kCpu0, PeciPriority::knob, request.data(), request.size(),
+                  response.data(), response.size());
+
+    EXPECT_THAT(bus_.getRequests(),
+                testing::ElementsAre(testing::ElementsAre(0xa5, 0x02, 0x10),
+                                     testing::ElementsAre(0xa5, 0x03, 0x10)));
+    EXPECT_EQ(response[0], COMPLETION_CODE_SUCCESS);
+}
+
+TEST_F(PeciSchedulerTest, RetriesAreLimited)
+{
+    createScheduler();
+    bus_.completionCodes = {COMPLETION_CODE_NEED_RETRY,
+                            COMPLETION_CODE_NEED_RETRY,
+                            COMPLETION_CODE_NEED_RETRY};
+
+    const auto [status, response] =
+        executeAsync(kCpu0, PeciPriority::telemetry, 0x01).get();
+
+    EXPECT_EQ(response[0], COMPLETION_CODE_NEED_RETRY);
+    EXPECT_EQ(bus_.getSent().size(), 3u);
+    EXPECT_EQ(sut_->getCounters(kCpu0).failures, 1u);
+}
+
+TEST_F(PeciSchedulerTest, TimeoutIsNotRetried)
+{
+    createScheduler();
+    bus_.status = PECI_CC_TIMEOUT;
+
+    const auto [status, response] =
+        executeAsync(kCpu0, PeciPriority::telemetry, 0x01).get();
+
+    EXPECT_EQ(status, PECI_CC_TIMEOUT);
+    EXPECT_EQ(bus_.getSent().size(), 1u);
+    EXPECT_EQ(sut_->getCounters(kCpu0).retries, 0u);
+}
+
+TEST_F(PeciSchedulerTest, KnobWriteOvertakesPendingTelemetry)
+{
+    createScheduler();
+    auto held = executeAsync(kCpu0, PeciPriority::telemetry,
+                             FakePeciBus::kHoldOpcode);
+    ASSERT_TRUE(bus_.waitForSent(1));
+    auto telemetry = executeAsync(kCpu0, PeciPriority::telemetry, 0x01);
+    ASSERT_TRUE(waitUntil([this]() { return sut_->getPendingCount() == 1; }));
+    auto knob = executeAsync(kCpu1, PeciPriority::knob, 0x02);
+    ASSERT_TRUE(waitUntil([this]() { return sut_->getPendingCount() == 2; }));
+
+    bus_.release();
+    held.get();
+    telemetry.get();
+    knob.get();
+
+    EXPECT_THAT(bus_.getSent(),
+                testing::ElementsAre(
+                    std::make_pair(kCpu0, FakePeciBus::kHoldOpcode),
+                    std::make_pair(kCpu1, uint8_t{0x02}),
+                    std::make_pair(kCpu0, uint8_t{0x01})));
+}
+
+TEST_F(PeciSchedulerTest, IdenticalPendingReadsAreCoalesced)
+{
+    createScheduler();
+    auto held = executeAsync(kCpu0, PeciPriority::telemetry,
+                             FakePeciBus::kHoldOpcode);
+    ASSERT_TRUE(bus_.waitForSent(1));
+    auto first = executeAsync(kCpu0, PeciPriority::telemetry, 0x01);
+    ASSERT_TRUE(waitUntil([this]() { return sut_->getPendingCount() == 1; }));
+    auto second = executeAsync(kCpu0, PeciPriority::telemetry, 0x01);
+    ASSERT_TRUE(waitUntil(
+        [this]() { return sut_->getCounters(kCpu0).coalesced == 1; }));
+
+    bus_.release();
+    held.get();
+    EXPECT_EQ(first.get().second[1], 0x01);
+    EXPECT_EQ(second.get().second[1], 0x01);
+
+    EXPECT_EQ(bus_.getSent().size(), 2u);
+    EXPECT_EQ(sut_->getCounters(kCpu0).transactions, 2u);
+}
+
+TEST_F(PeciSchedulerTest, KnobWritesAreNotCoalesced)
+{
+    createScheduler();
+    auto held = executeAsync(kCpu0, PeciPriority::telemetry,
+                             FakePeciBus::kHoldOpcode);
+    ASSERT_TRUE(bus_.waitForSent(1));
+    auto first = executeAsync(kCpu0, PeciPriority::knob, 0x02);
+    auto second = executeAsync(kCpu0, PeciPriority::knob, 0x02);
+    ASSERT_TRUE(waitUntil([this]() { return sut_->getPendingCount() == 2; }));
+
+    bus_.release();
+    held.get();
+    first.get();
+    second.get();
+
+    EXPECT_EQ(bus_.getSent().size(), 3u);
+    EXPECT_EQ(sut_->getCounters(kCpu0).coalesced, 0u);
+}
+
+TEST_F(PeciSchedulerTest, TransactionsOfOneCpuAreSerialized)
+{
+    createScheduler(2);
+    auto held = executeAsync(kCpu0, PeciPriority::telemetry,
+                             FakePeciBus::kHoldOpcode);
+    ASSERT_TRUE(bus_.waitForSent(1));
+    auto sameCpu = executeAsync(kCpu0, PeciPriority::knob, 0x01);
+    auto otherCpu = executeAsync(kCpu1, PeciPriority::telemetry, 0x02);
+
+    ASSERT_TRUE(bus_.waitForSent(2));
+    otherCpu.get();
+    EXPECT_EQ(sut_->getPendingCount(), 1u);
+    EXPECT_EQ(bus_.getSent().size(), 2u);
+
+    bus_.release();
+    held.get();
+    sameCpu.get();
+    EXPECT_EQ(bus_.getSent().back(), std::make_pair(kCpu0, uint8_t{0x01}));
+}
+
+} // namespace nodemanager
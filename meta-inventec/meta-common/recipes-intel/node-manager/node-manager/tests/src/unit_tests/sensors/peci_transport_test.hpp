@@ -0,0 +1,172 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "sensors/peci/peci_commands.hpp"
+#include "sensors/peci/peci_transport.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+class PeciTransportTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(rootPath_);
+        std::filesystem::create_directories(rootPath_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(rootPath_);
+    }
+
+    /**
+     * @brief Records `count` transactions of a counter increasing with every
+     * request.
+     */
+    void record(size_t count)
+    {
+        uint8_t counter = 0;
+        PeciTraceRecorder recorder(
+            [&counter](uint8_t, const std::vector<uint8_t>&,
+                       std::vector<uint8_t>& response) {
+                response[0] = COMPLETION_CODE_SUCCESS;
+                response[1] = ++counter;
+                return PECI_CC_SUCCESS;
+            },
+            filePath_);
+        for (size_t idx = 0; idx < count; ++idx)
+        {
+            std::vector<uint8_t> response(2);
+            recorder(kAddress, kRequest, response);
+        }
+    }
+
+    static uint8_t send(PeciTransport transport, uint8_t address,
+                        const std::vector<uint8_t>& request,
+                        EPECIStatus expectedStatus = PECI_CC_SUCCESS)
+    {
+        std::vector<uint8_t> response(2);
+        EXPECT_EQ(transport(address, request, response), expectedStatus);
+        return response[1];
+    }
+
+    static constexpr uint8_t kAddress = PECI_TRANSPORT_CPU0_ADDRESS;
+    const std::vector<uint8_t> kRequest = {0xA1, 0x00, 0x1F, 0xFE, 0x00};
+    std::filesystem::path rootPath_ =
+        std::filesystem::temp_directory_path() / "nm-peci-transport-ut";
+    std::filesystem::path filePath_ = rootPath_ / "peci.trace";
+};
+
+TEST_F(PeciTransportTest, RecordedResponsesAreReplayedInOrderAndRepeated)
+{
+    record(3);
+    const auto records = PeciTraceFile::load(filePath_);
+    ASSERT_TRUE(records);
+    ASSERT_EQ(records->size(), 3u);
+
+    PeciTraceReplayer replayer(*records, 0);
+    PeciTransport transport = std::ref(replayer);
+    EXPECT_EQ(send(transport, kAddress, kRequest), 1);
+    EXPECT_EQ(send(transport, kAddress, kRequest), 2);
+    EXPECT_EQ(send(transport, kAddress, kRequest), 3);
+    EXPECT_EQ(send(transport, kAddress, kRequest), 1);
+}
+
+TEST_F(PeciTransportTest, RequestMissingInTraceTimesOut)
+{
+    record(1);
+    PeciTraceReplayer replayer(*PeciTraceFile::load(filePath_), 0);
+    PeciTransport transport = std::ref(replayer);
+
+    send(transport, kAddress + 1, kRequest, PECI_CC_TIMEOUT);
+    send(transport, kAddress, {0xA1, 0x00, 0x00, 0x00, 0x00},
+         PECI_CC_TIMEOUT);
+}
+
+TEST_F(PeciTransportTest, TruncatedRecordIsDropped)
+{
+    record(2);
+    std::filesystem::resize_file(filePath_,
+                                 std::filesystem::file_size(filePath_) - 1);
+
+    const auto records = PeciTraceFile::load(filePath_);
+    ASSERT_TRUE(records);
+    EXPECT_EQ(records->size(), 1u);
+}
+
+TEST_F(PeciTransportTest, FileWithUnknownHeaderIsRejected)
+{
+    std::ofstream(filePath_) << "not a trace";
+
+    EXPECT_FALSE(PeciTraceFile::load(filePath_));
+}
+
+TEST_F(PeciTransportTest, ReplayIsDelayedByScaledLatency)
+{
+    PeciTraceRecord record{kAddress, PECI_CC_SUCCESS, kRequest,
+                           std::vector<uint8_t>(2),
+                           std::chrono::microseconds{20000}};
+    PeciTraceReplayer replayer({record}, 0.5);
+    PeciTransport transport = std::ref(replayer);
+
+    const auto started = std::chrono::steady_clock::now();
+    send(transport, kAddress, kRequest);
+
+    EXPECT_GE(std::chrono::steady_clock::now() - started,
+              std::chrono::milliseconds{10});
+}
+
+TEST_F(PeciTransportTest, SyntheticCpusAreDetectedByPeciCommands)
+{
+    PeciScheduler scheduler(*makePeciTransport(
+        {PeciTransportMode::synthetic, filePath_, 1.0, 2}));
+    PeciCommands peci(scheduler);
+
+    const auto cpuId = peci.getCpuId(0);
+    ASSERT_TRUE(cpuId);
+    EXPECT_EQ(request::getCpuModel(*cpuId), request::CpuModelType::spr);
+    EXPECT_EQ(peci.detectCores(1, *cpuId), 56);
+    EXPECT_EQ(peci.getMaxNonTurboRatio(1, *cpuId), 20);
+    EXPECT_FALSE(peci.getCpuId(2));
+}
+
+TEST_F(PeciTransportTest, SyntheticC0CounterIncreases)
+{
+    PeciScheduler scheduler(*makePeciTransport(
+        {PeciTransportMode::synthetic, filePath_, 1.0, 1}));
+    PeciCommands peci(scheduler);
+
+    const auto first = peci.getC0CounterSensor(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    const auto second = peci.getC0CounterSensor(0);
+
+    ASSERT_TRUE(first && second);
+    EXPECT_GT(*second, *first);
+}
+
+TEST_F(PeciTransportTest, ReplayWithoutTraceFileFails)
+{
+    EXPECT_FALSE(makePeciTransport(
+        {PeciTransportMode::replay, rootPath_ / "missing.trace", 1.0, 1}));
+}
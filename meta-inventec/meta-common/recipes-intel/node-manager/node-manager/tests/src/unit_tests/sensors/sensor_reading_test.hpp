@@ -42,8 +42,7 @@ class SensorReadingTest : public ::testing::Test
     }
 
     testing::NiceMock<testing::MockFunction<void(
-        SensorEventType eventType,
-        std::shared_ptr<SensorReadingIf> sensorReading)>>
+        SensorEventType eventType, const SensorReadingIf& sensorReading)>>
         eventCallback_;
     std::shared_ptr<SensorReadingIf> sut_;
     DeviceIndex deviceIndex_ = 1;
@@ -192,13 +191,11 @@ TEST_P(SensorReadingTestCheckEventsBasedOnStatus,
     }
     for (auto event : expectedEvents)
     {
-        EXPECT_CALL(eventCallback_,
-                    Call(event, testing::Pointee(testing::Ref(*sut_))));
+        EXPECT_CALL(eventCallback_, Call(event, testing::Ref(*sut_)));
     }
     if (0 == expectedEvents.size())
     {
-        EXPECT_CALL(eventCallback_,
-                    Call(testing::_, testing::Pointee(testing::Ref(*sut_))))
+        EXPECT_CALL(eventCallback_, Call(testing::_, testing::Ref(*sut_)))
             .Times(0);
     }
     for (auto [status, callsNumber] : statusRequests)
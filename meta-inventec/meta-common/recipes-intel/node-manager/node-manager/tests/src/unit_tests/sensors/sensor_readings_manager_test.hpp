@@ -401,6 +401,42 @@ TEST_F(SensorReadingsManagerTestFindAllReadings,
               false);
 }
 
+TEST_F(SensorReadingsManagerTestFindAllReadings,
+       ExpectOnlyExistingReadingsPassedWhenIndexesAreSparse)
+{
+    const DeviceIndex aboveExpected = kMaxCpuNumber + 3;
+    sut_->createSensorReading(SensorReadingType::cpuPackagePower, 1);
+    auto sensorReading = sut_->createSensorReading(
+        SensorReadingType::cpuPackagePower, aboveExpected);
+
+    EXPECT_CALL(callback_, Call(testing::_)).Times(2);
+    EXPECT_TRUE(sut_->forEachSensorReading(SensorReadingType::cpuPackagePower,
+                                           kAllDevices,
+                                           callback_.AsStdFunction()));
+    EXPECT_EQ(
+        sut_->getSensorReading(SensorReadingType::cpuPackagePower,
+                               aboveExpected),
+        sensorReading);
+    EXPECT_EQ(sut_->getSensorReading(SensorReadingType::cpuPackagePower, 2),
+              nullptr);
+}
+
+TEST_F(SensorReadingsManagerTestFindAllReadings,
+       ExpectNoReadingsFoundAfterDeleteOnlyForDeletedType)
+{
+    sut_->createSensorReading(SensorReadingType::acPlatformPower, 0);
+    sut_->createSensorReading(SensorReadingType::acPlatformPower, 1);
+    sut_->createSensorReading(SensorReadingType::dcPlatformPowerCpu, 0);
+
+    sut_->deleteSensorReading(SensorReadingType::acPlatformPower);
+
+    EXPECT_FALSE(sut_->forEachSensorReading(SensorReadingType::acPlatformPower,
+                                            kAllDevices,
+                                            callback_.AsStdFunction()));
+    EXPECT_NE(sut_->getSensorReading(SensorReadingType::dcPlatformPowerCpu, 0),
+              nullptr);
+}
+
 class SensorReadingsManagerTestCheckIfAvailableAndValid
     : public SensorReadingsManagerFixture,
       public ::testing::Test
@@ -509,12 +545,14 @@ TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
                 reportEvent(testing::_, testing::_, testing::_))
         .Times(0);
     sensorReading_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
 }
 
 TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
        EventDispatchedWhenSensorReadingAvailable)
 {
     acPlatformPowerState_0_->setStatus(SensorReadingStatus::invalid);
+    sut_->dispatchEvents();
     EXPECT_CALL(
         *readingConsumerMock_0_,
         reportEvent(
@@ -542,12 +580,14 @@ TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
                 testing::Field(&ReadingContext::deviceIndex, kAllDevices))))
         .Times(1);
     acPlatformPowerState_0_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
 }
 
 TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
        EventDispatchedWhenSensorReadingAvailableDevice1)
 {
     acPlatformPowerState_1_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
     EXPECT_CALL(*readingConsumerMock_0_,
                 reportEvent(testing::_, testing::_, testing::_))
         .Times(0);
@@ -576,4 +616,139 @@ TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
                 testing::Field(&ReadingContext::deviceIndex, kAllDevices))))
         .Times(1);
     acPlatformPowerState_1_->setStatus(SensorReadingStatus::invalid);
-}
\ No newline at end of file
+    sut_->dispatchEvents();
+}
+
+TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
+       EventsAreNotDeliveredBeforeDispatch)
+{
+    EXPECT_CALL(*readingConsumerMock_All_,
+                reportEvent(testing::_, testing::_, testing::_))
+        .Times(0);
+    acPlatformPowerState_0_->setStatus(SensorReadingStatus::valid);
+    testing::Mock::VerifyAndClearExpectations(readingConsumerMock_All_.get());
+
+    EXPECT_CALL(*readingConsumerMock_All_,
+                reportEvent(SensorEventType::sensorAppear, testing::_,
+                            testing::_))
+        .Times(1);
+    EXPECT_CALL(*readingConsumerMock_All_,
+                reportEvent(SensorEventType::readingAvailable, testing::_,
+                            testing::_))
+        .Times(1);
+    sut_->dispatchEvents();
+    sut_->dispatchEvents();
+}
+
+TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
+       NoEventAfterConsumerUnregistered)
+{
+    sut_->unregisterReadingConsumer(readingConsumerMock_0_);
+    EXPECT_CALL(*readingConsumerMock_0_,
+                reportEvent(testing::_, testing::_, testing::_))
+        .Times(0);
+    EXPECT_CALL(*readingConsumerMock_All_,
+                reportEvent(testing::_, testing::_, testing::_))
+        .Times(2);
+    acPlatformPowerState_0_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
+}
+
+TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
+       RegisteringConsumerAgainReplacesItsSubscription)
+{
+    sut_->registerReadingConsumer(readingConsumerMock_0_,
+                                  ReadingType::acPlatformPower, 1);
+    EXPECT_CALL(*readingConsumerMock_0_,
+                reportEvent(testing::_,
+                            testing::Field(&SensorContext::deviceIndex, 1),
+                            testing::Field(&ReadingContext::deviceIndex, 1)))
+        .Times(2);
+    acPlatformPowerState_0_->setStatus(SensorReadingStatus::valid);
+    acPlatformPowerState_1_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
+}
+
+TEST_F(SensorReadingsManagerTestCheckReadingEventDispatching,
+       ConsumerUnregisteringItselfDoesNotSkipNextConsumer)
+{
+    auto readingConsumerMock_All_2 =
+        std::make_shared<testing::NiceMock<ReadingConsumerMock>>();
+    sut_->registerReadingConsumer(readingConsumerMock_All_2,
+                                  ReadingType::acPlatformPower, kAllDevices);
+    EXPECT_CALL(*readingConsumerMock_All_,
+                reportEvent(testing::_, testing::_, testing::_))
+        .WillOnce(testing::InvokeWithoutArgs([this]() {
+            sut_->unregisterReadingConsumer(readingConsumerMock_All_);
+        }));
+    EXPECT_CALL(*readingConsumerMock_All_2,
+                reportEvent(testing::_, testing::_, testing::_))
+        .Times(2);
+    acPlatformPowerState_0_->setStatus(SensorReadingStatus::valid);
+    sut_->dispatchEvents();
+
+    EXPECT_CALL(*readingConsumerMock_All_2,
+                reportEvent(testing::_, testing::_, testing::_))
+        .Times(1);
+    acPlatformPowerState_0_->setStatus(SensorReadingStatus::invalid);
+    sut_->dispatchEvents();
+}
+
+class SensorReadingsManagerTestSnapshot : public SensorReadingsManagerFixture,
+                                          public ::testing::Test
+{
+};
+
+TEST_F(SensorReadingsManagerTestSnapshot, SnapshotIsEmptyBeforeFirstPublish)
+{
+    sut_->createSensorReading(SensorReadingType::acPlatformPower, 0);
+
+    EXPECT_EQ(sut_->getSnapshot().size(), 0u);
+}
+
+TEST_F(SensorReadingsManagerTestSnapshot,
+       PublishedSnapshotContainsValueStatusAndTimestampOfEachReading)
+{
+    auto sensorReading =
+        sut_->createSensorReading(SensorReadingType::acPlatformPower, 1);
+    sut_->createSensorReading(SensorReadingType::cpuPackagePower, 0);
+    sensorReading->setStatus(SensorReadingStatus::valid);
+    sensorReading->updateValue(123.0);
+
+    sut_->publishSnapshot();
+
+    const auto& snapshot = sut_->getSnapshot();
+    EXPECT_EQ(snapshot.size(), 2u);
+    const auto entry = snapshot.find(SensorReadingType::acPlatformPower, 1);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->isGood());
+    EXPECT_EQ(entry->value, ValueType{123.0});
+    EXPECT_EQ(entry->timestamp, sensorReading->getUpdateTimestamp());
+    EXPECT_EQ(snapshot.find(SensorReadingType::acPlatformPower, 0), nullptr);
+}
+
+TEST_F(SensorReadingsManagerTestSnapshot,
+       SnapshotDoesNotChangeWhenReadingIsUpdatedUntilNextPublish)
+{
+    auto sensorReading =
+        sut_->createSensorReading(SensorReadingType::acPlatformPower, 0);
+    sensorReading->setStatus(SensorReadingStatus::valid);
+    sensorReading->updateValue(100.0);
+    sut_->publishSnapshot();
+    const auto& first = sut_->getSnapshot();
+
+    sensorReading->updateValue(200.0);
+    sensorReading->setStatus(SensorReadingStatus::invalid);
+
+    const auto entry = first.find(SensorReadingType::acPlatformPower, 0);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->isGood());
+    EXPECT_EQ(entry->value, ValueType{100.0});
+
+    sut_->publishSnapshot();
+    const auto updated =
+        sut_->getSnapshot().find(SensorReadingType::acPlatformPower, 0);
+    ASSERT_NE(updated, nullptr);
+    EXPECT_FALSE(updated->isGood());
+    EXPECT_EQ(updated->value, ValueType{200.0});
+}
@@ -0,0 +1,95 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "sensors/sensor_snapshot.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+class SensorSnapshotTest : public ::testing::Test
+{
+  public:
+    void add(SensorReadingType type, DeviceIndex deviceIndex, double value)
+    {
+        sut_.add({type, deviceIndex, SensorReadingStatus::valid, value,
+                  Clock::time_point{}});
+    }
+
+    std::vector<double> collect(SensorReadingType type,
+                                DeviceIndex deviceIndex) const
+    {
+        std::vector<double> values;
+        sut_.forEach(type, deviceIndex,
+                     [&values](const SensorSnapshotEntry& entry) {
+                         values.push_back(std::get<double>(entry.value));
+                     });
+        return values;
+    }
+
+  protected:
+    SensorSnapshot sut_;
+};
+
+TEST_F(SensorSnapshotTest, ForEachVisitsEntriesOfTheTypeOrderedByDeviceIndex)
+{
+    add(SensorReadingType::cpuPackagePower, 2, 12.0);
+    add(SensorReadingType::acPlatformPower, 0, 1.0);
+    add(SensorReadingType::cpuPackagePower, 0, 10.0);
+    add(SensorReadingType::cpuPackagePower, 1, 11.0);
+    sut_.finalize();
+
+    EXPECT_THAT(collect(SensorReadingType::cpuPackagePower, kAllDevices),
+                testing::ElementsAre(10.0, 11.0, 12.0));
+    EXPECT_THAT(collect(SensorReadingType::acPlatformPower, kAllDevices),
+                testing::ElementsAre(1.0));
+}
+
+TEST_F(SensorSnapshotTest, ForEachWithDeviceIndexVisitsOnlyThatDevice)
+{
+    add(SensorReadingType::cpuPackagePower, 0, 10.0);
+    add(SensorReadingType::cpuPackagePower, 3, 13.0);
+    sut_.finalize();
+
+    EXPECT_THAT(collect(SensorReadingType::cpuPackagePower, 3),
+                testing::ElementsAre(13.0));
+    EXPECT_FALSE(sut_.forEach(SensorReadingType::cpuPackagePower, 1,
+                              [](const auto&) {}));
+}
+
+TEST_F(SensorSnapshotTest, ForEachReturnsFalseForTypeWithoutEntries)
+{
+    add(SensorReadingType::cpuPackagePower, 0, 10.0);
+    sut_.finalize();
+
+    EXPECT_FALSE(sut_.forEach(SensorReadingType::dramPower, kAllDevices,
+                              [](const auto&) {}));
+    EXPECT_EQ(sut_.find(SensorReadingType::dramPower, 0), nullptr);
+}
+
+TEST_F(SensorSnapshotTest, ClearRemovesAllEntries)
+{
+    add(SensorReadingType::cpuPackagePower, 0, 10.0);
+    sut_.finalize();
+
+    sut_.clear();
+    sut_.finalize();
+
+    EXPECT_EQ(sut_.size(), 0u);
+    EXPECT_EQ(sut_.find(SensorReadingType::cpuPackagePower, 0), nullptr);
+}
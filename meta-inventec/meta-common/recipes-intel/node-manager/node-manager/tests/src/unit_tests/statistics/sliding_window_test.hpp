@@ -0,0 +1,130 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "statistics/sliding_window.hpp"
+#include "utils/naive_sliding_window.hpp"
+
+#include <random>
+
+#include <gmock/gmock.h>
+
+using namespace nodemanager;
+
+class SlidingWindowTest : public ::testing::TestWithParam<size_t>
+{
+  public:
+    void pushToBoth(const Sample& sample)
+    {
+        sut_.push(sample);
+        reference_.push(sample);
+    }
+
+    void expectSameAsReference()
+    {
+        ASSERT_THAT(sut_.size(), testing::Eq(reference_.size()));
+        ASSERT_THAT(sut_.getSum(),
+                    testing::DoubleNear(reference_.getSum(), 1e-6));
+        ASSERT_THAT(sut_.getMin(), testing::DoubleEq(reference_.getMin()));
+        ASSERT_THAT(sut_.getMax(), testing::DoubleEq(reference_.getMax()));
+    }
+
+  protected:
+    SlidingWindow sut_{GetParam()};
+    NaiveSlidingWindow reference_{GetParam()};
+    std::mt19937 generator_{GetParam()};
+};
+
+INSTANTIATE_TEST_SUITE_P(Capacities, SlidingWindowTest,
+                         ::testing::Values(1, 2, 3, 10, 30, 64));
+
+TEST_P(SlidingWindowTest, EmptyWindowReturnsNeutralValues)
+{
+    EXPECT_TRUE(sut_.empty());
+    EXPECT_THAT(sut_.getSum(), testing::DoubleEq(0.0));
+    EXPECT_THAT(sut_.getMin(),
+                testing::DoubleEq(std::numeric_limits<double>::max()));
+    EXPECT_THAT(sut_.getMax(),
+                testing::DoubleEq(std::numeric_limits<double>::lowest()));
+}
+
+TEST_P(SlidingWindowTest, RandomSamplesGiveSameResultsAsReference)
+{
+    std::uniform_real_distribution<double> value(-1000.0, 1000.0);
+    for (size_t idx = 0; idx < 20 * GetParam() + 100; ++idx)
+    {
+        const double a = value(generator_);
+        const double b = value(generator_);
+        pushToBoth(Sample{value(generator_), std::max(a, b), std::min(a, b)});
+        expectSameAsReference();
+    }
+}
+
+TEST_P(SlidingWindowTest, MonotonicSamplesGiveSameResultsAsReference)
+{
+    for (size_t idx = 0; idx < 5 * GetParam(); ++idx)
+    {
+        const auto increasing = static_cast<double>(idx);
+        pushToBoth(Sample{increasing, increasing, increasing});
+        expectSameAsReference();
+    }
+    for (size_t idx = 0; idx < 5 * GetParam(); ++idx)
+    {
+        const auto decreasing = -static_cast<double>(idx);
+        pushToBoth(Sample{decreasing, decreasing, decreasing});
+        expectSameAsReference();
+    }
+}
+
+TEST_P(SlidingWindowTest, RepeatedSamplesGiveSameResultsAsReference)
+{
+    std::uniform_int_distribution<int> value(0, 3);
+    for (size_t idx = 0; idx < 20 * GetParam(); ++idx)
+    {
+        const auto repeated = static_cast<double>(value(generator_));
+        pushToBoth(Sample{repeated, repeated, repeated});
+        expectSameAsReference();
+    }
+}
+
+TEST_P(SlidingWindowTest, SumDoesNotDriftOverLongSequences)
+{
+    std::uniform_real_distribution<double> small(0.0, 1.0);
+    for (size_t idx = 0; idx < 100000; ++idx)
+    {
+        const double acc = (idx % 7 == 0) ? 1e9 : small(generator_);
+        pushToBoth(Sample{acc, acc, acc});
+    }
+    EXPECT_THAT(sut_.getSum(), testing::DoubleNear(reference_.getSum(), 1e-3));
+}
+
+TEST_P(SlidingWindowTest, ClearRemovesAllSamples)
+{
+    for (size_t idx = 0; idx < 2 * GetParam(); ++idx)
+    {
+        sut_.push(Sample{100.0, 100.0, 100.0});
+    }
+
+    sut_.clear();
+    sut_.push(Sample{1.0, 2.0, 0.5});
+
+    EXPECT_THAT(sut_.size(), testing::Eq(1u));
+    EXPECT_THAT(sut_.getSum(), testing::DoubleEq(1.0));
+    EXPECT_THAT(sut_.getMin(), testing::DoubleEq(0.5));
+    EXPECT_THAT(sut_.getMax(), testing::DoubleEq(2.0));
+}
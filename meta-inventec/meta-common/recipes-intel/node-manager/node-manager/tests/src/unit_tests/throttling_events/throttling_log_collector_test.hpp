@@ -0,0 +1,213 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "throttling_events/throttling_log_collector.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+static ThrottlingEvent makeThrottlingEvent(int64_t start, const std::string& id,
+                                           bool isNmEvent = true)
+{
+    return ThrottlingEvent(
+        std::chrono::seconds{start}, id,
+        isNmEvent ? nlohmann::json{{"Id", "Policy" + id}} : nlohmann::json(),
+        "Reason");
+}
+
+TEST(ThrottlingEventBufferTest, StopFinishesMostRecentEventWithTheId)
+{
+    ThrottlingEventBuffer sut{4};
+    sut.push(makeThrottlingEvent(1, "A"));
+    sut.push(makeThrottlingEvent(2, "A"));
+
+    EXPECT_TRUE(sut.stop("A", std::chrono::seconds{3}));
+    EXPECT_FALSE(sut.at(0).isFinished());
+    EXPECT_TRUE(sut.at(1).isFinished());
+    EXPECT_FALSE(sut.stop("B", std::chrono::seconds{3}));
+}
+
+TEST(ThrottlingEventBufferTest, FullBufferDropsOldestFinishedEvent)
+{
+    ThrottlingEventBuffer sut{3};
+    sut.push(makeThrottlingEvent(1, "A"));
+    sut.push(makeThrottlingEvent(2, "B"));
+    sut.push(makeThrottlingEvent(3, "C"));
+    sut.stop("B", std::chrono::seconds{4});
+
+    ASSERT_TRUE(sut.push(makeThrottlingEvent(5, "D")));
+    ASSERT_EQ(sut.size(), 3u);
+    EXPECT_EQ(sut.at(0).getId(), "A");
+    EXPECT_EQ(sut.at(1).getId(), "C");
+    EXPECT_EQ(sut.at(2).getId(), "D");
+
+    EXPECT_TRUE(sut.stop("A", std::chrono::seconds{6}));
+    EXPECT_TRUE(sut.at(0).isFinished());
+    EXPECT_TRUE(sut.stop("C", std::chrono::seconds{6}));
+    EXPECT_TRUE(sut.at(1).isFinished());
+}
+
+TEST(ThrottlingEventBufferTest, PushToBufferWithoutFinishedEventsFails)
+{
+    ThrottlingEventBuffer sut{2};
+    sut.push(makeThrottlingEvent(1, "A"));
+    sut.push(makeThrottlingEvent(2, "B"));
+
+    EXPECT_FALSE(sut.push(makeThrottlingEvent(3, "C")));
+    EXPECT_EQ(sut.size(), 2u);
+}
+
+TEST(ThrottlingEventBufferTest, StopNmEventsKeepsOtherEventsRunning)
+{
+    ThrottlingEventBuffer sut{4};
+    sut.push(makeThrottlingEvent(1, "A"));
+    sut.push(makeThrottlingEvent(2, "B", false));
+
+    sut.stopNmEvents(std::chrono::seconds{3});
+
+    EXPECT_TRUE(sut.at(0).isFinished());
+    EXPECT_FALSE(sut.at(1).isFinished());
+    EXPECT_FALSE(sut.stop("A", std::chrono::seconds{4}));
+    EXPECT_TRUE(sut.stop("B", std::chrono::seconds{4}));
+}
+
+class ThrottlingLogCollectorTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(rootPath_);
+        std::filesystem::create_directories(rootPath_);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(rootPath_);
+    }
+
+    static std::string startLine(int64_t start, const std::string& id)
+    {
+        return nlohmann::json{{"Tag", "+"},
+                              {"From", "NM"},
+                              {"StartTimestamp", std::to_string(start)},
+                              {"Id", id},
+                              {"Policy", {{"Id", "Policy" + id}}},
+                              {"Reason", "Reason"}}
+            .dump();
+    }
+
+    static std::string stopLine(int64_t stop, const std::string& id)
+    {
+        return nlohmann::json{{"Tag", "-"},
+                              {"From", "NM"},
+                              {"StartTimestamp", std::to_string(stop)},
+                              {"Id", id}}
+            .dump();
+    }
+
+    void append(const std::filesystem::path& path, const std::string& line)
+    {
+        std::ofstream(path, std::ios_base::out | std::ios_base::app)
+            << line << "\n";
+    }
+
+    std::unique_ptr<ThrottlingLogCollector> makeSut()
+    {
+        return std::make_unique<ThrottlingLogCollector>(
+            DbusEnvironment::getIoc(), logPath_, mirrorPath_);
+    }
+
+    std::filesystem::path rootPath_ =
+        std::filesystem::temp_directory_path() / "nm-throttling-log-ut";
+    std::filesystem::path logPath_ = rootPath_ / "nm_events";
+    std::filesystem::path mirrorPath_ = rootPath_ / "mirror";
+};
+
+TEST_F(ThrottlingLogCollectorTest, EventsAreReadFromRotatedAndCurrentLogs)
+{
+    append(logPath_.string() + ".2", startLine(1, "A"));
+    append(logPath_.string() + ".1", stopLine(2, "A"));
+    append(logPath_, startLine(3, "B"));
+
+    auto sut = makeSut();
+
+    ASSERT_EQ(sut->getEventsCount(), 2u);
+    EXPECT_EQ(sut->getEvent(0).toJson()["Stop"], 2);
+    EXPECT_FALSE(sut->getEvent(1).isFinished());
+    EXPECT_TRUE(std::filesystem::exists(mirrorPath_));
+}
+
+TEST_F(ThrottlingLogCollectorTest, AppendedLinesAreProcessed)
+{
+    append(logPath_, startLine(1, "A"));
+    auto sut = makeSut();
+
+    append(logPath_, stopLine(2, "A"));
+    append(logPath_, startLine(3, "B"));
+    DbusEnvironment::synchronizeIoc();
+
+    ASSERT_EQ(sut->getEventsCount(), 2u);
+    EXPECT_TRUE(sut->getEvent(0).isFinished());
+    EXPECT_EQ(sut->getEvent(1).getId(), "B");
+}
+
+TEST_F(ThrottlingLogCollectorTest, AfterRestartOnlyNewLinesAreParsed)
+{
+    append(logPath_.string() + ".1", startLine(1, "A"));
+    append(logPath_, startLine(2, "B"));
+    makeSut();
+
+    std::filesystem::remove(logPath_.string() + ".1");
+    append(logPath_, stopLine(3, "B"));
+    auto sut = makeSut();
+
+    ASSERT_EQ(sut->getEventsCount(), 2u);
+    EXPECT_EQ(sut->getEvent(0).getId(), "A");
+    EXPECT_FALSE(sut->getEvent(0).isFinished());
+    EXPECT_EQ(sut->getEvent(1).toJson()["Stop"], 3);
+}
+
+TEST_F(ThrottlingLogCollectorTest, AllLogsAreParsedWhenMirrorIsOutdated)
+{
+    append(logPath_, startLine(1, "A"));
+    makeSut();
+
+    std::filesystem::rename(logPath_, logPath_.string() + ".1");
+    append(logPath_, startLine(2, "B"));
+    auto sut = makeSut();
+
+    ASSERT_EQ(sut->getEventsCount(), 2u);
+    EXPECT_EQ(sut->getEvent(0).getId(), "A");
+    EXPECT_EQ(sut->getEvent(1).getId(), "B");
+}
+
+TEST_F(ThrottlingLogCollectorTest, AllLogsAreParsedWhenMirrorIsCorrupted)
+{
+    append(logPath_, startLine(1, "A"));
+    append(mirrorPath_, "not a cbor");
+
+    auto sut = makeSut();
+
+    ASSERT_EQ(sut->getEventsCount(), 1u);
+    EXPECT_EQ(sut->getEvent(0).getId(), "A");
+}
@@ -19,6 +19,7 @@
 #include "utility/async_executor.hpp"
 #include "utils/dbus_environment.hpp"
 
+#include <atomic>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <gtest/internal/gtest-death-test-internal.h>
@@ -34,7 +35,9 @@ class AsyncExecutorTest : public testing::Test
     virtual void SetUp() override
     {
         sut_ = std::make_shared<AsyncExecutor<int, std::string>>(
-            DbusEnvironment::getBus(), std::chrono::milliseconds{5});
+            DbusEnvironment::getBus(),
+            AsyncTaskTimeout<std::string>{std::chrono::milliseconds{100},
+                                          "Timeout"});
     }
 
     virtual void TearDown()
@@ -44,7 +47,7 @@ class AsyncExecutorTest : public testing::Test
     std::shared_ptr<AsyncExecutor<int, std::string>> sut_;
 };
 
-TEST_F(AsyncExecutorTest, TaskTakesLessThanCheckInterval)
+TEST_F(AsyncExecutorTest, TaskResultIsPassedToCallback)
 {
     testing::MockFunction<std::string(int)> task;
     testing::MockFunction<void(std::string)> completionHandler;
@@ -115,7 +118,7 @@ TEST_F(AsyncExecutorTest, TwoTasksWhereOneIsDelayed)
     DbusEnvironment::waitForAllFutures();
 }
 
-TEST_F(AsyncExecutorTest, SingleTaskTakesLongerThanCheckInterval)
+TEST_F(AsyncExecutorTest, SlowTaskResultIsPassedToCallback)
 {
     testing::MockFunction<std::string(int)> task;
     testing::MockFunction<void(std::string)> completionHandler;
@@ -136,17 +139,52 @@ TEST_F(AsyncExecutorTest, SingleTaskTakesLongerThanCheckInterval)
     DbusEnvironment::waitForFuture("complete");
 }
 
-TEST_F(AsyncExecutorTest, AnotheScheduleCalledWhenOneIsPendingDoesNothing)
+TEST_F(AsyncExecutorTest,
+       AnotherScheduleCalledWhenOneIsPendingIsExecutedAfterIt)
 {
     testing::MockFunction<std::string(int)> task;
     testing::MockFunction<void(std::string)> completionHandler;
 
-    EXPECT_CALL(task, Call(42)).WillOnce(testing::Return("Ok"));
-    EXPECT_CALL(completionHandler, Call("Ok"))
+    testing::Sequence tasks, callbacks;
+    EXPECT_CALL(task, Call(42))
+        .InSequence(tasks)
+        .WillOnce(testing::Return("Ok"));
+    EXPECT_CALL(task, Call(24))
+        .InSequence(tasks)
+        .WillOnce(testing::Return("Ok2"));
+    EXPECT_CALL(completionHandler, Call("Ok")).InSequence(callbacks);
+    EXPECT_CALL(completionHandler, Call("Ok2"))
+        .InSequence(callbacks)
         .WillOnce(testing::InvokeWithoutArgs(
             DbusEnvironment::setPromise("complete")));
 
-    EXPECT_CALL(task, Call(24)).Times(0);
+    EXPECT_TRUE(sut_->schedule(
+        0,
+        [&task]() -> std::string {
+            std::this_thread::sleep_for(std::chrono::milliseconds{15});
+            return task.Call(42);
+        },
+        [&completionHandler](std::string v) { completionHandler.Call(v); }));
+
+    EXPECT_TRUE(sut_->schedule(
+        0, [&task]() -> std::string { return task.Call(24); },
+        [&completionHandler](std::string v) { completionHandler.Call(v); }));
+
+    DbusEnvironment::waitForFuture("complete");
+}
+
+TEST_F(AsyncExecutorTest, OnlyNewestOfTasksWaitingForPendingOneIsExecuted)
+{
+    testing::MockFunction<std::string(int)> task;
+    testing::MockFunction<void(std::string)> completionHandler;
+
+    EXPECT_CALL(task, Call(42)).WillOnce(testing::Return("Ok"));
+    EXPECT_CALL(task, Call(1)).Times(0);
+    EXPECT_CALL(task, Call(2)).WillOnce(testing::Return("Ok2"));
+    EXPECT_CALL(completionHandler, Call("Ok"));
+    EXPECT_CALL(completionHandler, Call("Ok2"))
+        .WillOnce(testing::InvokeWithoutArgs(
+            DbusEnvironment::setPromise("complete")));
 
     sut_->schedule(
         0,
@@ -155,12 +193,114 @@ TEST_F(AsyncExecutorTest, AnotheScheduleCalledWhenOneIsPendingDoesNothing)
             return task.Call(42);
         },
         [&completionHandler](std::string v) { completionHandler.Call(v); });
+    for (int value : {1, 2})
+    {
+        EXPECT_TRUE(sut_->schedule(
+            0, [&task, value]() -> std::string { return task.Call(value); },
+            [&completionHandler](std::string v) {
+                completionHandler.Call(v);
+            }));
+    }
+
+    DbusEnvironment::waitForFuture("complete");
+}
+
+TEST_F(AsyncExecutorTest, IsPendingUntilCallbackIsCalled)
+{
+    testing::MockFunction<void(std::string)> completionHandler;
+    EXPECT_CALL(completionHandler, Call("Ok"))
+        .WillOnce(testing::InvokeWithoutArgs(
+            DbusEnvironment::setPromise("complete")));
 
+    EXPECT_FALSE(sut_->isPending(0));
     sut_->schedule(
-        0, [&task]() -> std::string { return task.Call(24); },
+        0, []() -> std::string { return "Ok"; },
+        [&completionHandler](std::string v) { completionHandler.Call(v); });
+    EXPECT_TRUE(sut_->isPending(0));
+    EXPECT_FALSE(sut_->isPending(1));
+
+    DbusEnvironment::waitForFuture("complete");
+    EXPECT_FALSE(sut_->isPending(0));
+}
+
+TEST_F(AsyncExecutorTest, TaskExceedingTimeoutCallsCallbackWithTimeoutResult)
+{
+    testing::MockFunction<void(std::string)> completionHandler;
+
+    EXPECT_CALL(completionHandler, Call("Ok")).Times(0);
+    EXPECT_CALL(completionHandler, Call("Timeout"))
+        .WillOnce(testing::InvokeWithoutArgs(
+            DbusEnvironment::setPromise("timeout")));
+
+    sut_->schedule(
+        0,
+        []() -> std::string {
+            std::this_thread::sleep_for(std::chrono::milliseconds{200});
+            return "Ok";
+        },
+        [&completionHandler](std::string v) { completionHandler.Call(v); });
+
+    DbusEnvironment::waitForFuture("timeout");
+    EXPECT_TRUE(sut_->isPending(0));
+    DbusEnvironment::sleepFor(std::chrono::milliseconds{200});
+    EXPECT_FALSE(sut_->isPending(0));
+}
+
+TEST_F(AsyncExecutorTest, TaskScheduledAfterTimeoutWaitsForTimedOutTask)
+{
+    std::atomic<bool> firstTaskRunning = false;
+    testing::MockFunction<void(std::string)> completionHandler;
+
+    EXPECT_CALL(completionHandler, Call("Timeout"));
+    EXPECT_CALL(completionHandler, Call("Ok2"))
+        .WillOnce(testing::InvokeWithoutArgs(
+            DbusEnvironment::setPromise("complete")));
+
+    sut_->schedule(
+        0,
+        [&firstTaskRunning]() -> std::string {
+            firstTaskRunning = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds{200});
+            firstTaskRunning = false;
+            return "Ok";
+        },
+        [this, &firstTaskRunning, &completionHandler](std::string v) {
+            completionHandler.Call(v);
+            sut_->schedule(
+                0,
+                [&firstTaskRunning]() -> std::string {
+                    return firstTaskRunning ? "Overlap" : "Ok2";
+                },
+                [&completionHandler](std::string v) {
+                    completionHandler.Call(v);
+                });
+        });
+
+    DbusEnvironment::waitForFuture("complete");
+}
+
+TEST_F(AsyncExecutorTest, ThrowingTaskCallsCallbackWithTimeoutResult)
+{
+    testing::MockFunction<void(std::string)> completionHandler;
+
+    EXPECT_CALL(completionHandler, Call("Timeout"))
+        .WillOnce(testing::InvokeWithoutArgs(
+            DbusEnvironment::setPromise("complete")));
+
+    sut_->schedule(
+        0, []() -> std::string { throw std::runtime_error("Failed"); },
         [&completionHandler](std::string v) { completionHandler.Call(v); });
 
     DbusEnvironment::waitForFuture("complete");
+    EXPECT_FALSE(sut_->isPending(0));
+}
+
+TEST_F(AsyncExecutorTest, ScheduleWithNullTaskOrCallbackIsRejected)
+{
+    EXPECT_FALSE(sut_->schedule(0, nullptr, [](std::string) {}));
+    EXPECT_FALSE(
+        sut_->schedule(0, []() -> std::string { return "Ok"; }, nullptr));
+    EXPECT_FALSE(sut_->isPending(0));
 }
 
 TEST_F(AsyncExecutorTest,
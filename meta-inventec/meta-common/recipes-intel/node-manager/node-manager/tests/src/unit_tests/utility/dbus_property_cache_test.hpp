@@ -0,0 +1,104 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+
+#include "stubs/arbitrary_dbus_stub.hpp"
+#include "utility/dbus_property_cache.hpp"
+#include "utils/busctl_call.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+static constexpr const auto kCacheTestPath = "/xyz/openbmc_project/cache_test";
+static constexpr const auto kCacheTestInterface =
+    "xyz.openbmc_project.CacheTest";
+static constexpr const auto kCacheTestProperty = "State";
+
+class DbusPropertyCacheTest : public ::testing::Test
+{
+  protected:
+    virtual void SetUp() override
+    {
+        BusctlCall::SetProperty(kCacheTestPath, kCacheTestInterface,
+                                kCacheTestProperty, "A");
+    }
+
+    auto setPromise(const std::string& tag)
+    {
+        return testing::InvokeWithoutArgs(DbusEnvironment::setPromise(tag));
+    }
+
+    std::unique_ptr<ArbitraryDbusStub<std::string>> dbusStub_ =
+        std::make_unique<ArbitraryDbusStub<std::string>>(
+            DbusEnvironment::getIoc(), DbusEnvironment::getBus(),
+            DbusEnvironment::getObjServer(), kCacheTestPath,
+            std::unordered_map<std::string, std::vector<std::string>>{
+                {kCacheTestInterface, {kCacheTestProperty}}});
+    const DbusPropertyKey key_{kCacheTestPath, kCacheTestInterface,
+                               kCacheTestProperty};
+    testing::MockFunction<void(const std::optional<DBusValue>&)> callback_;
+    std::shared_ptr<DbusPropertyCache> sut_ = DbusPropertyCache::getInstance(
+        DbusEnvironment::getBus(), DbusEnvironment::serviceName());
+};
+
+TEST_F(DbusPropertyCacheTest, CacheIsSharedByUsersOfTheSameService)
+{
+    EXPECT_EQ(sut_, DbusPropertyCache::getInstance(
+                        DbusEnvironment::getBus(),
+                        DbusEnvironment::serviceName()));
+}
+
+TEST_F(DbusPropertyCacheTest, ReadReturnsCurrentValueAndCachesIt)
+{
+    EXPECT_FALSE(sut_->getAge(key_));
+    EXPECT_CALL(callback_, Call(std::optional<DBusValue>{std::string("A")}))
+        .WillOnce(setPromise("read"));
+
+    sut_->read(key_, callback_.AsStdFunction(), 0, std::chrono::seconds{0});
+    DbusEnvironment::waitForAllFutures();
+
+    EXPECT_TRUE(sut_->getAge(key_));
+}
+
+TEST_F(DbusPropertyCacheTest, ReadOfMissingPropertyIsRetried)
+{
+    dbusStub_.reset();
+    EXPECT_CALL(callback_, Call(std::optional<DBusValue>{}))
+        .WillOnce(testing::Return())
+        .WillOnce(setPromise("read"));
+
+    sut_->read(key_, callback_.AsStdFunction(), 1, std::chrono::seconds{0});
+    DbusEnvironment::waitForAllFutures();
+}
+
+TEST_F(DbusPropertyCacheTest, SubscriberIsNotifiedAboutChangedValue)
+{
+    auto subscription = sut_->subscribe(key_, callback_.AsStdFunction());
+    testing::MockFunction<void(const std::optional<DBusValue>&)> readCallback;
+    EXPECT_CALL(readCallback, Call(testing::_)).WillOnce(setPromise("read"));
+    sut_->read(key_, readCallback.AsStdFunction(), 0, std::chrono::seconds{0});
+    DbusEnvironment::waitForAllFutures();
+
+    EXPECT_CALL(callback_, Call(std::optional<DBusValue>{std::string("B")}))
+        .WillOnce(setPromise("changed"));
+    BusctlCall::SetProperty(kCacheTestPath, kCacheTestInterface,
+                            kCacheTestProperty, "B");
+    DbusEnvironment::waitForAllFutures();
+}
@@ -0,0 +1,100 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "utility/crash_dump_buffer.hpp"
+#include "utility/diagnostics_writer.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+
+class DiagnosticsWriterTest
+    : public ::testing::TestWithParam<DiagnosticsFormat>
+{
+  protected:
+    nlohmann::json parse(const std::string& out)
+    {
+        if (GetParam() == DiagnosticsFormat::cbor)
+        {
+            return nlohmann::json::from_cbor(out);
+        }
+        return nlohmann::json::parse(out);
+    }
+
+    std::string out_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Formats, DiagnosticsWriterTest,
+                         ::testing::Values(DiagnosticsFormat::json,
+                                           DiagnosticsFormat::cbor));
+
+TEST_P(DiagnosticsWriterTest, EmptyReportIsEmptyObject)
+{
+    DiagnosticsWriter sut(GetParam(), out_);
+    sut.finish();
+
+    EXPECT_EQ(parse(out_), nlohmann::json::object());
+}
+
+TEST_P(DiagnosticsWriterTest, AllKindsOfMembersAreWrittenToSingleObject)
+{
+    const DiagnosticsSection section("Image", {{"Version", "1.0"}});
+    DiagnosticsWriter sut(GetParam(), out_);
+    sut.add("Timestamp", 123);
+    sut.add(section);
+    sut.addMembers({{"Knobs", {{"Health", "OK"}}}, {"Sensors", {1, 2}}});
+    sut.finish();
+
+    EXPECT_EQ(parse(out_), nlohmann::json({{"Timestamp", 123},
+                                           {"Image", {{"Version", "1.0"}}},
+                                           {"Knobs", {{"Health", "OK"}}},
+                                           {"Sensors", {1, 2}}}));
+}
+
+TEST_P(DiagnosticsWriterTest, BufferContentIsReplacedByNewReport)
+{
+    {
+        DiagnosticsWriter sut(GetParam(), out_);
+        sut.add("Old", true);
+        sut.finish();
+    }
+    DiagnosticsWriter sut(GetParam(), out_);
+    sut.add("New", true);
+    sut.finish();
+
+    EXPECT_EQ(parse(out_), nlohmann::json({{"New", true}}));
+}
+
+TEST(CrashDumpBufferTest, StoredContentIsReturned)
+{
+    auto sut = std::make_unique<CrashDumpBuffer>();
+    EXPECT_STREQ(sut->get(), "");
+
+    sut->store("{\"Timestamp\":123}");
+    EXPECT_STREQ(sut->get(), "{\"Timestamp\":123}");
+}
+
+TEST(CrashDumpBufferTest, ContentExceedingCapacityIsTruncated)
+{
+    auto sut = std::make_unique<CrashDumpBuffer>();
+    sut->store(std::string(CrashDumpBuffer::kCapacity, 'x'));
+
+    const std::string_view content = sut->get();
+    EXPECT_EQ(content.size(), CrashDumpBuffer::kCapacity - 1);
+    EXPECT_TRUE(content.ends_with("x..."));
+}
@@ -0,0 +1,129 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "utility/latency_histogram.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace nodemanager
+{
+
+class LatencyHistogramTest : public testing::Test
+{
+  public:
+    virtual ~LatencyHistogramTest() = default;
+
+    LatencyHistogram sut_;
+};
+
+TEST_F(LatencyHistogramTest, EmptyHistogramReportsZero)
+{
+    EXPECT_EQ(sut_.getCount(), 0);
+    EXPECT_EQ(sut_.getValueAtPercentile(50.0), 0);
+    EXPECT_EQ(sut_.getValueAtPercentile(99.9), 0);
+}
+
+TEST_F(LatencyHistogramTest, SmallValuesAreCountedExactly)
+{
+    for (uint32_t value = 0; value < LatencyHistogram::kSubBucketsCount;
+         ++value)
+    {
+        EXPECT_EQ(LatencyHistogram::getBucketIndex(value), value);
+        EXPECT_EQ(LatencyHistogram::getBucketUpperBound(value), value);
+    }
+}
+
+TEST_F(LatencyHistogramTest, BucketBoundsAreWithinRelativeError)
+{
+    for (uint64_t value = 1; value <= std::numeric_limits<uint32_t>::max();
+         value = value * 3 + 1)
+    {
+        const auto index =
+            LatencyHistogram::getBucketIndex(static_cast<uint32_t>(value));
+        ASSERT_LT(index, LatencyHistogram::kBucketsCount);
+        const auto upperBound = LatencyHistogram::getBucketUpperBound(index);
+        EXPECT_GE(upperBound, value);
+        EXPECT_LE(static_cast<double>(upperBound - value),
+                  static_cast<double>(value) /
+                      LatencyHistogram::kSubBucketsCount);
+    }
+    EXPECT_EQ(LatencyHistogram::getBucketIndex(
+                  std::numeric_limits<uint32_t>::max()),
+              LatencyHistogram::kBucketsCount - 1);
+}
+
+TEST_F(LatencyHistogramTest, PercentilesOfUniformDistribution)
+{
+    for (uint32_t value = 1; value <= 10000; ++value)
+    {
+        sut_.record(value);
+    }
+
+    EXPECT_EQ(sut_.getCount(), 10000);
+    EXPECT_EQ(sut_.getMax(), 10000);
+    EXPECT_NEAR(sut_.getValueAtPercentile(50.0), 5000, 5000 / 16);
+    EXPECT_NEAR(sut_.getValueAtPercentile(90.0), 9000, 9000 / 16);
+    EXPECT_NEAR(sut_.getValueAtPercentile(99.0), 9900, 9900 / 16);
+    EXPECT_NEAR(sut_.getValueAtPercentile(99.9), 9990, 9990 / 16);
+    EXPECT_EQ(sut_.getValueAtPercentile(100.0), 10000);
+}
+
+TEST_F(LatencyHistogramTest, TailIsVisibleInHighPercentiles)
+{
+    for (int i = 0; i < 990; ++i)
+    {
+        sut_.record(100);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        sut_.record(50000);
+    }
+
+    EXPECT_NEAR(sut_.getValueAtPercentile(50.0), 100, 100 / 16);
+    EXPECT_NEAR(sut_.getValueAtPercentile(99.0), 100, 100 / 16);
+    EXPECT_EQ(sut_.getValueAtPercentile(99.9), 50000);
+}
+
+TEST_F(LatencyHistogramTest, ValuesAboveRangeAreClamped)
+{
+    sut_.record(uint64_t{1} << 40);
+
+    EXPECT_EQ(sut_.getMax(), std::numeric_limits<uint32_t>::max());
+    EXPECT_EQ(sut_.getValueAtPercentile(50.0),
+              std::numeric_limits<uint32_t>::max());
+}
+
+TEST_F(LatencyHistogramTest, MergeAddsCountsAndResetClears)
+{
+    LatencyHistogram other;
+    sut_.record(10);
+    other.record(1000);
+
+    sut_.merge(other);
+
+    EXPECT_EQ(sut_.getCount(), 2);
+    EXPECT_EQ(sut_.getValueAtPercentile(50.0), 10);
+    EXPECT_EQ(sut_.getValueAtPercentile(100.0), 1000);
+
+    sut_.reset();
+
+    EXPECT_EQ(sut_.getCount(), 0);
+    EXPECT_EQ(sut_.getMax(), 0);
+}
+
+} // namespace nodemanager
@@ -0,0 +1,125 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "utility/log_tail_reader.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace nodemanager;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class LogTailReaderTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(rootPath_);
+        std::filesystem::create_directories(rootPath_);
+        append("first\nsecond\n");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(rootPath_);
+    }
+
+    void append(const std::string& content)
+    {
+        std::ofstream(filePath_, std::ios_base::out | std::ios_base::app)
+            << content;
+    }
+
+    std::filesystem::path rootPath_ =
+        std::filesystem::temp_directory_path() / "nm-log-tail-reader-ut";
+    std::filesystem::path filePath_ = rootPath_ / "log";
+    LogTailReader sut_{filePath_};
+};
+
+TEST_F(LogTailReaderTest, FirstReadReturnsWholeFile)
+{
+    EXPECT_THAT(sut_.readNewLines(), ElementsAre("first", "second"));
+    EXPECT_THAT(sut_.readNewLines(), IsEmpty());
+}
+
+TEST_F(LogTailReaderTest, OnlyAppendedLinesAreReturned)
+{
+    sut_.readNewLines();
+    append("third\n");
+
+    EXPECT_THAT(sut_.readNewLines(), ElementsAre("third"));
+}
+
+TEST_F(LogTailReaderTest, IncompleteLineIsReturnedWhenCompleted)
+{
+    sut_.seekToEnd();
+    append("thi");
+    EXPECT_THAT(sut_.readNewLines(), IsEmpty());
+
+    append("rd\n");
+    EXPECT_THAT(sut_.readNewLines(), ElementsAre("third"));
+}
+
+TEST_F(LogTailReaderTest, RestOfRotatedFileIsReadBeforeTheNewFile)
+{
+    sut_.readNewLines();
+    append("third\n");
+    std::filesystem::rename(filePath_, filePath_.string() + ".1");
+    append("fourth\n");
+
+    EXPECT_THAT(sut_.readNewLines(), ElementsAre("third", "fourth"));
+}
+
+TEST_F(LogTailReaderTest, TruncatedFileIsReadFromTheBeginning)
+{
+    sut_.readNewLines();
+    std::ofstream(filePath_, std::ios_base::out | std::ios_base::trunc)
+        << "new\n";
+
+    EXPECT_THAT(sut_.readNewLines(), ElementsAre("new"));
+}
+
+TEST_F(LogTailReaderTest, ReadingIsContinuedFromStoredPosition)
+{
+    sut_.readNewLines();
+    append("thi");
+    sut_.readNewLines();
+    const auto position = sut_.getPosition();
+    ASSERT_TRUE(position);
+    append("rd\n");
+
+    LogTailReader other{filePath_};
+    ASSERT_TRUE(other.seek(*position));
+    EXPECT_THAT(other.readNewLines(), ElementsAre("third"));
+}
+
+TEST_F(LogTailReaderTest, SeekToPositionInOtherFileFails)
+{
+    sut_.readNewLines();
+    const auto position = sut_.getPosition();
+    ASSERT_TRUE(position);
+    std::filesystem::rename(filePath_, filePath_.string() + ".1");
+    append("new\n");
+
+    LogTailReader other{filePath_};
+    EXPECT_FALSE(other.seek(*position));
+    EXPECT_THAT(other.readNewLines(), ElementsAre("new"));
+}
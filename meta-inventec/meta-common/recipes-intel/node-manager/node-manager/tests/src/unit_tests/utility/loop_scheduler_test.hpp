@@ -0,0 +1,176 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "clock.hpp"
+#include "utility/loop_scheduler.hpp"
+#include "utils/dbus_environment.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace nodemanager
+{
+
+static const LoopTaskConfig kFastTestTask = {
+    "Fast", std::chrono::milliseconds{50}, std::chrono::milliseconds{0},
+    std::chrono::milliseconds{20}, OverrunPolicy::skip};
+static const LoopTaskConfig kSlowTestTask = {
+    "Slow", std::chrono::milliseconds{100}, std::chrono::milliseconds{0},
+    std::chrono::milliseconds{50}, OverrunPolicy::skip};
+static const LoopTaskConfig kShiftedTestTask = {
+    "Shifted", std::chrono::milliseconds{1000}, std::chrono::milliseconds{50},
+    std::chrono::milliseconds{20}, OverrunPolicy::shed};
+
+class LoopSchedulerTest : public testing::Test
+{
+  public:
+    virtual ~LoopSchedulerTest() = default;
+
+    /**
+     * @brief Advances the mocked clock in `stepMs` steps and runs the due
+     * tasks after every step.
+     */
+    void runFor(int64_t durationMs, int64_t stepMs = 10)
+    {
+        for (int64_t elapsed = 0; elapsed < durationMs; elapsed += stepMs)
+        {
+            Clock::stepMs(stepMs);
+            sut_.runDueTasks();
+        }
+    }
+
+    LoopScheduler sut_{DbusEnvironment::getIoc()};
+    testing::MockFunction<void()> fast_;
+    testing::MockFunction<void()> slow_;
+    testing::MockFunction<void()> shifted_;
+};
+
+TEST_F(LoopSchedulerTest, TasksAreRunAccordingToTheirPeriods)
+{
+    sut_.addTask(kFastTestTask, fast_.AsStdFunction());
+    sut_.addTask(kSlowTestTask, slow_.AsStdFunction());
+    sut_.addTask(kShiftedTestTask, shifted_.AsStdFunction());
+    sut_.start();
+
+    EXPECT_CALL(fast_, Call()).Times(20);
+    EXPECT_CALL(slow_, Call()).Times(10);
+    EXPECT_CALL(shifted_, Call()).Times(1);
+    sut_.runDueTasks();
+    runFor(990);
+}
+
+TEST_F(LoopSchedulerTest, TaskWithOffsetIsFirstRunAfterTheOffset)
+{
+    sut_.addTask(kShiftedTestTask, shifted_.AsStdFunction());
+    sut_.start();
+
+    EXPECT_CALL(shifted_, Call()).Times(0);
+    runFor(40);
+    testing::Mock::VerifyAndClearExpectations(&shifted_);
+
+    EXPECT_CALL(shifted_, Call()).Times(1);
+    runFor(10);
+}
+
+TEST_F(LoopSchedulerTest, TasksDueAtTheSameTimeAreRunInOrderOfAdding)
+{
+    sut_.addTask(kFastTestTask, fast_.AsStdFunction());
+    sut_.addTask(kSlowTestTask, slow_.AsStdFunction());
+    sut_.start();
+
+    testing::InSequence seq;
+    EXPECT_CALL(fast_, Call());
+    EXPECT_CALL(slow_, Call());
+    EXPECT_CALL(fast_, Call());
+    EXPECT_CALL(fast_, Call());
+    EXPECT_CALL(slow_, Call());
+    sut_.runDueTasks();
+    runFor(100);
+}
+
+TEST_F(LoopSchedulerTest, NextDueTimeIsTheEarliestOfAllTasks)
+{
+    sut_.addTask(kSlowTestTask, slow_.AsStdFunction());
+    sut_.addTask(kShiftedTestTask, shifted_.AsStdFunction());
+    sut_.start();
+    const auto started = Clock::now();
+
+    EXPECT_CALL(slow_, Call());
+    sut_.runDueTasks();
+
+    EXPECT_EQ(sut_.getNextDueTime(), started + std::chrono::milliseconds{50});
+}
+
+TEST_F(LoopSchedulerTest, OverrunIsCountedAndMissedPeriodsAreSkipped)
+{
+    sut_.addTask(kFastTestTask, fast_.AsStdFunction());
+    sut_.start();
+
+    EXPECT_CALL(fast_, Call())
+        .WillOnce(testing::InvokeWithoutArgs([]() { Clock::stepMs(120); }))
+        .WillRepeatedly(testing::Return());
+    sut_.runDueTasks();
+
+    const auto counters = sut_.getCounters(kFastTestTask.name);
+    EXPECT_EQ(counters.runs, 1u);
+    EXPECT_EQ(counters.overruns, 1u);
+    EXPECT_EQ(counters.skippedPeriods, 2u);
+
+    runFor(40);
+    EXPECT_EQ(sut_.getCounters(kFastTestTask.name).runs, 2u);
+}
+
+TEST_F(LoopSchedulerTest, RunAfterOverrunIsShedWithShedPolicy)
+{
+    sut_.addTask(kShiftedTestTask, shifted_.AsStdFunction());
+    sut_.start();
+
+    EXPECT_CALL(shifted_, Call())
+        .WillOnce(testing::InvokeWithoutArgs([]() { Clock::stepMs(30); }));
+    runFor(50);
+    runFor(1900);
+
+    const auto counters = sut_.getCounters(kShiftedTestTask.name);
+    EXPECT_EQ(counters.runs, 1u);
+    EXPECT_EQ(counters.overruns, 1u);
+    EXPECT_EQ(counters.shedRuns, 1u);
+}
+
+TEST_F(LoopSchedulerTest, SlowTaskDoesNotPreventFasterTaskFromRunning)
+{
+    sut_.addTask(kFastTestTask, fast_.AsStdFunction());
+    sut_.addTask(kSlowTestTask, slow_.AsStdFunction());
+    sut_.start();
+
+    EXPECT_CALL(slow_, Call()).WillRepeatedly(testing::InvokeWithoutArgs([]() {
+        Clock::stepMs(40);
+    }));
+    EXPECT_CALL(fast_, Call()).Times(testing::AtLeast(19));
+    sut_.runDueTasks();
+    runFor(990);
+}
+
+TEST_F(LoopSchedulerTest, TaskWithZeroPeriodThrows)
+{
+    auto config = kFastTestTask;
+    config.period = std::chrono::milliseconds{0};
+
+    EXPECT_THROW(sut_.addTask(config, fast_.AsStdFunction()),
+                 std::logic_error);
+}
+
+} // namespace nodemanager
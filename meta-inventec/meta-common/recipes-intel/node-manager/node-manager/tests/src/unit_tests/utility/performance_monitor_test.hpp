@@ -0,0 +1,146 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "clock.hpp"
+#include "utility/performance_monitor.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace nodemanager
+{
+
+class PerformanceCollectorTest : public testing::Test
+{
+  public:
+    virtual ~PerformanceCollectorTest() = default;
+
+    virtual void SetUp() override
+    {
+        sut_ = std::make_shared<PerformanceCollector>();
+        performanceCollectorWp = sut_;
+    }
+
+    virtual void TearDown() override
+    {
+        performanceCollectorWp.reset();
+    }
+
+    nlohmann::json getMeasureJson(const std::string& name)
+    {
+        nlohmann::json out;
+        sut_->reportStatus(out);
+        return out["Performance"][name];
+    }
+
+    std::shared_ptr<PerformanceCollector> sut_;
+};
+
+TEST_F(PerformanceCollectorTest, HandlesWithSameNameShareMeasure)
+{
+    const MeasureHandle first("Test-shared-duration");
+    const MeasureHandle second("Test-shared-duration");
+    const MeasureHandle other("Test-other-duration");
+
+    EXPECT_EQ(first.getId(), second.getId());
+    EXPECT_NE(first.getId(), other.getId());
+    EXPECT_EQ(sut_->getMeasure(first), sut_->getMeasure(second));
+    EXPECT_EQ(sut_->getMeasure(first),
+              sut_->getMeasure("Test-shared-duration",
+                               Clock::duration::zero()));
+}
+
+TEST_F(PerformanceCollectorTest, PerfRecordsSampleInMeasureReferencedByHandle)
+{
+    static const MeasureHandle handle("Test-perf-duration");
+    {
+        auto perf = Perf(handle);
+        Clock::stepMs(3);
+    }
+
+    const auto json = getMeasureJson("Test-perf-duration");
+    EXPECT_EQ(json["HitCounter"], 1);
+    EXPECT_EQ(json["WindowHitCounter"], 1);
+    EXPECT_EQ(json["Value[us]"], 3000);
+    EXPECT_NEAR(json["P50[us]"].get<double>(), 3000, 3000 / 16);
+}
+
+TEST_F(PerformanceCollectorTest, PerfDoesNothingWhenCollectorDisabled)
+{
+    static const MeasureHandle handle("Test-disabled-duration");
+    performanceCollectorWp.reset();
+    {
+        auto perf = Perf(handle);
+    }
+    performanceCollectorWp = sut_;
+
+    EXPECT_TRUE(getMeasureJson("Test-disabled-duration").is_null());
+}
+
+TEST_F(PerformanceCollectorTest, PercentilesReportTailLatency)
+{
+    auto measure = sut_->getMeasure(MeasureHandle("Test-tail-duration"));
+    for (int i = 0; i < 999; ++i)
+    {
+        measure->addSample(std::chrono::microseconds{200});
+    }
+    measure->addSample(std::chrono::milliseconds{40});
+
+    const auto json = getMeasureJson("Test-tail-duration");
+    EXPECT_NEAR(json["P50[us]"].get<double>(), 200, 200 / 16);
+    EXPECT_NEAR(json["P99[us]"].get<double>(), 200, 200 / 16);
+    EXPECT_EQ(json["P99.9[us]"], 40000);
+    EXPECT_EQ(json["ValueMax[us]"], 40000);
+
+    const auto percentiles = sut_->getLatencyPercentiles();
+    ASSERT_EQ(percentiles.size(), 1);
+    EXPECT_EQ(std::get<0>(percentiles[0]), "Test-tail-duration");
+    EXPECT_EQ(std::get<1>(percentiles[0]), 1000);
+    EXPECT_EQ(std::get<6>(percentiles[0]), 40000);
+}
+
+TEST_F(PerformanceCollectorTest, HistogramCoversCurrentAndPreviousWindow)
+{
+    auto measure = sut_->getMeasure(MeasureHandle("Test-window-duration"));
+    measure->addSample(std::chrono::milliseconds{1});
+    Clock::stepSec(kPerformanceHistogramWindow.count());
+    measure->addSample(std::chrono::milliseconds{2});
+
+    EXPECT_EQ(getMeasureJson("Test-window-duration")["WindowHitCounter"], 2);
+
+    Clock::stepSec(kPerformanceHistogramWindow.count());
+    EXPECT_EQ(getMeasureJson("Test-window-duration")["WindowHitCounter"], 1);
+
+    Clock::stepSec(kPerformanceHistogramWindow.count());
+    const auto json = getMeasureJson("Test-window-duration");
+    EXPECT_EQ(json["WindowHitCounter"], 0);
+    EXPECT_EQ(json["HitCounter"], 2);
+}
+
+TEST_F(PerformanceCollectorTest, ResetRemovesMeasures)
+{
+    static const MeasureHandle handle("Test-reset-duration");
+    {
+        auto perf = Perf(handle);
+    }
+    sut_->reset();
+
+    EXPECT_TRUE(getMeasureJson("Test-reset-duration").is_null());
+    EXPECT_TRUE(sut_->getLatencyPercentiles().empty());
+}
+
+} // namespace nodemanager
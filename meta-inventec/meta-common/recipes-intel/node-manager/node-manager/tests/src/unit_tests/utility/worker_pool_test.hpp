@@ -0,0 +1,167 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+#pragma once
+#include "common_types.hpp"
+#include "utility/worker_pool.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace nodemanager
+{
+
+static constexpr std::array<WorkerQueueConfig, kWorkerQueuesCount>
+    kWorkerPoolTestConfigs = {{
+        {2, 1},  // hwmon
+        {64, 2}, // peci
+        {1, 1},  // smart
+        {2, 1},  // knob
+    }};
+
+class WorkerPoolTest : public testing::Test
+{
+  public:
+    virtual ~WorkerPoolTest() = default;
+
+    virtual void SetUp() override
+    {
+        performance_ = std::make_shared<PerformanceCollector>();
+        performanceCollectorWp = performance_;
+        sut_ = std::make_unique<WorkerPool>(2, kWorkerPoolTestConfigs);
+    }
+
+    virtual void TearDown() override
+    {
+        sut_ = nullptr;
+        performanceCollectorWp.reset();
+    }
+
+    std::shared_ptr<PerformanceCollector> performance_;
+    std::unique_ptr<WorkerPool> sut_;
+};
+
+TEST_F(WorkerPoolTest, SubmittedTasksAreExecutedAndResultsReturned)
+{
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 32; i++)
+    {
+        futures.emplace_back(
+            sut_->submit(WorkerQueue::peci, [i]() { return i * 2; }));
+    }
+
+    for (int i = 0; i < 32; i++)
+    {
+        ASSERT_TRUE(futures[i].valid());
+        EXPECT_EQ(futures[i].get(), i * 2);
+    }
+}
+
+TEST_F(WorkerPoolTest, TaskRejectedWithInvalidFutureWhenQueueIsFull)
+{
+    std::promise<void> started;
+    std::promise<void> gate;
+    auto gateFuture = gate.get_future().share();
+    auto blocking =
+        sut_->submit(WorkerQueue::hwmon, [&started, gateFuture]() {
+            started.set_value();
+            gateFuture.wait();
+            return 0;
+        });
+    started.get_future().wait();
+
+    auto first = sut_->submit(WorkerQueue::hwmon, []() { return 1; });
+    auto second = sut_->submit(WorkerQueue::hwmon, []() { return 2; });
+    auto rejected = sut_->submit(WorkerQueue::hwmon, []() { return 3; });
+
+    EXPECT_TRUE(first.valid());
+    EXPECT_TRUE(second.valid());
+    EXPECT_FALSE(rejected.valid());
+
+    gate.set_value();
+    EXPECT_EQ(blocking.get(), 0);
+    EXPECT_EQ(first.get(), 1);
+    EXPECT_EQ(second.get(), 2);
+}
+
+TEST_F(WorkerPoolTest, FullQueueDoesNotBlockOtherQueues)
+{
+    std::promise<void> gate;
+    auto gateFuture = gate.get_future().share();
+    auto blocking = sut_->submit(WorkerQueue::hwmon, [gateFuture]() {
+        gateFuture.wait();
+        return 0;
+    });
+
+    auto peci = sut_->submit(WorkerQueue::peci, []() { return 42; });
+    ASSERT_EQ(peci.wait_for(std::chrono::seconds{5}),
+              std::future_status::ready);
+    EXPECT_EQ(peci.get(), 42);
+
+    gate.set_value();
+    EXPECT_EQ(blocking.get(), 0);
+}
+
+TEST_F(WorkerPoolTest, CancelCompletesPendingTasksWithValueInitializedResult)
+{
+    std::promise<void> started;
+    std::promise<void> gate;
+    auto gateFuture = gate.get_future().share();
+    auto blocking =
+        sut_->submit(WorkerQueue::hwmon, [&started, gateFuture]() {
+            started.set_value();
+            gateFuture.wait();
+            return 0;
+        });
+    started.get_future().wait();
+    auto pending = sut_->submit(WorkerQueue::hwmon, []() { return 1; });
+
+    EXPECT_EQ(sut_->cancel(WorkerQueue::hwmon), 1);
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds{0}),
+              std::future_status::ready);
+    EXPECT_EQ(pending.get(), 0);
+
+    gate.set_value();
+    EXPECT_EQ(blocking.get(), 0);
+}
+
+TEST_F(WorkerPoolTest, TaskExceptionIsPassedToFuture)
+{
+    auto future = sut_->submit(WorkerQueue::peci, []() -> int {
+        throw std::runtime_error("failed");
+    });
+
+    EXPECT_THROW(future.get(), std::runtime_error);
+    EXPECT_EQ(sut_->submit(WorkerQueue::peci, []() { return 2; }).get(), 2);
+}
+
+TEST_F(WorkerPoolTest, StatisticsArePublishedToPerformanceCollector)
+{
+    // Statistics of a job are gathered before its future becomes ready
+    auto future = sut_->submit(WorkerQueue::peci, []() { return 1; });
+    future.get();
+
+    sut_->publishStatistics();
+
+    nlohmann::json out;
+    performance_->reportStatus(out);
+    const auto& perfJson = out["Performance"];
+    EXPECT_EQ(perfJson["WorkerPool-peci-queue-latency"]["HitCounter"], 1);
+    EXPECT_EQ(perfJson["WorkerPool-peci-job-duration"]["HitCounter"], 1);
+    EXPECT_EQ(perfJson["WorkerPool-peci-rejected"], 0);
+}
+
+} // namespace nodemanager
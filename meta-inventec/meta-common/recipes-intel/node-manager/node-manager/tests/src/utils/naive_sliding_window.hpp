@@ -0,0 +1,80 @@
+/*
+ * INTEL CONFIDENTIAL
+ *
+ * Copyright 2022 Intel Corporation.
+ *
+ * This software and the related documents are Intel copyrighted materials,
+ * and your use of them is governed by the express license under which they
+ * were provided to you ("License"). Unless the License provides otherwise,
+ * you may not use, modify, copy, publish, distribute, disclose or transmit
+ * this software or the related documents without Intel's prior written
+ * permission.
+ *
+ * This software and the related documents are provided as is, with
+ * no express or implied warranties, other than those that are expressly
+ * stated in the License.
+ */
+
+#pragma once
+
+#include "statistics/sliding_window.hpp"
+
+#include <algorithm>
+#include <boost/circular_buffer.hpp>
+#include <limits>
+#include <numeric>
+
+namespace nodemanager
+{
+
+/**
+ * @brief Reference window calculating statistics by iterating over all
+ * samples, as MovingAverage used to do.
+ */
+class NaiveSlidingWindow
+{
+  public:
+    explicit NaiveSlidingWindow(size_t capacity) : samples(capacity)
+    {
+    }
+
+    void push(const Sample& sample)
+    {
+        samples.push_back(sample);
+    }
+
+    double getSum() const
+    {
+        return std::accumulate(
+            samples.begin(), samples.end(), 0.0,
+            [](double sum, const Sample& curr) { return sum + curr.acc; });
+    }
+
+    double getMin() const
+    {
+        auto it = std::min_element(
+            samples.begin(), samples.end(),
+            [](const auto& a, const auto& b) { return a.min < b.min; });
+        return it != samples.end() ? it->min
+                                   : std::numeric_limits<double>::max();
+    }
+
+    double getMax() const
+    {
+        auto it = std::max_element(
+            samples.begin(), samples.end(),
+            [](const auto& a, const auto& b) { return a.max < b.max; });
+        return it != samples.end() ? it->max
+                                   : std::numeric_limits<double>::lowest();
+    }
+
+    size_t size() const
+    {
+        return samples.size();
+    }
+
+  private:
+    boost::circular_buffer<Sample> samples;
+};
+
+} // namespace nodemanager
@@ -40,16 +40,34 @@ extern "C" {
  */
 #define IS_VALID_LOG_PRIO(p) (((p) >= LOG_EMERG) && ((p) <= LOG_DEBUG))
 
+/*
+ * Highest priority value (i.e., least important messages) currently
+ * logged, or -1 if no logging device is enabled. It is maintained by
+ * the library and must not be modified by callers.
+ */
+extern int obmc_log_threshold;
+
+/*
+ * Check if messages of priority <p> would be logged. It's a single load
+ * so that filtered messages are neither formatted nor their arguments
+ * evaluated by the macros below.
+ */
+#define OBMC_LOG_IS_ENABLED(p)	\
+	((p) <= __atomic_load_n(&obmc_log_threshold, __ATOMIC_RELAXED))
+#define OBMC_LOG(prio, fmt, args...)				\
+	(OBMC_LOG_IS_ENABLED(prio) ?				\
+	 obmc_log_by_prio(prio, fmt, ##args) : 0)
+
 /*
  * Macros for frequently used log priorities.
  */
-#define OBMC_CRIT(fmt, args...) obmc_log_by_prio(LOG_CRIT, fmt, ##args)
+#define OBMC_CRIT(fmt, args...) OBMC_LOG(LOG_CRIT, fmt, ##args)
 #define OBMC_ERROR(err, fmt, args...)	\
-	obmc_log_by_prio(LOG_ERR, fmt ": %s", ##args, strerror(err))
-#define OBMC_WARN(fmt, args...) obmc_log_by_prio(LOG_WARNING, fmt, ##args)
-#define OBMC_INFO(fmt, args...) obmc_log_by_prio(LOG_INFO, fmt, ##args)
+	OBMC_LOG(LOG_ERR, fmt ": %s", ##args, strerror(err))
+#define OBMC_WARN(fmt, args...) OBMC_LOG(LOG_WARNING, fmt, ##args)
+#define OBMC_INFO(fmt, args...) OBMC_LOG(LOG_INFO, fmt, ##args)
 #ifdef OBMC_DEBUG_ENABLED
-#define OBMC_DEBUG(fmt, args...) obmc_log_by_prio(LOG_DEBUG, fmt, ##args)
+#define OBMC_DEBUG(fmt, args...) OBMC_LOG(LOG_DEBUG, fmt, ##args)
 #else
 #define OBMC_DEBUG(fmt, args...)
 #endif /* OBMC_DEBUG_ENABLED */
@@ -86,8 +104,16 @@ extern void obmc_log_destroy(void);
  * this case, only messages with INFO or lower priority (higher importance)
  * are logged to standard stream.
  *
+ * If asynchronous logging is enabled (see obmc_log_set_async()), the
+ * message is formatted into the ring buffer of the calling thread and
+ * written by the drain thread later. Messages with CRIT or lower priority
+ * are flushed before the function returns. In this mode syslog gets the
+ * formatted message too, so messages longer than 512 bytes are cut there
+ * as well. A cut message ends with " [truncated]".
+ *
  * Returns:
- *     0 for success, and -1 on failures.
+ *     0 for success, and -1 on failures. errno is set to ENOBUFS if the
+ *     message is dropped because the ring buffer is full.
  */
 extern int obmc_log_by_prio(int prio, const char *fmt, ...)
 	__attribute__ ((__format__ (__printf__, 2, 3)));
@@ -142,6 +168,56 @@ extern int obmc_log_set_std_stream(void);
  */
 extern void obmc_log_unset_std_stream(void);
 
+/*
+ * Policies of asynchronous logging when the ring buffer of the calling
+ * thread is full: drop the message and count it, or drain the buffers in
+ * the calling thread until the message fits.
+ */
+#define OBMC_LOG_ASYNC_DROP	0
+#define OBMC_LOG_ASYNC_BLOCK	1
+
+/*
+ * Configure the logger to queue messages in per-thread ring buffers of
+ * <ring_size> messages (0 for default), which are written to logging
+ * devices by a background thread. Messages from one thread are written
+ * in order, but messages from different threads may be interleaved.
+ * <policy> is one of OBMC_LOG_ASYNC_* and applies to messages with ERR
+ * or higher priority value; more important messages are never dropped.
+ * Dropped messages are never discarded silently: the drain thread
+ * reports them with a "<N> log messages dropped" warning on its next
+ * pass over the ring buffer.
+ *
+ * Pending messages are flushed at exit.
+ *
+ * Returns:
+ *     0 for success, and -1 on failures.
+ */
+extern int obmc_log_set_async(unsigned ring_size, int policy);
+
+/*
+ * Flush pending messages, stop the background thread and log messages
+ * synchronously again. It's no-op if asynchronous logging was never
+ * enabled.
+ */
+extern void obmc_log_unset_async(void);
+
+/*
+ * Write all the messages queued so far to logging devices.
+ */
+extern void obmc_log_flush(void);
+
+struct obmc_log_stats {
+	unsigned long long queued;	/* messages added to ring buffers */
+	unsigned long long written;	/* messages written by drain */
+	unsigned long long dropped;	/* messages lost on full buffers */
+	unsigned long long blocked;	/* waits on full buffers */
+};
+
+/*
+ * Get counters of asynchronous logging since the process started.
+ */
+extern void obmc_log_get_stats(struct obmc_log_stats *stats);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,218 @@
+/*
+ * Benchmark of repeated FRU field reads and small field writes against a
+ * file-backed stand-in EEPROM, comparing the per call open/seek/close
+ * access with the cached EEPROM handle.
+ *
+ * Build with "make eeprom-bench" and run "./eeprom-bench [path]".
+ */
+
+#include "../libobmci2c.h"
+
+#include <time.h>
+
+#define BENCH_EEPROM_PATH "/tmp/eeprom-bench.bin"
+#define BENCH_EEPROM_SIZE 8192
+#define BENCH_ITERATIONS 20000
+#define BENCH_WRITES 64
+#define BENCH_WRITE_CYCLE_US 5000
+
+struct fru_field
+{
+    uint32_t offset;
+    uint8_t len;
+};
+
+/* Common header, then fields of board and product info areas. */
+static const struct fru_field fru_fields[] = {
+    {0, 8},    {8, 2},    {13, 3},   {16, 1},   {17, 24}, {42, 1},
+    {43, 16},  {60, 16},  {77, 10},  {88, 2},   {96, 32}, {129, 32},
+    {162, 16}, {179, 20}, {200, 8},  {209, 10},
+};
+
+#define FRU_FIELDS (sizeof(fru_fields) / sizeof(fru_fields[0]))
+
+static double elapsed_s(const struct timespec* start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) +
+           (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int create_eeprom(const char* path)
+{
+    uint8_t data[BENCH_EEPROM_SIZE];
+    FILE* fp;
+    size_t i;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    fp = fopen(path, "wb");
+    if (NULL == fp || fwrite(data, 1, sizeof(data), fp) != sizeof(data))
+    {
+        perror(path);
+        return -1;
+    }
+    fclose(fp);
+    return 0;
+}
+
+/* What i2cEEPROMGet() used to do for every field. */
+static uint8_t read_uncached(const char* path, uint32_t offset, uint8_t len,
+                             uint8_t* buffer)
+{
+    FILE* fp = fopen(path, "rb");
+    uint8_t status = SUCCESS;
+
+    if (NULL == fp)
+    {
+        return FAILURE;
+    }
+    fseek(fp, offset, SEEK_SET);
+    if (fread(buffer, 1, len, fp) != len)
+    {
+        status = FAILURE;
+    }
+    fclose(fp);
+    return status;
+}
+
+static void bench_reads(const char* path)
+{
+    i2c_eeprom_config_t config = {0};
+    i2c_eeprom_stats_t stats;
+    struct timespec start;
+    uint8_t buffer[256];
+    i2c_eeprom_t* eeprom;
+    double seconds;
+    int i;
+    size_t f;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        for (f = 0; f < FRU_FIELDS; f++)
+        {
+            read_uncached(path, fru_fields[f].offset, fru_fields[f].len,
+                          buffer);
+        }
+    }
+    seconds = elapsed_s(&start);
+    printf("%-28s %12.0f %14.2f\n", "open/seek/read/close",
+           BENCH_ITERATIONS * FRU_FIELDS / seconds, (double)FRU_FIELDS);
+
+    config.cache_ttl_ms = EEPROM_CACHE_TTL_INFINITE;
+    eeprom = i2cEEPROMOpenPath(path, &config);
+    if (NULL == eeprom)
+    {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        for (f = 0; f < FRU_FIELDS; f++)
+        {
+            i2cEEPROMRead(eeprom, fru_fields[f].offset, fru_fields[f].len,
+                          buffer);
+        }
+    }
+    seconds = elapsed_s(&start);
+    i2cEEPROMGetStats(eeprom, &stats);
+    printf("%-28s %12.0f %14.2f\n", "handle, cached",
+           BENCH_ITERATIONS * FRU_FIELDS / seconds,
+           (double)stats.device_reads / BENCH_ITERATIONS);
+
+    /* Every pass reads the device again, as with an expired cache. */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        i2cEEPROMInvalidate(eeprom);
+        for (f = 0; f < FRU_FIELDS; f++)
+        {
+            i2cEEPROMRead(eeprom, fru_fields[f].offset, fru_fields[f].len,
+                          buffer);
+        }
+    }
+    seconds = elapsed_s(&start);
+    i2cEEPROMGetStats(eeprom, &stats);
+    printf("%-28s %12.0f %14.2f\n", "handle, invalidated per pass",
+           BENCH_ITERATIONS * FRU_FIELDS / seconds,
+           (double)stats.device_reads / BENCH_ITERATIONS - 1);
+    i2cEEPROMClose(eeprom);
+}
+
+static void bench_writes(const char* path)
+{
+    i2c_eeprom_config_t config = {0};
+    i2c_eeprom_stats_t stats;
+    struct timespec start;
+    i2c_eeprom_t* eeprom;
+    uint8_t value;
+    int i;
+
+    config.write_cycle_us = BENCH_WRITE_CYCLE_US;
+
+    /* Each field write flushed on its own, like i2cEEPROMSet(). */
+    eeprom = i2cEEPROMOpenPath(path, &config);
+    if (NULL == eeprom)
+    {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < BENCH_WRITES; i++)
+    {
+        value = (uint8_t)i;
+        i2cEEPROMWrite(eeprom, 16 + i, 1, &value);
+        i2cEEPROMFlush(eeprom);
+    }
+    i2cEEPROMGetStats(eeprom, &stats);
+    printf("%-28s %12.1f %14llu\n", "write + flush per field",
+           elapsed_s(&start) * 1000,
+           (unsigned long long)stats.device_writes);
+    i2cEEPROMClose(eeprom);
+
+    eeprom = i2cEEPROMOpenPath(path, &config);
+    if (NULL == eeprom)
+    {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < BENCH_WRITES; i++)
+    {
+        value = (uint8_t)~i;
+        i2cEEPROMWrite(eeprom, 16 + i, 1, &value);
+    }
+    i2cEEPROMFlush(eeprom);
+    i2cEEPROMGetStats(eeprom, &stats);
+    printf("%-28s %12.1f %14llu\n", "coalesced page bursts",
+           elapsed_s(&start) * 1000,
+           (unsigned long long)stats.device_writes);
+    i2cEEPROMClose(eeprom);
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : BENCH_EEPROM_PATH;
+
+    if (argc <= 1 && create_eeprom(path) != 0)
+    {
+        return -1;
+    }
+
+    printf("%-28s %12s %14s\n", "reads", "fields/s", "dev reads/pass");
+    bench_reads(path);
+
+    printf("\n%-28s %12s %14s\n", "writes (tWR 5 ms)", "time (ms)",
+           "page writes");
+    bench_writes(path);
+
+    if (argc <= 1)
+    {
+        unlink(path);
+    }
+    return 0;
+}
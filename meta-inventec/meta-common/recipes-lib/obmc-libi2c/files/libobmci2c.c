@@ -1,6 +1,10 @@
 
 #include "libobmci2c.h"
 
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+
 #define POLY    (0x1070U << 3)
 static uint8_t crc8(uint16_t data)
 {
@@ -164,11 +168,283 @@ int i2c_slave_clear_buffer(int file)
     return ret;
 }
 
+struct i2c_eeprom_page
+{
+    uint64_t loaded_ms;
+    uint16_t dirty_lo;
+    uint16_t dirty_hi;
+    uint8_t valid;
+};
+
+struct i2c_eeprom
+{
+    int fd;
+    uint32_t size;
+    uint32_t page_size;
+    uint32_t page_count;
+    uint32_t write_cycle_us;
+    uint32_t cache_ttl_ms;
+    uint8_t* data;
+    struct i2c_eeprom_page* pages;
+    struct timespec last_write;
+    i2c_eeprom_stats_t stats;
+};
+
+static void eeprom_sysfs_path(char* path, size_t size, const char* i2cbus,
+                              const char* i2caddr)
+{
+    snprintf(path, size, "/sys/bus/i2c/devices/%s-00%s/eeprom", i2cbus,
+             i2caddr);
+}
+
+static uint64_t monotonic_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/*
+ * The device does not respond until the last page write completes, so
+ * every access waits for the remaining write cycle time.
+ */
+static void eeprom_wait_write_cycle(i2c_eeprom_t* eeprom)
+{
+    struct timespec now;
+    int64_t elapsed_us;
+
+    if (eeprom->write_cycle_us == 0 || eeprom->last_write.tv_sec == 0)
+    {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_us = (int64_t)(now.tv_sec - eeprom->last_write.tv_sec) * 1000000 +
+                 (now.tv_nsec - eeprom->last_write.tv_nsec) / 1000;
+    if (elapsed_us < eeprom->write_cycle_us)
+    {
+        usleep(eeprom->write_cycle_us - elapsed_us);
+    }
+    eeprom->last_write.tv_sec = 0;
+}
+
+static int eeprom_page_is_fresh(const i2c_eeprom_t* eeprom, uint32_t page,
+                                uint64_t now_ms)
+{
+    const struct i2c_eeprom_page* p = &eeprom->pages[page];
+
+    if (!p->valid)
+    {
+        return 0;
+    }
+    return p->dirty_hi > p->dirty_lo ||
+           eeprom->cache_ttl_ms == EEPROM_CACHE_TTL_INFINITE ||
+           now_ms - p->loaded_ms < eeprom->cache_ttl_ms;
+}
+
+static int eeprom_pread_all(int fd, uint8_t* buffer, uint32_t len,
+                            uint32_t offset)
+{
+    ssize_t ret;
+
+    while (len > 0)
+    {
+        ret = pread(fd, buffer, len, offset);
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ret <= 0)
+        {
+            return -1;
+        }
+        buffer += ret;
+        offset += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+static int eeprom_pwrite_all(int fd, const uint8_t* buffer, uint32_t len,
+                             uint32_t offset)
+{
+    ssize_t ret;
+
+    while (len > 0)
+    {
+        ret = pwrite(fd, buffer, len, offset);
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ret <= 0)
+        {
+            return -1;
+        }
+        buffer += ret;
+        offset += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+/*
+ * Read stale pages in [first, last] from the device, every run of
+ * consecutive stale pages with a single read.
+ */
+static uint8_t eeprom_load_pages(i2c_eeprom_t* eeprom, uint32_t first,
+                                 uint32_t last)
+{
+    uint64_t now_ms = monotonic_ms();
+    uint32_t page, end, offset, len;
+
+    for (page = first; page <= last; page = end)
+    {
+        if (eeprom_page_is_fresh(eeprom, page, now_ms))
+        {
+            end = page + 1;
+            continue;
+        }
+        for (end = page + 1;
+             end <= last && !eeprom_page_is_fresh(eeprom, end, now_ms); end++)
+        {
+        }
+
+        offset = page * eeprom->page_size;
+        len = end * eeprom->page_size;
+        if (len > eeprom->size)
+        {
+            len = eeprom->size;
+        }
+        len -= offset;
+
+        eeprom_wait_write_cycle(eeprom);
+        eeprom->stats.device_reads++;
+        if (eeprom_pread_all(eeprom->fd, &eeprom->data[offset], len,
+                             offset) < 0)
+        {
+            fprintf(stderr, "Failed to read EEPROM: %s\n", strerror(errno));
+            return FAILURE;
+        }
+
+        now_ms = monotonic_ms();
+        for (; page < end; page++)
+        {
+            eeprom->pages[page].valid = 1;
+            eeprom->pages[page].loaded_ms = now_ms;
+        }
+    }
+    return SUCCESS;
+}
+
+static int eeprom_range_is_valid(const i2c_eeprom_t* eeprom, uint32_t offset,
+                                 uint32_t len)
+{
+    return len > 0 && offset < eeprom->size && len <= eeprom->size - offset;
+}
+
 /**
- *  @brief Function of getting EEPROM data on i2c bus
+ *  @brief Open EEPROM file (e.g. sysfs eeprom of at24 driver) for cached
+ *         access
+ *
+ *  @param path: Path to EEPROM file
+ *  @param config: Settings of the handle, NULL for defaults
+ *
+ *  @return EEPROM handle, NULL on failure
+ **/
+i2c_eeprom_t* i2cEEPROMOpenPath(const char* path,
+                                const i2c_eeprom_config_t* config)
+{
+    i2c_eeprom_config_t defaults = {0};
+    i2c_eeprom_t* eeprom;
+    struct stat st;
+    int fd;
+
+    if (NULL == config)
+    {
+        config = &defaults;
+    }
+    if (config->page_size > EEPROM_MAX_PAGE_SIZE)
+    {
+        fprintf(stderr, "Invalid EEPROM page size %u\n", config->page_size);
+        return NULL;
+    }
+
+    fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd < 0 && (errno == EACCES || errno == EROFS))
+    {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0)
+    {
+        fprintf(stderr, "eeprom: Unable to open the file %s\n", path);
+        return NULL;
+    }
+
+    eeprom = (i2c_eeprom_t*)calloc(1, sizeof(*eeprom));
+    if (NULL == eeprom)
+    {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        close(fd);
+        return NULL;
+    }
+    eeprom->fd = fd;
+    eeprom->size = config->size;
+    if (0 == eeprom->size && fstat(fd, &st) == 0)
+    {
+        eeprom->size = st.st_size;
+    }
+    eeprom->page_size = config->page_size ? config->page_size
+                                          : EEPROM_DEFAULT_PAGE_SIZE;
+    eeprom->write_cycle_us = config->write_cycle_us;
+    eeprom->cache_ttl_ms = config->cache_ttl_ms ? config->cache_ttl_ms
+                                                : EEPROM_DEFAULT_CACHE_TTL_MS;
+    eeprom->page_count =
+        (eeprom->size + eeprom->page_size - 1) / eeprom->page_size;
+
+    if (0 == eeprom->size)
+    {
+        fprintf(stderr, "eeprom: Unknown size of %s\n", path);
+        i2cEEPROMClose(eeprom);
+        return NULL;
+    }
+
+    eeprom->data = (uint8_t*)malloc(eeprom->size);
+    eeprom->pages = (struct i2c_eeprom_page*)calloc(eeprom->page_count,
+                                                    sizeof(eeprom->pages[0]));
+    if (NULL == eeprom->data || NULL == eeprom->pages)
+    {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        i2cEEPROMClose(eeprom);
+        return NULL;
+    }
+
+    return eeprom;
+}
+
+/**
+ *  @brief Open EEPROM on i2c bus for cached access
  *
  *  @param i2cbus: The i2c bus number of EEPROM
  *  @param i2caddr: The i2c address (7-bit) of EEPROM
+ *  @param config: Settings of the handle, NULL for defaults
+ *
+ *  @return EEPROM handle, NULL on failure
+ **/
+i2c_eeprom_t* i2cEEPROMOpen(const char* i2cbus, const char* i2caddr,
+                            const i2c_eeprom_config_t* config)
+{
+    char eeprom_path[64] = {0};
+
+    eeprom_sysfs_path(eeprom_path, sizeof(eeprom_path), i2cbus, i2caddr);
+    return i2cEEPROMOpenPath(eeprom_path, config);
+}
+
+/**
+ *  @brief Read EEPROM data, from the cache when possible
+ *
+ *  @param eeprom: EEPROM handle
  *  @param offset: Offset to target location
  *  @param len: The data length retrieved from target location
  *  @param buffer: The data buffer of returned data
@@ -177,107 +453,333 @@ int i2c_slave_clear_buffer(int file)
  *      0: Success
  *      others: Fail
  **/
-uint8_t i2cEEPROMGet(const char* i2cbus, const char* i2caddr, uint32_t offset,
-                     uint8_t len, uint8_t* buffer)
+uint8_t i2cEEPROMRead(i2c_eeprom_t* eeprom, uint32_t offset, uint32_t len,
+                      uint8_t* buffer)
 {
-    uint8_t status = SUCCESS;
-    char eeprom_path[64] = {0};
-    FILE *eeprom_fp;
-    uint8_t* ptr = NULL;
-    uint8_t result, unit = 1;
+    uint32_t first, last, page;
+    uint64_t now_ms;
 
-    ptr = (uint8_t*)malloc(sizeof(uint8_t)*len);
-    if (NULL == ptr)
+    if (0 == len)
     {
-        fprintf(stderr, "Failed to allocate memory.\n");
+        return SUCCESS;
+    }
+    if (!eeprom_range_is_valid(eeprom, offset, len))
+    {
+        fprintf(stderr, "Invalid EEPROM range %u+%u\n", offset, len);
         return FAILURE;
     }
 
-    sprintf(eeprom_path, "/sys/bus/i2c/devices/%s-00%s/eeprom", i2cbus, i2caddr);
+    first = offset / eeprom->page_size;
+    last = (offset + len - 1) / eeprom->page_size;
+    now_ms = monotonic_ms();
+    for (page = first; page <= last; page++)
+    {
+        if (!eeprom_page_is_fresh(eeprom, page, now_ms))
+        {
+            break;
+        }
+    }
 
-    // Open EEPROM bin file
-    eeprom_fp = fopen(eeprom_path, "rb");
-    if (NULL == eeprom_fp)
+    if (page > last)
+    {
+        eeprom->stats.cache_hits++;
+    }
+    else if (eeprom_load_pages(eeprom, page, last) != SUCCESS)
     {
-        fprintf(stderr, "eeprom_fp: Unable to open the file %s\n", eeprom_path);
+        return FAILURE;
+    }
+
+    memcpy(buffer, &eeprom->data[offset], len);
+    return SUCCESS;
+}
+
+/**
+ *  @brief Write EEPROM data to the cache, it's written to the device by
+ *         i2cEEPROMFlush() or i2cEEPROMClose()
+ *
+ *  @param eeprom: EEPROM handle
+ *  @param offset: Offset to target location
+ *  @param len: The data length written to target location
+ *  @param buffer: The data buffer to write
+ *
+ *  @return Status of writing EEPROM data.
+ *      0: Success
+ *      others: Fail
+ **/
+uint8_t i2cEEPROMWrite(i2c_eeprom_t* eeprom, uint32_t offset, uint32_t len,
+                       const uint8_t* buffer)
+{
+    uint32_t first, last, page, lo, hi;
+    struct i2c_eeprom_page* p;
+    uint64_t now_ms;
 
-        free(ptr);
+    if (0 == len)
+    {
+        return SUCCESS;
+    }
+    if (!eeprom_range_is_valid(eeprom, offset, len))
+    {
+        fprintf(stderr, "Invalid EEPROM range %u+%u\n", offset, len);
+        return FAILURE;
+    }
 
+    /*
+     * Only the first and the last page can be written partially, they
+     * are read first so that whole pages are cached.
+     */
+    first = offset / eeprom->page_size;
+    last = (offset + len - 1) / eeprom->page_size;
+    if (offset % eeprom->page_size != 0 &&
+        eeprom_load_pages(eeprom, first, first) != SUCCESS)
+    {
+        return FAILURE;
+    }
+    if ((offset + len) % eeprom->page_size != 0 &&
+        (offset + len) != eeprom->size &&
+        eeprom_load_pages(eeprom, last, last) != SUCCESS)
+    {
         return FAILURE;
     }
 
-    fseek(eeprom_fp, offset, SEEK_SET);
+    memcpy(&eeprom->data[offset], buffer, len);
 
-    result = fread(ptr, unit, len, eeprom_fp);
-    if (result != (len * unit))
+    now_ms = monotonic_ms();
+    for (page = first; page <= last; page++)
     {
-        fprintf(stderr, "Failed to read EEPROM.\n");
+        p = &eeprom->pages[page];
+        lo = page == first ? offset % eeprom->page_size : 0;
+        hi = page == last ? (offset + len - 1) % eeprom->page_size + 1
+                          : eeprom->page_size;
+        if (p->dirty_hi > p->dirty_lo)
+        {
+            lo = lo < p->dirty_lo ? lo : p->dirty_lo;
+            hi = hi > p->dirty_hi ? hi : p->dirty_hi;
+        }
+        p->dirty_lo = lo;
+        p->dirty_hi = hi;
+        p->valid = 1;
+        p->loaded_ms = now_ms;
+    }
+    return SUCCESS;
+}
+
+/**
+ *  @brief Write dirty pages to the device, one burst per page
+ *
+ *  @param eeprom: EEPROM handle
+ *
+ *  @return Status of writing EEPROM data.
+ *      0: Success
+ *      others: Fail
+ **/
+uint8_t i2cEEPROMFlush(i2c_eeprom_t* eeprom)
+{
+    struct i2c_eeprom_page* p;
+    uint32_t page, offset;
 
-        fclose(eeprom_fp);
+    for (page = 0; page < eeprom->page_count; page++)
+    {
+        p = &eeprom->pages[page];
+        if (p->dirty_hi <= p->dirty_lo)
+        {
+            continue;
+        }
 
-        free(ptr);
+        offset = page * eeprom->page_size + p->dirty_lo;
+        eeprom_wait_write_cycle(eeprom);
+        eeprom->stats.device_writes++;
+        if (eeprom_pwrite_all(eeprom->fd, &eeprom->data[offset],
+                              p->dirty_hi - p->dirty_lo, offset) < 0)
+        {
+            fprintf(stderr, "Failed to write EEPROM: %s\n", strerror(errno));
+            return FAILURE;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &eeprom->last_write);
 
-        return FAILURE;
+        p->dirty_lo = 0;
+        p->dirty_hi = 0;
     }
+    return SUCCESS;
+}
 
-    memcpy(buffer, ptr, len);
+/*
+ * Forget data not written to the device, so the next read loads the
+ * pages from the device again instead of returning the failed write.
+ */
+static void eeprom_discard_dirty(i2c_eeprom_t* eeprom)
+{
+    struct i2c_eeprom_page* p;
+    uint32_t page;
+
+    for (page = 0; page < eeprom->page_count; page++)
+    {
+        p = &eeprom->pages[page];
+        if (p->dirty_hi > p->dirty_lo)
+        {
+            p->dirty_lo = 0;
+            p->dirty_hi = 0;
+            p->valid = 0;
+        }
+    }
+}
 
-    fclose(eeprom_fp);
+/**
+ *  @brief Drop cached pages, e.g. after the EEPROM was written by another
+ *         process. Pages not written to the device yet are kept.
+ *
+ *  @param eeprom: EEPROM handle
+ **/
+void i2cEEPROMInvalidate(i2c_eeprom_t* eeprom)
+{
+    uint32_t page;
 
-    free(ptr);
+    for (page = 0; page < eeprom->page_count; page++)
+    {
+        if (eeprom->pages[page].dirty_hi <= eeprom->pages[page].dirty_lo)
+        {
+            eeprom->pages[page].valid = 0;
+        }
+    }
+}
 
-    return status;
+void i2cEEPROMGetStats(const i2c_eeprom_t* eeprom, i2c_eeprom_stats_t* stats)
+{
+    *stats = eeprom->stats;
 }
 
-uint8_t i2cEEPROMSet(const char* i2cbus, const char* i2caddr, uint32_t offset,
-                     uint8_t len, uint8_t* buffer)
+uint32_t i2cEEPROMSize(const i2c_eeprom_t* eeprom)
+{
+    return eeprom->size;
+}
+
+/**
+ *  @brief Write dirty pages and release the EEPROM handle
+ *
+ *  @param eeprom: EEPROM handle
+ *
+ *  @return Status of writing EEPROM data.
+ *      0: Success
+ *      others: Fail
+ **/
+uint8_t i2cEEPROMClose(i2c_eeprom_t* eeprom)
 {
     uint8_t status = SUCCESS;
 
-    char eeprom_path[64] = {0};
-    FILE *eeprom_fp;
-    uint8_t* ptr = NULL;
-    uint8_t result, unit = 1;
+    if (NULL == eeprom)
+    {
+        return SUCCESS;
+    }
 
-    ptr = (uint8_t*)malloc(sizeof(uint8_t)*len);
-    if (NULL == ptr)
+    if (NULL != eeprom->pages)
     {
-        fprintf(stderr, "Failed to allocate memory.\n");
-        return FAILURE;
+        status = i2cEEPROMFlush(eeprom);
     }
+    close(eeprom->fd);
+    free(eeprom->pages);
+    free(eeprom->data);
+    free(eeprom);
+    return status;
+}
 
-    memcpy(ptr, buffer, len);
+/*
+ * i2cEEPROMGet() and i2cEEPROMSet() share one handle per EEPROM, kept
+ * open for the lifetime of the process.
+ */
+struct eeprom_shared_handle
+{
+    char path[64];
+    i2c_eeprom_t* eeprom;
+    struct eeprom_shared_handle* next;
+};
 
-    sprintf(eeprom_path, "/sys/bus/i2c/devices/%s-00%s/eeprom", i2cbus, i2caddr);
+static pthread_mutex_t eeprom_shared_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct eeprom_shared_handle* eeprom_shared_handles;
 
-    // Open EEPROM bin file
-    eeprom_fp = fopen(eeprom_path, "wb");
-    if (NULL == eeprom_fp)
-    {
-        fprintf(stderr, "eeprom_fp: Unable to open the file %s\n", eeprom_path);
+static i2c_eeprom_t* eeprom_shared_get(const char* i2cbus, const char* i2caddr)
+{
+    struct eeprom_shared_handle* handle;
+    char eeprom_path[64] = {0};
 
-        free(ptr);
+    eeprom_sysfs_path(eeprom_path, sizeof(eeprom_path), i2cbus, i2caddr);
+    for (handle = eeprom_shared_handles; handle; handle = handle->next)
+    {
+        if (strcmp(handle->path, eeprom_path) == 0)
+        {
+            return handle->eeprom;
+        }
+    }
 
-        return FAILURE;
+    handle = (struct eeprom_shared_handle*)calloc(1, sizeof(*handle));
+    if (NULL == handle)
+    {
+        fprintf(stderr, "Failed to allocate memory.\n");
+        return NULL;
+    }
+    handle->eeprom = i2cEEPROMOpenPath(eeprom_path, NULL);
+    if (NULL == handle->eeprom)
+    {
+        free(handle);
+        return NULL;
     }
+    strcpy(handle->path, eeprom_path);
+    handle->next = eeprom_shared_handles;
+    eeprom_shared_handles = handle;
+    return handle->eeprom;
+}
 
-    fseek(eeprom_fp, offset, SEEK_SET);
+/**
+ *  @brief Function of getting EEPROM data on i2c bus. Data is served from
+ *         the cache of the shared handle, so changes made by other
+ *         processes are seen after up to EEPROM_DEFAULT_CACHE_TTL_MS.
+ *
+ *  @param i2cbus: The i2c bus number of EEPROM
+ *  @param i2caddr: The i2c address (7-bit) of EEPROM
+ *  @param offset: Offset to target location
+ *  @param len: The data length retrieved from target location
+ *  @param buffer: The data buffer of returned data
+ *
+ *  @return Status of fetching EEPROM data.
+ *      0: Success
+ *      others: Fail
+ **/
+uint8_t i2cEEPROMGet(const char* i2cbus, const char* i2caddr, uint32_t offset,
+                     uint8_t len, uint8_t* buffer)
+{
+    uint8_t status = FAILURE;
+    i2c_eeprom_t* eeprom;
 
-    result = fwrite(ptr, unit, len, eeprom_fp);
-    if (result != (len * unit))
+    pthread_mutex_lock(&eeprom_shared_lock);
+    eeprom = eeprom_shared_get(i2cbus, i2caddr);
+    if (NULL != eeprom)
     {
-        fprintf(stderr, "Failed to write EEPROM.\n");
+        status = i2cEEPROMRead(eeprom, offset, len, buffer);
+    }
+    pthread_mutex_unlock(&eeprom_shared_lock);
 
-        fclose(eeprom_fp);
+    return status;
+}
 
-        free(ptr);
+uint8_t i2cEEPROMSet(const char* i2cbus, const char* i2caddr, uint32_t offset,
+                     uint8_t len, uint8_t* buffer)
+{
+    uint8_t status = FAILURE;
+    i2c_eeprom_t* eeprom;
 
-        return FAILURE;
+    pthread_mutex_lock(&eeprom_shared_lock);
+    eeprom = eeprom_shared_get(i2cbus, i2caddr);
+    if (NULL != eeprom)
+    {
+        status = i2cEEPROMWrite(eeprom, offset, len, buffer);
+        if (SUCCESS == status)
+        {
+            status = i2cEEPROMFlush(eeprom);
+            if (SUCCESS != status)
+            {
+                eeprom_discard_dirty(eeprom);
+            }
+        }
     }
-
-    fclose(eeprom_fp);
-
-    free(ptr);
+    pthread_mutex_unlock(&eeprom_shared_lock);
 
     return status;
 }
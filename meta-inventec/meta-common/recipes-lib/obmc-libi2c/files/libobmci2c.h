@@ -26,6 +26,37 @@ extern "C" {
 #define CLR_SLAVE_BUF_SIZE 1
 #define IOCTL_CLR_SLAVE_BUF 0x0F
 
+#define EEPROM_DEFAULT_PAGE_SIZE 32
+#define EEPROM_MAX_PAGE_SIZE 256
+#define EEPROM_DEFAULT_CACHE_TTL_MS 1000
+#define EEPROM_CACHE_TTL_INFINITE UINT32_MAX
+
+/*
+ * Settings of an EEPROM handle, zero fields select the defaults.
+ *  size: EEPROM size in bytes, 0 to use the size of the file
+ *  page_size: write page size in bytes, which is also the granularity of
+ *             the read cache (at most EEPROM_MAX_PAGE_SIZE)
+ *  write_cycle_us: time the device needs to complete a page write (tWR).
+ *                  The at24 driver already waits for it on sysfs eeprom
+ *                  files, so it is only needed for other devices.
+ *  cache_ttl_ms: time after which cached pages are read from the device
+ *                again, or EEPROM_CACHE_TTL_INFINITE
+ */
+typedef struct i2c_eeprom_config {
+    uint32_t size;
+    uint32_t page_size;
+    uint32_t write_cycle_us;
+    uint32_t cache_ttl_ms;
+} i2c_eeprom_config_t;
+
+typedef struct i2c_eeprom_stats {
+    uint64_t cache_hits;    /* reads served entirely from the cache */
+    uint64_t device_reads;  /* read bursts issued to the device */
+    uint64_t device_writes; /* page writes issued to the device */
+} i2c_eeprom_stats_t;
+
+typedef struct i2c_eeprom i2c_eeprom_t;
+
 uint8_t i2c_smbus_pec(uint8_t crc, uint8_t *p, size_t count);
 int open_i2c_dev(int i2cbus, char *filename, size_t size, int quiet);
 int open_i2c_slave_dev(int i2cbus, int bmc_addr);
@@ -38,10 +69,38 @@ int i2c_master_write(int file, uint8_t slave_addr,
                      uint8_t tx_cnt, uint8_t* tx_buf);
 int i2c_slave_read(int file, uint8_t* rx_buf);
 int i2c_slave_clear_buffer(int file);
+/*
+ * i2cEEPROMGet() and i2cEEPROMSet() use one cached handle per EEPROM, shared
+ * within the process. Writes made by this process are seen at once, but
+ * data written to the EEPROM by another process may be returned stale for
+ * up to EEPROM_DEFAULT_CACHE_TTL_MS. Use a separate handle with a shorter
+ * cache_ttl_ms, or i2cEEPROMInvalidate(), when that matters. Zero length
+ * reads and writes succeed without accessing the device.
+ */
 uint8_t i2cEEPROMGet(const char* i2cbus, const char* i2caddr, uint32_t offset,
                      uint8_t len, uint8_t* buffer);
 uint8_t i2cEEPROMSet(const char* i2cbus, const char* i2caddr, uint32_t offset,
                      uint8_t len, uint8_t* buffer);
+
+/*
+ * EEPROM handle API: the device stays open and its content is cached by
+ * pages. Writes update the cache and are written to the device by
+ * i2cEEPROMFlush() or i2cEEPROMClose(), one page-aligned burst per dirty
+ * page. A handle must not be used by several threads at once.
+ */
+i2c_eeprom_t* i2cEEPROMOpen(const char* i2cbus, const char* i2caddr,
+                            const i2c_eeprom_config_t* config);
+i2c_eeprom_t* i2cEEPROMOpenPath(const char* path,
+                                const i2c_eeprom_config_t* config);
+uint8_t i2cEEPROMRead(i2c_eeprom_t* eeprom, uint32_t offset, uint32_t len,
+                      uint8_t* buffer);
+uint8_t i2cEEPROMWrite(i2c_eeprom_t* eeprom, uint32_t offset, uint32_t len,
+                       const uint8_t* buffer);
+uint8_t i2cEEPROMFlush(i2c_eeprom_t* eeprom);
+void i2cEEPROMInvalidate(i2c_eeprom_t* eeprom);
+void i2cEEPROMGetStats(const i2c_eeprom_t* eeprom, i2c_eeprom_stats_t* stats);
+uint32_t i2cEEPROMSize(const i2c_eeprom_t* eeprom);
+uint8_t i2cEEPROMClose(i2c_eeprom_t* eeprom);
 #ifdef  __cplusplus
 }
 #endif
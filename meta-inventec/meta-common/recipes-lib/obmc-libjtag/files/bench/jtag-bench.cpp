@@ -0,0 +1,285 @@
+/*
+ * Benchmark of CPLD user code reads and page programming on a simulated
+ * chain of Lattice CPLDs, comparing the request sequence of the per call
+ * JTAG access with the batched JTAG session. Driver requests and the time
+ * they would take on the wire are counted by the loopback backend.
+ *
+ * Build with "make jtag-bench" and run "./jtag-bench".
+ */
+
+#include "../libobmcjtagsession.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+constexpr uint32_t benchCplds = 4;
+constexpr uint32_t benchReads = 1000;
+constexpr uint32_t benchPages = 2000;
+constexpr uint32_t latticeIrLength = 8;
+constexpr uint32_t programInstruction = 0x70;
+constexpr uint32_t pageLength = JtagLoopbackBackend::dataLength;
+
+static std::vector<JtagLoopbackBackend::Device> benchChain()
+{
+    std::vector<JtagLoopbackBackend::Device> devices;
+
+    for (uint32_t i = 0; i < benchCplds; i++)
+    {
+        devices.push_back({latticeIrLength, 0x012BB043, 0xC0DE0000 + i});
+    }
+    return devices;
+}
+
+/* Chain-wide IR scan loading instruction into device, BYPASS elsewhere. */
+static int perCallIr(JtagBackend& backend, uint32_t device,
+                     uint32_t instruction)
+{
+    JtagScan scan = {JTAG_SIR_XFER, JTAG_WRITE_XFER, JTAG_STATE_IDLE,
+                     benchCplds * latticeIrLength, {}};
+
+    scan.tdio.assign((scan.length + 31) / 32, 0xFFFFFFFF);
+    uint32_t offset = device * latticeIrLength;
+    scan.tdio[offset / 32] &= ~(0xFFu << (offset % 32));
+    scan.tdio[offset / 32] |= instruction << (offset % 32);
+    return backend.xfer(scan);
+}
+
+/* DR scan of device, the others in BYPASS shift one bit each. */
+static int perCallDr(JtagBackend& backend, uint32_t device, uint32_t length,
+                     const uint32_t* tdi, uint32_t* tdo)
+{
+    JtagScan scan = {JTAG_SDR_XFER, JTAG_READ_WRITE_XFER, JTAG_STATE_IDLE,
+                     length + benchCplds - 1, {}};
+
+    scan.tdio.assign((scan.length + 31) / 32 + 1, 0);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t bit = tdi ? (tdi[i / 32] >> (i % 32)) & 1 : 0;
+        uint32_t pos = device + i;
+        scan.tdio[pos / 32] |= bit << (pos % 32);
+    }
+    if (backend.xfer(scan) < 0)
+    {
+        return -1;
+    }
+    for (uint32_t i = 0; tdo && i < length; i++)
+    {
+        uint32_t pos = device + i;
+        tdo[i / 32] &= ~(1u << (i % 32));
+        tdo[i / 32] |= ((scan.tdio[pos / 32] >> (pos % 32)) & 1) << (i % 32);
+    }
+    return 0;
+}
+
+/* Same requests as getCpldUserCode() before the session, per CPLD. */
+static int perCallUserCodes(JtagBackend& backend, uint32_t* codes)
+{
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        if (backend.setTapState(1, JTAG_STATE_IDLE, 2) < 0 ||
+            perCallIr(backend, device,
+                      JtagLoopbackBackend::usercodeInstruction) < 0 ||
+            backend.setTapState(0, JTAG_STATE_IDLE, 2) < 0 ||
+            perCallDr(backend, device, 32, NULL, &codes[device]) < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Same requests as getCpldUserCodes() on its persistent session. */
+static int sessionUserCodes(JtagSession& session, uint32_t* codes)
+{
+    if (session.reset(2) < 0)
+    {
+        return -1;
+    }
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        session.queueIr(device, JtagLoopbackBackend::usercodeInstruction, 2);
+    }
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        session.queueDr(device, 32, NULL, &codes[device], 2);
+    }
+    return session.execute();
+}
+
+/* One page written to every CPLD, a device at a time. */
+static int perCallPage(JtagBackend& backend, const uint32_t* page)
+{
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        if (perCallIr(backend, device, programInstruction) < 0 ||
+            backend.setTapState(0, JTAG_STATE_IDLE, 2) < 0 ||
+            perCallDr(backend, device, pageLength, page, NULL) < 0 ||
+            backend.setTapState(0, JTAG_STATE_IDLE, 2) < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int sessionPage(JtagSession& session, const uint32_t* page)
+{
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        session.queueIr(device, programInstruction, 2);
+        session.queueDr(device, pageLength, page, NULL, 2);
+    }
+    return session.execute();
+}
+
+static bool checkUserCodes(const uint32_t* codes)
+{
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        if (codes[device] != 0xC0DE0000 + device)
+        {
+            std::cerr << "CPLD " << device << " user code " << std::hex
+                      << codes[device] << std::dec << " is wrong.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The data register of every CPLD holds the last page written. */
+static bool checkLastPage(JtagSession& session, const uint32_t* page)
+{
+    std::vector<uint32_t> readback(benchCplds * pageLength / 32);
+
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        session.queueIr(device, programInstruction);
+        session.queueDr(device, pageLength, page,
+                        &readback[device * pageLength / 32]);
+    }
+    if (session.execute() < 0)
+    {
+        return false;
+    }
+    for (uint32_t device = 0; device < benchCplds; device++)
+    {
+        for (uint32_t i = 0; i < pageLength / 32; i++)
+        {
+            if (readback[device * pageLength / 32 + i] != page[i])
+            {
+                std::cerr << "CPLD " << device << " page data is wrong.\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void report(const char* name, const JtagLoopbackBackend& backend,
+                   std::chrono::steady_clock::duration elapsed)
+{
+    const auto& stats = backend.getStats();
+
+    std::cout << name << ": " << stats.requests << " requests, "
+              << stats.bits << " bits, "
+              << stats.simulatedNs / 1000000.0 << " ms simulated, "
+              << std::chrono::duration<double, std::milli>(elapsed).count()
+              << " ms cpu\n";
+}
+
+int main()
+{
+    std::vector<uint32_t> codes(benchCplds);
+    std::vector<uint32_t> page(pageLength / 32);
+
+    std::cout << benchCplds << " CPLDs, " << benchReads
+              << " user code reads of all of them\n";
+    {
+        JtagLoopbackBackend backend(benchChain());
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < benchReads; i++)
+        {
+            if (perCallUserCodes(backend, codes.data()) < 0 ||
+                !checkUserCodes(codes.data()))
+            {
+                return 1;
+            }
+        }
+        report("  per call", backend, std::chrono::steady_clock::now() - start);
+    }
+    {
+        auto loopback = std::make_unique<JtagLoopbackBackend>(benchChain());
+        const JtagLoopbackBackend& backend = *loopback;
+        JtagSession session(std::move(loopback),
+                            std::vector<uint32_t>(benchCplds,
+                                                  latticeIrLength));
+        auto start = std::chrono::steady_clock::now();
+
+        if (session.reset() < 0)
+        {
+            return 1;
+        }
+        for (uint32_t i = 0; i < benchReads; i++)
+        {
+            if (sessionUserCodes(session, codes.data()) < 0 ||
+                !checkUserCodes(codes.data()))
+            {
+                return 1;
+            }
+        }
+        report("  session ", backend, std::chrono::steady_clock::now() - start);
+    }
+
+    std::cout << benchPages << " pages of " << pageLength
+              << " bits programmed to all of them\n";
+    {
+        JtagLoopbackBackend backend(benchChain());
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < benchPages; i++)
+        {
+            std::fill(page.begin(), page.end(), i * 0x9E3779B9);
+            if (perCallPage(backend, page.data()) < 0)
+            {
+                return 1;
+            }
+        }
+        report("  per call", backend, std::chrono::steady_clock::now() - start);
+    }
+    {
+        auto loopback = std::make_unique<JtagLoopbackBackend>(benchChain());
+        const JtagLoopbackBackend& backend = *loopback;
+        JtagSession session(std::move(loopback),
+                            std::vector<uint32_t>(benchCplds,
+                                                  latticeIrLength));
+        auto start = std::chrono::steady_clock::now();
+
+        if (session.reset() < 0)
+        {
+            return 1;
+        }
+        for (uint32_t i = 0; i < benchPages; i++)
+        {
+            std::fill(page.begin(), page.end(), i * 0x9E3779B9);
+            if (sessionPage(session, page.data()) < 0)
+            {
+                return 1;
+            }
+        }
+        report("  session ", backend, std::chrono::steady_clock::now() - start);
+
+        const auto& stats = session.getStats();
+        std::cout << "  session skipped " << stats.skippedIrScans
+                  << " of " << stats.irScans + stats.skippedIrScans
+                  << " IR scans\n";
+        if (!checkLastPage(session, page.data()))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -5,14 +5,32 @@
 #include <sys/stat.h>
 #include <linux/jtag.h>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "libobmcjtag.hpp"
+#include "libobmcjtagsession.hpp"
 #include "libobmccpld.hpp"
 
 constexpr const uint32_t latticeIrWtLen = 8;
 constexpr const uint32_t latticeDrRdLen = 32;
 
-int getCpldUserCode(uint8_t part, uint32_t* buffer)
+/*
+ * The JTAG master is kept open between calls and reopened after a failure,
+ * e.g. when another process releasing it disabled its outputs.
+ */
+static std::mutex sessionMutex;
+static std::unique_ptr<JtagSession> session;
+
+/**
+ *  @part:   CPLD part providor
+ *  @count:  number of CPLDs on the JTAG chain
+ *  @buffer: user codes, from the CPLD nearest to TDO
+ *
+ *  User codes of all the CPLDs are read with one IR and one DR scan.
+*/
+int getCpldUserCodes(uint8_t part, uint32_t count, uint32_t* buffer)
 {
     uint32_t jtagIrWtLen = 0;
     uint32_t jtagDrRdLen = 0;
@@ -33,42 +51,54 @@ int getCpldUserCode(uint8_t part, uint32_t* buffer)
             return -1;
     }
 
-    int jtagFd = open_jtag_dev();
-    if (jtagFd < 0)
+    if (count == 0 || buffer == NULL)
     {
-        std::cerr << "Error in " << __FUNCTION__ << " in " << __LINE__ << "\n";
         return -1;
     }
 
-    // Reset to idle/run-test state and stay in 2 tcks
-    jtag_interface_end_tap_state(jtagFd, 1, JTAG_STATE_IDLE, 2);
-
-    int ret = -1;
-    ret = jtag_interface_xfer(jtagFd, JTAG_SIR_XFER, JTAG_WRITE_XFER,
-                              JTAG_STATE_IDLE, jtagIrWtLen, &jtagCmd);
-    if (ret < 0)
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (!session)
+    {
+        session = JtagSession::open(std::vector<uint32_t>(count, jtagIrWtLen));
+    }
+    else
     {
-         std::cerr << "Error in " << __FUNCTION__ << " in " << __LINE__ << "\n";
-         close_jtag_dev(jtagFd);
-         return -1;
+        session->setChain(std::vector<uint32_t>(count, jtagIrWtLen));
     }
 
-    // Go to idle/run-test state and stay in 2 tcks
-    jtag_interface_end_tap_state(jtagFd, 0, JTAG_STATE_IDLE, 2);
+    // Other processes may have used the chain since the last call, so the
+    // TAP is reset and stays in idle/run-test state for 2 tcks
+    if (!session || session->reset(2) < 0)
+    {
+        session = nullptr;
+        std::cerr << "Error in " << __FUNCTION__ << " in " << __LINE__ << "\n";
+        return -1;
+    }
 
-    uint32_t result = 0;
-    ret = jtag_interface_xfer(jtagFd, JTAG_SDR_XFER, JTAG_READ_XFER,
-                              JTAG_STATE_IDLE, jtagDrRdLen, &result);
-    if (ret < 0)
+    // Stay in idle/run-test state for 2 tcks after each scan
+    std::vector<uint32_t> result(count, 0);
+    for (uint32_t i = 0; i < count; i++)
     {
-         std::cerr << "Error in " << __FUNCTION__ << " in " << __LINE__ << "\n";
-         close_jtag_dev(jtagFd);
-         return -1;
+        session->queueIr(i, jtagCmd, 2);
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        session->queueDr(i, jtagDrRdLen, NULL, &result[i], 2);
     }
 
-    close_jtag_dev(jtagFd);
+    if (session->execute() < 0)
+    {
+        session = nullptr;
+        std::cerr << "Error in " << __FUNCTION__ << " in " << __LINE__ << "\n";
+        return -1;
+    }
 
-    std::memcpy(buffer, &result, sizeof(uint32_t));
+    std::memcpy(buffer, result.data(), count * sizeof(uint32_t));
 
     return 0;
 }
+
+int getCpldUserCode(uint8_t part, uint32_t* buffer)
+{
+    return getCpldUserCodes(part, 1, buffer);
+}
@@ -13,3 +13,4 @@ enum lattice_op_cmd : uint8_t
 };
 
 int getCpldUserCode(uint8_t part, uint32_t* buffer);
+int getCpldUserCodes(uint8_t part, uint32_t count, uint32_t* buffer);
@@ -0,0 +1,565 @@
+
+#include <algorithm>
+#include <iostream>
+#include <linux/jtag.h>
+
+#include "libobmcjtag.hpp"
+#include "libobmcjtagsession.hpp"
+
+static uint32_t wordsOf(uint32_t bits)
+{
+    return (bits + 31) / 32;
+}
+
+static uint32_t maskOf(uint32_t bits)
+{
+    return bits >= 32 ? 0xFFFFFFFF : (1u << bits) - 1;
+}
+
+/* Copy length bits of src (zeros if src is NULL) to dst at offset. */
+static void putBits(std::vector<uint32_t>& dst, uint32_t offset,
+                    const uint32_t* src, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t bit = src ? (src[i / 32] >> (i % 32)) & 1 : 0;
+        uint32_t pos = offset + i;
+
+        dst[pos / 32] &= ~(1u << (pos % 32));
+        dst[pos / 32] |= bit << (pos % 32);
+    }
+}
+
+/* Copy length bits of src at offset to dst. */
+static void getBits(const std::vector<uint32_t>& src, uint32_t offset,
+                    uint32_t* dst, uint32_t length)
+{
+    std::fill(dst, dst + wordsOf(length), 0);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t pos = offset + i;
+
+        dst[i / 32] |= ((src[pos / 32] >> (pos % 32)) & 1) << (i % 32);
+    }
+}
+
+std::unique_ptr<JtagDeviceBackend> JtagDeviceBackend::open()
+{
+    int fd = open_jtag_dev();
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<JtagDeviceBackend>(new JtagDeviceBackend(fd));
+}
+
+JtagDeviceBackend::JtagDeviceBackend(int fd) : fd(fd)
+{
+}
+
+JtagDeviceBackend::~JtagDeviceBackend()
+{
+    close_jtag_dev(fd);
+}
+
+int JtagDeviceBackend::setTapState(uint8_t reset, uint8_t endstate,
+                                   uint8_t tck)
+{
+    return jtag_interface_end_tap_state(fd, reset, endstate, tck);
+}
+
+int JtagDeviceBackend::xfer(JtagScan& scan)
+{
+    return jtag_interface_xfer(fd, scan.type, scan.direction, scan.endstate,
+                               scan.length, scan.tdio.data());
+}
+
+int JtagDeviceBackend::setFreq(unsigned int freq)
+{
+    return jtag_interface_set_freq(fd, freq);
+}
+
+JtagLoopbackBackend::JtagLoopbackBackend(std::vector<Device> devices,
+                                         unsigned int freq,
+                                         uint32_t requestNs) :
+    freq(freq), requestNs(requestNs)
+{
+    for (const auto& device : devices)
+    {
+        chain.push_back({device, idcodeInstruction,
+                         std::vector<uint32_t>(wordsOf(dataLength), 0)});
+    }
+}
+
+void JtagLoopbackBackend::account(uint64_t bits)
+{
+    stats.requests++;
+    stats.bits += bits;
+    stats.simulatedNs += requestNs + bits * 1000000000ULL / freq;
+}
+
+uint32_t JtagLoopbackBackend::drLength(const DeviceState& device) const
+{
+    if (device.ir == maskOf(device.device.irLength))
+    {
+        return 1;
+    }
+    if (device.ir == idcodeInstruction || device.ir == usercodeInstruction)
+    {
+        return 32;
+    }
+    return dataLength;
+}
+
+int JtagLoopbackBackend::setTapState(uint8_t reset, uint8_t endstate,
+                                     uint8_t tck)
+{
+    if (reset)
+    {
+        for (auto& device : chain)
+        {
+            device.ir = idcodeInstruction;
+        }
+    }
+
+    // TMS sequence of Test-Logic-Reset and the way to the end state
+    account((reset ? 6 : 3) + tck);
+    return endstate == JTAG_STATE_IDLE ? 0 : -1;
+}
+
+int JtagLoopbackBackend::xfer(JtagScan& scan)
+{
+    uint32_t total = 0;
+
+    for (const auto& device : chain)
+    {
+        total += scan.type == JTAG_SIR_XFER ? device.device.irLength
+                                            : drLength(device);
+    }
+    if (scan.length != total || scan.tdio.size() < wordsOf(total))
+    {
+        std::cerr << "Loopback JTAG scan of " << scan.length
+                  << " bits, chain expects " << total << ".\n";
+        return -1;
+    }
+
+    std::vector<uint32_t> tdo(scan.tdio.size(), 0);
+    uint32_t offset = 0;
+    for (auto& device : chain)
+    {
+        if (scan.type == JTAG_SIR_XFER)
+        {
+            uint32_t length = device.device.irLength;
+            uint32_t ir = 0;
+            uint32_t capture = 0x1;
+
+            getBits(scan.tdio, offset, &ir, std::min<uint32_t>(length, 32));
+            device.ir = ir & maskOf(length);
+            putBits(tdo, offset, &capture, std::min<uint32_t>(length, 2));
+            offset += length;
+            continue;
+        }
+
+        uint32_t length = drLength(device);
+        if (device.ir == idcodeInstruction)
+        {
+            putBits(tdo, offset, &device.device.idcode, length);
+        }
+        else if (device.ir == usercodeInstruction)
+        {
+            putBits(tdo, offset, &device.device.usercode, length);
+        }
+        else if (length == dataLength)
+        {
+            putBits(tdo, offset, device.data.data(), length);
+            getBits(scan.tdio, offset, device.data.data(), length);
+        }
+        offset += length;
+    }
+
+    if (scan.direction & JTAG_READ_XFER)
+    {
+        scan.tdio = tdo;
+    }
+
+    account(total);
+    return scan.endstate == JTAG_STATE_IDLE ? 0 : -1;
+}
+
+int JtagLoopbackBackend::setFreq(unsigned int freq)
+{
+    if (freq == 0)
+    {
+        return -1;
+    }
+
+    this->freq = freq;
+    return 0;
+}
+
+JtagSession::JtagSession(std::unique_ptr<JtagBackend> backend,
+                         std::vector<uint32_t> irLengths) :
+    backend(std::move(backend))
+{
+    setChain(std::move(irLengths));
+}
+
+std::unique_ptr<JtagSession> JtagSession::open(std::vector<uint32_t> irLengths)
+{
+    auto backend = JtagDeviceBackend::open();
+    if (!backend)
+    {
+        return nullptr;
+    }
+
+    return std::make_unique<JtagSession>(std::move(backend),
+                                         std::move(irLengths));
+}
+
+int JtagSession::setChain(std::vector<uint32_t> irLengths)
+{
+    if (!queue.empty())
+    {
+        std::cerr << "JTAG chain changed with scans queued.\n";
+        return -1;
+    }
+
+    this->irLengths = std::move(irLengths);
+    instructions.assign(this->irLengths.size(), std::nullopt);
+    return 0;
+}
+
+int JtagSession::reset(uint8_t tck)
+{
+    stats.stateChanges++;
+    if (backend->setTapState(1, JTAG_STATE_IDLE, tck) < 0)
+    {
+        tapState.reset();
+        return -1;
+    }
+
+    // Test-Logic-Reset selects IDCODE or BYPASS, depending on the device
+    tapState = JTAG_STATE_IDLE;
+    instructions.assign(irLengths.size(), std::nullopt);
+    return 0;
+}
+
+void JtagSession::invalidate()
+{
+    instructions.assign(irLengths.size(), std::nullopt);
+}
+
+int JtagSession::idle(uint32_t tck)
+{
+    if (tapState == JTAG_STATE_IDLE && tck == 0)
+    {
+        stats.skippedStateChanges++;
+        return 0;
+    }
+
+    return runTest(tck);
+}
+
+int JtagSession::setFreq(unsigned int freq)
+{
+    return backend->setFreq(freq);
+}
+
+/* Go to Run-Test/Idle, or stay there, and clock tck cycles. */
+int JtagSession::runTest(uint32_t tck)
+{
+    if (tck == 0 && tapState == JTAG_STATE_IDLE)
+    {
+        return 0;
+    }
+
+    do
+    {
+        uint8_t cycles = std::min<uint32_t>(tck, UINT8_MAX);
+
+        stats.stateChanges++;
+        if (backend->setTapState(0, JTAG_STATE_IDLE, cycles) < 0)
+        {
+            tapState.reset();
+            return -1;
+        }
+        tapState = JTAG_STATE_IDLE;
+        tck -= cycles;
+    } while (tck > 0);
+    return 0;
+}
+
+int JtagSession::queueIr(size_t device, uint32_t instruction, uint32_t tck)
+{
+    if (device >= irLengths.size())
+    {
+        std::cerr << "Invalid JTAG device " << device << ".\n";
+        return -1;
+    }
+
+    uint32_t length = irLengths[device];
+    queue.push_back({JTAG_SIR_XFER, device, length,
+                     {instruction & maskOf(length)}, true, nullptr, tck});
+    return 0;
+}
+
+int JtagSession::queueDr(size_t device, uint32_t length, const uint32_t* tdi,
+                         uint32_t* tdo, uint32_t tck)
+{
+    if (device >= irLengths.size() || length == 0)
+    {
+        std::cerr << "Invalid JTAG device " << device << " or length "
+                  << length << ".\n";
+        return -1;
+    }
+
+    std::vector<uint32_t> bits(wordsOf(length), 0);
+    if (tdi != NULL)
+    {
+        std::copy(tdi, tdi + bits.size(), bits.begin());
+    }
+    queue.push_back({JTAG_SDR_XFER, device, length, std::move(bits),
+                     tdi != NULL, tdo, tck});
+    return 0;
+}
+
+/**
+ * Split the queue into rounds where every device has at most an IR scan
+ * followed by a DR scan, and run every round with at most one IR and one
+ * DR scan of the chain. A round ends at the first scan that doesn't fit,
+ * so the scans of every device run in the order they were queued.
+ */
+int JtagSession::execute()
+{
+    size_t begin = 0;
+    int ret = 0;
+
+    while (ret == 0 && begin < queue.size())
+    {
+        size_t end = roundEnd(begin);
+
+        ret = executeRound(begin, end);
+        begin = end;
+    }
+
+    queue.clear();
+    return ret;
+}
+
+/*
+ * The DR scan of a round puts every device without a DR scan in BYPASS, so
+ * a device with only an IR scan can't share a round with DR scans. Such a
+ * round is cut before the IR scan, or before the first DR scan when the IR
+ * scan comes first.
+ */
+size_t JtagSession::roundEnd(size_t begin) const
+{
+    std::vector<uint8_t> scanned(irLengths.size());
+    size_t end = begin;
+
+    while (end < queue.size())
+    {
+        const Operation& operation = queue[end];
+        uint8_t& done = scanned[operation.device];
+
+        if (operation.type == JTAG_SIR_XFER ? done != 0 : done > 1)
+        {
+            break;
+        }
+        done = operation.type == JTAG_SIR_XFER ? 1 : 2;
+        end++;
+    }
+
+    while (true)
+    {
+        size_t firstDr = end;
+        size_t firstIrOnly = end;
+
+        std::fill(scanned.begin(), scanned.end(), 0);
+        for (size_t i = begin; i < end; i++)
+        {
+            scanned[queue[i].device] = queue[i].type == JTAG_SIR_XFER ? 1 : 2;
+        }
+        for (size_t i = begin; i < end; i++)
+        {
+            if (queue[i].type == JTAG_SDR_XFER)
+            {
+                firstDr = std::min(firstDr, i);
+            }
+            else if (scanned[queue[i].device] == 1)
+            {
+                firstIrOnly = std::min(firstIrOnly, i);
+            }
+        }
+        if (firstDr == end || firstIrOnly == end)
+        {
+            return end;
+        }
+        end = std::max(firstDr, firstIrOnly);
+    }
+}
+
+int JtagSession::executeRound(size_t begin, size_t end)
+{
+    std::vector<std::optional<uint32_t>> wanted(irLengths.size());
+    uint32_t irTck = 0;
+    uint32_t drTck = 0;
+    bool dr = std::any_of(
+        queue.begin() + begin, queue.begin() + end,
+        [](const Operation& operation) {
+            return operation.type == JTAG_SDR_XFER;
+        });
+
+    // Devices not taking part in a DR scan are put in BYPASS, so their DR
+    // is one bit. Rounds of IR scans only keep the other instructions.
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        wanted[device] = instructions[device];
+        if (dr || !wanted[device])
+        {
+            wanted[device] = maskOf(irLengths[device]);
+        }
+    }
+    for (size_t i = begin; i < end; i++)
+    {
+        if (queue[i].type == JTAG_SDR_XFER)
+        {
+            wanted[queue[i].device] = instructions[queue[i].device];
+            drTck = std::max(drTck, queue[i].tck);
+        }
+    }
+    for (size_t i = begin; i < end; i++)
+    {
+        if (queue[i].type == JTAG_SIR_XFER)
+        {
+            wanted[queue[i].device] = queue[i].tdi[0];
+            irTck = std::max(irTck, queue[i].tck);
+        }
+    }
+
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        if (!wanted[device])
+        {
+            std::cerr << "Unknown instruction of JTAG device " << device
+                      << ", queue its IR scan first.\n";
+            return -1;
+        }
+    }
+
+    // Nothing to wait for when the instructions are loaded already
+    if (wanted == instructions)
+    {
+        stats.skippedIrScans++;
+    }
+    else if (scanIr(wanted) < 0 || runTest(irTck) < 0)
+    {
+        return -1;
+    }
+
+    if (!dr)
+    {
+        return 0;
+    }
+    if (scanDr(begin, end) < 0)
+    {
+        return -1;
+    }
+    return runTest(drTck);
+}
+
+int JtagSession::scanIr(const std::vector<std::optional<uint32_t>>& wanted)
+{
+    JtagScan scan = {JTAG_SIR_XFER, JTAG_WRITE_XFER, JTAG_STATE_IDLE, 0, {}};
+
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        scan.length += irLengths[device];
+    }
+
+    scan.tdio.assign(wordsOf(scan.length), 0);
+    uint32_t offset = 0;
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        // Bits of instructions longer than 32 bits are all ones (BYPASS)
+        for (uint32_t bit = 0; bit < irLengths[device]; bit += 32)
+        {
+            uint32_t value = bit == 0 ? *wanted[device] : 0xFFFFFFFF;
+            putBits(scan.tdio, offset + bit, &value,
+                    std::min<uint32_t>(irLengths[device] - bit, 32));
+        }
+        offset += irLengths[device];
+    }
+
+    stats.irScans++;
+    if (backend->xfer(scan) < 0)
+    {
+        tapState.reset();
+        instructions.assign(irLengths.size(), std::nullopt);
+        return -1;
+    }
+
+    tapState = JTAG_STATE_IDLE;
+    instructions = wanted;
+    return 0;
+}
+
+int JtagSession::scanDr(size_t begin, size_t end)
+{
+    std::vector<const Operation*> operations(irLengths.size(), nullptr);
+    JtagScan scan = {JTAG_SDR_XFER, 0, JTAG_STATE_IDLE, 0, {}};
+    bool read = false;
+    bool write = false;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        if (queue[i].type != JTAG_SDR_XFER)
+        {
+            continue;
+        }
+        operations[queue[i].device] = &queue[i];
+        read = read || queue[i].tdo != NULL;
+        write = write || queue[i].write;
+    }
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        scan.length += operations[device] ? operations[device]->length : 1;
+    }
+
+    scan.direction = read && write ? JTAG_READ_WRITE_XFER
+                     : read        ? JTAG_READ_XFER
+                                   : JTAG_WRITE_XFER;
+    scan.tdio.assign(wordsOf(scan.length), 0);
+    uint32_t offset = 0;
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        const Operation* operation = operations[device];
+        if (operation)
+        {
+            putBits(scan.tdio, offset, operation->tdi.data(),
+                    operation->length);
+        }
+        offset += operation ? operation->length : 1;
+    }
+
+    stats.drScans++;
+    if (backend->xfer(scan) < 0)
+    {
+        tapState.reset();
+        return -1;
+    }
+    tapState = JTAG_STATE_IDLE;
+
+    offset = 0;
+    for (size_t device = 0; device < irLengths.size(); device++)
+    {
+        const Operation* operation = operations[device];
+        if (operation && operation->tdo)
+        {
+            getBits(scan.tdio, offset, operation->tdo, operation->length);
+        }
+        offset += operation ? operation->length : 1;
+    }
+    return 0;
+}
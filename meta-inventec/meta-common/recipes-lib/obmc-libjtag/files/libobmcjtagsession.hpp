@@ -0,0 +1,211 @@
+#pragma once
+
+#include <linux/jtag.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * One IR or DR scan passed to a JTAG backend.
+ *  type: JTAG_SIR_XFER or JTAG_SDR_XFER
+ *  direction: JTAG_READ_XFER, JTAG_WRITE_XFER or JTAG_READ_WRITE_XFER
+ *  length: scan length in bits
+ *  tdio: TDI bits, replaced with TDO bits by read scans
+ */
+struct JtagScan
+{
+    uint8_t type;
+    uint8_t direction;
+    uint8_t endstate;
+    uint32_t length;
+    std::vector<uint32_t> tdio;
+};
+
+/**
+ * Transport executing TAP operations, one call per driver request.
+ */
+class JtagBackend
+{
+  public:
+    virtual ~JtagBackend() = default;
+
+    /* tck: Run-Test/Idle cycles clocked when endstate is JTAG_STATE_IDLE. */
+    virtual int setTapState(uint8_t reset, uint8_t endstate, uint8_t tck) = 0;
+    virtual int xfer(JtagScan& scan) = 0;
+    virtual int setFreq(unsigned int freq) = 0;
+};
+
+/**
+ * Backend of the JTAG master device, kept open for the lifetime of the
+ * backend.
+ */
+class JtagDeviceBackend : public JtagBackend
+{
+  public:
+    static std::unique_ptr<JtagDeviceBackend> open();
+    ~JtagDeviceBackend() override;
+
+    int setTapState(uint8_t reset, uint8_t endstate, uint8_t tck) override;
+    int xfer(JtagScan& scan) override;
+    int setFreq(unsigned int freq) override;
+
+  private:
+    explicit JtagDeviceBackend(int fd);
+
+    int fd;
+};
+
+/**
+ * Software model of a chain of Lattice-like devices, for testing and
+ * throughput measurements without hardware. Devices are numbered from
+ * TDO, so device 0 gets the first bits of every scan.
+ *
+ * IDCODE and USERCODE shift out the device codes, BYPASS is one bit and
+ * any other instruction selects a data register of dataLength bits that
+ * shifts out what was last shifted in. The time the scans would take on
+ * the wire at the given frequency, plus a fixed cost per driver request,
+ * is accumulated in simulatedNs instead of being slept.
+ */
+class JtagLoopbackBackend : public JtagBackend
+{
+  public:
+    struct Device
+    {
+        uint32_t irLength;
+        uint32_t idcode;
+        uint32_t usercode;
+    };
+
+    struct Stats
+    {
+        uint64_t requests = 0;
+        uint64_t bits = 0;
+        uint64_t simulatedNs = 0;
+    };
+
+    static constexpr uint32_t idcodeInstruction = 0xE0;
+    static constexpr uint32_t usercodeInstruction = 0xC0;
+    static constexpr uint32_t dataLength = 128;
+
+    explicit JtagLoopbackBackend(std::vector<Device> devices,
+                                 unsigned int freq = 10000000,
+                                 uint32_t requestNs = 20000);
+
+    int setTapState(uint8_t reset, uint8_t endstate, uint8_t tck) override;
+    int xfer(JtagScan& scan) override;
+    int setFreq(unsigned int freq) override;
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct DeviceState
+    {
+        Device device;
+        uint32_t ir;
+        std::vector<uint32_t> data;
+    };
+
+    std::vector<DeviceState> chain;
+    unsigned int freq;
+    uint32_t requestNs;
+    Stats stats;
+
+    void account(uint64_t bits);
+    uint32_t drLength(const DeviceState& device) const;
+};
+
+struct JtagSessionStats
+{
+    uint64_t irScans = 0;
+    uint64_t drScans = 0;
+    uint64_t skippedIrScans = 0;
+    uint64_t stateChanges = 0;
+    uint64_t skippedStateChanges = 0;
+};
+
+/**
+ * JTAG session on a chain of devices: the backend stays open, the TAP
+ * state and the instruction of every device are cached, so transitions
+ * and IR loads which would not change anything are skipped.
+ *
+ * IR and DR scans are queued per device and submitted by execute(). An
+ * IR scan followed by a DR scan of every device are merged with those of
+ * the other devices into a single chain-wide IR scan and a single DR
+ * scan, with the devices not taking part put in BYPASS. So an operation
+ * on several CPLDs of a chain costs about the same as on one of them.
+ * Every scan ends in Run-Test/Idle.
+ */
+class JtagSession
+{
+  public:
+    static constexpr uint32_t bypassInstruction = 0xFFFFFFFF;
+
+    /* irLengths: IR length of every device on the chain, from TDO. */
+    JtagSession(std::unique_ptr<JtagBackend> backend,
+                std::vector<uint32_t> irLengths);
+
+    /* Session on the JTAG master device, nullptr if it can't be opened. */
+    static std::unique_ptr<JtagSession> open(std::vector<uint32_t> irLengths);
+
+    int setChain(std::vector<uint32_t> irLengths);
+    size_t getChainLength() const
+    {
+        return irLengths.size();
+    }
+
+    /* Go through Test-Logic-Reset to Run-Test/Idle, then clock tck cycles. */
+    int reset(uint8_t tck = 0);
+    /*
+     * Forget the cached instructions, so the next round loads them again,
+     * e.g. when another process may have used the chain meanwhile.
+     */
+    void invalidate();
+    /* Go to Run-Test/Idle unless already there, then clock tck cycles. */
+    int idle(uint32_t tck);
+    int setFreq(unsigned int freq);
+
+    /*
+     * tck: Run-Test/Idle cycles after the scan, merged scans run the
+     * maximum of their cycles.
+     */
+    int queueIr(size_t device, uint32_t instruction, uint32_t tck = 0);
+    /* tdi may be nullptr to shift zeros, tdo nullptr to ignore output. */
+    int queueDr(size_t device, uint32_t length, const uint32_t* tdi,
+                uint32_t* tdo, uint32_t tck = 0);
+    int execute();
+
+    const JtagSessionStats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct Operation
+    {
+        uint8_t type;
+        size_t device;
+        uint32_t length;
+        std::vector<uint32_t> tdi;
+        bool write;
+        uint32_t* tdo;
+        uint32_t tck;
+    };
+
+    std::unique_ptr<JtagBackend> backend;
+    std::vector<uint32_t> irLengths;
+    std::vector<std::optional<uint32_t>> instructions;
+    std::optional<uint8_t> tapState;
+    std::vector<Operation> queue;
+    JtagSessionStats stats;
+
+    size_t roundEnd(size_t begin) const;
+    int executeRound(size_t begin, size_t end);
+    int scanIr(const std::vector<std::optional<uint32_t>>& wanted);
+    int scanDr(size_t begin, size_t end);
+    int runTest(uint32_t tck);
+};
@@ -0,0 +1,154 @@
+/*
+ * Checks of the scan rounds built by the JTAG session, run on the loopback
+ * backend, which fails scans not matching the length of the chain.
+ *
+ * Build with "make jtag-test" and run "./jtag-test".
+ */
+
+#include "../libobmcjtagsession.hpp"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+constexpr uint32_t testCplds = 3;
+constexpr uint32_t latticeIrLength = 8;
+
+struct TestChain
+{
+    const JtagLoopbackBackend* backend;
+    std::unique_ptr<JtagSession> session;
+};
+
+static TestChain testChain()
+{
+    std::vector<JtagLoopbackBackend::Device> devices;
+
+    for (uint32_t i = 0; i < testCplds; i++)
+    {
+        devices.push_back({latticeIrLength, 0x012BB043 + i, 0xC0DE0000 + i});
+    }
+
+    auto loopback = std::make_unique<JtagLoopbackBackend>(devices);
+    TestChain chain = {loopback.get(), nullptr};
+    chain.session = std::make_unique<JtagSession>(
+        std::move(loopback),
+        std::vector<uint32_t>(testCplds, latticeIrLength));
+    return chain;
+}
+
+static bool expect(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cerr << "    " << what << "\n";
+    }
+    return condition;
+}
+
+/* All user codes are read with one IR and one DR scan of the chain. */
+static bool userCodesAreMerged()
+{
+    TestChain chain = testChain();
+    JtagSession& session = *chain.session;
+    std::vector<uint32_t> codes(testCplds);
+
+    for (uint32_t device = 0; device < testCplds; device++)
+    {
+        session.queueIr(device, JtagLoopbackBackend::usercodeInstruction);
+    }
+    for (uint32_t device = 0; device < testCplds; device++)
+    {
+        session.queueDr(device, 32, NULL, &codes[device]);
+    }
+
+    bool ok = expect(session.reset() == 0 && session.execute() == 0,
+                     "execute failed");
+    for (uint32_t device = 0; device < testCplds; device++)
+    {
+        ok = expect(codes[device] == 0xC0DE0000 + device, "wrong user code") &&
+             ok;
+    }
+    ok = expect(session.getStats().irScans == 1, "IR scans not merged") && ok;
+    return expect(session.getStats().drScans == 1, "DR scans not merged") &&
+           ok;
+}
+
+/* An IR scan of one device queued before a DR scan of another. */
+static bool irOnlyDeviceBeforeDrOfAnother()
+{
+    TestChain chain = testChain();
+    JtagSession& session = *chain.session;
+    uint32_t code = 0;
+
+    session.queueIr(1, JtagLoopbackBackend::usercodeInstruction);
+    bool ok = expect(session.reset() == 0 && session.execute() == 0,
+                     "loading USERCODE failed");
+
+    session.queueIr(0, JtagLoopbackBackend::idcodeInstruction);
+    session.queueDr(1, 32, NULL, &code);
+    ok = expect(session.execute() == 0, "execute failed") && ok;
+    return expect(code == 0xC0DE0001, "wrong user code") && ok;
+}
+
+/* An IR scan of one device queued after a DR scan of another. */
+static bool irOnlyDeviceAfterDrOfAnother()
+{
+    TestChain chain = testChain();
+    JtagSession& session = *chain.session;
+    uint32_t code = 0;
+
+    session.queueIr(1, JtagLoopbackBackend::usercodeInstruction);
+    bool ok = expect(session.reset() == 0 && session.execute() == 0,
+                     "loading USERCODE failed");
+
+    session.queueDr(1, 32, NULL, &code);
+    session.queueIr(0, JtagLoopbackBackend::idcodeInstruction);
+    ok = expect(session.execute() == 0, "execute failed") && ok;
+    ok = expect(code == 0xC0DE0001, "wrong user code") && ok;
+
+    session.queueDr(0, 32, NULL, &code);
+    ok = expect(session.execute() == 0, "execute of IDCODE failed") && ok;
+    return expect(code == 0x012BB043, "wrong IDCODE") && ok;
+}
+
+/* Run-Test/Idle cycles are clocked by the state change requests. */
+static bool idleCyclesAreClockedByStateChanges()
+{
+    TestChain chain = testChain();
+    JtagSession& session = *chain.session;
+    uint32_t code = 0;
+
+    bool ok = expect(session.reset(2) == 0, "reset failed");
+    session.queueIr(0, JtagLoopbackBackend::usercodeInstruction, 2);
+    session.queueDr(0, 32, NULL, &code, 300);
+    ok = expect(session.execute() == 0, "execute failed") && ok;
+    ok = expect(code == 0xC0DE0000, "wrong user code") && ok;
+
+    // reset, IR scan, 2 cycles, DR scan, 255 + 45 cycles
+    ok = expect(chain.backend->getStats().requests == 6,
+                "wrong number of requests") && ok;
+    return expect(session.getStats().stateChanges == 4,
+                  "wrong number of state changes") && ok;
+}
+
+int main()
+{
+    const std::vector<std::pair<const char*, std::function<bool()>>> tests = {
+        {"userCodesAreMerged", userCodesAreMerged},
+        {"irOnlyDeviceBeforeDrOfAnother", irOnlyDeviceBeforeDrOfAnother},
+        {"irOnlyDeviceAfterDrOfAnother", irOnlyDeviceAfterDrOfAnother},
+        {"idleCyclesAreClockedByStateChanges",
+         idleCyclesAreClockedByStateChanges},
+    };
+    int failed = 0;
+
+    for (const auto& [name, test] : tests)
+    {
+        bool ok = test();
+        std::cout << (ok ? "PASS " : "FAIL ") << name << "\n";
+        failed += ok ? 0 : 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -36,6 +36,11 @@
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "cpldupdate-i2c.hpp"
 
 #ifdef DEBUG
@@ -47,12 +52,17 @@
 #define ERR_PRINT(fmt, args...) \
         fprintf(stderr, fmt ": %s\n", ##args, strerror(errno));
 
-#define BUSY_RETRIES (15)
+#define BUSY_TIMEOUT_US (15 * 1000000)
+#define BUSY_POLL_MIN_US (50)
 #define UPDATE_RETRIES (5)
 #define VERSION_ID_PATH_END (4)
 #define RETRY_NUM (1)
 #define CMD_SIZE (4)
 #define PROGRAM_DONE_RETRY_NUM (3)
+#define FLASH_PAGE_SIZE (16)
+/* Command and data of a burst have to fit in one 255 byte i2c message */
+#define MAX_BURST_PAGES (15)
+#define PROGRESS_INTERVAL_MS (500)
 
 const int VERIFY_PERCENTAGE = 40;
 const int FLASH_PERCENTAGE = 40;
@@ -88,6 +98,31 @@ typedef struct cpld_config_t {
     uint8_t erase_flash_cmd[CMD_SIZE];
 } cpld_config_t;
 
+/*
+ * Busy flag polling of an operation: first poll after first_us, then the
+ * interval doubles up to max_us, the datasheet maximum of the operation.
+ */
+typedef struct busy_timing_t {
+    uint32_t first_us;
+    uint32_t max_us;
+} busy_timing_t;
+
+const busy_timing_t cmd_busy_timing = {
+    .first_us = 0,
+    .max_us = 1000
+};
+
+/* Per page, a burst waits pages times as long before the first poll */
+const busy_timing_t page_busy_timing = {
+    .first_us = 100,
+    .max_us = 1000
+};
+
+const busy_timing_t erase_busy_timing = {
+    .first_us = 50000,
+    .max_us = 1000000
+};
+
 enum {
     TRANSPARENT_MODE = 0x74,
     OFFLINE_MODE = 0xC6,
@@ -271,15 +306,20 @@ read_status(i2c_info_t cpld)
 }
 
 static int
-read_busy_flag(i2c_info_t cpld)
+read_busy_flag(i2c_info_t cpld, const busy_timing_t& timing, uint32_t scale = 1)
 {
 
     uint8_t busy_flag_cmd[4] = {0xF0, 0x00, 0x00, 0x00};
-    uint8_t count = 0;
     uint8_t flag[1];
     int ret = -1;
+    uint32_t delay_us = timing.first_us * scale;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(BUSY_TIMEOUT_US);
 
-    for (count = 0; count < BUSY_RETRIES; count++) {
+    while (true) {
+        if (delay_us) {
+            usleep(delay_us);
+        }
         ret = i2c_rdwr_msg_transfer_retry(cpld.fd, cpld.addr << 1, busy_flag_cmd,
                                     sizeof(busy_flag_cmd), flag, sizeof(flag));
         if (ret != 0) {
@@ -289,10 +329,12 @@ read_busy_flag(i2c_info_t cpld)
         if (!(flag[0] & 0x80)) {
             return 0;
         }
-        sleep(1);
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return -1;
+        }
+        delay_us = std::min(std::max(delay_us * 2, (uint32_t)BUSY_POLL_MIN_US),
+                            timing.max_us);
     }
-
-    return -1;
 }
 
 static int
@@ -366,7 +408,7 @@ erash_flash(i2c_info_t cpld, uint8_t *erase_flash_cmd)
         ERR_PRINT("erase_flash()");
         return ret;
     }
-    if (read_busy_flag(cpld) != 0) {
+    if (read_busy_flag(cpld, erase_busy_timing) != 0) {
         CPLD_DEBUG("Device busy is caused by flash erase\n");
         return -1;
     }
@@ -512,6 +554,116 @@ disable_config(i2c_info_t cpld)
     return 0;
 }
 
+/*
+ * Publishes ActivationProgress from a worker thread with its own bus
+ * connection, so programming and verify never wait on D-Bus. Only the
+ * latest percentage is kept, and it is sent at most once per
+ * PROGRESS_INTERVAL_MS.
+ */
+class progress_reporter
+{
+  public:
+    ~progress_reporter()
+    {
+        stop();
+    }
+
+    /* Reads the current progress, then starts the worker */
+    int start(const std::string& service, const std::string& object)
+    {
+        auto bus = sdbusplus::bus::new_default();
+        auto method = bus.new_method_call(service.c_str(), object.c_str(),
+                                          PROP_INTF, "Get");
+        std::variant<std::uint8_t> activation_progess;
+
+        method.append(ACTIVATION_PROGRESS_INTF, "Progress");
+        try {
+            auto reply = bus.call(method);
+            reply.read(activation_progess);
+        } catch (const sdbusplus::exception::SdBusError& e) {
+            printf("SdBusError!\n");
+            return -1;
+        }
+
+        this->service = service;
+        this->object = object;
+        pending = sent = std::get<std::uint8_t>(activation_progess);
+        running = true;
+        worker = std::thread(&progress_reporter::run, this);
+        return 0;
+    }
+
+    uint8_t get()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return pending;
+    }
+
+    void set(uint8_t percentage)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (running && percentage != pending) {
+            pending = percentage;
+            cond.notify_one();
+        }
+    }
+
+    /* Sends the last percentage set and stops the worker */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            running = false;
+            cond.notify_one();
+        }
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+  private:
+    std::string service;
+    std::string object;
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable cond;
+    uint8_t pending = 0;
+    uint8_t sent = 0;
+    bool running = false;
+
+    void run()
+    {
+        auto bus = sdbusplus::bus::new_default();
+        std::unique_lock<std::mutex> guard(lock);
+
+        while (true) {
+            cond.wait(guard, [this] { return pending != sent || !running; });
+            if (pending == sent) {
+                break;
+            }
+
+            uint8_t percentage = pending;
+            guard.unlock();
+            auto method = bus.new_method_call(service.c_str(), object.c_str(),
+                                              PROP_INTF, "Set");
+            method.append(ACTIVATION_PROGRESS_INTF, "Progress");
+            method.append(std::variant<uint8_t>(percentage));
+            try {
+                bus.call(method);
+            } catch (const sdbusplus::exception::SdBusError& e) {
+                printf("error setting property: %s Progress: %s\n",
+                       ACTIVATION_PROGRESS_INTF, e.what());
+            }
+            guard.lock();
+            sent = percentage;
+
+            cond.wait_for(guard,
+                          std::chrono::milliseconds(PROGRESS_INTERVAL_MS),
+                          [this] { return !running; });
+        }
+    }
+};
+
 /*RD debug: mainly check if access flash data normally*/
 static int
 pre_verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
@@ -531,7 +683,7 @@ pre_verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
         ERR_PRINT("verify_flash(): Reset Page Address");
         return ret;
     }
-    if (read_busy_flag(cpld) != 0) {
+    if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
         CPLD_DEBUG("Device busy is caused by address reset\n");
         return -1;
     }
@@ -545,7 +697,7 @@ pre_verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
             ERR_PRINT("verify_flash(): Read Page Data");
             return ret;
         }
-        if (read_busy_flag(cpld) != 0) {
+        if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
             CPLD_DEBUG("Device busy is caused by Read Page Data\n");
             return -1;
         }
@@ -562,21 +714,16 @@ pre_verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
 }
 static int
 verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
-       uint8_t *data, int data_len, bool is_remote, const std::string& service, const std::string& object)
+       uint8_t *data, int data_len, progress_reporter *progress)
 {
 
    // uint8_t reset_addr_cmd[4] = {page, 0x00, 0x01, 0x00};
     /* 0x73 0x00: i2c, 0x73 0x10: JTAG/SSPI */
     uint8_t read_page_cmd[4] = {0x73, 0x00, 0x00, 0x01};
-    uint8_t page_data[16] = {0};
+    uint8_t page_data[FLASH_PAGE_SIZE] = {0};
     int byte_index = 0;
     int ret = -1;
-    auto bus = sdbusplus::bus::new_default();
-    std::variant<std::uint8_t> activation_progess;
-    auto method=sdbusplus::message::message();
-    auto reply=sdbusplus::message::message();
     uint8_t percentage_start = 0;
-    uint8_t percentage = 0;
     uint8_t page = 0;
     /* Reset Page Address */
     ret = i2c_rdwr_msg_transfer_retry(cpld.fd, cpld.addr << 1, reset_addr_cmd,
@@ -585,7 +732,7 @@ verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
         ERR_PRINT("verify_flash(): Reset Page Address");
         return ret;
     }
-    if (read_busy_flag(cpld) != 0) {
+    if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
         CPLD_DEBUG("Device busy is caused by address reset\n");
         return -1;
     }
@@ -596,20 +743,12 @@ verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
         printf("- Verify UFM Page -\n");
     }
 
-    if( is_remote ) {
-        method = bus.new_method_call(service.c_str(), object.c_str(), PROP_INTF, "Get");
-        method.append(ACTIVATION_PROGRESS_INTF,"Progress");
-        try {
-            reply=bus.call(method);
-            reply.read(activation_progess);
-        } catch (const sdbusplus::exception::SdBusError& e) {
-            printf("SdBusError!\n");
-            return -1;
-        }
-        percentage_start = std::get<std::uint8_t>(activation_progess);
+    if (progress) {
+        percentage_start = progress->get();
     }
 
-    for (byte_index = 0; byte_index < data_len; byte_index+=16) {
+    /* Reads don't keep the flash busy, so pages are read back to back */
+    for (byte_index = 0; byte_index < data_len; byte_index += FLASH_PAGE_SIZE) {
 
         /* Read Page Data */
         ret = i2c_rdwr_msg_transfer_retry(cpld.fd, cpld.addr << 1, read_page_cmd,
@@ -618,61 +757,51 @@ verify(i2c_info_t cpld, uint8_t *reset_addr_cmd,
             ERR_PRINT("verify_flash(): Read Page Data");
             return ret;
         }
-        if (read_busy_flag(cpld) != 0) {
+        if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
             CPLD_DEBUG("Device busy is caused by Read Page Data\n");
             return -1;
         }
-        usleep(2000);
 
         /* Compare Data */
-        if (memcmp(page_data, data+byte_index, 16) != 0) {
+        if (memcmp(page_data, data+byte_index, FLASH_PAGE_SIZE) != 0) {
             CPLD_DEBUG("\nImage_data: ");
-            for (int i = 0; i < 16; i++) {
+            for (int i = 0; i < FLASH_PAGE_SIZE; i++) {
                 CPLD_DEBUG("0x%2x ", page_data[i]);
             }
             CPLD_DEBUG("\nFlash_data: ");
-            for (int i = 0; i < 16; i++) {
+            for (int i = 0; i < FLASH_PAGE_SIZE; i++) {
                 CPLD_DEBUG("0x%2x ", data[byte_index+i]);
             }
             printf("\nCompare Fail - Do Clean Up Procedure\n");
             return -1;
         }
-        printf("  (%d/%d) (%d%%/100%%)\r",
-               byte_index + 16, data_len, (100 * (byte_index + 16) / data_len));
-        if ((byte_index & 0xFFF) == 0) {
-            if(is_remote) {
-                percentage = percentage_start + (VERIFY_PERCENTAGE *( byte_index + 16)) / data_len;
-                method = bus.new_method_call(service.c_str(), object.c_str() ,PROP_INTF, "Set");
-                method.append(ACTIVATION_PROGRESS_INTF,"Progress");
-                method.append(std::variant<uint8_t>(percentage));
-                reply = bus.call(method);
-                if (reply.is_method_error()) {
-                    printf("error setting property: %s Progress",ACTIVATION_PROGRESS_INTF);
-                    return -1;
-                }
-            }
+        printf("  (%d/%d) (%d%%/100%%)\r", byte_index + FLASH_PAGE_SIZE,
+               data_len, (100 * (byte_index + FLASH_PAGE_SIZE) / data_len));
+        if (progress) {
+            progress->set(percentage_start + (VERIFY_PERCENTAGE *
+                          (byte_index + FLASH_PAGE_SIZE)) / data_len);
         }
-        usleep(200);
     }
     printf("\t\t\t\t...Done!\n");
     return 0;
 }
 
+/*
+ * Pages are written in bursts of burst_pages, when the device takes more
+ * than one page per program command, and the busy flag is polled with
+ * backoff instead of sleeping for the worst case after every page.
+ */
 static int
 program_flash(i2c_info_t cpld, uint8_t *reset_addr_cmd,
-              uint8_t *data, int data_len, bool is_remote, const std::string& service, const std::string object)
+              uint8_t *data, int data_len, int burst_pages,
+              progress_reporter *progress)
 {
 
     //uint8_t reset_addr_cmd[4] = {page, 0x00, 0x00, 0x00};
     uint8_t write_page_cmd[4] = {0x70, 0x00, 0x00, 0x01};
-    uint8_t program_page_cmd[32] = {0};
+    uint8_t program_page_cmd[CMD_SIZE + FLASH_PAGE_SIZE * MAX_BURST_PAGES] = {0};
     int byte_index = 0;
     int ret = -1;
-    auto bus = sdbusplus::bus::new_default();
-    std::variant<std::uint8_t> activation_progess;
-    auto method=sdbusplus::message::message() ;
-    auto reply=sdbusplus::message::message() ;
-    uint8_t percentage = 0;
     uint8_t percentage_start = 0;
     uint8_t page = 0;
 
@@ -682,7 +811,7 @@ program_flash(i2c_info_t cpld, uint8_t *reset_addr_cmd,
         ERR_PRINT("program_flash(): Reset Page Address");
         return ret;
     }
-    if (read_busy_flag(cpld) != 0) {
+    if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
         CPLD_DEBUG("Device busy is caused by address reset.\n");
         return -1;
     }
@@ -693,55 +822,47 @@ program_flash(i2c_info_t cpld, uint8_t *reset_addr_cmd,
         printf("- Program UFM Page -\n");
     }
 
-    if( is_remote ) {
-        method = bus.new_method_call(service.c_str(), object.c_str(), PROP_INTF, "Get");
-        method.append(ACTIVATION_PROGRESS_INTF,"Progress");
-        try {
-            reply=bus.call(method);
-            reply.read(activation_progess);
-        } catch (const sdbusplus::exception::SdBusError& e) {
-            printf("SdBusError!\n");
-            return -1;
-        }
-        percentage_start = std::get<std::uint8_t>(activation_progess);
+    if (progress) {
+        percentage_start = progress->get();
     }
 
-    memcpy(&program_page_cmd[0], write_page_cmd, 4);
+    for (byte_index = 0; byte_index < data_len;) {
+        int pages = std::min(burst_pages,
+                             (data_len - byte_index + FLASH_PAGE_SIZE - 1) /
+                             FLASH_PAGE_SIZE);
+        int len = std::min(pages * FLASH_PAGE_SIZE, data_len - byte_index);
 
-    for (byte_index = 0; byte_index < data_len; byte_index += 16) {
-        memcpy(&program_page_cmd[4], &data[byte_index], 16);
+        /* A single page command is padded to 32 bytes as it always was */
+        int cmd_len = std::max(CMD_SIZE + pages * FLASH_PAGE_SIZE, 32);
+
+        memcpy(&program_page_cmd[0], write_page_cmd, CMD_SIZE);
+        program_page_cmd[3] = pages;
+        memset(&program_page_cmd[CMD_SIZE], 0, cmd_len - CMD_SIZE);
+        memcpy(&program_page_cmd[CMD_SIZE], &data[byte_index], len);
         CPLD_DEBUG("\n");
-        for (int i = 0; i < 20; i++) {
+        for (int i = 0; i < CMD_SIZE + len; i++) {
             CPLD_DEBUG("0x%2x ", program_page_cmd[i]);
         }
         CPLD_DEBUG("\n");
 
         ret = i2c_rdwr_msg_transfer_retry(cpld.fd, cpld.addr << 1, program_page_cmd,
-                                    sizeof(program_page_cmd), NULL, 0);
+                                    cmd_len, NULL, 0);
         if (ret != 0) {
             ERR_PRINT("program_flash(): Program Page Data");
             return ret;
         }
-        if (read_busy_flag(cpld) != 0) {
+        if (read_busy_flag(cpld, page_busy_timing, pages) != 0) {
             CPLD_DEBUG("Device busy is caused by page data program.\n");
             return -1;
         }
-        printf("  (%d/%d) (%d%%/100%%)\r",
-               byte_index + 16, data_len, (100 * (byte_index + 16) / data_len));
-        if ((byte_index & 0xFFF) == 0) {
-            if(is_remote) {
-                percentage =  percentage_start + (FLASH_PERCENTAGE * (byte_index + 16) / data_len);
-                method = bus.new_method_call(service.c_str(), object.c_str() ,PROP_INTF, "Set");
-                method.append(ACTIVATION_PROGRESS_INTF,"Progress");
-                method.append(std::variant<uint8_t>(percentage));
-                reply = bus.call(method);
-                if (reply.is_method_error()) {
-                    printf("error setting property: %s Progress",ACTIVATION_PROGRESS_INTF);
-                    return -1;
-                }
-            }
+        byte_index += pages * FLASH_PAGE_SIZE;
+
+        printf("  (%d/%d) (%d%%/100%%)\r", std::min(byte_index, data_len),
+               data_len, (100 * std::min(byte_index, data_len) / data_len));
+        if (progress) {
+            progress->set(percentage_start + (FLASH_PERCENTAGE *
+                          std::min(byte_index, data_len) / data_len));
         }
-        usleep(2000);
     }
     printf("\t\t\t\t...Done!\n");
     return 0;
@@ -760,7 +881,7 @@ program_done(i2c_info_t cpld)
         ERR_PRINT("program_done()");
         return ret;
     }
-    if (read_busy_flag(cpld) != 0) {
+    if (read_busy_flag(cpld, cmd_busy_timing) != 0) {
         CPLD_DEBUG("Device busy is caused by program done.\n");
         return -1;
     }
@@ -807,6 +928,8 @@ main(int argc, const char *argv[])
     auto bus = sdbusplus::bus::new_default();
     auto reply =sdbusplus::message::message();
     int update_retry = 0;
+    int burst_pages = 1;
+    progress_reporter progress;
     if (argc != 2) {
         print_usage(argv[0]);
         exit(EXIT_FAILURE);
@@ -880,8 +1003,19 @@ main(int argc, const char *argv[])
             std::cerr << "UNKNOWN type, only support for MachXO3D or MachXO3\n";
             return 0;
         }
+        /* Pages per program command, MachXO3 and MachXO3D take one */
+        if (json_data[type].count("burst_pages") == 1) {
+            burst_pages = json_data[type]["burst_pages"].get<int>();
+            if (burst_pages < 1 || burst_pages > MAX_BURST_PAGES) {
+                std::cerr << "burst_pages must be 1 to " << MAX_BURST_PAGES << "\n";
+                return 0;
+            }
+        }
     }catch(std::string s){
 	    std::cerr << s << std::endl;
+    }catch(const json::exception& e){
+        std::cerr << "Invalid CPLD configuration: " << e.what() << "\n";
+        return 0;
     }
     cpld.fd = i2c_open(cpld.bus, cpld.addr);
     if (cpld.fd < 0) {
@@ -947,6 +1081,10 @@ main(int argc, const char *argv[])
     } else {
         printf("pre verify check pass\n");
     }
+    if (is_remote && progress.start(service, object) != 0) {
+        printf("progress is not reported\n");
+        is_remote = false;
+    }
     for (update_retry = 0; update_retry < UPDATE_RETRIES; update_retry++) {
 
         sleep(1);
@@ -957,13 +1095,15 @@ main(int argc, const char *argv[])
             CPLD_DEBUG("erase flash succeed\n");
         }
 
-        if (program_flash(cpld, cpld_config.reset_addr_cmd, cfg_data, cfg_len, is_remote, service, object) != 0 ) {
+        if (program_flash(cpld, cpld_config.reset_addr_cmd, cfg_data, cfg_len,
+                          burst_pages, is_remote ? &progress : NULL) != 0 ) {
             continue;
         }else{
             CPLD_DEBUG("program flash succeed\n");
         }
 
-        if (verify(cpld, cpld_config.reset_addr_cmd, cfg_data, cfg_len, is_remote, service, object) != 0 ) {
+        if (verify(cpld, cpld_config.reset_addr_cmd, cfg_data, cfg_len,
+                   is_remote ? &progress : NULL) != 0 ) {
             continue;
         }else{
             CPLD_DEBUG("verify succeed\n");
@@ -990,16 +1130,8 @@ main(int argc, const char *argv[])
     }
 
     if(is_remote) {
-        bus = sdbusplus::bus::new_default();
-        method = bus.new_method_call(service.c_str(), object.c_str() ,PROP_INTF, "Set");
-        method.append(ACTIVATION_PROGRESS_INTF,"Progress");
-        uint8_t p = 100;
-        method.append(std::variant<uint8_t>(p));
-        try {
-            reply = bus.call(method);
-        } catch (const sdbusplus::exception::SdBusError& e) {
-            printf("error: sdbus %s\n", e.what());
-        }
+        progress.set(100);
+        progress.stop();
     }
     sleep(2);
     close(cpld.fd);